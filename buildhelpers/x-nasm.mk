@@ -34,4 +34,5 @@ X-AS    = egrep -v 'END[SP]?$$' \
         | sed 's/ PTR / /' \
         | sed 's/XMMWORD/OWORD/' \
         | sed 's/YMMWORD/YWORD/' \
+        | sed 's/ZMMWORD/ZWORD/' \
         | buildhelpers/x-nasm-macros.sh
@@ -15,6 +15,8 @@
 #define __GRAZELLE_CMDLINE_H
 
 
+#include "execution.h"
+
 #include <stdint.h>
 
 
@@ -23,23 +25,66 @@
 // Default values for the command-line settings; any option not specified here has no default
 #define CMDLINE_DEFAULT_NUM_THREADS             0
 #define CMDLINE_DEFAULT_NUM_ITERATIONS          1
+#define CMDLINE_DEFAULT_MAX_NUM_ITERATIONS      1000
 #define CMDLINE_DEFAULT_SCHED_GRANULARITY       0
 
+// Default algorithm, which is selected at build time
+#if defined(DEFAULT_ALGORITHM_BREADTH_FIRST_SEARCH)
+#define CMDLINE_DEFAULT_ALGORITHM               EXECUTION_ALGORITHM_BREADTH_FIRST_SEARCH
+#elif defined(DEFAULT_ALGORITHM_CONNECTED_COMPONENTS)
+#define CMDLINE_DEFAULT_ALGORITHM               EXECUTION_ALGORITHM_CONNECTED_COMPONENTS
+#else
+#define CMDLINE_DEFAULT_ALGORITHM               EXECUTION_ALGORITHM_PAGERANK
+#endif
+
 // Maximum number of NUMA nodes supported at the command line.
 #define CMDLINE_MAX_NUM_NUMA_NODES              4
 
+// Maximum number of input graphs supported at the command line.
+#define CMDLINE_MAX_NUM_INPUT_GRAPHS            16
+
+// Maximum number of algorithms, run one after another on each graph, supported at the command line.
+#define CMDLINE_MAX_NUM_ALGORITHMS              8
+
+// Maximum number of search roots, from each of which search algorithms run once on each graph, supported at the command line.
+#define CMDLINE_MAX_NUM_SEARCH_ROOTS            16384
+
 
 /* -------- TYPE DEFINITIONS ----------------------------------------------- */
 
 // Contains the values for each possible command-line option.
 typedef struct cmdline_opts_t
 {
-    char graph_input_filename_gather[1024];                 // 'i' -> required; filename of the graph input file, gather version, derived from the supplied name by adding "-pull"
-    char graph_input_filename_scatter[1024];                // 'i' -> required; filename of the graph input file, scatter version, derived from the supplied name by adding "-push"
+    char graph_input_filename[CMDLINE_MAX_NUM_INPUT_GRAPHS][1024];           // 'i' -> required unless 'r' is specified; filename of each graph input file as supplied, used if neither of the following exists
+    char graph_input_filename_gather[CMDLINE_MAX_NUM_INPUT_GRAPHS][1024];    // 'i' -> required unless 'r' is specified; filename of each graph input file, gather version, derived from the supplied name by adding "-pull"
+    char graph_input_filename_scatter[CMDLINE_MAX_NUM_INPUT_GRAPHS][1024];   // 'i' -> required unless 'r' is specified; filename of each graph input file, scatter version, derived from the supplied name by adding "-push"
+    uint32_t num_input_graphs;                              // 'i' -> number of input graphs, which are loaded and processed one after another, inferred from the number of times the option appears
+    
+    char* graph_snapshot_input_filename;                    // 'r' -> optional; filename of a graph snapshot to read instead of the graph input file
+    uint32_t vertex_reorder_method;                         // 'R' -> optional; method for reordering vertices while reading the graph input file, one of the GRAPH_REORDER_* constants
+    char* graph_snapshot_output_filename;                   // 'w' -> optional; filename of a graph snapshot to write once the graph is loaded
+    
+    char graph_compressed_output_filename_gather[1024];     // 'c' -> optional; filename of the compressed graph output file, gather version, derived from the supplied name by adding "-pull"
+    char graph_compressed_output_filename_scatter[1024];    // 'c' -> optional; filename of the compressed graph output file, scatter version, derived from the supplied name by adding "-push"
     
     char* graph_ranks_output_filename;                      // 'o' -> optional; filename of the output file that should contain ranks for each vertex
+    uint32_t graph_ranks_output_binary;                     // 'b' -> optional; if set, the output file is written in binary rather than as text
+    uint32_t graph_depths_output;                           // 'd' -> optional; if set, searches that produce the parent of each vertex also write its depth to a second output file
+    
+    uint32_t page_policy;                                   // 'p' -> optional; kind of pages to use for large graph data structures, one of the NUMANODES_PAGES_* constants
+    uint32_t phase_isa;                                     // 'k' -> optional; instruction set to use for the processing kernels, one of the PHASES_ISA_* constants
+    
+    uint32_t engine_select_method;                          // 'e' -> optional; method for choosing between the Pull and Push engines, one of the ENGINESELECT_METHOD_* constants
+    uint32_t engine_calibration_persist;                    // 'E' -> optional; if set, adaptive engine selection measurements are read from and written to a file next to each input graph
 
-    uint32_t num_iterations;                                // 'N' -> optional; number of iterations of the algorithm to execute
+    uint32_t algorithms[CMDLINE_MAX_NUM_ALGORITHMS];        // 'a' -> optional; list of algorithms to run on each graph, one after another, each one of the EXECUTION_ALGORITHM_* constants
+    uint32_t num_algorithms;                                // 'a' -> optional; number of algorithms to run on each graph, inferred from the list
+    
+    uint64_t search_roots[CMDLINE_MAX_NUM_SEARCH_ROOTS];    // 'S' -> optional; list of vertices from which to start search algorithms, one run per vertex, identified as in the input graph
+    uint32_t num_search_roots;                              // 'S' -> optional; number of search roots, inferred from the list
+    
+    uint32_t num_iterations;                                // 'N' -> optional; number of iterations of the algorithm to execute, or the maximum number if a tolerance is specified
+    double tolerance;                                       // 't' -> optional; L1 residual below which PageRank stops iterating, or 0 to run a fixed number of iterations
     
     uint32_t num_threads;                                   // 'n' -> optional; number of worker threads to use while executing
 	uint32_t num_numa_nodes;								// 'u' -> optional; number of NUMA nodes to use, inferred from the list
@@ -0,0 +1,68 @@
+/*****************************************************************************
+* Grazelle
+*      High performance, hardware-optimized graph processing engine.
+*      Targets a single machine with one or more x86-based sockets.
+*****************************************************************************
+* Authored by Samuel Grossman
+* Department of Electrical Engineering, Stanford University
+* (c) 2015-2018
+*****************************************************************************
+* engineselect.h
+*      Selection between the Edge-Pull and Edge-Push engines in each
+*      iteration of algorithms that converge dynamically. Either compares
+*      the frontier size to a fixed threshold or predicts the cost of each
+*      engine using a model calibrated online for the loaded graph.
+*****************************************************************************/
+
+#ifndef __GRAZELLE_ENGINESELECT_H
+#define __GRAZELLE_ENGINESELECT_H
+
+
+#include <stdint.h>
+
+
+/* -------- CONSTANTS ------------------------------------------------------ */
+
+// Uses the Pull engine whenever the frontier size exceeds a fixed threshold.
+#define ENGINESELECT_METHOD_THRESHOLD           0
+
+// Uses whichever engine is predicted to be cheaper for the frontier size, based on measured Edge phase times.
+// Falls back to the threshold until both engines have been measured on the loaded graph.
+#define ENGINESELECT_METHOD_ADAPTIVE            1
+
+// While only one engine has been measured, the other is tried once if the frontier size is within this factor of the threshold.
+#define ENGINESELECT_EXPLORE_FACTOR             4ull
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+
+// Discards all calibration and selects the method to use, one of the ENGINESELECT_METHOD_* constants.
+// Measurements depend on the number of threads and on the instruction set of the kernels, so calibration is kept only for the specified ones.
+// Must be called whenever a new graph is loaded.
+void engineselect_reset(const uint32_t method, const uint32_t num_threads, const uint32_t phase_isa);
+
+// Reads calibration previously written for the loaded graph, if the file exists.
+// Calibration written for a different number of threads or instruction set is ignored.
+// Returns nonzero if calibration was read, or 0 if the file does not exist or was written for a different configuration.
+uint32_t engineselect_read_calibration(const char* filename);
+
+// Writes the current calibration to the specified file, replacing it.
+void engineselect_write_calibration(const char* filename);
+
+// Selects the algorithm whose calibration is used and updated, one of the EXECUTION_ALGORITHM_* constants.
+// Must be called before the algorithm starts running.
+void engineselect_select_algorithm(const uint32_t algorithm);
+
+// Determines if the Pull engine should be used for the next iteration, given the frontier size and the threshold the algorithm compares it to.
+// Must be called by all threads with the same arguments, and produces the same result on all of them.
+uint8_t engineselect_use_pull(const uint64_t frontier_size, const uint64_t engine_threshold);
+
+// Marks the start of the Edge phase. Only has an effect on the first thread.
+void engineselect_edge_phase_start();
+
+// Marks the end of the Edge phase, after the barrier that follows it, and records its cost for the engine that was used.
+// Only has an effect on the first thread, and the update is visible to all threads after the next barrier.
+void engineselect_edge_phase_end(const uint8_t used_pull, const uint64_t frontier_size);
+
+
+#endif //__GRAZELLE_ENGINESELECT_H
@@ -31,75 +31,116 @@ extern uint64_t total_iterations_executed;
 extern uint64_t total_iterations_used_gather;
 extern uint64_t total_iterations_used_scatter;
 
-
-/* -------- ALGORITHM SELECTION -------------------------------------------- */
-
-#if defined(BREADTH_FIRST_SEARCH)
-
-#define SCALAR_REDUCE_OP(a,b)                   (((a) < (b)) ? (a) : (b))
-#define execution_init                          execution_init_bfs
-#define execution_cleanup                       execution_cleanup_bfs
-#define execution_accumulator_bits_per_vertex   execution_accumulator_bits_per_vertex_bfs
-#define execution_initialize_frontier_has_info  execution_initialize_frontier_has_info_bfs
-#define execution_initialize_frontier_wants_info execution_initialize_frontier_wants_info_bfs
-#define execution_initialize_vertex_accum       execution_initialize_vertex_accum_bfs
-#define execution_initialize_vertex_prop        execution_initialize_vertex_prop_bfs
-#define execution_impl                          execution_impl_bfs
-
-#elif defined(CONNECTED_COMPONENTS)
-
-#define SCALAR_REDUCE_OP(a,b)                   (((a) < (b)) ? (a) : (b))
-#define execution_init                          execution_init_cc
-#define execution_cleanup                       execution_cleanup_cc
-#define execution_accumulator_bits_per_vertex   execution_accumulator_bits_per_vertex_cc
-#define execution_initialize_frontier_has_info  execution_initialize_frontier_has_info_cc
-#define execution_initialize_frontier_wants_info execution_initialize_frontier_wants_info_cc
-#define execution_initialize_vertex_accum       execution_initialize_vertex_accum_cc
-#define execution_initialize_vertex_prop        execution_initialize_vertex_prop_cc
-#define execution_impl                          execution_impl_cc
-
-#else
-
-#define SCALAR_REDUCE_OP(a,b)                   ((a) + (b))
-#define execution_init                          execution_init_pr
-#define execution_cleanup                       execution_cleanup_pr
-#define execution_accumulator_bits_per_vertex   execution_accumulator_bits_per_vertex_pr
-#define execution_initialize_frontier_has_info  execution_initialize_frontier_has_info_pr
-#define execution_initialize_frontier_wants_info execution_initialize_frontier_wants_info_pr
-#define execution_initialize_vertex_accum       execution_initialize_vertex_accum_pr
-#define execution_initialize_vertex_prop        execution_initialize_vertex_prop_pr
-#define execution_impl                          execution_impl_pr
-
-#endif
+// L1 norm of the change in all vertex ranks during the last iteration, or a negative value if the algorithm that last ran did not compute it.
+extern double total_residual;
+
+// Vertex from which search algorithms start, as numbered internally, which differs from the input graph if vertices were renumbered or reordered at ingress.
+// Set before the vertex state of the currently-loaded graph is initialized for a search algorithm.
+extern uint64_t execution_search_root;
+
+// Vertices from which algorithms that run several searches at once start, numbered internally like `execution_search_root`, and how many there are.
+// Set before such an algorithm runs, which then runs all of the searches.
+extern const uint64_t* execution_search_roots;
+extern uint64_t execution_num_search_roots;
+
+
+/* -------- CONSTANTS ------------------------------------------------------ */
+
+// Identifies each algorithm that can be selected at runtime, as an index into the algorithm table.
+#define EXECUTION_ALGORITHM_PAGERANK            0
+#define EXECUTION_ALGORITHM_CONNECTED_COMPONENTS 1
+#define EXECUTION_ALGORITHM_BREADTH_FIRST_SEARCH 2
+#define EXECUTION_ALGORITHM_PAGERANK_SINGLE     3
+#define EXECUTION_ALGORITHM_SINGLE_SOURCE_SHORTEST_PATHS 4
+#define EXECUTION_ALGORITHM_MULTI_SOURCE_BFS    5
+#define EXECUTION_ALGORITHM_PAGERANK_DELTA      6
+#define EXECUTION_ALGORITHM_PAGERANK_GAS        7
+#define EXECUTION_ALGORITHM_CONNECTED_COMPONENTS_GAS 8
+
+// Number of algorithms in the algorithm table.
+#define EXECUTION_NUM_ALGORITHMS                9
+
+// Kind of value an algorithm produces for each vertex as output: a rank, written as a double.
+#define EXECUTION_OUTPUT_RANK                   0
+
+// Kind of value an algorithm produces for each vertex as output: the ID of another vertex, written as a vertex ID and translated like one.
+#define EXECUTION_OUTPUT_VERTEX_ID              1
+
+// Kind of value an algorithm produces for each vertex as output: a distance, written as a double and infinite if the vertex is unreachable.
+#define EXECUTION_OUTPUT_DISTANCE               2
+
+// Kind of value produced for each vertex by the depth output of a search: the number of edges from the search root, written as an integer and -1 if the vertex is unreachable.
+#define EXECUTION_OUTPUT_DEPTH                  3
+
+// Kind of value an algorithm produces for each vertex as output: totals over several searches, namely how many reached the vertex, the sum of their distances to it, and the largest of those distances, written as three integers.
+#define EXECUTION_OUTPUT_SEARCH_TOTALS          4
+
+// Kind of value an algorithm produces for each vertex as output: a component label, which is the output position of a vertex, written as a vertex ID and translated like one.
+#define EXECUTION_OUTPUT_COMPONENT              5
+
+// Ways in which an algorithm can use search roots: not at all, one run per search root starting from `execution_search_root`, or a single run covering all of the search roots in `execution_search_roots`.
+#define EXECUTION_SEARCH_ROOTS_NONE             0
+#define EXECUTION_SEARCH_ROOTS_EACH             1
+#define EXECUTION_SEARCH_ROOTS_ALL              2
+
+
+/* -------- TYPE DEFINITIONS ----------------------------------------------- */
+
+// Describes an algorithm and holds the functions that implement it.
+// Exactly one algorithm is selected at a time, and the rest of the program uses it through the functions held here.
+typedef struct execution_algorithm_t
+{
+    const char* name;                                                   // short name used to select the algorithm on the command line
+    const char* display_name;                                           // full name of the algorithm, used when reporting results
+    uint32_t converges_dynamically;                                     // whether the algorithm runs until convergence, as opposed to for a fixed number of iterations
+    uint32_t output_type;                                               // kind of value produced for each vertex, one of the EXECUTION_OUTPUT_* constants
+    uint32_t single_precision;                                          // whether vertex properties and accumulators are stored as floats rather than doubles
+    uint32_t uses_edge_weights;                                         // whether the algorithm reads the weight of each edge, which are loaded only if needed
+    uint32_t search_roots;                                              // how the algorithm uses search roots, one of the EXECUTION_SEARCH_ROOTS_* constants
+    uint32_t vertex_id_props;                                           // whether vertex properties are stored as 32-bit vertex IDs, all bits set meaning none, rather than as doubles
+    
+    void (*init)();                                                     // performs any needed initialization tasks to prepare for execution
+    void (*cleanup)();                                                  // cleans up after execution
+    uint64_t (*accumulator_bits_per_vertex)();                          // specifies the number of bits per vertex required in the accumulator
+    uint64_t (*initialize_frontier_has_info)(const uint64_t base);      // initializes the HasInfo frontier for a group of 64 vertices starting with `base`
+    uint64_t (*initialize_frontier_wants_info)(const uint64_t base);    // initializes the WantsInfo frontier for a group of 64 vertices starting with `base`
+    double (*initialize_vertex_accum)(const uint64_t id);               // initializes a vertex accumulator, given a vertex ID
+    double (*initialize_vertex_prop)(const uint64_t id);                // initializes a vertex property, given a vertex ID
+    double (*scalar_reduce_op)(const double a, const double b);         // combines two partial accumulator values for the same vertex
+    void (*impl)(void* unused_arg);                                     // acts as a driver for the algorithm and sequences the phases, executed by every worker thread
+} execution_algorithm_t;
+
+
+/* -------- ALGORITHMS ----------------------------------------------------- */
+
+// Table of all algorithms, indexed by the EXECUTION_ALGORITHM_* constants.
+extern const execution_algorithm_t* const execution_algorithms[EXECUTION_NUM_ALGORITHMS];
+
+// Currently-selected algorithm.
+extern const execution_algorithm_t* execution_algorithm;
+
+// Implementations of each algorithm, which appear in the table above.
+// Initialization and frontier functions return, for the frontiers, a bit-mask with '1' meaning the vertex is in the frontier and '0' meaning it is not.
+extern const execution_algorithm_t execution_algorithm_pr;
+extern const execution_algorithm_t execution_algorithm_cc;
+extern const execution_algorithm_t execution_algorithm_bfs;
+extern const execution_algorithm_t execution_algorithm_prf;
+extern const execution_algorithm_t execution_algorithm_sssp;
+extern const execution_algorithm_t execution_algorithm_msbfs;
+extern const execution_algorithm_t execution_algorithm_prd;
+extern const execution_algorithm_t execution_algorithm_prg;
+extern const execution_algorithm_t execution_algorithm_ccg;
 
 
 /* -------- FUNCTIONS ------------------------------------------------------ */
 
-// Performs any needed initialization tasks to prepare for execution.
-void execution_init();
-
-// Cleans up after execution.
-void execution_cleanup();
-
-// Specifies the number of bits per vertex are required in the accumulator.
-uint64_t execution_accumulator_bits_per_vertex();
-
-// Initializes the HasInfo frontier for a group of 64 vertices starting with `base`.
-// A bit-mask should be returned, with '1' meaning the vertex is in the frontier and '0' means it is not.
-uint64_t execution_initialize_frontier_has_info(const uint64_t base);
-
-// Initializes the WantsInfo frontier for a group of 64 vertices starting with `base`.
-// A bit-mask should be returned, with '1' meaning the vertex is in the frontier and '0' means it is not.
-uint64_t execution_initialize_frontier_wants_info(const uint64_t base);
-
-// Initializes a vertex accumulator, given a vertex ID.
-double execution_initialize_vertex_accum(const uint64_t id);
-
-// Initializes a vertex property, given a vertex ID.
-double execution_initialize_vertex_prop(const uint64_t id);
+// Looks up an algorithm by its short name.
+// Returns one of the EXECUTION_ALGORITHM_* constants, or EXECUTION_NUM_ALGORITHMS if no algorithm has the specified name.
+uint32_t execution_find_algorithm(const char* name);
 
-// Implements the PageRank/CC/BFS algorithms, depending on compile options. This function acts as a driver and sequences other operations by calling their respective functions.
-void execution_impl(void* unused_arg);
+// Selects the algorithm to run, one of the EXECUTION_ALGORITHM_* constants, along with the phase control functions that implement it.
+// Must be called before the graph is loaded or its vertex state is initialized, since this depends on the selected algorithm.
+void execution_select_algorithm(const uint32_t algorithm);
 
 
 #endif //__GRAZELLE_EXECUTION_H
@@ -0,0 +1,818 @@
+/*****************************************************************************
+* Grazelle
+*      High performance, hardware-optimized graph processing engine.
+*      Targets a single machine with one or more x86-based sockets.
+*****************************************************************************
+* Authored by Samuel Grossman
+* Department of Electrical Engineering, Stanford University
+* (c) 2015-2018
+*****************************************************************************
+* gas.h
+*      Gather-Apply-Scatter programming interface. Generates the phase
+*      control functions and the driver for an algorithm from a small set
+*      of vectorized operators, using the same edge lists, scheduler,
+*      merge buffers, and frontiers as the hand-written phases.
+*      C++ only; include from a source file that implements an algorithm.
+*****************************************************************************/
+
+#ifndef __GRAZELLE_GAS_H
+#define __GRAZELLE_GAS_H
+
+
+#include "intrinhelper.h"
+
+extern "C" {
+#include "cmdline.h"
+#include "engineselect.h"
+#include "execution.h"
+#include "functionhelper.h"
+#include "graphdata.h"
+#include "graphtypes.h"
+#include "numanodes.h"
+#include "phases.h"
+#include "scheduler.h"
+#include "threads.h"
+}
+
+#include <stdint.h>
+
+
+/*
+ * An algorithm is described by a program type, which is a struct that derives from gas_program_defaults_t and supplies static operators.
+ * Every operator works on four vertices or edges at once, one per lane of an AVX2 register of packed doubles.
+ *
+ *   identity()                     value of an accumulator that has received nothing; must leave any value unchanged when reduced with it
+ *   gather(src_props)              message sent along an edge, given the property of its source vertex
+ *   reduce(a, b)                   combines two messages or partial accumulators; must be associative and commutative
+ *   apply(accum, prop, outdeg, g)  new property of a vertex, given its accumulator, current property, outdegree, and the globals
+ *   scatter(new_prop, prop)        all bits set for each vertex that should send messages in the next iteration (frontier rule)
+ *   residual(new_prop, prop, outdeg, g)
+ *                                  amount by which a vertex changed, summed over all vertices when a tolerance is specified
+ *
+ * The frontier rule selects which vertices send messages.
+ * With GAS_FRONTIER_ALL, every vertex sends messages every iteration, and the algorithm runs for a fixed number of iterations or until the residual falls below the tolerance.
+ * With GAS_FRONTIER_ACTIVE, only vertices marked by scatter() in the previous iteration send messages, all vertices being marked initially, and the algorithm runs until none are marked.
+ * The engine is then selected every iteration based on the size of the frontier, in the same way as the hand-written algorithms.
+ *
+ * Setting uses_accum_total causes the sum of all accumulators produced by the Edge phase to be made available to apply() as a global.
+ */
+
+
+/* -------- CONSTANTS ------------------------------------------------------ */
+
+// Frontier rule: every vertex sends messages every iteration.
+#define GAS_FRONTIER_ALL                        0
+
+// Frontier rule: only vertices marked by the scatter operator in the previous iteration send messages.
+#define GAS_FRONTIER_ACTIVE                     1
+
+// Mask that extracts a vertex ID from one lane of an edge vector.
+#define GAS_EDGE_VECTOR_VERTEX_MASK             0x0000ffffffffffffull
+
+// Returned by the frontier search when no further active vertices have edges in the current edge list.
+#define GAS_FRONTIER_SEARCH_END                 0xffffffffffffffffull
+
+
+/* -------- TYPE DEFINITIONS ----------------------------------------------- */
+
+// Global values made available to the apply and residual operators.
+typedef struct gas_globals_t
+{
+    double num_vertices;                                    // number of vertices in the graph
+    double accum_total;                                     // sum of all accumulators produced by the Edge phase, if the program uses it
+} gas_globals_t;
+
+// Parameters passed to the generated Vertex phase, in place of the reduce buffer.
+typedef struct gas_vertex_params_t
+{
+    gas_globals_t globals;                                  // global values for the apply and residual operators
+    uint64_t reset_accumulators;                            // whether to reset each accumulator to the identity after applying it
+    double* residual_buffer;                                // receives each thread's part of the residual, or NULL if the residual is not needed
+    uint64_t* vote_buffer;                                  // receives each thread's part of the frontier size, used only with GAS_FRONTIER_ACTIVE
+} gas_vertex_params_t;
+
+// Default operators and settings, from which every program derives.
+struct gas_program_defaults_t
+{
+    static const uint32_t frontier = GAS_FRONTIER_ALL;
+    static const uint32_t uses_accum_total = 0;
+
+    static inline __m256d scatter(const __m256d new_prop, const __m256d prop)
+    {
+        return _mm256_castsi256_pd(_mm256_set1_epi64x(-1ll));
+    }
+
+    static inline __m256d residual(const __m256d new_prop, const __m256d prop, const __m256d outdeg, const gas_globals_t& g)
+    {
+        __m256d diff = _mm256_sub_pd(new_prop, prop);
+        return _mm256_max_pd(diff, _mm256_sub_pd(_mm256_setzero_pd(), diff));
+    }
+};
+
+// Per-thread buffers used by a program, one set per program type.
+template <typename P> struct gas_buffers_t
+{
+    static uint64_t size;                                   // number of elements in each buffer
+    static double* accum_total;                             // each thread's part of the accumulator total from the Edge phase
+    static double* residual;                                // each thread's part of the residual from the Vertex phase
+    static uint64_t* vote;                                  // each thread's part of the frontier size from the Vertex phase
+};
+
+template <typename P> uint64_t gas_buffers_t<P>::size = 0ull;
+template <typename P> double* gas_buffers_t<P>::accum_total = NULL;
+template <typename P> double* gas_buffers_t<P>::residual = NULL;
+template <typename P> uint64_t* gas_buffers_t<P>::vote = NULL;
+
+
+/* -------- INTERNAL FUNCTIONS --------------------------------------------- */
+
+// Extracts the vertex ID shared by all lanes of an edge vector in the standard encoding, spread 15 bits at a time over the top bits of each lane.
+static inline uint64_t gas_decode_shared_vertex(const uint64_t* edge)
+{
+    return ((edge[0] >> 48) & 0x7fffull) | (((edge[1] >> 48) & 0x7fffull) << 15) | (((edge[2] >> 48) & 0x7fffull) << 30) | (((edge[3] >> 48) & 0x0007ull) << 45);
+}
+
+// Combines all four lanes of a vector into a single value using the reduce operator of the specified program.
+template <typename P> static inline double gas_horizontal_reduce(const __m256d v)
+{
+    __m256d r = P::reduce(v, _mm256_permute_pd(v, 0x5));
+    r = P::reduce(r, _mm256_permute2f128_pd(r, r, 0x01));
+    return _mm_cvtsd_f64(_mm256_castpd256_pd128(r));
+}
+
+// Adds together all four lanes of a vector.
+static inline double gas_horizontal_sum(const __m256d v)
+{
+    const __m128d r = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(r, _mm_unpackhi_pd(r, r)));
+}
+
+// Combines two values using the reduce operator of the specified program.
+template <typename P> static inline double gas_scalar_reduce(const double a, const double b)
+{
+    return _mm_cvtsd_f64(_mm256_castpd256_pd128(P::reduce(_mm256_set1_pd(a), _mm256_set1_pd(b))));
+}
+
+// Combines a value into an accumulator that other threads might be updating at the same time, unless synchronization is disabled.
+template <typename P, bool synchronized> static inline void gas_reduce_into(double* accum, const double value)
+{
+    if (synchronized)
+    {
+        uint64_t* const target = (uint64_t*)accum;
+        uint64_t expected = *(volatile uint64_t*)target;
+
+        while (1)
+        {
+            union { uint64_t u; double d; } current, proposed;
+            current.u = expected;
+            proposed.d = gas_scalar_reduce<P>(current.d, value);
+
+            const uint64_t actual = __sync_val_compare_and_swap(target, expected, proposed.u);
+            if (actual == expected)
+                break;
+
+            expected = actual;
+        }
+    }
+    else
+    {
+        *accum = gas_scalar_reduce<P>(*accum, value);
+    }
+}
+
+// Initializes the work scheduler at the beginning of an Edge phase by setting the current group's dynamic scheduling counter to the number of threads in the group.
+// Does nothing for a thread stealing work from another group, since that group's phase is already underway.
+// Equivalent to scheduler_phase_init in the assembly scheduler.
+static inline void gas_scheduler_phase_init()
+{
+    if (threads_get_local_thread_id() & SCHED_STEAL_LOCAL_ID_FLAG)
+        return;
+
+    if (0 == threads_get_local_thread_id())
+    {
+        *graph_scheduler_dynamic_counter_numa[threads_get_thread_group_id()] = threads_get_threads_per_group();
+    }
+
+    threads_barrier();
+}
+
+// Retrieves the index of the first unit of work to assign to the calling thread, which is its local thread ID or, for a thread stealing work, the unit it reserved.
+static inline int64_t gas_scheduler_get_first_assigned_unit()
+{
+    return (int64_t)(threads_get_local_thread_id() & ~SCHED_STEAL_LOCAL_ID_FLAG);
+}
+
+// Retrieves the index of the next unit of work to assign to the calling thread, or -1 if no unit is available.
+// A thread stealing work processes only the unit it reserved, so it never has a next one.
+static inline int64_t gas_scheduler_get_next_assigned_unit(const uint64_t num_units)
+{
+    if (threads_get_local_thread_id() & SCHED_STEAL_LOCAL_ID_FLAG)
+        return -1ll;
+
+    const uint64_t unit = __sync_fetch_and_add(graph_scheduler_dynamic_counter_numa[threads_get_thread_group_id()], 1ull);
+    return ((unit < num_units) ? (int64_t)unit : -1ll);
+}
+
+// Computes the range of edge vectors, as first and one-past-last index, that makes up the specified unit of work.
+// Uses the same formulas as scheduler_assign_work_for_unit in the assembly scheduler, so units match those of the hand-written phases.
+static inline void gas_scheduler_assign_work_for_unit(const uint64_t unit, const uint64_t num_units, const uint64_t num_vectors, uint64_t* first, uint64_t* last)
+{
+    const uint64_t assignment = num_vectors / num_units;
+    const uint64_t remainder = num_vectors % num_units;
+
+    *first = (assignment * unit) + ((unit < remainder) ? unit : remainder);
+    *last = *first + assignment + ((unit < remainder) ? 1ull : 0ull);
+}
+
+// Searches the HasInfo frontier, starting at the specified vertex, for the next active vertex that has edges in the current edge list.
+// Returns the index of its first edge vector, or GAS_FRONTIER_SEARCH_END if there is no such vertex.
+// Uses the sparse frontier queue if it was built for this phase, and otherwise the bitmask.
+// Equivalent to the search performed by phase_helper_strong_frontier_check_queue.
+static inline uint64_t gas_frontier_search(const uint64_t* frontier, const uint64_t frontier_count, const uint64_t* vertex_index, const uint64_t vertex)
+{
+    const uint64_t queue_count = graph_frontier_queue_count;
+
+    if (GRAPH_FRONTIER_QUEUE_NONE != queue_count)
+    {
+        // binary search for the first queued vertex not less than the specified vertex, then check candidates in order
+        uint64_t lo = 0ull;
+        uint64_t hi = queue_count;
+
+        while (lo < hi)
+        {
+            const uint64_t mid = (lo + hi) >> 1;
+
+            if (graph_frontier_queue[mid] < vertex)
+                lo = mid + 1ull;
+            else
+                hi = mid;
+        }
+
+        for (; lo < queue_count; ++lo)
+        {
+            const uint64_t index = vertex_index[graph_frontier_queue[lo]];
+            if (index & 0x8000000000000000ull)
+                return GAS_FRONTIER_SEARCH_END;
+
+            if (!(index & 0x4000000000000000ull))
+                return index;
+        }
+
+        return GAS_FRONTIER_SEARCH_END;
+    }
+
+    uint64_t element = vertex >> 6;
+    uint64_t bits = frontier[element] & (~0ull << (vertex & 63ull));
+
+    while (1)
+    {
+        while (0ull == bits)
+        {
+            element += 1ull;
+            if (element >= frontier_count)
+                return GAS_FRONTIER_SEARCH_END;
+
+            bits = frontier[element];
+        }
+
+        // top bit of the index value means the vertex is past the end of the graph, and the next bit means the vertex has no edges
+        const uint64_t index = vertex_index[(element << 6) + (uint64_t)__builtin_ctzll(bits)];
+        if (index & 0x8000000000000000ull)
+            return GAS_FRONTIER_SEARCH_END;
+
+        if (!(index & 0x4000000000000000ull))
+            return index;
+
+        bits &= (bits - 1ull);
+    }
+}
+
+// Computes the messages sent along the edges in four lanes of an in-edge vector to their shared destination.
+// Source vertex IDs are in the lower bits of each lane of `sources`, and the top bit of each lane of `valid` is set if that lane holds an edge.
+// Lanes without an edge, or whose source is not in the frontier for programs that have one, produce the identity.
+// Returns zero if no lane produced a message, in which case the messages are all the identity.
+template <typename P> static inline int gas_pull_messages(const __m256i sources, __m256i valid, __m256d* messages)
+{
+    if (GAS_FRONTIER_ACTIVE == P::frontier)
+    {
+        // weak frontier check: a message is sent only if the source is in HasInfo
+        const __m256i frontier_elements = _mm256_mask_i64gather_epi64(_mm256_setzero_si256(), (const long long*)graph_frontier_has_info, _mm256_srli_epi64(sources, 6), valid, 8);
+        const __m256i frontier_bits = _mm256_srlv_epi64(frontier_elements, _mm256_and_si256(sources, _mm256_set1_epi64x(63ll)));
+        valid = _mm256_and_si256(valid, _mm256_slli_epi64(frontier_bits, 63));
+
+        if (0 == _mm256_movemask_pd(_mm256_castsi256_pd(valid)))
+        {
+            *messages = P::identity();
+            return 0;
+        }
+    }
+
+    const __m256d valid_mask = _mm256_castsi256_pd(valid);
+    const __m256d props = _mm256_mask_i64gather_pd(P::identity(), graph_vertex_props, sources, valid_mask, 8);
+    *messages = _mm256_blendv_pd(P::identity(), P::gather(props), valid_mask);
+    return 1;
+}
+
+// Computes the messages sent along all edges of the in-edge vector at the specified index and extracts their shared destination.
+// Handles both the standard encoding and, if enabled, the compact encoding, whose eight lanes are reduced down to four.
+template <typename P> static inline int gas_pull_vector(const __m256i* edge_list, const uint64_t* edge_info, const uint64_t index, uint64_t* destination, __m256d* messages)
+{
+#ifdef EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    // compact vectors hold eight 32-bit source IDs, with the destination and a mask of valid lanes kept alongside
+    const uint64_t info = edge_info[index];
+    const __m256i edgevec = _mm256_load_si256(&edge_list[index]);
+    const __m256i lane_bits = _mm256_set_epi64x(8ll, 4ll, 2ll, 1ll);
+    const __m256i lane_mask = _mm256_set1_epi64x((long long)(info >> GRAPH_EDGE_INFO_LANE_MASK_SHIFT));
+
+    *destination = info & GRAPH_EDGE_INFO_VERTEX_MASK;
+
+    __m256d messages_lo, messages_hi;
+    const int any_lo = gas_pull_messages<P>(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(edgevec)), _mm256_cmpeq_epi64(_mm256_and_si256(lane_mask, lane_bits), lane_bits), &messages_lo);
+    const int any_hi = gas_pull_messages<P>(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(edgevec, 1)), _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_srli_epi64(lane_mask, 4), lane_bits), lane_bits), &messages_hi);
+
+    *messages = P::reduce(messages_lo, messages_hi);
+    return (any_lo | any_hi);
+#else
+    const uint64_t* edge = (const uint64_t*)&edge_list[index];
+    const __m256i edgevec = _mm256_load_si256(&edge_list[index]);
+
+    *destination = gas_decode_shared_vertex(edge);
+    return gas_pull_messages<P>(_mm256_and_si256(edgevec, _mm256_set1_epi64x((long long)GAS_EDGE_VECTOR_VERTEX_MASK)), edgevec, messages);
+#endif
+}
+
+
+/* -------- PHASE CONTROL FUNCTIONS ---------------------------------------- */
+
+// Performs the Edge-Pull phase for the specified program. See "phases.h" for documentation of the parameters.
+// Each thread keeps a partial accumulator for the current destination and writes it out when the destination changes.
+// With scheduler awareness, the first and last destinations of each unit of work may be shared with other units, so the final partial accumulator goes to the merge buffer.
+template <typename P> static inline void gas_edge_pull_phase(const __m256i* edge_list, const uint64_t edge_list_count)
+{
+    const uint32_t group = threads_get_thread_group_id();
+    const uint64_t num_units = sched_pull_units_per_node;
+    double* const vaccum = graph_vertex_accumulators;
+
+#ifdef EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    const uint64_t* const edge_info = graph_edges_gather_list_block_info_numa[group];
+#else
+    const uint64_t* const edge_info = NULL;
+#endif
+
+#ifndef EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+    mergeaccum_t* const merge_buffer = graph_vertex_merge_buffer_baseptr_numa[group];
+#endif
+
+    double accum_total = 0.0;
+
+    gas_scheduler_phase_init();
+
+    for (int64_t unit = gas_scheduler_get_first_assigned_unit(); unit >= 0; unit = gas_scheduler_get_next_assigned_unit(num_units))
+    {
+        uint64_t first, last;
+        gas_scheduler_assign_work_for_unit((uint64_t)unit, num_units, edge_list_count, &first, &last);
+        if (first >= last)
+            continue;
+
+#ifndef EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+        // initialize the previous destination to the first one in this unit, so that nothing is written for it until it changes
+#ifdef EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+        uint64_t prev_destination = edge_info[first] & GRAPH_EDGE_INFO_VERTEX_MASK;
+#else
+        uint64_t prev_destination = gas_decode_shared_vertex((const uint64_t*)&edge_list[first]);
+#endif
+        __m256d accum = P::identity();
+
+        merge_buffer[unit].initial_vertex_id = prev_destination;
+#endif
+
+        for (uint64_t i = first; i < last; ++i)
+        {
+#ifndef EXPERIMENT_WITHOUT_PREFETCH
+            _mm_prefetch((const char*)&edge_list[i] + 256, _MM_HINT_NTA);
+#endif
+
+            uint64_t destination;
+            __m256d messages;
+            const int any_messages = gas_pull_vector<P>(edge_list, edge_info, i, &destination, &messages);
+
+#ifndef EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+            // write the accumulator once all of the in-edges of its vertex have been seen
+            if (destination != prev_destination)
+            {
+                const double value = gas_horizontal_reduce<P>(accum);
+                vaccum[prev_destination] = value;
+                if (P::uses_accum_total) accum_total += value;
+
+                accum = P::identity();
+                prev_destination = destination;
+            }
+
+            if (any_messages)
+            {
+                accum = P::reduce(accum, messages);
+            }
+#else
+            // without scheduler awareness, every edge vector updates the accumulator directly
+            if (any_messages)
+            {
+                const double value = gas_horizontal_reduce<P>(messages);
+#ifdef EXPERIMENT_EDGE_PULL_WITHOUT_SYNC
+                gas_reduce_into<P, false>(&vaccum[destination], value);
+#else
+                gas_reduce_into<P, true>(&vaccum[destination], value);
+#endif
+                if (P::uses_accum_total) accum_total += value;
+            }
+#endif
+        }
+
+#ifndef EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+        // the last destination might continue into the next unit of work, so its partial accumulator goes to the merge buffer
+        const double value = gas_horizontal_reduce<P>(accum);
+        if (P::uses_accum_total) accum_total += value;
+
+        merge_buffer[unit].final_vertex_id = prev_destination;
+        merge_buffer[unit].final_partial_value = value;
+#endif
+    }
+
+    if (P::uses_accum_total)
+    {
+        // a thread stealing work adds to the part it produced from its own group's work
+        if (threads_get_local_thread_id() & SCHED_STEAL_LOCAL_ID_FLAG)
+            gas_buffers_t<P>::accum_total[threads_get_global_thread_id()] += accum_total;
+        else
+            gas_buffers_t<P>::accum_total[threads_get_global_thread_id()] = accum_total;
+    }
+}
+
+// Performs the Edge-Push phase for the specified program. See "phases.h" for documentation of the parameters.
+// Each edge vector holds up to four out-edges of a single source, whose message is combined into the accumulator of each destination.
+// With a frontier, inactive sources are skipped using the HasInfo frontier and the vertex index, as in the hand-written phases.
+template <typename P> static inline void gas_edge_push_phase(const __m256i* edge_list, const uint64_t edge_list_count)
+{
+    const uint32_t group = threads_get_thread_group_id();
+    const uint64_t num_units = (uint64_t)threads_get_threads_per_group() << SCHED_PUSH_UNITS_PER_THREAD_LOG2;
+    double* const vaccum = graph_vertex_accumulators;
+    const double* const vprop = graph_vertex_props;
+
+    const uint64_t* const frontier = graph_frontier_has_info;
+    const uint64_t* const vertex_index = graph_vertex_scatter_index_numa[group];
+    const uint64_t frontier_count = ((graph_vertex_scatter_index_end_numa[group] + 1ull) >> 6) + 1ull;
+
+    double accum_total = 0.0;
+
+    // index of the next edge vector whose source is known to be active, which might lie beyond the current unit of work
+    uint64_t next_active = 0ull;
+
+    gas_scheduler_phase_init();
+
+    for (int64_t unit = gas_scheduler_get_first_assigned_unit(); unit >= 0 && GAS_FRONTIER_SEARCH_END != next_active; unit = gas_scheduler_get_next_assigned_unit(num_units))
+    {
+        uint64_t first, last;
+        gas_scheduler_assign_work_for_unit((uint64_t)unit, num_units, edge_list_count, &first, &last);
+
+        for (uint64_t i = ((next_active > first) ? next_active : first); i < last; ++i)
+        {
+#ifndef EXPERIMENT_WITHOUT_PREFETCH
+            _mm_prefetch((const char*)&edge_list[i] + 256, _MM_HINT_NTA);
+#endif
+
+            const uint64_t* edge = (const uint64_t*)&edge_list[i];
+            const uint64_t source = gas_decode_shared_vertex(edge);
+
+            if (GAS_FRONTIER_ACTIVE == P::frontier && !(frontier[source >> 6] & (1ull << (source & 63ull))))
+            {
+#ifndef EXPERIMENT_FRONTIERS_NOSTRONG_PUSH
+                // strong frontier check: skip ahead to the first edge vector of the next active source
+                next_active = gas_frontier_search(frontier, frontier_count, vertex_index, source);
+                if (GAS_FRONTIER_SEARCH_END == next_active)
+                    break;
+
+                i = next_active - 1ull;
+#endif
+                continue;
+            }
+
+            const double message = _mm_cvtsd_f64(_mm256_castpd256_pd128(P::gather(_mm256_broadcast_sd(&vprop[source]))));
+
+            for (uint32_t lane = 0; lane < GRAPH_EDGE_VECTOR_LANES; ++lane)
+            {
+                if (edge[lane] & 0x8000000000000000ull)
+                {
+#ifdef EXPERIMENT_EDGE_PUSH_WITHOUT_SYNC
+                    gas_reduce_into<P, false>(&vaccum[edge[lane] & GAS_EDGE_VECTOR_VERTEX_MASK], message);
+#else
+                    gas_reduce_into<P, true>(&vaccum[edge[lane] & GAS_EDGE_VECTOR_VERTEX_MASK], message);
+#endif
+                    if (P::uses_accum_total) accum_total += message;
+                }
+            }
+        }
+    }
+
+    if (P::uses_accum_total)
+    {
+        // a thread stealing work adds to the part it produced from its own group's work
+        if (threads_get_local_thread_id() & SCHED_STEAL_LOCAL_ID_FLAG)
+            gas_buffers_t<P>::accum_total[threads_get_global_thread_id()] += accum_total;
+        else
+            gas_buffers_t<P>::accum_total[threads_get_global_thread_id()] = accum_total;
+    }
+}
+
+// Performs the Vertex phase for the specified program. See "phases.h" for documentation of the parameters, of which the last points to a gas_vertex_params_t.
+// Vertices are processed eight at a time, so that each group of eight updates exactly one byte of the HasInfo frontier.
+template <typename P> static inline void gas_vertex_phase(const uint64_t vertex_start, const uint64_t vertex_count, const gas_vertex_params_t* params)
+{
+    const uint64_t vertex_end = vertex_start + vertex_count;
+    const uint64_t num_steps = (vertex_count >> 3) + ((vertex_count & 7ull) ? 1ull : 0ull);
+
+    // assign a contiguous range of steps to each thread in the group, in the same way as the hand-written phases
+    const uint64_t threads_per_group = threads_get_threads_per_group();
+    const uint64_t local_thread_id = threads_get_local_thread_id();
+    const uint64_t assignment = num_steps / threads_per_group;
+    const uint64_t remainder = num_steps % threads_per_group;
+    const uint64_t first = (assignment * local_thread_id) + ((local_thread_id < remainder) ? local_thread_id : remainder);
+    const uint64_t last = first + assignment + ((local_thread_id < remainder) ? 1ull : 0ull);
+
+    double* const vprop = graph_vertex_props;
+    double* const vaccum = graph_vertex_accumulators;
+    const double* const outdeg = graph_vertex_outdegrees;
+    uint8_t* const frontier = (uint8_t*)graph_frontier_has_info;
+
+    const gas_globals_t globals = params->globals;
+    const __m256i end = _mm256_set1_epi64x((long long)vertex_end);
+    const __m256i lane_offsets = _mm256_set_epi64x(3ll, 2ll, 1ll, 0ll);
+
+    __m256d residual = _mm256_setzero_pd();
+    __m256d vote_outdeg = _mm256_setzero_pd();
+    uint64_t vote_count = 0ull;
+
+    for (uint64_t step = first; step < last; ++step)
+    {
+        const uint64_t base = vertex_start + (step << 3);
+        uint32_t frontier_bits = 0;
+
+        for (uint64_t half = 0; half < 2ull; ++half)
+        {
+            const uint64_t v = base + (half << 2);
+
+            const __m256d accum = _mm256_load_pd(&vaccum[v]);
+            const __m256d prop = _mm256_load_pd(&vprop[v]);
+            const __m256d deg = _mm256_load_pd(&outdeg[v]);
+            const __m256d new_prop = P::apply(accum, prop, deg, globals);
+
+            _mm256_store_pd(&vprop[v], new_prop);
+            if (params->reset_accumulators)
+            {
+                _mm256_store_pd(&vaccum[v], P::identity());
+            }
+
+            // lanes past the end of this group's vertices hold padding and must not count towards anything
+            const __m256d lane_valid = _mm256_castsi256_pd(_mm256_cmpgt_epi64(end, _mm256_add_epi64(_mm256_set1_epi64x((long long)v), lane_offsets)));
+
+            if (NULL != params->residual_buffer)
+            {
+                residual = _mm256_add_pd(residual, _mm256_and_pd(P::residual(new_prop, prop, deg, globals), lane_valid));
+            }
+
+            if (GAS_FRONTIER_ACTIVE == P::frontier)
+            {
+                const __m256d active = _mm256_and_pd(P::scatter(new_prop, prop), lane_valid);
+                const uint32_t active_bits = (uint32_t)_mm256_movemask_pd(active);
+
+                frontier_bits |= (active_bits << (half << 2));
+                vote_count += (uint64_t)__builtin_popcount(active_bits);
+                vote_outdeg = _mm256_add_pd(vote_outdeg, _mm256_and_pd(deg, active));
+            }
+        }
+
+        if (GAS_FRONTIER_ACTIVE == P::frontier)
+        {
+            frontier[base >> 3] = (uint8_t)frontier_bits;
+        }
+    }
+
+    const uint32_t global_thread_id = threads_get_global_thread_id();
+
+    if (NULL != params->residual_buffer)
+    {
+        params->residual_buffer[global_thread_id] = gas_horizontal_sum(residual);
+    }
+
+    if (GAS_FRONTIER_ACTIVE == P::frontier)
+    {
+        uint64_t vote = 0ull;
+
+#ifndef EXPERIMENT_THRESHOLD_WITHOUT_COUNT
+        vote += vote_count;
+#endif
+#ifndef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+        vote += (uint64_t)gas_horizontal_sum(vote_outdeg);
+#endif
+
+        params->vote_buffer[global_thread_id] = vote;
+    }
+}
+
+
+/* -------- ALGORITHM FUNCTIONS -------------------------------------------- */
+
+// Allocates the per-thread buffers used by the specified program. Only needs to happen once, even if the program runs several times.
+template <typename P> static inline void gas_init()
+{
+    const cmdline_opts_t* cmdline_settings = cmdline_get_current_settings();
+
+    if (NULL != gas_buffers_t<P>::accum_total)
+    {
+        return;
+    }
+
+    gas_buffers_t<P>::size = cmdline_settings->num_threads + (8 - (cmdline_settings->num_threads % 8));
+    gas_buffers_t<P>::accum_total = (double*)numanodes_malloc(sizeof(double) * gas_buffers_t<P>::size, cmdline_settings->numa_nodes[0]);
+    gas_buffers_t<P>::residual = (double*)numanodes_malloc(sizeof(double) * gas_buffers_t<P>::size, cmdline_settings->numa_nodes[0]);
+    gas_buffers_t<P>::vote = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * gas_buffers_t<P>::size, cmdline_settings->numa_nodes[0]);
+
+    for (uint64_t i = 0; i < gas_buffers_t<P>::size; ++i)
+    {
+        gas_buffers_t<P>::accum_total[i] = 0.0;
+        gas_buffers_t<P>::residual[i] = 0.0;
+        gas_buffers_t<P>::vote[i] = 0ull;
+    }
+}
+
+// Frees the per-thread buffers used by the specified program.
+template <typename P> static inline void gas_cleanup()
+{
+    if (NULL != gas_buffers_t<P>::accum_total)
+    {
+        numanodes_free((void*)gas_buffers_t<P>::accum_total, sizeof(double) * gas_buffers_t<P>::size);
+        numanodes_free((void*)gas_buffers_t<P>::residual, sizeof(double) * gas_buffers_t<P>::size);
+        numanodes_free((void*)gas_buffers_t<P>::vote, sizeof(uint64_t) * gas_buffers_t<P>::size);
+        gas_buffers_t<P>::accum_total = NULL;
+        gas_buffers_t<P>::residual = NULL;
+        gas_buffers_t<P>::vote = NULL;
+    }
+}
+
+// Produces the initial value of every accumulator, which is the identity of the specified program.
+template <typename P> static inline double gas_initialize_vertex_accum(const uint64_t id)
+{
+    return _mm_cvtsd_f64(_mm256_castpd256_pd128(P::identity()));
+}
+
+// Sequences the phases of the specified program. Executed by every worker thread.
+// The phase control functions must already point at the ones generated for this program.
+template <typename P> static inline void gas_impl()
+{
+    uint64_t num_iterations_used_gather = 0ull;
+    uint64_t num_iterations_used_scatter = 0ull;
+
+    uint64_t ctr = 0ull;
+
+    // programs without a frontier run a fixed number of iterations, or until the residual falls below the tolerance, in which case the number of iterations is a limit
+    const double tolerance = ((GAS_FRONTIER_ALL == P::frontier) ? cmdline_get_current_settings()->tolerance : 0.0);
+    const uint64_t num_iterations = ((GAS_FRONTIER_ALL == P::frontier) ? (uint64_t)cmdline_get_current_settings()->num_iterations : ~0ull);
+    double residual = -1.0;
+
+    // programs with a frontier select an engine using the number of active vertices and their outdegrees, all vertices being active initially
+    uint64_t converge_vote = 0ull;
+
+#ifndef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+    converge_vote += graph_num_edges;
+#endif
+#ifndef EXPERIMENT_THRESHOLD_WITHOUT_COUNT
+    converge_vote += graph_num_vertices;
+#endif
+
+    gas_vertex_params_t vertex_phase_params;
+    vertex_phase_params.globals.num_vertices = (double)graph_num_vertices;
+    vertex_phase_params.globals.accum_total = 0.0;
+    vertex_phase_params.residual_buffer = ((0.0 < tolerance) ? gas_buffers_t<P>::residual : NULL);
+    vertex_phase_params.vote_buffer = gas_buffers_t<P>::vote;
+
+    while (ctr < num_iterations)
+    {
+        ctr += 1ull;
+
+#if defined(EXPERIMENT_EDGE_FORCE_PULL)
+        const uint8_t use_gather_for_processing = 1;
+#elif defined(EXPERIMENT_EDGE_FORCE_PUSH)
+        const uint8_t use_gather_for_processing = 0;
+#else
+#ifdef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+        const uint64_t engine_threshold = (graph_num_vertices / 2ull);
+#else
+        const uint64_t engine_threshold = (graph_num_edges / 5ull);
+#endif
+        const uint8_t use_gather_for_processing = ((GAS_FRONTIER_ALL == P::frontier) || engineselect_use_pull(converge_vote, engine_threshold));
+#endif
+
+        /* Edge Phase */
+
+        // only programs with a frontier choose between engines, so only they calibrate the adaptive engine selection
+        if (GAS_FRONTIER_ACTIVE == P::frontier)
+        {
+            engineselect_edge_phase_start();
+        }
+
+        if (use_gather_for_processing)
+        {
+            num_iterations_used_gather += 1ull;
+
+            perform_edge_pull_phase(graph_edges_gather_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_gather_list_block_counts_numa[threads_get_thread_group_id()][0]);
+            scheduler_steal_edge_pull_work(NULL);
+            threads_barrier();
+
+#ifndef EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+            // first thread performs the actual merge operation between potentially-overlapping accumulators
+            if (0 == threads_get_global_thread_id())
+            {
+                edge_pull_op_merge_with_merge_buffer(graph_vertex_merge_buffer, sched_pull_units_total, graph_vertex_accumulators);
+            }
+
+            threads_merge_barrier();
+
+            // the Edge-Pull phase overwrites every accumulator that receives anything, and the rest still hold the identity
+            vertex_phase_params.reset_accumulators = 0ull;
+#else
+            vertex_phase_params.reset_accumulators = 1ull;
+#endif
+        }
+        else
+        {
+            num_iterations_used_scatter += 1ull;
+
+            if (GAS_FRONTIER_ACTIVE == P::frontier)
+            {
+                edge_push_op_build_frontier_queue(graph_frontier_has_info);
+            }
+
+            perform_edge_push_phase(graph_edges_scatter_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_scatter_list_block_counts_numa[threads_get_thread_group_id()][0]);
+            scheduler_steal_edge_push_work(NULL);
+            threads_barrier();
+
+            // the Edge-Push phase combines messages into the existing accumulators, so they must start at the identity every time
+            vertex_phase_params.reset_accumulators = 1ull;
+        }
+
+        if (GAS_FRONTIER_ACTIVE == P::frontier)
+        {
+            engineselect_edge_phase_end(use_gather_for_processing, converge_vote);
+        }
+
+        if (P::uses_accum_total)
+        {
+            double accum_total = 0.0;
+
+            for (uint32_t i = 0; i < threads_get_total_threads(); ++i)
+            {
+                accum_total += gas_buffers_t<P>::accum_total[i];
+            }
+
+            vertex_phase_params.globals.accum_total = accum_total;
+        }
+
+        /* Vertex Phase */
+
+        perform_vertex_phase(graph_vertex_first_numa[threads_get_thread_group_id()], graph_vertex_count_numa[threads_get_thread_group_id()], (const uint64_t*)&vertex_phase_params);
+        threads_barrier();
+
+        /* Termination Check */
+
+        // every thread combines the same per-thread values, so they all agree on whether to stop
+        if (GAS_FRONTIER_ACTIVE == P::frontier)
+        {
+            converge_vote = phase_op_combine_global_var_from_buf(gas_buffers_t<P>::vote);
+            if (0ull == converge_vote)
+                break;
+        }
+
+        if (0.0 < tolerance)
+        {
+            residual = 0.0;
+
+            for (uint32_t i = 0; i < threads_get_total_threads(); ++i)
+            {
+                residual += gas_buffers_t<P>::residual[i];
+            }
+
+            if (residual < tolerance)
+                break;
+        }
+    }
+
+    // algorithm complete, record the number of iterations run of each type
+    if (0 == threads_get_global_thread_id())
+    {
+        total_iterations_executed = ctr;
+        total_iterations_used_gather = num_iterations_used_gather;
+        total_iterations_used_scatter = num_iterations_used_scatter;
+        total_residual = residual;
+    }
+}
+
+
+#endif //__GRAZELLE_GAS_H
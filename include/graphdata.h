@@ -32,10 +32,21 @@ extern uint64_t graph_num_vertices;
 // Number of edges in the graph
 extern uint64_t graph_num_edges;
 
+// Original ID of each vertex in the input graph, or NULL if vertices were not renumbered
+extern uint64_t* graph_vertex_original_ids;
+
+// New ID of each vertex after reordering at ingress, indexed by the ID it would otherwise have had, or NULL if vertices were not reordered
+extern uint64_t* graph_vertex_reordered_ids;
+
+// ID each vertex would have had without reordering at ingress, which is also its position in the output, indexed by its new ID, or NULL if vertices were not reordered
+extern uint64_t* graph_vertex_output_positions;
+
 // Collection of vertex ranks
+// Algorithms that use single precision store these as floats, so graph_data_get_vertex_prop() should be used to read them.
 extern double* graph_vertex_props;
 
 // Collection of vertex accumulators, used between the gather and combine phases
+// Like vertex properties, these are floats for algorithms that use single precision.
 extern double* graph_vertex_accumulators;
 
 // Collection of vertex outdegrees
@@ -47,6 +58,24 @@ extern uint64_t* graph_frontier_has_info;
 // Graph frontier for "wants_info", one bit per vertex.
 extern uint64_t* graph_frontier_wants_info;
 
+// Summary of the "wants_info" frontier, one bit per block of 512 vertices, which is set if any vertex in the block might be in the frontier.
+extern uint64_t* graph_frontier_wants_info_summary;
+
+// Vertices in the "has_info" frontier in ascending order, compacted from the bitmask before each Edge-Push phase when few enough to fit.
+extern uint64_t* graph_frontier_queue;
+
+// Number of vertices in the frontier queue, or GRAPH_FRONTIER_QUEUE_NONE if it does not currently hold the frontier.
+extern uint64_t graph_frontier_queue_count;
+
+// Maximum number of vertices the frontier queue can hold.
+extern uint64_t graph_frontier_queue_capacity;
+
+// Number of frontier vertices found by each thread while building the frontier queue, one entry per thread.
+extern uint64_t* graph_frontier_queue_thread_counts;
+
+// Search state of each vertex, GRAPH_SEARCH_STATE_WORDS words per vertex, or NULL if no algorithm to run needs it.
+extern uint64_t* graph_vertex_search_state;
+
 // Number of vectors in the edge gather list
 extern uint64_t graph_edges_gather_list_vector_count;
 
@@ -65,6 +94,15 @@ extern __m256i*** graph_edges_gather_list_block_bufs_numa;
 // Edge scatter list block buffer pointers, NUMA-aware
 extern __m256i*** graph_edges_scatter_list_block_bufs_numa;
 
+// Shared vertex and mask of valid lanes for each vector in the edge gather list, NUMA-aware, or NULL if the list does not use the compact encoding
+extern uint64_t** graph_edges_gather_list_block_info_numa;
+
+// Weight of each edge in the edge gather list, one double per lane of each vector, NUMA-aware, or NULL if edge weights were not loaded
+extern double** graph_edges_gather_list_block_weights_numa;
+
+// Weight of each edge in the edge scatter list, one double per lane of each vector, NUMA-aware, or NULL if edge weights were not loaded
+extern double** graph_edges_scatter_list_block_weights_numa;
+
 // Record count for each block in the edge gather list, NUMA-aware
 extern uint64_t** graph_edges_gather_list_block_counts_numa;
 
@@ -117,8 +155,21 @@ extern uint64_t* graph_stat_num_edges_per_iteration;
 /* -------- FUNCTIONS ------------------------------------------------------ */
 
 // Reads graph data from a properly-formatted file and fills in the graph data structures.
+// Edge lists may be binary, compressed, or text, and if neither the gather nor the scatter file exists, the single named file is used for both.
+// Vertices are reordered before the edge lists are built using the specified method, one of the GRAPH_REORDER_* constants.
+// If edge weights are requested, they are taken from the third column of a text file or from a weights file alongside a binary file, and edges without a weight get unit weight.
+// File names are required.
+void graph_data_read_from_file(const char* filename, const char* filename_gather, const char* filename_scatter, const uint32_t reorder_method, const uint32_t with_weights, const uint32_t num_numa_nodes, const uint32_t* numa_nodes);
+
+// Reads fully-built graph data structures from a snapshot file previously written by graph_data_write_snapshot(), skipping ingress.
+// Each NUMA node's part of the graph is read directly into memory on that node, so the number of NUMA nodes must match the snapshot.
+// Edge weights are loaded only if requested, and every edge gets unit weight if the snapshot was written without them.
 // A file name is required.
-void graph_data_read_from_file(const char* filename_gather, const char* filename_scatter, const uint32_t num_numa_nodes, const uint32_t* numa_nodes);
+void graph_data_read_snapshot(const char* filename, const uint32_t with_weights, const uint32_t num_numa_nodes, const uint32_t* numa_nodes);
+
+// Initializes the vertex properties, accumulators, and frontiers of the currently-loaded graph for the selected algorithm.
+// Loading a graph already does this, so this is needed only to run another algorithm on the same graph.
+void graph_data_initialize_vertex_state(const uint32_t* numa_nodes);
 
 // Allocates accumulators for the currently-loaded graph.
 void graph_data_allocate_accumulators(const uint64_t num_threads, const uint32_t num_numa_nodes, const uint32_t* numa_nodes);
@@ -126,6 +177,12 @@ void graph_data_allocate_accumulators(const uint64_t num_threads, const uint32_t
 // Allocates merge buffers for the currently-loaded graph.
 void graph_data_allocate_merge_buffers(const uint64_t num_threads, const uint32_t num_numa_nodes, const uint32_t* numa_nodes);
 
+// Allocates the frontier queue for the currently-loaded graph.
+void graph_data_allocate_frontier_queue(const uint64_t num_threads, const uint32_t* numa_nodes);
+
+// Allocates the search state for the currently-loaded graph, which algorithms that run several searches at once use and initialize themselves.
+void graph_data_allocate_search_state(const uint32_t num_numa_nodes, const uint32_t* numa_nodes);
+
 // Allocates all statistics arrays.
 // Useful only if running an experiment that collects statistics.
 void graph_data_allocate_stats(const uint64_t num_threads, const uint32_t numa_node);
@@ -134,9 +191,39 @@ void graph_data_allocate_stats(const uint64_t num_threads, const uint32_t numa_n
 // A file name is required.
 void graph_data_write_to_file(const char* filename);
 
-// Writes vertex ranks to a text file.
+// Writes the currently-loaded graph data structures, as partitioned across NUMA nodes, to a binary snapshot file.
+// A file name is required. This file will be overwritten if it exists.
+void graph_data_write_snapshot(const char* filename);
+
+// Writes the currently-loaded edge lists to compressed edge list files, which graph_data_read_from_file() accepts in place of binary edge list files.
+// The out-edge list file is written only if the out-edge list is present. File names are required. These files will be overwritten if they exist.
+void graph_data_write_compressed_edge_lists(const char* filename_gather, const char* filename_scatter);
+
+// Writes the output of the application for each vertex to a file, in parallel using the specified threads and NUMA nodes.
+// Text output has one line per vertex, and binary output is an array with one value per vertex: a double for PageRank and Shortest Paths, or a vertex ID for other applications.
+// Applications that run several searches at once instead produce three integers per vertex, taken from the search totals in `graph_vertex_search_state`.
+// Either way, vertices appear in the order they would have had if they had not been reordered at ingress.
 // A file name is required. This file will be overwritten if it exists.
-void graph_data_write_ranks_to_file(const char* filename);
+void graph_data_write_ranks_to_file(const char* filename, const uint32_t binary, const uint64_t num_threads, const uint32_t num_numa_nodes, const uint32_t* numa_nodes);
+
+// Writes the depth of each vertex in the search tree produced by the selected algorithm, which must output the parent of each vertex, to a file in the same way as graph_data_write_ranks_to_file().
+// Depths count edges from the vertex identified by `execution_search_root`, and unreachable vertices have depth -1, which is written as all bits set in binary output.
+// A file name is required. This file will be overwritten if it exists.
+void graph_data_write_depths_to_file(const char* filename, const uint32_t binary, const uint64_t num_threads, const uint32_t num_numa_nodes, const uint32_t* numa_nodes);
+
+// Looks up a vertex by its ID in the input graph and returns its ID as numbered internally, or the number of vertices if the input graph has no such vertex.
+uint64_t graph_data_find_vertex(const uint64_t original_id);
+
+// Retrieves the property of the specified vertex, converted to double precision if the selected algorithm stores it in single precision.
+double graph_data_get_vertex_prop(const uint64_t vertex);
+
+// Returns the granularity at which a vertex array with the specified number of bits per vertex is divided among NUMA nodes, for use with numanodes_malloc_divisible().
+// This is the largest power of two that divides the offset, in bytes, of each NUMA node's part, or 0 if there is only one NUMA node.
+uint64_t graph_data_vertex_array_granularity(const uint64_t bits_per_vertex);
+
+// Prints the kind of pages that back each of the large graph data structures on each NUMA node.
+// Also reports any structures divided among NUMA nodes that cannot use the requested explicit huge pages, and any parts of structures that could not be placed on their NUMA nodes.
+void graph_data_print_pages();
 
 // Clears out the current graph.
 void graph_data_clear();
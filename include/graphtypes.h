@@ -21,6 +21,75 @@
 #include <stdint.h>
 
 
+/* -------- CONSTANTS ------------------------------------------------------ */
+
+// Identifies a file as a graph snapshot; spells "GRZSNAPS" when read as bytes
+#define GRAPH_SNAPSHOT_MAGIC                    0x5350414e535a5247ull
+
+// Snapshot format version, incremented whenever the layout of a snapshot file changes
+#define GRAPH_SNAPSHOT_VERSION                  6ull
+
+// Alignment, in bytes, of each bulk part of a snapshot file (edge vectors and vertex indices), so that it can be read with direct I/O
+#define GRAPH_SNAPSHOT_ALIGNMENT                4096ull
+
+// Size, in bytes, of each read issued when loading the bulk parts of a snapshot file, a multiple of GRAPH_SNAPSHOT_ALIGNMENT
+#define GRAPH_SNAPSHOT_READ_CHUNK_BYTES         (16ull << 20)
+
+// Methods for reordering vertices at ingress: none, descending out-degree, descending out-degree for hubs only (vertices with more out-edges than average), and Reverse Cuthill-McKee
+#define GRAPH_REORDER_NONE                      0
+#define GRAPH_REORDER_DEGREE                    1
+#define GRAPH_REORDER_HUB                       2
+#define GRAPH_REORDER_RCM                       3
+
+// Number of vertex IDs held by each edge vector, as 48-bit IDs in the standard encoding or as 32-bit IDs in the compact encoding
+#define GRAPH_EDGE_VECTOR_LANES                 4ull
+#define GRAPH_EDGE_VECTOR_COMPACT_LANES         8ull
+
+// Number of vertex IDs held by each vector of the in-edge list, which uses the compact encoding if the corresponding experiment is enabled
+#ifdef EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+#ifdef EXPERIMENT_WITHOUT_VECTORS
+#error "Compact edge vectors require the vectorized engine implementations."
+#endif
+#define GRAPH_GATHER_LIST_LANES                 GRAPH_EDGE_VECTOR_COMPACT_LANES
+#else
+#define GRAPH_GATHER_LIST_LANES                 GRAPH_EDGE_VECTOR_LANES
+#endif
+
+// Log2 of the number of vertices per entry in the frontier queue, which limits the size of the frontiers it can hold
+// Frontiers with more vertices than the queue can hold are searched directly in the bitmask instead
+#define GRAPH_FRONTIER_QUEUE_CAPACITY_SHIFT     4ull
+
+// Value of the frontier queue count when the queue does not hold the current frontier
+#define GRAPH_FRONTIER_QUEUE_NONE               0xffffffffffffffffull
+
+// Log2 of the number of frontier elements summarized by each bit of a frontier summary, which is 8 elements or 512 vertices
+// This matches the alignment of the boundaries between NUMA nodes, so no summary bit covers vertices on more than one node
+#define GRAPH_FRONTIER_SUMMARY_ELEMENTS_SHIFT   3ull
+
+// Number of 64-bit words of search state kept for each vertex by algorithms that run several searches at once
+// In order, these hold the searches that have reached the vertex in the current batch, one bit per search, then totals over all searches run so far: how many reached the vertex, the sum of their distances to it, and the largest of those distances
+#define GRAPH_SEARCH_STATE_WORDS                4ull
+
+// Layout of the information stored alongside each compact edge vector: the shared vertex ID in the lower 48 bits and a mask of valid lanes in the upper 8 bits
+#define GRAPH_EDGE_INFO_VERTEX_MASK             0x0000ffffffffffffull
+#define GRAPH_EDGE_INFO_LANE_MASK_SHIFT         56ull
+
+// Suffix appended to the name of a binary edge list file to form the name of the file holding its edge weights, one double per edge in the same order
+#define GRAPH_EDGE_WEIGHTS_SUFFIX               "-weights"
+
+// Identifies a file as a compressed edge list; spells "GRZCEDGE" when read as bytes
+#define GRAPH_COMPRESSED_MAGIC                  0x45474445435a5247ull
+
+// Number of edges in each independently-decodable chunk of a compressed edge list
+#define GRAPH_COMPRESSED_CHUNK_EDGES            (1ull << 16)
+
+// Maximum number of edges sorted in memory at once when ingesting an edge list file whose edges are not in the required order
+// Larger inputs are sorted externally, in runs of this many edges spilled to local disk; each run needs 32 bytes of memory per edge
+#ifndef GRAPH_INGRESS_SORT_RUN_EDGES
+#define GRAPH_INGRESS_SORT_RUN_EDGES            (1ull << 27)
+#endif
+
+
 /* -------- TYPE DEFINITIONS ----------------------------------------------- */
 
 // Defines the type of an element in the merge buffers, which are used to merge overlapped vertex updates to a collapsed accumulator
@@ -33,5 +102,45 @@ typedef struct mergeaccum_t
     uint64_t __padding__;                                   // nothing, just pads the size of each entry to be 32 bytes
 } mergeaccum_t;
 
+// Defines the header at the start of a graph snapshot file, which holds fully-built and NUMA-partitioned graph data structures
+typedef struct graphsnapshot_t
+{
+    uint64_t magic;                                         // must be GRAPH_SNAPSHOT_MAGIC
+    uint64_t version;                                       // must be GRAPH_SNAPSHOT_VERSION
+    uint64_t num_numa_nodes;                                // number of NUMA nodes across which the graph is partitioned
+    uint64_t num_vertices;                                  // number of vertices in the graph
+    uint64_t num_edges;                                     // number of edges in the graph
+    uint64_t gather_list_vector_count;                      // number of vectors in the edge gather list
+    uint64_t gather_list_num_blocks;                        // number of blocks in the edge gather list
+    uint64_t scatter_list_vector_count;                     // number of vectors in the edge scatter list, 0 if not present
+    uint64_t scatter_list_num_blocks;                       // number of blocks in the edge scatter list, 0 if not present
+    uint64_t has_original_ids;                              // 1 if the original ID of each vertex follows the edge lists, 0 if vertices were not renumbered
+    uint64_t has_reordered_ids;                             // 1 if the new ID of each vertex after reordering follows the original IDs, 0 if vertices were not reordered
+    uint64_t gather_list_lanes;                             // number of vertex IDs in each vector of the edge gather list, which is followed by per-vector information if compact
+    uint64_t has_edge_weights;                              // 1 if each edge list's vectors are followed by the weight of each lane, 0 if the graph was loaded without weights
+} graphsnapshot_t;
+
+// Defines a bulk part of a graph snapshot file that is to be read directly into memory owned by a particular NUMA node
+typedef struct graphsnapshotread_t
+{
+    void* buf;                                              // destination buffer, allocated on the NUMA node that owns it
+    uint64_t offset;                                        // position in the file of the first byte, a multiple of GRAPH_SNAPSHOT_ALIGNMENT
+    uint64_t size;                                          // number of bytes to read
+    uint32_t group_id;                                      // index of the owning NUMA node in the list of NUMA nodes in use
+} graphsnapshotread_t;
+
+// Defines the header at the start of a compressed edge list file, followed by (num_chunks + 1) file offsets marking where each chunk starts and the last one ends
+// Each chunk is a sequence of groups of edges sharing a key vertex, and each group is a sequence of varints:
+// key vertex delta from the previous group in the chunk, number of edges, then each other vertex as a zigzag delta from the previous one in the group
+typedef struct graphcompressed_t
+{
+    uint64_t magic;                                         // must be GRAPH_COMPRESSED_MAGIC
+    uint64_t num_vertices;                                  // number of vertices in the graph
+    uint64_t num_edges;                                     // number of edges in the file
+    uint64_t key_offset;                                    // position within each edge of the key vertex, 0 (source) or 1 (destination)
+    uint64_t chunk_edges;                                   // number of edges in each chunk except possibly the last
+    uint64_t num_chunks;                                    // number of chunks
+} graphcompressed_t;
+
 
 #endif //__GRAZELLE_GRAPHTYPES_H
@@ -21,6 +21,23 @@
 #include <stdint.h>
 
 
+/* -------- CONSTANTS ------------------------------------------------------ */
+
+// Kinds of pages that can be requested for large allocations.
+// Explicit huge pages come from the pools the administrator reserves per NUMA node, and each kind falls back to the next-smaller one if the pool on the node is exhausted.
+#define NUMANODES_PAGES_SMALL                   0       // regular pages only, transparent huge pages disabled
+#define NUMANODES_PAGES_TRANSPARENT             1       // transparent huge pages, whenever the kernel can provide them
+#define NUMANODES_PAGES_HUGE_2M                 2       // explicit 2 MiB huge pages
+#define NUMANODES_PAGES_HUGE_1G                 3       // explicit 1 GiB huge pages
+
+// Sizes of explicit huge pages.
+#define NUMANODES_HUGE_PAGE_SIZE_2M             (2ull << 20ull)
+#define NUMANODES_HUGE_PAGE_SIZE_1G             (1ull << 30ull)
+
+// Maximum number of allocations that can be backed by explicit huge pages at once; any more use transparent huge pages instead.
+#define NUMANODES_MAX_HUGETLB_ALLOCATIONS       256
+
+
 /* -------- FUNCTIONS ------------------------------------------------------ */
 
 // Initializes the NUMA awareness subsystem.
@@ -44,10 +61,21 @@ uint32_t numanodes_get_num_processors_on_node(uint32_t node);
 // If an invalid processor or node is specified, the return value is UINT32_MAX.
 uint32_t numanodes_get_nth_processor_on_node(uint32_t n, uint32_t node);
 
+// Returns the relative distance from one NUMA node to another, where the distance from a node to itself is 10.
+// If the distance is not known, nodes are assumed to be 20 away from each other.
+uint32_t numanodes_get_distance(uint32_t node_from, uint32_t node_to);
+
 // Allocates a memory buffer on the specified NUMA node, counting from 0.
+// Large buffers are backed by huge pages according to the current page policy.
 // Returns NULL on failure.
 void* numanodes_malloc(size_t size, uint32_t node);
 
+// Allocates a memory buffer on the specified NUMA node that is later divided among NUMA nodes using numanodes_tonode_buffer().
+// Granularity is a power of two that divides the offset of every boundary between the parts for different nodes, or 0 if the buffer is not divided.
+// Explicit huge pages can only be moved whole, so only those no larger than the granularity are used, and otherwise transparent huge pages are requested unless the page policy is regular pages only.
+// Returns NULL on failure.
+void* numanodes_malloc_divisible(size_t size, uint32_t node, size_t granularity);
+
 // Allocates a memory buffer on the local NUMA node (i.e. whatever node calls this function).
 // Returns NULL on failure.
 void* numanodes_malloc_local(size_t size);
@@ -57,8 +85,23 @@ void numanodes_free(void* mem, size_t size);
 
 // Moves the specified memory buffer to the specified NUMA node.
 // Typically this would be called on all or part of a buffer already allocated using numanodes_malloc.
+// Buffers backed by explicit huge pages are moved at the granularity of a huge page, so a huge page that straddles either end of the specified range stays where it is, unless it is the last huge page of the buffer; use numanodes_malloc_divisible() for buffers divided among nodes.
+// Failures, including such partial moves, are counted rather than reported immediately.
 // Currently this is a no-op on Windows.
 void numanodes_tonode_buffer(void* mem, size_t size, uint32_t node);
 
+// Returns the number of calls to numanodes_tonode_buffer() so far that could not place their entire buffer on the requested NUMA node.
+uint32_t numanodes_get_num_misplaced_buffers();
+
+// Sets the kind of pages that future large allocations should use, one of the NUMANODES_PAGES_* constants.
+// The default is NUMANODES_PAGES_TRANSPARENT.
+void numanodes_set_page_policy(uint32_t policy);
+
+// Returns the size of the explicit huge pages requested by the current page policy, or 0 if it does not request them.
+size_t numanodes_get_huge_page_size();
+
+// Writes a short human-readable description of the pages that actually back the specified buffer, allocated using this subsystem.
+void numanodes_describe_pages(const void* mem, char* description, size_t description_size);
+
 
 #endif //__GRAZELLE_NUMANODES_H
@@ -23,27 +23,16 @@
 #include <stdint.h>
 
 
-/* -------- ALGORITHM SELECTION -------------------------------------------- */
+/* -------- CONSTANTS ------------------------------------------------------ */
 
-#if defined(BREADTH_FIRST_SEARCH)
+// Instruction set used by the phase control functions: selected automatically based on what the processor supports.
+#define PHASES_ISA_AUTO                         0
 
-#define perform_edge_pull_phase                 perform_edge_pull_phase_bfs
-#define perform_edge_push_phase                 perform_edge_push_phase_bfs
-#define perform_vertex_phase                    perform_vertex_phase_bfs
+// Instruction set used by the phase control functions: AVX2, which all supported processors have.
+#define PHASES_ISA_AVX2                         1
 
-#elif defined(CONNECTED_COMPONENTS)
-
-#define perform_edge_pull_phase                 perform_edge_pull_phase_cc
-#define perform_edge_push_phase                 perform_edge_push_phase_cc
-#define perform_vertex_phase                    perform_vertex_phase_cc
-
-#else
-
-#define perform_edge_pull_phase                 perform_edge_pull_phase_pr
-#define perform_edge_push_phase                 perform_edge_push_phase_pr
-#define perform_vertex_phase                    perform_vertex_phase_pr
-
-#endif
+// Instruction set used by the phase control functions: AVX-512, specifically the F, VL, DQ, and CD subsets.
+#define PHASES_ISA_AVX512                       2
 
 
 /* -------- COMMON PHASE OPERATORS ----------------------------------------- */
@@ -56,6 +45,10 @@ void phase_op_reset_global_accum() __WRITTEN_IN_ASSEMBLY__;
 // The buffer is assumed to be a reduce buffer indexed by thread ID.
 void phase_op_write_global_accum_to_buf(uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
 
+// Performs the specified Edge phase, continuing the global variable accumulation from the current thread's value in a reduce buffer and writing the result back.
+// Used to run additional Edge phase work from C code, which does not preserve the global variable accumulator.
+void phase_op_perform_edge_phase_into_buf(void (__WRITTEN_IN_ASSEMBLY__ *edge_phase)(const __m256i* edge_list, const uint64_t edge_list_count), const __m256i* edge_list, const uint64_t edge_list_count, uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+
 // Combines partial values of a global variable, using summation, from the specified reduce buffer.
 // Returns the fully-combined result.
 uint64_t phase_op_combine_global_var_from_buf(uint64_t* reduce_buffer);
@@ -66,24 +59,102 @@ uint64_t phase_op_combine_global_var_from_buf(uint64_t* reduce_buffer);
 // Performs a merge to the accumulators based on all the entries in the merge buffer.
 // Should only be called by a single thread on each NUMA node, but it does not matter which thread.
 // The "count" parameter refers to the "merge_buffer" array; "vertex_accumulators" is indexed based on the contents of "merge_buffer" and is assumed to have enough entries.
+// Accumulators are treated as single-precision if the selected algorithm stores them that way.
 // This function is written in C.
 void edge_pull_op_merge_with_merge_buffer(mergeaccum_t* merge_buffer, uint64_t count, double* vertex_accumulators);
 
+// Rebuilds the specified frontier summary from the specified frontier, setting one bit per block of 512 vertices if any of them is in the frontier.
+// The Edge-Pull phase uses the summary to skip whole blocks when searching for the next destination in the frontier, which is only valid as long as vertices are only removed from the frontier.
+// Must be called by all threads, which each summarize an equal part of the frontier, and returns after a barrier once the summary is ready.
+// This function is written in C.
+void edge_pull_op_build_frontier_summary(const uint64_t* frontier, uint64_t* summary);
+
+
+/* -------- EDGE-PUSH ENGINE OPERATORS ------------------------------------- */
+
+// Compacts the vertices in the specified frontier into the frontier queue, in ascending order, if there are few enough of them to fit.
+// The Edge-Push phase then finds each active vertex by searching the queue rather than the bitmask, so skipping inactive vertices no longer depends on the number of vertices in the graph.
+// Otherwise, or in builds that do not use the queue, marks the queue as not holding the frontier, and the Edge-Push phase searches the bitmask as usual.
+// Must be called by all threads, which each compact an equal part of the frontier, and returns after a barrier once the queue is ready.
+// This function is written in C.
+void edge_push_op_build_frontier_queue(const uint64_t* frontier);
+
 
 /* -------- PHASE CONTROL FUNCTIONS ---------------------------------------- */
 
+// Each phase control function is implemented once per algorithm and supported instruction set, and the versions for each algorithm are otherwise identical.
+// Algorithms written using the Gather-Apply-Scatter interface in "gas.h" have a single version of each, which uses AVX2 and is also used when AVX-512 is selected.
+// Callers use the function pointers below, which phases_select_isa() and phases_select_algorithm() point at the versions to use.
+
 // Performs the Edge-Pull phase.
 // Specify the address and size (measured in 256-bit elements) of the edge vector list.
-void perform_edge_pull_phase(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+extern void (__WRITTEN_IN_ASSEMBLY__ *perform_edge_pull_phase)(const __m256i* edge_list, const uint64_t edge_list_count);
+void perform_edge_pull_phase_pr(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_pr_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_cc(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_cc_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_bfs(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_bfs_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_prf(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_prf_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_sssp(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_sssp_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_msbfs(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_msbfs_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_prg(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_pull_phase_ccg(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
 
 // Performs the Edge-Push phase.
 // Specify the address and size (measured in 256-bit elements) of the edge vector list.
-void perform_edge_push_phase(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+extern void (__WRITTEN_IN_ASSEMBLY__ *perform_edge_push_phase)(const __m256i* edge_list, const uint64_t edge_list_count);
+void perform_edge_push_phase_pr(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_pr_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_cc(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_cc_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_bfs(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_bfs_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_prf(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_prf_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_sssp(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_sssp_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_msbfs(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_msbfs_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_prd(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_prd_avx512(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_prg(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
+void perform_edge_push_phase_ccg(const __m256i* edge_list, const uint64_t edge_list_count) __WRITTEN_IN_ASSEMBLY__;
 
 // Performs the Vertex phase.
 // Specify the range of vertices to process (as a starting vertex ID and count) and the address of the reduce buffer (optional, depends on the algorithm).
 // Reduce buffer is used for global variable propagation from a previous phase and may be NULL if not used.
-void perform_vertex_phase(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
-
+// Single-Source Shortest Paths uses the Connected Components version, since for both the only job of this phase is to clear HasInfo*.
+// Multi-Source BFS instead passes, in place of the reduce buffer, the current search level followed by a mask of the searches in the current batch.
+// PageRank passes the address of the reduce buffer followed by the address of a buffer to receive each thread's part of the residual, or NULL if the residual is not needed.
+// Delta PageRank passes the parameters described in "execution_prd.c" and reuses the PageRank version of the Edge-Pull phase, since inactive vertices send nothing.
+// Algorithms written using the Gather-Apply-Scatter interface pass a gas_vertex_params_t, defined in "gas.h".
+extern void (__WRITTEN_IN_ASSEMBLY__ *perform_vertex_phase)(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer);
+void perform_vertex_phase_pr(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_pr_avx512(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_cc(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_cc_avx512(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_bfs(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_bfs_avx512(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_prf(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_prf_avx512(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_msbfs(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_msbfs_avx512(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_prd(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_prd_avx512(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_prg(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+void perform_vertex_phase_ccg(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) __WRITTEN_IN_ASSEMBLY__;
+
+// Selects the instruction set used by the phase control functions, one of the PHASES_ISA_* constants, and returns the one actually selected.
+// Automatic selection picks AVX-512 if the processor supports it. Requesting an instruction set the processor does not support is an error.
+// Must be called once, before phases_select_algorithm().
+uint32_t phases_select_isa(const uint32_t isa);
+
+// Points the phase control functions at the versions that implement the specified algorithm, one of the EXECUTION_ALGORITHM_* constants, using the selected instruction set.
+// Normally called by execution_select_algorithm() rather than directly.
+void phases_select_algorithm(const uint32_t algorithm);
 
 #endif //__GRAZELLE_PHASES_H
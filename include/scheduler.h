@@ -8,7 +8,8 @@
 * (c) 2015-2018
 *****************************************************************************
 * scheduler.h
-*      Scheduling-related globals. Primarily affects the pull engine.
+*      Scheduling-related globals and work stealing between thread groups.
+*      Primarily affects the pull engine.
 *****************************************************************************/
 
 #ifndef __GRAZELLE_SCHEDULER_H
@@ -18,6 +19,17 @@
 #include <stdint.h>
 
 
+/* -------- CONSTANTS ------------------------------------------------------ */
+
+// Log2(number of units of work to create per thread) for the push engine.
+// Must match the value of the same name in "scheduler_push.inc".
+#define SCHED_PUSH_UNITS_PER_THREAD_LOG2        5
+
+// Flag set in the local thread ID of a thread while it steals work from another group, whose lower bits then hold the unit it reserved.
+// Must match the way "scheduler_pull.inc" and "scheduler_push.inc" test for it.
+#define SCHED_STEAL_LOCAL_ID_FLAG               0x80000000u
+
+
 /* -------- GLOBALS -------------------------------------------------------- */
 
 // Number of units of work to create per node for the pull engine.
@@ -26,5 +38,24 @@ extern uint64_t sched_pull_units_per_node;
 // Number of units of work to create in total for the pull engine.
 extern uint64_t sched_pull_units_total;
 
+// Number of units of work stolen from other groups since this was last reset.
+extern uint64_t sched_units_stolen;
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+
+// Determines the order in which each group steals work from the others, nearest NUMA node first, and how much work must remain in each for stealing from it to be worthwhile.
+// Must be called before any thread steals work, with the same list of NUMA nodes used to spawn threads.
+void scheduler_init_stealing(const uint32_t num_numa_nodes, const uint32_t* numa_nodes);
+
+// Performs units of the current Edge-Pull phase that remain unassigned in other groups, once the calling thread has no more units in its own group.
+// Must be called after the calling thread's own Edge-Pull phase has returned and before the barrier that follows it.
+// If a reduce buffer is specified, the calling thread must already have written its global variable accumulator to it, and stolen units add to that value.
+// Otherwise, the Edge-Pull phase must not use the global variable accumulator.
+void scheduler_steal_edge_pull_work(uint64_t* reduce_buffer);
+
+// Same as above, for the Edge-Push phase.
+void scheduler_steal_edge_push_work(uint64_t* reduce_buffer);
+
 
 #endif //__GRAZELLE_SCHEDULER_H
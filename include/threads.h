@@ -70,6 +70,10 @@ void threads_set_per_thread_variable(uint64_t value) __WRITTEN_IN_ASSEMBLY__;
 // Retrieves the per-thread 64-bit variable. This variable can be used for any purpose.
 uint64_t threads_get_per_thread_variable() __WRITTEN_IN_ASSEMBLY__;
 
+// Changes the current thread's local ID within its group and its logical group number.
+// Used by the scheduler to let a thread work on behalf of another group, after which the original values must be restored.
+void threads_set_local_thread_id_and_group(const uint32_t local_id, const uint32_t group_id) __WRITTEN_IN_ASSEMBLY__;
+
 // Provides a barrier that no thread can pass until all threads have reached this point in the execution.
 void threads_barrier() __WRITTEN_IN_ASSEMBLY__;
 
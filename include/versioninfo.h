@@ -18,13 +18,7 @@
 
 /* -------- CONSTANTS ------------------------------------------------------ */
 
-#if defined (CONNECTED_COMPONENTS)
-#define GRAZELLE_PROGRAM_NAME                   "Grazelle-CC"
-#elif defined (BREADTH_FIRST_SEARCH)
-#define GRAZELLE_PROGRAM_NAME                   "Grazelle-BFS"
-#else
-#define GRAZELLE_PROGRAM_NAME                   "Grazelle-PR"
-#endif
+#define GRAZELLE_PROGRAM_NAME                   "Grazelle"
 #define GRAZELLE_PROGRAM_VERSION                "1.0.1-ppopp18"
 
 
@@ -12,10 +12,15 @@
 *****************************************************************************/
 
 #include "cmdline.h"
+#include "engineselect.h"
+#include "execution.h"
+#include "graphtypes.h"
 #include "numanodes.h"
+#include "phases.h"
 #include "versioninfo.h"
 
 #include <ctype.h>
+#include <float.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -65,14 +70,27 @@ uint32_t cmdline_helper_is_recognized_option(char check)
 {
     switch (check)
     {
+    case 'a':
+    case 'b':
+    case 'c':
+    case 'd':
+    case 'e':
+    case 'E':
     case 'h':
     case 'i':
+    case 'k':
     case 'n':
     case 'N':
     case 'o':
+    case 'p':
+    case 'r':
+    case 'R':
     case 's':
+    case 'S':
+    case 't':
     case 'V':
 	case 'u':
+    case 'w':
 #ifdef GRAZELLE_WINDOWS
     case '?':
 #endif
@@ -89,12 +107,22 @@ uint32_t cmdline_helper_option_requires_value(char check)
 {
     switch (check)
     {
+    case 'a':
+    case 'c':
+    case 'e':
     case 'i':
+    case 'k':
     case 'n':
     case 'N':
 	case 'u':
     case 'o':
+    case 'p':
+    case 'r':
+    case 'R':
     case 's':
+    case 'S':
+    case 't':
+    case 'w':
         return 1;
 
     default:
@@ -182,6 +210,10 @@ void cmdline_helper_print_version_and_exit()
 void cmdline_helper_print_usage_and_exit(char* argv0)
 {
     printf("Usage: %s [options] %ci input-graph\n", argv0, CMDLINE_SWITCH_CHAR);
+    if (cmdline_helper_is_recognized_option('r'))
+    {
+        printf("       %s [options] %cr input-snapshot\n", argv0, CMDLINE_SWITCH_CHAR);
+    }
     if (cmdline_helper_is_recognized_option('h'))
     {
         if (cmdline_helper_is_recognized_option('?'))
@@ -204,11 +236,76 @@ void cmdline_helper_print_usage_and_exit(char* argv0)
     {
         printf("  %ci input-graph\n", CMDLINE_SWITCH_CHAR);
         printf("        Path of the file containing the input graph.\n");
+        printf("        Files with \"-pull\" and \"-push\" appended are read if either exists.\n");
+        printf("        Edge weights are read from a file with \"-weights\" appended, or from a third column of text.\n");
+        printf("        May be repeated to process several graphs one after another.\n");
+    }
+    
+    if (cmdline_helper_is_recognized_option('r'))
+    {
+        printf("  %cr input-snapshot\n", CMDLINE_SWITCH_CHAR);
+        printf("        Path of a graph snapshot to load instead of the input graph.\n");
+        printf("        Must have been written with the same number of NUMA nodes.\n");
     }
     
     printf("\n");
     printf("Options:\n");
     
+    if (cmdline_helper_is_recognized_option('a'))
+    {
+        printf("  %ca algorithm1[,algorithm2[,algorithm3[...]]]\n", CMDLINE_SWITCH_CHAR);
+        printf("        Comma-delimited list of algorithms to run on each graph, one after another.\n");
+        printf("        \"pr\" is PageRank, \"cc\" is Connected Components, and \"bfs\" is Breadth-First Search.\n");
+        printf("        \"prf\" is PageRank with single-precision vertex properties, which halves the bytes gathered per edge.\n");
+        printf("        \"sssp\" is Single-Source Shortest Paths, which uses edge weights if the input graph has them.\n");
+        printf("        \"msbfs\" is Multi-Source BFS, which runs searches from all roots at once and reports per-vertex totals.\n");
+        printf("        \"prd\" is Delta PageRank, which sends only changes in rank and switches to Push as ranks settle.\n");
+        printf("        \"prg\" and \"ccg\" are PageRank and Connected Components written using the Gather-Apply-Scatter interface.\n");
+        printf("        With several algorithms, \"-pr\", \"-cc\", and so on are appended to output file names.\n");
+        printf("        Maximum number of values is %llu.\n", (long long unsigned int)CMDLINE_MAX_NUM_ALGORITHMS);
+        printf("        Defaults to \"%s\".\n", execution_algorithms[CMDLINE_DEFAULT_ALGORITHM]->name);
+    }
+    
+    if (cmdline_helper_is_recognized_option('b'))
+    {
+        printf("  %cb\n", CMDLINE_SWITCH_CHAR);
+        printf("        Write the output file in binary rather than as text.\n");
+        printf("        Contains one double (PageRank, Shortest Paths) or 64-bit vertex ID (others) per vertex.\n");
+    }
+    
+    if (cmdline_helper_is_recognized_option('c'))
+    {
+        printf("  %cc output-graph\n", CMDLINE_SWITCH_CHAR);
+        printf("        Path of compressed edge list files to write once the graph is loaded.\n");
+        printf("        Suffixes are added as for the input graph, and the files can be read back using %ci.\n", CMDLINE_SWITCH_CHAR);
+    }
+    
+    if (cmdline_helper_is_recognized_option('d'))
+    {
+        printf("  %cd\n", CMDLINE_SWITCH_CHAR);
+        printf("        Also write the depth of each vertex in the search tree, for searches that output parents.\n");
+        printf("        Written to the output file with \"-depth\" appended, as text or in binary like the output file.\n");
+        printf("        Unreachable vertices have depth -1. Requires %co.\n", CMDLINE_SWITCH_CHAR);
+    }
+    
+    if (cmdline_helper_is_recognized_option('e'))
+    {
+        printf("  %ce engine-selection\n", CMDLINE_SWITCH_CHAR);
+        printf("        Method for choosing between the Pull and Push engines in each iteration.\n");
+        printf("        Applies to \"cc\", \"bfs\", \"sssp\", \"msbfs\", \"prd\", and \"ccg\".\n");
+        printf("        \"threshold\" uses Pull whenever the frontier is larger than a fixed fraction of the graph.\n");
+        printf("        \"adaptive\" measures the time each engine takes and uses the one predicted to be faster.\n");
+        printf("        Defaults to \"threshold\".\n");
+    }
+    
+    if (cmdline_helper_is_recognized_option('E'))
+    {
+        printf("  %cE\n", CMDLINE_SWITCH_CHAR);
+        printf("        Keep the measurements of adaptive engine selection between runs on the same graph.\n");
+        printf("        Read from and written to the input graph or snapshot file with \"-engine\" appended.\n");
+        printf("        Requires %ce adaptive.\n", CMDLINE_SWITCH_CHAR);
+    }
+    
     if (cmdline_helper_is_recognized_option('h'))
     {
         if (cmdline_helper_is_recognized_option('?'))
@@ -222,6 +319,15 @@ void cmdline_helper_print_usage_and_exit(char* argv0)
         printf("        Prints this information and exits.\n");
     }
     
+    if (cmdline_helper_is_recognized_option('k'))
+    {
+        printf("  %ck kernel-isa\n", CMDLINE_SWITCH_CHAR);
+        printf("        Instruction set to use for the processing kernels.\n");
+        printf("        \"avx2\" works on all supported processors, and \"avx512\" requires AVX-512.\n");
+        printf("        \"auto\" uses AVX-512 if the processor supports it and AVX2 otherwise.\n");
+        printf("        Defaults to \"auto\".\n");
+    }
+    
     if (cmdline_helper_is_recognized_option('n'))
     {
         printf("  %cn num-threads\n", CMDLINE_SWITCH_CHAR);
@@ -236,13 +342,36 @@ void cmdline_helper_print_usage_and_exit(char* argv0)
         printf("  %cN num-iterations\n", CMDLINE_SWITCH_CHAR);
         printf("        Number of iterations of the algorithm to execute.\n");
         printf("        Ignored for algorithms that dynamically converge.\n");
-        printf("        Defaults to %llu.\n", (long long unsigned int)(CMDLINE_DEFAULT_NUM_ITERATIONS));
+        printf("        With a tolerance, this is instead the maximum number of iterations.\n");
+        printf("        Defaults to %llu, or %llu with a tolerance.\n", (long long unsigned int)(CMDLINE_DEFAULT_NUM_ITERATIONS), (long long unsigned int)(CMDLINE_DEFAULT_MAX_NUM_ITERATIONS));
     }
     
     if (cmdline_helper_is_recognized_option('o'))
     {
         printf("  %co output-file\n", CMDLINE_SWITCH_CHAR);
         printf("        Path of the file to write as output.\n");
+        printf("        With several input graphs, \"-0\", \"-1\", and so on are appended.\n");
+    }
+    
+    if (cmdline_helper_is_recognized_option('p'))
+    {
+        printf("  %cp page-size\n", CMDLINE_SWITCH_CHAR);
+        printf("        Kind of pages to use for large graph data structures.\n");
+        printf("        \"4k\" uses regular pages only, and \"thp\" uses transparent huge pages.\n");
+        printf("        \"2m\" and \"1g\" use explicit huge pages reserved on each NUMA node,\n");
+        printf("        falling back to smaller pages on any node that runs out.\n");
+        printf("        Vertices are divided among nodes on huge page boundaries if possible.\n");
+        printf("        Defaults to \"thp\".\n");
+    }
+    
+    if (cmdline_helper_is_recognized_option('R'))
+    {
+        printf("  %cR reorder-method\n", CMDLINE_SWITCH_CHAR);
+        printf("        Reorder vertices while loading the input graph to improve locality.\n");
+        printf("        \"degree\" sorts all vertices by descending out-degree.\n");
+        printf("        \"hub\" sorts only vertices with above-average out-degree and places them first.\n");
+        printf("        \"rcm\" uses the Reverse Cuthill-McKee ordering.\n");
+        printf("        Output still identifies vertices as they were in the input graph.\n");
     }
 	
 	if (cmdline_helper_is_recognized_option('s'))
@@ -253,6 +382,28 @@ void cmdline_helper_print_usage_and_exit(char* argv0)
         printf("        Default behavior is to create 32n units of work, where n = # threads.\n");
     }
     
+    if (cmdline_helper_is_recognized_option('S'))
+    {
+        printf("  %cS root1[,root2[,root3[...]]]\n", CMDLINE_SWITCH_CHAR);
+        printf("        Comma-delimited list of vertices from which to start \"bfs\", \"sssp\", and \"msbfs\".\n");
+        printf("        \"bfs\" and \"sssp\" run once from each root on the same loaded graph.\n");
+        printf("        \"msbfs\" runs all of them at once, in batches of 64 searches that share each pass over the edges.\n");
+        printf("        Vertices are identified as in the input graph. May be repeated to add more roots.\n");
+        printf("        With several roots, \"-root\" and the root are appended to output file names.\n");
+        printf("        Maximum number of values is %llu.\n", (long long unsigned int)CMDLINE_MAX_NUM_SEARCH_ROOTS);
+        printf("        Defaults to 0.\n");
+    }
+    
+    if (cmdline_helper_is_recognized_option('t'))
+    {
+        printf("  %ct tolerance\n", CMDLINE_SWITCH_CHAR);
+        printf("        L1 residual, the total change in all ranks in an iteration, at which PageRank stops.\n");
+        printf("        \"pr\", \"prf\", and \"prg\" compute the residual in each iteration and stop once it falls below this.\n");
+        printf("        \"prd\" keeps updating a vertex only while its rank changes by more than this divided by # vertices.\n");
+        printf("        Must be at least the precision of the ranks, %.1le for \"prf\" and %.1le otherwise.\n", (double)FLT_EPSILON, DBL_EPSILON);
+        printf("        Default behavior is a fixed number of iterations, or 1e-6 for \"prd\".\n");
+    }
+    
     if (cmdline_helper_is_recognized_option('u'))
     {
         printf("  %cu node1[,node2[,node3[...]]]\n", CMDLINE_SWITCH_CHAR);
@@ -270,6 +421,13 @@ void cmdline_helper_print_usage_and_exit(char* argv0)
         printf("        Prints version information and exits.\n");
     }
     
+    if (cmdline_helper_is_recognized_option('w'))
+    {
+        printf("  %cw output-snapshot\n", CMDLINE_SWITCH_CHAR);
+        printf("        Path of the file to which to write a graph snapshot once loaded.\n");
+        printf("        Loading this snapshot later using %cr skips graph ingress.\n", CMDLINE_SWITCH_CHAR);
+    }
+    
     exit(0);
 }
 
@@ -302,6 +460,51 @@ void cmdline_parse_single_option_or_die(char* argv0, char* cmdline_option, char*
     // Handle each individual supported command-line option
     switch (cmdline_option[1])
     {
+    case 'a':
+        {
+            char algorithm_name[64];
+            const char* startptr = cmdline_value;
+            uint32_t algorithm_idx = 0;
+            
+            while ('\0' != *startptr)
+            {
+                const char* endptr = strchr(startptr, ',');
+                const size_t name_length = ((NULL == endptr) ? strlen(startptr) : (size_t)(endptr - startptr));
+                uint32_t algorithm;
+                
+                if (name_length >= sizeof(algorithm_name) || algorithm_idx >= CMDLINE_MAX_NUM_ALGORITHMS)
+                {
+                    cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+                }
+                
+                memcpy(algorithm_name, startptr, name_length);
+                algorithm_name[name_length] = '\0';
+                algorithm = execution_find_algorithm(algorithm_name);
+                
+                if (EXECUTION_NUM_ALGORITHMS == algorithm)
+                {
+                    cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+                }
+                
+                cmdline_opts.algorithms[algorithm_idx] = algorithm;
+                algorithm_idx += 1;
+                startptr += name_length;
+                
+                if (',' == *startptr && '\0' != *(startptr + 1))
+                {
+                    startptr += 1;
+                }
+            }
+            
+            if (0 == algorithm_idx)
+            {
+                cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+            }
+            
+            cmdline_opts.num_algorithms = algorithm_idx;
+        }
+        break;
+    
     case 'h':
     case '?':
         if (NULL != cmdline_value)
@@ -316,11 +519,71 @@ void cmdline_parse_single_option_or_die(char* argv0, char* cmdline_option, char*
         
         break;
     
+    case 'b':
+        cmdline_opts.graph_ranks_output_binary = 1;
+        break;
+    
+    case 'd':
+        cmdline_opts.graph_depths_output = 1;
+        break;
+    
+    case 'c':
+        strncpy(cmdline_opts.graph_compressed_output_filename_gather, cmdline_value, (sizeof(cmdline_opts.graph_compressed_output_filename_gather) / sizeof(char)) - (10 * sizeof(char)));
+        strncat(cmdline_opts.graph_compressed_output_filename_gather, "-pull", sizeof("-pull") / sizeof(char));
+        strncpy(cmdline_opts.graph_compressed_output_filename_scatter, cmdline_value, (sizeof(cmdline_opts.graph_compressed_output_filename_scatter) / sizeof(char)) - (10 * sizeof(char)));
+        strncat(cmdline_opts.graph_compressed_output_filename_scatter, "-push", sizeof("-push") / sizeof(char));
+        break;
+    
+    case 'e':
+        if (0 == strcmp(cmdline_value, "threshold"))
+        {
+            cmdline_opts.engine_select_method = ENGINESELECT_METHOD_THRESHOLD;
+        }
+        else if (0 == strcmp(cmdline_value, "adaptive"))
+        {
+            cmdline_opts.engine_select_method = ENGINESELECT_METHOD_ADAPTIVE;
+        }
+        else
+        {
+            cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+        }
+        break;
+    
+    case 'E':
+        cmdline_opts.engine_calibration_persist = 1;
+        break;
+    
     case 'i':
-        strncpy(cmdline_opts.graph_input_filename_gather, cmdline_value, (sizeof(cmdline_opts.graph_input_filename_gather) / sizeof(char)) - (10 * sizeof(char)));
-        strncat(cmdline_opts.graph_input_filename_gather, "-pull", sizeof("-pull") / sizeof(char));
-        strncpy(cmdline_opts.graph_input_filename_scatter, cmdline_value, (sizeof(cmdline_opts.graph_input_filename_scatter) / sizeof(char)) - (10 * sizeof(char)));
-        strncat(cmdline_opts.graph_input_filename_scatter, "-push", sizeof("-push") / sizeof(char));
+        if (cmdline_opts.num_input_graphs >= CMDLINE_MAX_NUM_INPUT_GRAPHS)
+        {
+            cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+        }
+        
+        strncpy(cmdline_opts.graph_input_filename[cmdline_opts.num_input_graphs], cmdline_value, (sizeof(cmdline_opts.graph_input_filename[0]) / sizeof(char)) - (10 * sizeof(char)));
+        strncpy(cmdline_opts.graph_input_filename_gather[cmdline_opts.num_input_graphs], cmdline_value, (sizeof(cmdline_opts.graph_input_filename_gather[0]) / sizeof(char)) - (10 * sizeof(char)));
+        strncat(cmdline_opts.graph_input_filename_gather[cmdline_opts.num_input_graphs], "-pull", sizeof("-pull") / sizeof(char));
+        strncpy(cmdline_opts.graph_input_filename_scatter[cmdline_opts.num_input_graphs], cmdline_value, (sizeof(cmdline_opts.graph_input_filename_scatter[0]) / sizeof(char)) - (10 * sizeof(char)));
+        strncat(cmdline_opts.graph_input_filename_scatter[cmdline_opts.num_input_graphs], "-push", sizeof("-push") / sizeof(char));
+        cmdline_opts.num_input_graphs += 1;
+        break;
+    
+    case 'k':
+        if (0 == strcmp(cmdline_value, "auto"))
+        {
+            cmdline_opts.phase_isa = PHASES_ISA_AUTO;
+        }
+        else if (0 == strcmp(cmdline_value, "avx2"))
+        {
+            cmdline_opts.phase_isa = PHASES_ISA_AVX2;
+        }
+        else if (0 == strcmp(cmdline_value, "avx512"))
+        {
+            cmdline_opts.phase_isa = PHASES_ISA_AVX512;
+        }
+        else
+        {
+            cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+        }
         break;
         
     case 'n':
@@ -354,6 +617,52 @@ void cmdline_parse_single_option_or_die(char* argv0, char* cmdline_option, char*
     case 'o':
         cmdline_opts.graph_ranks_output_filename = cmdline_value;
         break;
+    
+    case 'p':
+        if (0 == strcmp(cmdline_value, "4k"))
+        {
+            cmdline_opts.page_policy = NUMANODES_PAGES_SMALL;
+        }
+        else if (0 == strcmp(cmdline_value, "thp"))
+        {
+            cmdline_opts.page_policy = NUMANODES_PAGES_TRANSPARENT;
+        }
+        else if (0 == strcmp(cmdline_value, "2m"))
+        {
+            cmdline_opts.page_policy = NUMANODES_PAGES_HUGE_2M;
+        }
+        else if (0 == strcmp(cmdline_value, "1g"))
+        {
+            cmdline_opts.page_policy = NUMANODES_PAGES_HUGE_1G;
+        }
+        else
+        {
+            cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+        }
+        break;
+    
+    case 'r':
+        cmdline_opts.graph_snapshot_input_filename = cmdline_value;
+        break;
+    
+    case 'R':
+        if (0 == strcmp(cmdline_value, "degree"))
+        {
+            cmdline_opts.vertex_reorder_method = GRAPH_REORDER_DEGREE;
+        }
+        else if (0 == strcmp(cmdline_value, "hub"))
+        {
+            cmdline_opts.vertex_reorder_method = GRAPH_REORDER_HUB;
+        }
+        else if (0 == strcmp(cmdline_value, "rcm"))
+        {
+            cmdline_opts.vertex_reorder_method = GRAPH_REORDER_RCM;
+        }
+        else
+        {
+            cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+        }
+        break;
 	
 	case 's':
         {
@@ -369,6 +678,47 @@ void cmdline_parse_single_option_or_die(char* argv0, char* cmdline_option, char*
         }
         break;
     
+    case 'S':
+        {
+            char* endptr = cmdline_value;
+            
+            while ('\0' != *endptr)
+            {
+                if (!isdigit(*endptr) || cmdline_opts.num_search_roots >= CMDLINE_MAX_NUM_SEARCH_ROOTS)
+                {
+                    cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+                }
+                
+                cmdline_opts.search_roots[cmdline_opts.num_search_roots] = strtoull(endptr, &endptr, 10);
+                cmdline_opts.num_search_roots += 1;
+                
+                if ('\0' != *endptr && ',' != *endptr)
+                {
+                    cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+                }
+                
+                if ('\0' != *endptr && '\0' != *(endptr + 1))
+                {
+                    endptr += 1;
+                }
+            }
+        }
+        break;
+    
+    case 't':
+        {
+            char* endptr;
+            double cmdline_tolerance = strtod(cmdline_value, &endptr);
+            
+            if ('\0' != *endptr || !(cmdline_tolerance > 0.0))
+            {
+                cmdline_helper_print_error_invalid_value_and_exit(argv0, cmdline_option, cmdline_value);
+            }
+            
+            cmdline_opts.tolerance = cmdline_tolerance;
+        }
+        break;
+    
     case 'u':
         {
             char* endptr = cmdline_value;
@@ -406,6 +756,10 @@ void cmdline_parse_single_option_or_die(char* argv0, char* cmdline_option, char*
         cmdline_helper_print_version_and_exit();
         break;
     
+    case 'w':
+        cmdline_opts.graph_snapshot_output_filename = cmdline_value;
+        break;
+    
     default:
         cmdline_helper_print_error_unknown_option_and_exit(argv0, cmdline_option);
         break;
@@ -415,10 +769,59 @@ void cmdline_parse_single_option_or_die(char* argv0, char* cmdline_option, char*
 // Validates the command-line settings structure, returns on success, or prints and terminates on failure.
 void cmdline_validate_or_die(char* argv0)
 {
-    // Verify that an input filename has been supplied
-    if ('\0' == cmdline_opts.graph_input_filename_gather[0] || '\0' == cmdline_opts.graph_input_filename_scatter[0])
+    // Verify that exactly one of an input filename or an input snapshot has been supplied
+    if (NULL == cmdline_opts.graph_snapshot_input_filename)
+    {
+        if (0 == cmdline_opts.num_input_graphs)
+        {
+            cmdline_helper_print_error_missing_option_and_exit(argv0, "i");
+        }
+    }
+    else if (0 != cmdline_opts.num_input_graphs || GRAPH_REORDER_NONE != cmdline_opts.vertex_reorder_method)
+    {
+        cmdline_helper_print_error_incompatible_options_and_exit(argv0);
+    }
+    
+    // Verify that a single graph is being loaded if it is to be written back out, since there is only one output file name
+    if (cmdline_opts.num_input_graphs > 1 && (NULL != cmdline_opts.graph_snapshot_output_filename || '\0' != cmdline_opts.graph_compressed_output_filename_gather[0]))
+    {
+        cmdline_helper_print_error_incompatible_options_and_exit(argv0);
+    }
+    
+    // Verify that depths are written only alongside an output file, since their file name is derived from it
+    if (0 != cmdline_opts.graph_depths_output && NULL == cmdline_opts.graph_ranks_output_filename)
+    {
+        cmdline_helper_print_error_incompatible_options_and_exit(argv0);
+    }
+    
+    // Verify that engine selection measurements are kept only when they are taken
+    if (0 != cmdline_opts.engine_calibration_persist && ENGINESELECT_METHOD_ADAPTIVE != cmdline_opts.engine_select_method)
+    {
+        cmdline_helper_print_error_incompatible_options_and_exit(argv0);
+    }
+    
+    // Search from the first vertex if no search roots are specified
+    if (0 == cmdline_opts.num_search_roots)
+    {
+        cmdline_opts.search_roots[0] = 0ull;
+        cmdline_opts.num_search_roots = 1;
+    }
+    
+    // Verify that the tolerance can be reached by every algorithm that computes ranks, since the residual cannot fall much below the precision of the ranks themselves
+    for (uint32_t i = 0; i < cmdline_opts.num_algorithms; ++i)
+    {
+        const execution_algorithm_t* algorithm = execution_algorithms[cmdline_opts.algorithms[i]];
+        
+        if (EXECUTION_OUTPUT_RANK == algorithm->output_type && 0.0 < cmdline_opts.tolerance && cmdline_opts.tolerance < (algorithm->single_precision ? (double)FLT_EPSILON : DBL_EPSILON))
+        {
+            cmdline_helper_print_error_incompatible_options_and_exit(argv0);
+        }
+    }
+    
+    // Run the default number of iterations if none is specified, or the default maximum if there is a tolerance
+    if (0 == cmdline_opts.num_iterations)
     {
-        cmdline_helper_print_error_missing_option_and_exit(argv0, "i");
+        cmdline_opts.num_iterations = ((0.0 < cmdline_opts.tolerance) ? CMDLINE_DEFAULT_MAX_NUM_ITERATIONS : CMDLINE_DEFAULT_NUM_ITERATIONS);
     }
     
     // Calculate the number of threads if 0 is specified.
@@ -446,8 +849,13 @@ void cmdline_init()
     // Set the default configuration values
     cmdline_opts.num_threads = CMDLINE_DEFAULT_NUM_THREADS;
 	cmdline_opts.num_numa_nodes = 1;
-    cmdline_opts.num_iterations = CMDLINE_DEFAULT_NUM_ITERATIONS;
+    cmdline_opts.num_iterations = 0;
     cmdline_opts.sched_granularity = CMDLINE_DEFAULT_SCHED_GRANULARITY;
+    cmdline_opts.page_policy = NUMANODES_PAGES_TRANSPARENT;
+    cmdline_opts.phase_isa = PHASES_ISA_AUTO;
+    cmdline_opts.engine_select_method = ENGINESELECT_METHOD_THRESHOLD;
+    cmdline_opts.algorithms[0] = CMDLINE_DEFAULT_ALGORITHM;
+    cmdline_opts.num_algorithms = 1;
 }
 
 
@@ -66,6 +66,12 @@ const_edge_mask_and_mask                    DQ          8000000000000000H
                                             DQ          8000000000000000H
                                             DQ          8000000000000000H
 
+PUBLIC const_compact_lane_bits
+const_compact_lane_bits                     DQ          0000000200000001H
+                                            DQ          0000000800000004H
+                                            DQ          0000002000000010H
+                                            DQ          0000008000000040H
+
 PUBLIC const_positive_sign_and_mask         
 const_positive_sign_and_mask                DQ          7fffffffffffffffH
                                             DQ          7fffffffffffffffH
@@ -0,0 +1,257 @@
+/*****************************************************************************
+* Grazelle
+*      High performance, hardware-optimized graph processing engine.
+*      Targets a single machine with one or more x86-based sockets.
+*****************************************************************************
+* Authored by Samuel Grossman
+* Department of Electrical Engineering, Stanford University
+* (c) 2015-2018
+*****************************************************************************
+* engineselect.c
+*      Implementation of selection between the Edge-Pull and Edge-Push
+*      engines, including the online cost model for adaptive selection.
+*****************************************************************************/
+
+#include "benchmark.h"
+#include "engineselect.h"
+#include "execution.h"
+#include "threads.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* -------- TYPE DEFINITIONS ----------------------------------------------- */
+
+// Running sums of Edge phase measurements for one engine, from which a linear cost model is fit by least squares.
+// Frontier sizes are (f) and Edge phase times, in cycles, are (t).
+typedef struct engineselect_model_t
+{
+    double count;
+    double sum_f;
+    double sum_t;
+    double sum_ff;
+    double sum_ft;
+} engineselect_model_t;
+
+
+/* -------- LOCALS --------------------------------------------------------- */
+
+// Selection method in effect, one of the ENGINESELECT_METHOD_* constants.
+static uint32_t engineselect_method = ENGINESELECT_METHOD_THRESHOLD;
+
+// Number of threads and instruction set for which the calibration is valid.
+static uint32_t engineselect_num_threads = 0;
+static uint32_t engineselect_phase_isa = 0;
+
+// Cost model for each algorithm and engine, indexed first by algorithm and then by 0 for Push and 1 for Pull.
+static engineselect_model_t engineselect_models[EXECUTION_NUM_ALGORITHMS][2];
+
+// Algorithm whose cost models are currently used and updated.
+static uint32_t engineselect_algorithm = 0;
+
+// Cycle counter value at the start of the current Edge phase, kept by the first thread.
+static uint64_t engineselect_edge_phase_start_time = 0ull;
+
+
+/* -------- INTERNAL FUNCTIONS --------------------------------------------- */
+
+// Predicts the Edge phase time, in cycles, for the specified frontier size using the specified model, which must contain at least one measurement.
+// If all measurements share a single frontier size, the Pull engine is assumed to take constant time and the Push engine time proportional to the frontier size.
+static double engineselect_predict(const engineselect_model_t* model, const uint8_t is_pull, const double frontier_size)
+{
+    const double spread = (model->count * model->sum_ff) - (model->sum_f * model->sum_f);
+
+    if (spread > (1.0e-9 * model->count * model->sum_ff))
+    {
+        const double slope = ((model->count * model->sum_ft) - (model->sum_f * model->sum_t)) / spread;
+        const double intercept = (model->sum_t - (slope * model->sum_f)) / model->count;
+
+        // cost never decreases as the frontier grows, nor is it negative for an empty frontier, so the fit is constrained accordingly
+        if (slope < 0.0)
+        {
+            return model->sum_t / model->count;
+        }
+
+        if (intercept < 0.0)
+        {
+            return (model->sum_ft / model->sum_ff) * frontier_size;
+        }
+
+        return intercept + (slope * frontier_size);
+    }
+
+    if (is_pull || !(model->sum_f > 0.0))
+    {
+        return model->sum_t / model->count;
+    }
+
+    return (model->sum_t / model->sum_f) * frontier_size;
+}
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+// See "engineselect.h" for documentation.
+
+void engineselect_reset(const uint32_t method, const uint32_t num_threads, const uint32_t phase_isa)
+{
+    engineselect_method = method;
+    engineselect_num_threads = num_threads;
+    engineselect_phase_isa = phase_isa;
+    engineselect_algorithm = 0;
+
+    memset((void*)engineselect_models, 0, sizeof(engineselect_models));
+}
+
+// ---------
+
+uint32_t engineselect_read_calibration(const char* filename)
+{
+    FILE* calibrationfile = fopen(filename, "r");
+    unsigned int file_num_threads;
+    unsigned int file_phase_isa;
+    char algorithm_name[64];
+    char engine_name[8];
+    engineselect_model_t model;
+
+    if (NULL == calibrationfile)
+    {
+        return 0;
+    }
+
+    if (2 != fscanf(calibrationfile, " threads %u isa %u", &file_num_threads, &file_phase_isa))
+    {
+        fprintf(stderr, "Error: engine calibration file \"%s\" is malformed\n", filename);
+        exit(255);
+    }
+
+    if (file_num_threads != engineselect_num_threads || file_phase_isa != engineselect_phase_isa)
+    {
+        fclose(calibrationfile);
+        return 0;
+    }
+
+    while (7 == fscanf(calibrationfile, " %63s %7s %lf %lf %lf %lf %lf", algorithm_name, engine_name, &model.count, &model.sum_f, &model.sum_t, &model.sum_ff, &model.sum_ft))
+    {
+        const uint32_t algorithm = execution_find_algorithm(algorithm_name);
+
+        if (EXECUTION_NUM_ALGORITHMS == algorithm || (0 != strcmp(engine_name, "push") && 0 != strcmp(engine_name, "pull")) || !(model.count > 0.0))
+        {
+            fprintf(stderr, "Error: engine calibration file \"%s\" is malformed\n", filename);
+            exit(255);
+        }
+
+        engineselect_models[algorithm][(0 == strcmp(engine_name, "pull")) ? 1 : 0] = model;
+    }
+
+    if (!feof(calibrationfile))
+    {
+        fprintf(stderr, "Error: engine calibration file \"%s\" is malformed\n", filename);
+        exit(255);
+    }
+
+    fclose(calibrationfile);
+    return 1;
+}
+
+// ---------
+
+void engineselect_write_calibration(const char* filename)
+{
+    FILE* calibrationfile = fopen(filename, "w");
+
+    if (NULL == calibrationfile)
+    {
+        fprintf(stderr, "Error: unable to write file \"%s\"\n", filename);
+        exit(255);
+    }
+
+    fprintf(calibrationfile, "threads %u isa %u\n", (unsigned int)engineselect_num_threads, (unsigned int)engineselect_phase_isa);
+
+    for (uint32_t algorithm = 0; algorithm < EXECUTION_NUM_ALGORITHMS; ++algorithm)
+    {
+        for (uint32_t engine = 0; engine < 2; ++engine)
+        {
+            const engineselect_model_t* model = &engineselect_models[algorithm][engine];
+
+            if (model->count > 0.0)
+            {
+                fprintf(calibrationfile, "%s %s %.17le %.17le %.17le %.17le %.17le\n", execution_algorithms[algorithm]->name, ((1 == engine) ? "pull" : "push"), model->count, model->sum_f, model->sum_t, model->sum_ff, model->sum_ft);
+            }
+        }
+    }
+
+    fclose(calibrationfile);
+}
+
+// ---------
+
+void engineselect_select_algorithm(const uint32_t algorithm)
+{
+    engineselect_algorithm = algorithm;
+}
+
+// ---------
+
+uint8_t engineselect_use_pull(const uint64_t frontier_size, const uint64_t engine_threshold)
+{
+    const uint8_t threshold_use_pull = (frontier_size > engine_threshold);
+    const engineselect_model_t* model_push = &engineselect_models[engineselect_algorithm][0];
+    const engineselect_model_t* model_pull = &engineselect_models[engineselect_algorithm][1];
+
+    if (ENGINESELECT_METHOD_ADAPTIVE != engineselect_method)
+    {
+        return threshold_use_pull;
+    }
+
+    // once both engines have been measured, the model decides
+    if (model_push->count > 0.0 && model_pull->count > 0.0)
+    {
+        return (engineselect_predict(model_pull, 1, (double)frontier_size) <= engineselect_predict(model_push, 0, (double)frontier_size));
+    }
+
+    // otherwise, when the frontier is close enough to the threshold that either engine could be cheaper, try the one that has not yet been measured
+    if ((frontier_size / ENGINESELECT_EXPLORE_FACTOR) <= engine_threshold && (engine_threshold / ENGINESELECT_EXPLORE_FACTOR) <= frontier_size)
+    {
+        if (threshold_use_pull && model_pull->count > 0.0)
+        {
+            return 0;
+        }
+
+        if (!threshold_use_pull && model_push->count > 0.0)
+        {
+            return 1;
+        }
+    }
+
+    return threshold_use_pull;
+}
+
+// ---------
+
+void engineselect_edge_phase_start()
+{
+    if (ENGINESELECT_METHOD_ADAPTIVE == engineselect_method && 0 == threads_get_global_thread_id())
+    {
+        engineselect_edge_phase_start_time = benchmark_rdtsc();
+    }
+}
+
+// ---------
+
+void engineselect_edge_phase_end(const uint8_t used_pull, const uint64_t frontier_size)
+{
+    if (ENGINESELECT_METHOD_ADAPTIVE == engineselect_method && 0 == threads_get_global_thread_id())
+    {
+        const double edge_phase_time = (double)(benchmark_rdtsc() - engineselect_edge_phase_start_time);
+        engineselect_model_t* model = &engineselect_models[engineselect_algorithm][(used_pull ? 1 : 0)];
+
+        model->count += 1.0;
+        model->sum_f += (double)frontier_size;
+        model->sum_t += edge_phase_time;
+        model->sum_ff += (double)frontier_size * (double)frontier_size;
+        model->sum_ft += (double)frontier_size * edge_phase_time;
+    }
+}
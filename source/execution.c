@@ -9,10 +9,15 @@
 *****************************************************************************
 * execution.c
 *      Implementation of the top-level functions executed by this program.
-*      Defines common variables used across algorithms.
+*      Defines common variables used across algorithms and selects among
+*      them at runtime.
 *****************************************************************************/
 
+#include "execution.h"
+#include "phases.h"
+
 #include <stdint.h>
+#include <string.h>
 
 
 /* -------- GLOBALS -------------------------------------------------------- */
@@ -21,3 +26,33 @@
 uint64_t total_iterations_executed = 0ull;
 uint64_t total_iterations_used_gather = 0ull;
 uint64_t total_iterations_used_scatter = 0ull;
+double total_residual = -1.0;
+uint64_t execution_search_root = 0ull;
+const uint64_t* execution_search_roots = &execution_search_root;
+uint64_t execution_num_search_roots = 1ull;
+const execution_algorithm_t* const execution_algorithms[EXECUTION_NUM_ALGORITHMS] = { &execution_algorithm_pr, &execution_algorithm_cc, &execution_algorithm_bfs, &execution_algorithm_prf, &execution_algorithm_sssp, &execution_algorithm_msbfs, &execution_algorithm_prd, &execution_algorithm_prg, &execution_algorithm_ccg };
+const execution_algorithm_t* execution_algorithm = &execution_algorithm_pr;
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+// See "execution.h" for documentation.
+
+uint32_t execution_find_algorithm(const char* name)
+{
+    uint32_t algorithm = 0;
+    
+    while (algorithm < EXECUTION_NUM_ALGORITHMS && 0 != strcmp(name, execution_algorithms[algorithm]->name))
+    {
+        algorithm += 1;
+    }
+    
+    return algorithm;
+}
+
+// ---------
+
+void execution_select_algorithm(const uint32_t algorithm)
+{
+    execution_algorithm = execution_algorithms[algorithm];
+    phases_select_algorithm(algorithm);
+}
@@ -13,21 +13,18 @@
 
 #include "benchmark.h"
 #include "cmdline.h"
+#include "engineselect.h"
 #include "execution.h"
 #include "graphdata.h"
 #include "numanodes.h"
 #include "phases.h"
+#include "scheduler.h"
 #include "threads.h"
 
 #include <stdint.h>
 #include <stdio.h>
 
 
-/* -------- ALGORITHM PARAMETERS ------------------------------------------- */
-
-#define SEARCH_ROOT                             0ull
-
-
 /* -------- LOCALS --------------------------------------------------------- */
 
 // Size of the reduce buffer for inter-phase and inter-thread communication. Measured in number of elements.
@@ -70,11 +67,12 @@ uint64_t execution_accumulator_bits_per_vertex_bfs()
 uint64_t execution_initialize_frontier_has_info_bfs(const uint64_t base)
 {
     const uint64_t top = base + 63ull;
+    const uint64_t search_root = execution_search_root;
     
-    if (SEARCH_ROOT >= base && SEARCH_ROOT <= top)
+    if (search_root >= base && search_root <= top)
     {
         // the search root has info
-        return (1ull << (SEARCH_ROOT - base));
+        return (1ull << (search_root - base));
     }
     else
     {
@@ -88,11 +86,12 @@ uint64_t execution_initialize_frontier_has_info_bfs(const uint64_t base)
 uint64_t execution_initialize_frontier_wants_info_bfs(const uint64_t base)
 {    
     const uint64_t top = base + 63ull;
+    const uint64_t search_root = execution_search_root;
     
-    if (SEARCH_ROOT >= base && SEARCH_ROOT <= top)
+    if (search_root >= base && search_root <= top)
     {
         // the search root does not want info
-        return (~(1ull << (SEARCH_ROOT - base)));
+        return (~(1ull << (search_root - base)));
     }
     else
     {
@@ -117,6 +116,14 @@ double execution_initialize_vertex_prop_bfs(const uint64_t id)
 
 // ---------
 
+double execution_scalar_reduce_op_bfs(const double a, const double b)
+{
+    // partial values are combined by keeping the lowest
+    return ((a < b) ? a : b);
+}
+
+// ---------
+
 void execution_impl_bfs(void* unused_arg)
 {
     uint64_t num_iterations_used_gather = 0ull;
@@ -132,7 +139,7 @@ void execution_impl_bfs(void* unused_arg)
     uint64_t converge_vote = 0ull;
     
 #ifndef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
-    converge_vote += (uint64_t)graph_vertex_outdegrees[SEARCH_ROOT];
+    converge_vote += (uint64_t)graph_vertex_outdegrees[execution_search_root];
 #else
 #ifdef EXPERIMENT_ITERATION_PROFILE
     iteration_frontier_comparator = (double)graph_num_vertices;
@@ -164,11 +171,14 @@ void execution_impl_bfs(void* unused_arg)
 #endif
         
         // dynamically select an engine (either Push or Pull) depending on some condition
-        const uint8_t use_gather_for_processing = (converge_vote > engine_threshold);
+        // the adaptive method instead picks the engine predicted to be cheaper, based on the measured cost of previous iterations
+        const uint8_t use_gather_for_processing = engineselect_use_pull(converge_vote, engine_threshold);
 #endif
         
         /* Edge Phase */
         
+        engineselect_edge_phase_start();
+        
 #ifdef EXPERIMENT_ITERATION_PROFILE
         if (0 == threads_get_global_thread_id())
         {
@@ -176,16 +186,27 @@ void execution_impl_bfs(void* unused_arg)
         }
 #endif
         
-        // reset the global variable accumulator
-        phase_op_reset_global_accum();
-        
         if (use_gather_for_processing)
         {
             // if the threshold is met, use the Pull engine to do this round of processing
             num_iterations_used_gather += 1ull;
             
+#ifndef EXPERIMENT_FRONTIERS_WITHOUT_SUMMARY
+            // summarize the vertices still unvisited so the Edge-Pull phase can skip whole blocks of visited destinations
+            edge_pull_op_build_frontier_summary(graph_frontier_wants_info, graph_frontier_wants_info_summary);
+#endif
+            
+            // reset the global variable accumulator
+            // this happens immediately before the Edge phase because C code, such as the frontier queue build, does not preserve it
+            phase_op_reset_global_accum();
+            
             // perform the Edge-Pull phase
             perform_edge_pull_phase(graph_edges_gather_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_gather_list_block_counts_numa[threads_get_thread_group_id()][0]);
+            
+            // each thread would have a partial value for the global variable which represents the number of vertices changed this algorithm iteration
+            // therefore, each thread should write the partial value to the reduce buffer, to which any units it steals then add
+            phase_op_write_global_accum_to_buf(reduce_buffer);
+            scheduler_steal_edge_pull_work(reduce_buffer);
             threads_barrier();
         }
         else
@@ -193,16 +214,24 @@ void execution_impl_bfs(void* unused_arg)
             // otherwise, use the Edge-Push phase to do this round of processing
             num_iterations_used_scatter += 1ull;
             
+            // list the active vertices so the Edge-Push phase can skip directly between them
+            edge_push_op_build_frontier_queue(graph_frontier_has_info);
+            
+            // reset the global variable accumulator
+            // this happens immediately before the Edge phase because C code, such as the frontier queue build, does not preserve it
+            phase_op_reset_global_accum();
+            
             // perform the Edge-Push phase
             perform_edge_push_phase(graph_edges_scatter_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_scatter_list_block_counts_numa[threads_get_thread_group_id()][0]);
+            
+            // each thread would have a partial value for the global variable which represents the number of vertices changed this algorithm iteration
+            // therefore, each thread should write the partial value to the reduce buffer, to which any units it steals then add
+            phase_op_write_global_accum_to_buf(reduce_buffer);
+            scheduler_steal_edge_push_work(reduce_buffer);
             threads_barrier();
         }
         
-        // each thread would have a partial value for the global variable which represents the number of vertices changed this algorithm iteration
-        // therefore, each thread should write the partial value to the reduce buffer
-        phase_op_write_global_accum_to_buf(reduce_buffer);
-        
-        threads_barrier();
+        engineselect_edge_phase_end(use_gather_for_processing, converge_vote);
         
 #ifdef EXPERIMENT_ITERATION_PROFILE
         if (0 == threads_get_global_thread_id())
@@ -274,3 +303,27 @@ void execution_impl_bfs(void* unused_arg)
         total_iterations_used_scatter = num_iterations_used_scatter;
     }
 }
+
+
+/* -------- ALGORITHM DEFINITION ------------------------------------------- */
+// See "execution.h" for documentation.
+
+const execution_algorithm_t execution_algorithm_bfs = {
+    .name = "bfs",
+    .display_name = "Breadth-First Search",
+    .converges_dynamically = 1,
+    .output_type = EXECUTION_OUTPUT_VERTEX_ID,
+    .single_precision = 0,
+    .uses_edge_weights = 0,
+    .search_roots = EXECUTION_SEARCH_ROOTS_EACH,
+    .vertex_id_props = 1,
+    .init = execution_init_bfs,
+    .cleanup = execution_cleanup_bfs,
+    .accumulator_bits_per_vertex = execution_accumulator_bits_per_vertex_bfs,
+    .initialize_frontier_has_info = execution_initialize_frontier_has_info_bfs,
+    .initialize_frontier_wants_info = execution_initialize_frontier_wants_info_bfs,
+    .initialize_vertex_accum = execution_initialize_vertex_accum_bfs,
+    .initialize_vertex_prop = execution_initialize_vertex_prop_bfs,
+    .scalar_reduce_op = execution_scalar_reduce_op_bfs,
+    .impl = execution_impl_bfs
+};
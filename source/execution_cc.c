@@ -13,6 +13,7 @@
 
 #include "benchmark.h"
 #include "cmdline.h"
+#include "engineselect.h"
 #include "execution.h"
 #include "graphdata.h"
 #include "numanodes.h"
@@ -86,7 +87,16 @@ double execution_initialize_vertex_accum_cc(const uint64_t id)
 
 double execution_initialize_vertex_prop_cc(const uint64_t id)
 {
-    return (double)id;
+    // labels are output positions rather than vertex IDs, so that the lowest label reaching a vertex is the same whether or not vertices were reordered
+    return (double)(NULL == graph_vertex_output_positions ? id : graph_vertex_output_positions[id]);
+}
+
+// ---------
+
+double execution_scalar_reduce_op_cc(const double a, const double b)
+{
+    // partial values are combined by keeping the lowest
+    return ((a < b) ? a : b);
 }
 
 // ---------
@@ -138,11 +148,14 @@ void execution_impl_cc(void* unused_arg)
 #endif
         
         // dynamically select an engine (either Push or Pull) depending on some condition
-        const uint8_t use_gather_for_processing = (converge_vote > engine_threshold);
+        // the adaptive method instead picks the engine predicted to be cheaper, based on the measured cost of previous iterations
+        const uint8_t use_gather_for_processing = engineselect_use_pull(converge_vote, engine_threshold);
 #endif
         
         /* Edge Phase */
         
+        engineselect_edge_phase_start();
+        
 #ifdef EXPERIMENT_ITERATION_PROFILE
         if (0 == threads_get_global_thread_id())
         {
@@ -150,16 +163,22 @@ void execution_impl_cc(void* unused_arg)
         }
 #endif
         
-        // reset the global variable accumulator
-        phase_op_reset_global_accum();
-        
         if (use_gather_for_processing)
         {
             // if the threshold is met, use the Pull engine to do this round of processing
             num_iterations_used_gather += 1ull;
             
+            // reset the global variable accumulator
+            // this happens immediately before the Edge phase because C code, such as the frontier queue build, does not preserve it
+            phase_op_reset_global_accum();
+            
             // perform the Edge-Pull phase
             perform_edge_pull_phase(graph_edges_gather_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_gather_list_block_counts_numa[threads_get_thread_group_id()][0]);
+            
+            // each thread would have a partial value for the global variable which represents the number of vertices changed this algorithm iteration
+            // therefore, each thread should write the partial value to the reduce buffer, to which any units it steals then add
+            phase_op_write_global_accum_to_buf(reduce_buffer);
+            scheduler_steal_edge_pull_work(reduce_buffer);
             threads_barrier();
             
 #if !defined(EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE) && defined(EXPERIMENT_EDGE_PULL_FORCE_MERGE)
@@ -168,16 +187,8 @@ void execution_impl_cc(void* unused_arg)
             {
                 edge_pull_op_merge_with_merge_buffer(graph_vertex_merge_buffer, sched_pull_units_total, graph_vertex_props);
             }
-#endif
             
-            // each thread would have a partial value for the global variable which represents the number of vertices changed this algorithm iteration
-            // therefore, each thread should write the partial value to the reduce buffer
-            phase_op_write_global_accum_to_buf(reduce_buffer);
-            
-#if !defined(EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE) && defined(EXPERIMENT_EDGE_PULL_FORCE_MERGE)
             threads_merge_barrier();
-#else
-            threads_barrier();
 #endif
         }
         else
@@ -185,17 +196,25 @@ void execution_impl_cc(void* unused_arg)
             // otherwise, use the Edge-Push phase to do this round of processing
             num_iterations_used_scatter += 1ull;
             
+            // list the active vertices so the Edge-Push phase can skip directly between them
+            edge_push_op_build_frontier_queue(graph_frontier_has_info);
+            
+            // reset the global variable accumulator
+            // this happens immediately before the Edge phase because C code, such as the frontier queue build, does not preserve it
+            phase_op_reset_global_accum();
+            
             // perform the Edge-Push phase
             perform_edge_push_phase(graph_edges_scatter_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_scatter_list_block_counts_numa[threads_get_thread_group_id()][0]);
-            threads_barrier();
             
             // each thread would have a partial value for the global variable which represents the number of vertices changed this algorithm iteration
-            // therefore, each thread should write the partial value to the reduce buffer
+            // therefore, each thread should write the partial value to the reduce buffer, to which any units it steals then add
             phase_op_write_global_accum_to_buf(reduce_buffer);
-            
+            scheduler_steal_edge_push_work(reduce_buffer);
             threads_barrier();
         }
         
+        engineselect_edge_phase_end(use_gather_for_processing, converge_vote);
+        
 #ifdef EXPERIMENT_ITERATION_PROFILE
         if (0 == threads_get_global_thread_id())
         {
@@ -266,3 +285,27 @@ void execution_impl_cc(void* unused_arg)
         total_iterations_used_scatter = num_iterations_used_scatter;
     }
 }
+
+
+/* -------- ALGORITHM DEFINITION ------------------------------------------- */
+// See "execution.h" for documentation.
+
+const execution_algorithm_t execution_algorithm_cc = {
+    .name = "cc",
+    .display_name = "Connected Components",
+    .converges_dynamically = 1,
+    .output_type = EXECUTION_OUTPUT_COMPONENT,
+    .single_precision = 0,
+    .uses_edge_weights = 0,
+    .search_roots = EXECUTION_SEARCH_ROOTS_NONE,
+    .vertex_id_props = 0,
+    .init = execution_init_cc,
+    .cleanup = execution_cleanup_cc,
+    .accumulator_bits_per_vertex = execution_accumulator_bits_per_vertex_cc,
+    .initialize_frontier_has_info = execution_initialize_frontier_has_info_cc,
+    .initialize_frontier_wants_info = execution_initialize_frontier_wants_info_cc,
+    .initialize_vertex_accum = execution_initialize_vertex_accum_cc,
+    .initialize_vertex_prop = execution_initialize_vertex_prop_cc,
+    .scalar_reduce_op = execution_scalar_reduce_op_cc,
+    .impl = execution_impl_cc
+};
@@ -0,0 +1,168 @@
+/*****************************************************************************
+* Grazelle
+*      High performance, hardware-optimized graph processing engine.
+*      Targets a single machine with one or more x86-based sockets.
+*****************************************************************************
+* Authored by Samuel Grossman
+* Department of Electrical Engineering, Stanford University
+* (c) 2015-2018
+*****************************************************************************
+* execution_ccg.cpp
+*      Implementation of Connected Components using the Gather-Apply-Scatter
+*      interface. Computes the same components as the hand-written version.
+*****************************************************************************/
+
+#include "gas.h"
+
+#include <stdint.h>
+
+
+/* -------- PROGRAM -------------------------------------------------------- */
+
+// Connected Components as a Gather-Apply-Scatter program, by label propagation.
+// Each vertex property holds the lowest vertex ID seen so far, and a vertex sends its label along its out-edges only in the iteration after the label changes.
+struct gas_program_cc_t : gas_program_defaults_t
+{
+    static const uint32_t frontier = GAS_FRONTIER_ACTIVE;
+    static const uint32_t uses_accum_total = 0;
+
+    static inline __m256d identity()
+    {
+        return _mm256_set1_pd(__builtin_inf());
+    }
+
+    static inline __m256d gather(const __m256d src_props)
+    {
+        return src_props;
+    }
+
+    static inline __m256d reduce(const __m256d a, const __m256d b)
+    {
+        return _mm256_min_pd(a, b);
+    }
+
+    static inline __m256d apply(const __m256d accum, const __m256d prop, const __m256d outdeg, const gas_globals_t& g)
+    {
+        return _mm256_min_pd(accum, prop);
+    }
+
+    static inline __m256d scatter(const __m256d new_prop, const __m256d prop)
+    {
+        return _mm256_cmp_pd(new_prop, prop, _CMP_LT_OQ);
+    }
+};
+
+
+/* -------- PHASE CONTROL FUNCTIONS ---------------------------------------- */
+// See "phases.h" for documentation.
+
+C_COMPATIBLE_API void __WRITTEN_IN_ASSEMBLY__ perform_edge_pull_phase_ccg(const __m256i* edge_list, const uint64_t edge_list_count)
+{
+    gas_edge_pull_phase<gas_program_cc_t>(edge_list, edge_list_count);
+}
+
+// ---------
+
+C_COMPATIBLE_API void __WRITTEN_IN_ASSEMBLY__ perform_edge_push_phase_ccg(const __m256i* edge_list, const uint64_t edge_list_count)
+{
+    gas_edge_push_phase<gas_program_cc_t>(edge_list, edge_list_count);
+}
+
+// ---------
+
+C_COMPATIBLE_API void __WRITTEN_IN_ASSEMBLY__ perform_vertex_phase_ccg(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer)
+{
+    gas_vertex_phase<gas_program_cc_t>(vertex_start, vertex_count, (const gas_vertex_params_t*)reduce_buffer);
+}
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+// See "execution.h" for documentation.
+
+static void execution_init_ccg()
+{
+    gas_init<gas_program_cc_t>();
+}
+
+// ---------
+
+static void execution_cleanup_ccg()
+{
+    gas_cleanup<gas_program_cc_t>();
+}
+
+// ---------
+
+static uint64_t execution_accumulator_bits_per_vertex_ccg()
+{
+    // the accumulator stores a full vertex property
+    return 8ull * sizeof(double);
+}
+
+// ---------
+
+static uint64_t execution_initialize_frontier_has_info_ccg(const uint64_t base)
+{
+    // every vertex starts out with a new label to send
+    return ~0ull;
+}
+
+// ---------
+
+static uint64_t execution_initialize_frontier_wants_info_ccg(const uint64_t base)
+{
+    return ~0ull;
+}
+
+// ---------
+
+static double execution_initialize_vertex_accum_ccg(const uint64_t id)
+{
+    return gas_initialize_vertex_accum<gas_program_cc_t>(id);
+}
+
+// ---------
+
+static double execution_initialize_vertex_prop_ccg(const uint64_t id)
+{
+    // labels are output positions rather than vertex IDs, as in the hand-written version
+    return (double)(NULL == graph_vertex_output_positions ? id : graph_vertex_output_positions[id]);
+}
+
+// ---------
+
+static double execution_scalar_reduce_op_ccg(const double a, const double b)
+{
+    return gas_scalar_reduce<gas_program_cc_t>(a, b);
+}
+
+// ---------
+
+static void execution_impl_ccg(void* unused_arg)
+{
+    gas_impl<gas_program_cc_t>();
+}
+
+
+/* -------- ALGORITHM DEFINITION ------------------------------------------- */
+// See "execution.h" for documentation.
+
+C_COMPATIBLE_API const execution_algorithm_t execution_algorithm_ccg = {
+    /* .name = */ "ccg",
+    /* .display_name = */ "Connected Components (GAS)",
+    /* .converges_dynamically = */ 1,
+    /* .output_type = */ EXECUTION_OUTPUT_COMPONENT,
+    /* .single_precision = */ 0,
+    /* .uses_edge_weights = */ 0,
+    /* .search_roots = */ EXECUTION_SEARCH_ROOTS_NONE,
+    /* .vertex_id_props = */ 0,
+    /* .init = */ execution_init_ccg,
+    /* .cleanup = */ execution_cleanup_ccg,
+    /* .accumulator_bits_per_vertex = */ execution_accumulator_bits_per_vertex_ccg,
+    /* .initialize_frontier_has_info = */ execution_initialize_frontier_has_info_ccg,
+    /* .initialize_frontier_wants_info = */ execution_initialize_frontier_wants_info_ccg,
+    /* .initialize_vertex_accum = */ execution_initialize_vertex_accum_ccg,
+    /* .initialize_vertex_prop = */ execution_initialize_vertex_prop_ccg,
+    /* .scalar_reduce_op = */ execution_scalar_reduce_op_ccg,
+    /* .impl = */ execution_impl_ccg
+};
@@ -0,0 +1,367 @@
+/*****************************************************************************
+* Grazelle
+*      High performance, hardware-optimized graph processing engine.
+*      Targets a single machine with one or more x86-based sockets.
+*****************************************************************************
+* Authored by Samuel Grossman
+* Department of Electrical Engineering, Stanford University
+* (c) 2015-2018
+*****************************************************************************
+* execution_msbfs.c
+*      Implementation of the algorithm control flow for Multi-Source BFS,
+*      which runs a batch of Breadth-First Searches at once by keeping
+*      a bit-mask of searches for each vertex.
+*****************************************************************************/
+
+#include "benchmark.h"
+#include "cmdline.h"
+#include "engineselect.h"
+#include "execution.h"
+#include "graphdata.h"
+#include "numanodes.h"
+#include "phases.h"
+#include "scheduler.h"
+#include "threads.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/* -------- ALGORITHM PARAMETERS ------------------------------------------- */
+
+// Number of searches run at once in each batch, one per bit of each vertex property and accumulator.
+#define MSBFS_BATCH_SIZE                        64ull
+
+
+/* -------- LOCALS --------------------------------------------------------- */
+
+// Size of the reduce buffer for inter-phase and inter-thread communication. Measured in number of elements.
+static uint64_t sz_reduce_buffer;
+
+// Pointer to the reduce buffer itself.
+static uint64_t* reduce_buffer;
+
+
+/* -------- INTERNAL FUNCTIONS --------------------------------------------- */
+
+// Prepares the search state for a new batch of searches, in parallel, with each thread handling its own part of the frontier.
+// The searches that have reached each vertex are cleared, as are the totals if requested, and every vertex wants information again.
+// The previous batch, if any, leaves the vertex properties, the accumulators, and HasInfo empty, since it ends only once no vertex is in the frontier of any search.
+static void execution_msbfs_reset_search_state(const uint32_t with_totals)
+{
+    const uint64_t num_threads = (uint64_t)threads_get_total_threads();
+    const uint64_t thread_id = (uint64_t)threads_get_global_thread_id();
+    const uint64_t frontier_count = (graph_num_vertices >> 6ull) + (graph_num_vertices & 63ull ? 1ull : 0ull);
+    const uint64_t first_element = frontier_count * thread_id / num_threads;
+    const uint64_t last_element = frontier_count * (thread_id + 1ull) / num_threads;
+
+    for (uint64_t i = first_element; i < last_element; ++i)
+    {
+        graph_frontier_wants_info[i] = execution_algorithm->initialize_frontier_wants_info(i << 6ull);
+    }
+
+    for (uint64_t v = (first_element << 6ull); v < (last_element << 6ull) && v < graph_num_vertices; ++v)
+    {
+        graph_vertex_search_state[GRAPH_SEARCH_STATE_WORDS * v] = 0ull;
+
+        if (with_totals)
+        {
+            for (uint64_t j = 1ull; j < GRAPH_SEARCH_STATE_WORDS; ++j)
+            {
+                graph_vertex_search_state[(GRAPH_SEARCH_STATE_WORDS * v) + j] = 0ull;
+            }
+        }
+    }
+}
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+// See "execution.h" for documentation.
+
+void execution_init_msbfs()
+{
+    const cmdline_opts_t* cmdline_settings = cmdline_get_current_settings();
+
+    sz_reduce_buffer = cmdline_settings->num_threads + (8 - (cmdline_settings->num_threads % 8));
+    reduce_buffer = numanodes_malloc(sizeof(double) * sz_reduce_buffer, cmdline_settings->numa_nodes[0]);
+
+    for (uint64_t i = 0; i < sz_reduce_buffer; ++i) reduce_buffer[i] = 0ull;
+}
+
+// ---------
+
+void execution_cleanup_msbfs()
+{
+    numanodes_free((void *)reduce_buffer, sizeof(double) * sz_reduce_buffer);
+}
+
+// ---------
+
+uint64_t execution_accumulator_bits_per_vertex_msbfs()
+{
+    // each accumulator is a bit-mask of the searches that reach the vertex next, one bit per search in the batch
+    return MSBFS_BATCH_SIZE;
+}
+
+// ---------
+
+uint64_t execution_initialize_frontier_has_info_msbfs(const uint64_t base)
+{
+    // search roots are added to the frontier when each batch starts
+    return 0ull;
+}
+
+// ---------
+
+uint64_t execution_initialize_frontier_wants_info_msbfs(const uint64_t base)
+{
+    // all vertices want info until every search in the batch has reached them
+    return ~0ull;
+}
+
+// ---------
+
+double execution_initialize_vertex_accum_msbfs(const uint64_t id)
+{
+    // all bits clear, meaning no searches
+    return 0.0;
+}
+
+// ---------
+
+double execution_initialize_vertex_prop_msbfs(const uint64_t id)
+{
+    // all bits clear, meaning no searches
+    return 0.0;
+}
+
+// ---------
+
+double execution_scalar_reduce_op_msbfs(const double a, const double b)
+{
+    // partial values are bit-masks of searches, which are combined by bitwise-OR
+    uint64_t a_bits, b_bits;
+    double result;
+
+    memcpy(&a_bits, &a, sizeof(a_bits));
+    memcpy(&b_bits, &b, sizeof(b_bits));
+    a_bits |= b_bits;
+    memcpy(&result, &a_bits, sizeof(result));
+
+    return result;
+}
+
+// ---------
+
+void execution_impl_msbfs(void* unused_arg)
+{
+    uint64_t num_iterations_used_gather = 0ull;
+    uint64_t num_iterations_used_scatter = 0ull;
+
+    uint64_t ctr = 0ull;
+
+#ifdef EXPERIMENT_ITERATION_PROFILE
+    uint64_t iteration_time = 0ull;
+    double iteration_frontier_comparator = (double)graph_num_edges;
+#ifdef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+    iteration_frontier_comparator = (double)graph_num_vertices;
+#endif
+#endif
+
+    for (uint64_t batch_first = 0ull; batch_first < execution_num_search_roots; batch_first += MSBFS_BATCH_SIZE)
+    {
+        const uint64_t batch_size = ((execution_num_search_roots - batch_first) < MSBFS_BATCH_SIZE ? (execution_num_search_roots - batch_first) : MSBFS_BATCH_SIZE);
+        const uint64_t batch_mask = ((MSBFS_BATCH_SIZE == batch_size) ? ~0ull : ((1ull << batch_size) - 1ull));
+
+        // the Vertex phase receives the current search level, which is the distance to every vertex that searches reach in the current iteration, along with the batch mask
+        uint64_t vertex_phase_params[2] = { 0ull, batch_mask };
+
+        uint64_t converge_vote = 0ull;
+
+        /* Batch Initialization */
+
+        // totals are kept over all batches, so they are cleared only before the first one
+        execution_msbfs_reset_search_state(0ull == batch_first);
+        threads_barrier();
+
+        // only the master thread has to do this, but each search starts with its root in its frontier, having reached it at a distance of 0
+        if (0 == threads_get_global_thread_id())
+        {
+            uint64_t* const vertex_props = (uint64_t*)graph_vertex_props;
+
+            for (uint64_t i = 0ull; i < batch_size; ++i)
+            {
+                const uint64_t root = execution_search_roots[batch_first + i];
+
+                vertex_props[root] |= (1ull << i);
+                graph_vertex_search_state[GRAPH_SEARCH_STATE_WORDS * root] |= (1ull << i);
+                graph_vertex_search_state[(GRAPH_SEARCH_STATE_WORDS * root) + 1ull] += 1ull;
+                graph_frontier_has_info[root >> 6ull] |= (1ull << (root & 63ull));
+            }
+
+            for (uint64_t i = 0ull; i < batch_size; ++i)
+            {
+                const uint64_t root = execution_search_roots[batch_first + i];
+
+                if (batch_mask == graph_vertex_search_state[GRAPH_SEARCH_STATE_WORDS * root])
+                {
+                    graph_frontier_wants_info[root >> 6ull] &= ~(1ull << (root & 63ull));
+                }
+            }
+        }
+
+        // every thread estimates the size of the initial frontier the same way, counting a root once for each search that starts there
+        for (uint64_t i = 0ull; i < batch_size; ++i)
+        {
+#ifndef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+            converge_vote += (uint64_t)graph_vertex_outdegrees[execution_search_roots[batch_first + i]];
+#endif
+#ifndef EXPERIMENT_THRESHOLD_WITHOUT_COUNT
+            converge_vote += 1ull;
+#endif
+        }
+
+        threads_barrier();
+
+        while(1)
+        {
+            ctr += 1ull;
+            vertex_phase_params[0] += 1ull;
+
+#if defined(EXPERIMENT_EDGE_FORCE_PULL)
+            const uint8_t use_gather_for_processing = 1;
+#elif defined(EXPERIMENT_EDGE_FORCE_PUSH)
+            const uint8_t use_gather_for_processing = 0;
+#else
+#ifdef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+            // without using outdegrees, the condition is based on the number of vertices
+            // converge_vote gets set to the number of vertices that "have info"
+            const uint64_t engine_threshold = (graph_num_vertices / 2ull);
+#else
+            // when using outdegrees, the condition is based on the number of edges
+            // converge_vote gets set to the number of vertices that "have info" plus their outdegrees
+            const uint64_t engine_threshold = (graph_num_edges / 5ull);
+#endif
+
+            // dynamically select an engine (either Push or Pull) depending on some condition
+            // the frontier counts each vertex once no matter how many searches include it, since one pass over its edges advances all of them
+            // the adaptive method instead picks the engine predicted to be cheaper, based on the measured cost of previous iterations
+            const uint8_t use_gather_for_processing = engineselect_use_pull(converge_vote, engine_threshold);
+#endif
+
+            /* Edge Phase */
+
+            engineselect_edge_phase_start();
+
+#ifdef EXPERIMENT_ITERATION_PROFILE
+            if (0 == threads_get_global_thread_id())
+            {
+                iteration_time = benchmark_rdtsc();
+            }
+#endif
+
+            if (use_gather_for_processing)
+            {
+                // if the threshold is met, use the Pull engine to do this round of processing
+                num_iterations_used_gather += 1ull;
+
+                // perform the Edge-Pull phase
+                perform_edge_pull_phase(graph_edges_gather_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_gather_list_block_counts_numa[threads_get_thread_group_id()][0]);
+                scheduler_steal_edge_pull_work(NULL);
+                threads_barrier();
+
+#if !defined(EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE)
+                // first thread performs the actual merge operation between potentially-overlapping accumulators
+                if (0 == threads_get_global_thread_id())
+                {
+                    edge_pull_op_merge_with_merge_buffer(graph_vertex_merge_buffer, sched_pull_units_total, graph_vertex_accumulators);
+                }
+
+                threads_merge_barrier();
+#endif
+            }
+            else
+            {
+                // otherwise, use the Edge-Push phase to do this round of processing
+                num_iterations_used_scatter += 1ull;
+
+                // list the active vertices so the Edge-Push phase can skip directly between them
+                edge_push_op_build_frontier_queue(graph_frontier_has_info);
+
+                // perform the Edge-Push phase
+                perform_edge_push_phase(graph_edges_scatter_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_scatter_list_block_counts_numa[threads_get_thread_group_id()][0]);
+                scheduler_steal_edge_push_work(NULL);
+                threads_barrier();
+            }
+
+            engineselect_edge_phase_end(use_gather_for_processing, converge_vote);
+
+
+            /* Vertex Phase */
+
+            // reset the global variable accumulator
+            phase_op_reset_global_accum();
+
+            // perform the Vertex phase
+            // its job is to turn the searches that reached each vertex into the next frontier, keeping only those new to the vertex, and to update the search state
+            perform_vertex_phase(graph_vertex_first_numa[threads_get_thread_group_id()], graph_vertex_count_numa[threads_get_thread_group_id()], vertex_phase_params);
+
+            // each thread would have a partial value for the global variable which represents the number of vertices in the next frontier
+            // therefore, each thread should write the partial value to the reduce buffer
+            phase_op_write_global_accum_to_buf(reduce_buffer);
+
+            threads_barrier();
+
+#ifdef EXPERIMENT_ITERATION_PROFILE
+            if (0 == threads_get_global_thread_id())
+            {
+                iteration_time = benchmark_rdtsc() - iteration_time;
+                fprintf(stderr, "%llu,%s,%llu,%.10lf\n", (long long unsigned int)ctr, (use_gather_for_processing ? "Pull" : "Push"), (long long unsigned int)iteration_time, (double)converge_vote / iteration_frontier_comparator);
+            }
+
+            threads_barrier();
+#endif
+
+            /* Termination Check */
+
+            // get the number of vertices in the frontier of at least one search
+            // if that number is 0, every search in the batch is complete
+            converge_vote = phase_op_combine_global_var_from_buf(reduce_buffer);
+            if (0 == converge_vote)
+                break;
+        }
+    }
+
+    // algorithm complete, record the number of iterations run of each type
+    if (0 == threads_get_global_thread_id())
+    {
+        total_iterations_executed = ctr;
+        total_iterations_used_gather = num_iterations_used_gather;
+        total_iterations_used_scatter = num_iterations_used_scatter;
+    }
+}
+
+
+/* -------- ALGORITHM DEFINITION ------------------------------------------- */
+// See "execution.h" for documentation.
+
+const execution_algorithm_t execution_algorithm_msbfs = {
+    .name = "msbfs",
+    .display_name = "Multi-Source BFS",
+    .converges_dynamically = 1,
+    .output_type = EXECUTION_OUTPUT_SEARCH_TOTALS,
+    .single_precision = 0,
+    .uses_edge_weights = 0,
+    .search_roots = EXECUTION_SEARCH_ROOTS_ALL,
+    .vertex_id_props = 0,
+    .init = execution_init_msbfs,
+    .cleanup = execution_cleanup_msbfs,
+    .accumulator_bits_per_vertex = execution_accumulator_bits_per_vertex_msbfs,
+    .initialize_frontier_has_info = execution_initialize_frontier_has_info_msbfs,
+    .initialize_frontier_wants_info = execution_initialize_frontier_wants_info_msbfs,
+    .initialize_vertex_accum = execution_initialize_vertex_accum_msbfs,
+    .initialize_vertex_prop = execution_initialize_vertex_prop_msbfs,
+    .scalar_reduce_op = execution_scalar_reduce_op_msbfs,
+    .impl = execution_impl_msbfs
+};
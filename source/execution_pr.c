@@ -8,7 +8,8 @@
 * (c) 2015-2018
 *****************************************************************************
 * execution_pr.c
-*      Implementation of the algorithm control flow for PageRank.
+*      Implementation of the algorithm control flow for PageRank, in both
+*      double and single precision.
 *****************************************************************************/
 
 #include "cmdline.h"
@@ -28,7 +29,28 @@
 static uint64_t sz_reduce_buffer;
 
 // Pointer to the reduce buffer itself.
-static uint64_t* reduce_buffer;
+static uint64_t* reduce_buffer = NULL;
+
+// Pointer to the residual buffer, which receives each thread's part of the residual from the Vertex phase. Same size as the reduce buffer.
+static double* residual_buffer = NULL;
+
+
+/* -------- INTERNAL FUNCTIONS --------------------------------------------- */
+
+#ifndef EXPERIMENT_EDGE_ONLY
+// Combines each thread's part of the residual, which is the L1 norm of the change in all ranks during the last iteration.
+static double execution_pr_combine_residual()
+{
+    double residual = 0.0;
+    
+    for (uint32_t i = 0; i < threads_get_total_threads(); ++i)
+    {
+        residual += residual_buffer[i];
+    }
+    
+    return residual;
+}
+#endif
 
 
 /* -------- FUNCTIONS ------------------------------------------------------ */
@@ -38,17 +60,31 @@ void execution_init_pr()
 {
     const cmdline_opts_t* cmdline_settings = cmdline_get_current_settings();
     
+    // both precisions share the reduce buffer, so it only needs to be allocated once
+    if (NULL != reduce_buffer)
+    {
+        return;
+    }
+    
     sz_reduce_buffer = cmdline_settings->num_threads + (8 - (cmdline_settings->num_threads % 8));
     reduce_buffer = numanodes_malloc(sizeof(double) * sz_reduce_buffer, cmdline_settings->numa_nodes[0]);
+    residual_buffer = numanodes_malloc(sizeof(double) * sz_reduce_buffer, cmdline_settings->numa_nodes[0]);
     
     for (uint64_t i = 0; i < sz_reduce_buffer; ++i) reduce_buffer[i] = 0;
+    for (uint64_t i = 0; i < sz_reduce_buffer; ++i) residual_buffer[i] = 0.0;
 }
 
 // ---------
 
 void execution_cleanup_pr()
 {
-    numanodes_free((void *)reduce_buffer, sizeof(double) * sz_reduce_buffer);
+    if (NULL != reduce_buffer)
+    {
+        numanodes_free((void *)reduce_buffer, sizeof(double) * sz_reduce_buffer);
+        numanodes_free((void *)residual_buffer, sizeof(double) * sz_reduce_buffer);
+        reduce_buffer = NULL;
+        residual_buffer = NULL;
+    }
 }
 
 // ---------
@@ -61,6 +97,14 @@ uint64_t execution_accumulator_bits_per_vertex_pr()
 
 // ---------
 
+uint64_t execution_accumulator_bits_per_vertex_prf()
+{
+    // the accumulator stores a full vertex property, but in single precision
+    return 8ull * sizeof(float);
+}
+
+// ---------
+
 uint64_t execution_initialize_frontier_has_info_pr(const uint64_t base)
 {
     return ~0ull;
@@ -89,6 +133,14 @@ double execution_initialize_vertex_prop_pr(const uint64_t id)
 
 // ---------
 
+double execution_scalar_reduce_op_pr(const double a, const double b)
+{
+    // partial ranks are combined by summing them
+    return a + b;
+}
+
+// ---------
+
 void execution_impl_pr(void* unused_arg)
 {
     uint64_t num_iterations_used_gather = 0ull;
@@ -96,8 +148,21 @@ void execution_impl_pr(void* unused_arg)
     
     uint64_t ctr = 0ull;
     
-    for (ctr = 0; ctr < cmdline_get_current_settings()->num_iterations; ++ctr)
+    // with a tolerance, the Vertex phase also computes the residual, and iterations stop once it falls below the tolerance
+    // the number of iterations then serves as a limit, which has a default if not specified
+    double residual = -1.0;
+    
+#ifndef EXPERIMENT_EDGE_ONLY
+    const double tolerance = cmdline_get_current_settings()->tolerance;
+    
+    // the Vertex phase receives the reduce buffer, followed by the residual buffer if it should compute the residual
+    const uint64_t vertex_phase_params[2] = { (uint64_t)reduce_buffer, (0.0 < tolerance ? (uint64_t)residual_buffer : 0ull) };
+#endif
+    
+    while (ctr < cmdline_get_current_settings()->num_iterations)
     {
+        ctr += 1ull;
+        
 #ifndef EXPERIMENT_VERTEX_ONLY
         /* Edge Phase */
         
@@ -110,6 +175,13 @@ void execution_impl_pr(void* unused_arg)
         
         // perform the Edge-Pull phase
         perform_edge_pull_phase(graph_edges_gather_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_gather_list_block_counts_numa[threads_get_thread_group_id()][0]);
+        
+        // now that the Edge-Pull phase is over, each thread must write its partial PageRank sum to the reduce buffer
+        // then, during the combine phase initialization, they will all compute the constant PageRank offset to apply to each vertex's rank
+        // this happens right away, since the global variable accumulator is not preserved across calls to functions written in C, such as work stealing and the merge below
+        // any units the thread steals add to the value in the reduce buffer
+        phase_op_write_global_accum_to_buf(reduce_buffer);
+        scheduler_steal_edge_pull_work(reduce_buffer);
         threads_barrier();
         
 #if !defined(EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE)
@@ -118,13 +190,7 @@ void execution_impl_pr(void* unused_arg)
         {
             edge_pull_op_merge_with_merge_buffer(graph_vertex_merge_buffer, sched_pull_units_total, graph_vertex_accumulators);
         }
-#endif
         
-        // now that the Edge-Pull phase is over, each thread must write its partial PageRank sum to the reduce buffer
-        // then, during the combine phase initialization, they will all compute the constant PageRank offset to apply to each vertex's rank
-        phase_op_write_global_accum_to_buf(reduce_buffer);
-        
-#if !defined(EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE)
         threads_merge_barrier();
 #else
         threads_barrier();
@@ -138,12 +204,12 @@ void execution_impl_pr(void* unused_arg)
         
         // perform the Edge-Push phase
         perform_edge_push_phase(graph_edges_scatter_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_scatter_list_block_counts_numa[threads_get_thread_group_id()][0]);
-        threads_barrier();
         
         // now that the Scatter phase is over, each thread must write its partial PageRank sum to the reduce buffer
         // then, during the combine phase initialization, they will all compute the constant PageRank offset to apply to each vertex's rank
+        // any units the thread steals add to the value in the reduce buffer
         phase_op_write_global_accum_to_buf(reduce_buffer);
-        
+        scheduler_steal_edge_push_work(reduce_buffer);
         threads_barrier();
 #endif
         
@@ -152,9 +218,19 @@ void execution_impl_pr(void* unused_arg)
         /* Vertex Phase */
         
         // perform the Vertex phase
-        perform_vertex_phase(graph_vertex_first_numa[threads_get_thread_group_id()], graph_vertex_count_numa[threads_get_thread_group_id()], reduce_buffer);
+        perform_vertex_phase(graph_vertex_first_numa[threads_get_thread_group_id()], graph_vertex_count_numa[threads_get_thread_group_id()], vertex_phase_params);
         
         threads_barrier();
+        
+        /* Termination Check */
+        
+        // every thread combines the same parts of the residual, so they all agree on whether to stop
+        if (0.0 < tolerance)
+        {
+            residual = execution_pr_combine_residual();
+            if (residual < tolerance)
+                break;
+        }
 #endif
     }
     
@@ -164,5 +240,52 @@ void execution_impl_pr(void* unused_arg)
         total_iterations_executed = ctr;
         total_iterations_used_gather = num_iterations_used_gather;
         total_iterations_used_scatter = num_iterations_used_scatter;
+        total_residual = residual;
     }
 }
+
+
+/* -------- ALGORITHM DEFINITION ------------------------------------------- */
+// See "execution.h" for documentation.
+
+const execution_algorithm_t execution_algorithm_pr = {
+    .name = "pr",
+    .display_name = "PageRank",
+    .converges_dynamically = 0,
+    .output_type = EXECUTION_OUTPUT_RANK,
+    .single_precision = 0,
+    .uses_edge_weights = 0,
+    .search_roots = EXECUTION_SEARCH_ROOTS_NONE,
+    .vertex_id_props = 0,
+    .init = execution_init_pr,
+    .cleanup = execution_cleanup_pr,
+    .accumulator_bits_per_vertex = execution_accumulator_bits_per_vertex_pr,
+    .initialize_frontier_has_info = execution_initialize_frontier_has_info_pr,
+    .initialize_frontier_wants_info = execution_initialize_frontier_wants_info_pr,
+    .initialize_vertex_accum = execution_initialize_vertex_accum_pr,
+    .initialize_vertex_prop = execution_initialize_vertex_prop_pr,
+    .scalar_reduce_op = execution_scalar_reduce_op_pr,
+    .impl = execution_impl_pr
+};
+
+// Single-precision PageRank follows exactly the same sequence of phases, so only the phase control functions and the layout of the vertex arrays differ.
+// The global rank total used to correct for sink vertices is still accumulated in double precision, which keeps the total rank from drifting over many iterations.
+const execution_algorithm_t execution_algorithm_prf = {
+    .name = "prf",
+    .display_name = "PageRank (Single Precision)",
+    .converges_dynamically = 0,
+    .output_type = EXECUTION_OUTPUT_RANK,
+    .single_precision = 1,
+    .uses_edge_weights = 0,
+    .search_roots = EXECUTION_SEARCH_ROOTS_NONE,
+    .vertex_id_props = 0,
+    .init = execution_init_pr,
+    .cleanup = execution_cleanup_pr,
+    .accumulator_bits_per_vertex = execution_accumulator_bits_per_vertex_prf,
+    .initialize_frontier_has_info = execution_initialize_frontier_has_info_pr,
+    .initialize_frontier_wants_info = execution_initialize_frontier_wants_info_pr,
+    .initialize_vertex_accum = execution_initialize_vertex_accum_pr,
+    .initialize_vertex_prop = execution_initialize_vertex_prop_pr,
+    .scalar_reduce_op = execution_scalar_reduce_op_pr,
+    .impl = execution_impl_pr
+};
@@ -0,0 +1,368 @@
+/*****************************************************************************
+* Grazelle
+*      High performance, hardware-optimized graph processing engine.
+*      Targets a single machine with one or more x86-based sockets.
+*****************************************************************************
+* Authored by Samuel Grossman
+* Department of Electrical Engineering, Stanford University
+* (c) 2015-2018
+*****************************************************************************
+* execution_prd.c
+*      Implementation of the algorithm control flow for Delta PageRank,
+*      which propagates only changes in rank large enough to matter.
+*****************************************************************************/
+
+#include "benchmark.h"
+#include "cmdline.h"
+#include "engineselect.h"
+#include "execution.h"
+#include "graphdata.h"
+#include "numanodes.h"
+#include "phases.h"
+#include "scheduler.h"
+#include "threads.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+
+/* -------- ALGORITHM PARAMETERS ------------------------------------------- */
+
+// Tolerance used if none is specified. A vertex stays active while its rank changes by more than the tolerance divided by the number of vertices.
+#define PRD_DEFAULT_TOLERANCE                   1e-6
+
+
+/* -------- TYPE DEFINITIONS ----------------------------------------------- */
+
+// Parameters passed to the Vertex phase in place of the reduce buffer.
+typedef struct prd_vertex_params_t
+{
+    double sink_correction;                                             // change in rank of active sink vertices in the previous iteration, divided by the number of vertices
+    double epsilon;                                                     // amount by which a vertex's rank must change for the vertex to be active
+    double teleport_weight;                                             // weight of the (1 - d) / V term, which is 1 in the first iteration and 0 afterwards
+    double* ranks;                                                      // rank of each vertex, to which each iteration adds the change in rank
+    double* sink_delta_buffer;                                          // receives the change in rank of active sink vertices, one element per thread
+} prd_vertex_params_t;
+
+
+/* -------- LOCALS --------------------------------------------------------- */
+
+// Size of the reduce buffer for inter-phase and inter-thread communication. Measured in number of elements.
+static uint64_t sz_reduce_buffer;
+
+// Pointer to the reduce buffer itself.
+static uint64_t* reduce_buffer;
+
+// Pointer to the buffer that receives each thread's part of the change in rank of active sink vertices. Same size as the reduce buffer.
+static double* sink_delta_buffer;
+
+// Rank of each vertex, allocated for the duration of each run, since the vertex properties hold the change in rank to propagate instead.
+static double* vertex_ranks;
+
+
+/* -------- INTERNAL FUNCTIONS --------------------------------------------- */
+
+// Combines each thread's part of the change in rank of active sink vertices.
+static double execution_prd_combine_sink_delta()
+{
+    double sink_delta = 0.0;
+    
+    for (uint32_t i = 0; i < threads_get_total_threads(); ++i)
+    {
+        sink_delta += sink_delta_buffer[i];
+    }
+    
+    return sink_delta;
+}
+
+// Runs the Vertex phase and returns the number of active vertices it produced, possibly along with their outdegrees, as seen by every thread.
+static uint64_t execution_prd_vertex_phase(const prd_vertex_params_t* vertex_phase_params)
+{
+    // reset the global variable accumulator
+    phase_op_reset_global_accum();
+    
+    // perform the Vertex phase
+    // its job is to apply the change in each vertex's rank and send it onwards only from vertices whose ranks changed enough
+    perform_vertex_phase(graph_vertex_first_numa[threads_get_thread_group_id()], graph_vertex_count_numa[threads_get_thread_group_id()], (const uint64_t*)vertex_phase_params);
+    
+    // each thread would have a partial value for the global variable which represents the number of active vertices
+    // therefore, each thread should write the partial value to the reduce buffer
+    phase_op_write_global_accum_to_buf(reduce_buffer);
+    
+    threads_barrier();
+    
+    return phase_op_combine_global_var_from_buf(reduce_buffer);
+}
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+// See "execution.h" for documentation.
+
+void execution_init_prd()
+{
+    const cmdline_opts_t* cmdline_settings = cmdline_get_current_settings();
+    
+    sz_reduce_buffer = cmdline_settings->num_threads + (8 - (cmdline_settings->num_threads % 8));
+    reduce_buffer = numanodes_malloc(sizeof(double) * sz_reduce_buffer, cmdline_settings->numa_nodes[0]);
+    sink_delta_buffer = numanodes_malloc(sizeof(double) * sz_reduce_buffer, cmdline_settings->numa_nodes[0]);
+    
+    for (uint64_t i = 0; i < sz_reduce_buffer; ++i) reduce_buffer[i] = 0;
+    for (uint64_t i = 0; i < sz_reduce_buffer; ++i) sink_delta_buffer[i] = 0.0;
+}
+
+// ---------
+
+void execution_cleanup_prd()
+{
+    numanodes_free((void *)reduce_buffer, sizeof(double) * sz_reduce_buffer);
+    numanodes_free((void *)sink_delta_buffer, sizeof(double) * sz_reduce_buffer);
+}
+
+// ---------
+
+uint64_t execution_accumulator_bits_per_vertex_prd()
+{
+    // the accumulator stores a full vertex property, which is the sum of the changes in rank sent to the vertex
+    return 8ull * sizeof(double);
+}
+
+// ---------
+
+uint64_t execution_initialize_frontier_has_info_prd(const uint64_t base)
+{
+    // the first iteration activates vertices without using the frontier
+    return 0ull;
+}
+
+// ---------
+
+uint64_t execution_initialize_frontier_wants_info_prd(const uint64_t base)
+{
+    // any vertex can receive a change in rank in any iteration
+    return ~0ull;
+}
+
+// ---------
+
+double execution_initialize_vertex_accum_prd(const uint64_t id)
+{
+    return 0.0;
+}
+
+// ---------
+
+double execution_initialize_vertex_prop_prd(const uint64_t id)
+{
+    // no changes in rank to send until the first iteration
+    return 0.0;
+}
+
+// ---------
+
+double execution_scalar_reduce_op_prd(const double a, const double b)
+{
+    // partial changes in rank are combined by summing them
+    return a + b;
+}
+
+// ---------
+
+void execution_impl_prd(void* unused_arg)
+{
+    const cmdline_opts_t* cmdline_settings = cmdline_get_current_settings();
+    
+    uint64_t num_iterations_used_gather = 0ull;
+    uint64_t num_iterations_used_scatter = 0ull;
+    
+    uint64_t ctr = 0ull;
+    
+#ifdef EXPERIMENT_ITERATION_PROFILE
+    uint64_t iteration_time = 0ull;
+    double iteration_frontier_comparator = (double)graph_num_edges;
+#ifdef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+    iteration_frontier_comparator = (double)graph_num_vertices;
+#endif
+#endif
+
+    prd_vertex_params_t vertex_phase_params;
+    uint64_t converge_vote = 0ull;
+    
+    /* Initialization */
+    
+    // only the master thread has to do this, but the ranks are allocated like the other vertex arrays, with each NUMA node getting the part corresponding to its assigned vertices
+    if (0 == threads_get_global_thread_id())
+    {
+        vertex_ranks = (double*)numanodes_malloc_divisible(sizeof(double) * (graph_num_vertices + 8ull), cmdline_settings->numa_nodes[0], graph_data_vertex_array_granularity(64ull));
+    
+        for (uint32_t i = 1; i < cmdline_settings->num_numa_nodes; ++i)
+        {
+            numanodes_tonode_buffer(&vertex_ranks[graph_vertex_first_numa[i]], sizeof(double) * graph_vertex_count_numa[i], cmdline_settings->numa_nodes[i]);
+        }
+    
+        for (uint64_t i = 0ull; i < (graph_num_vertices + 8ull); ++i)
+        {
+            vertex_ranks[i] = 0.0;
+        }
+    }
+    
+    threads_barrier();
+    
+    vertex_phase_params.sink_correction = 0.0;
+    vertex_phase_params.epsilon = ((0.0 < cmdline_settings->tolerance) ? cmdline_settings->tolerance : PRD_DEFAULT_TOLERANCE) / (double)graph_num_vertices;
+    vertex_phase_params.ranks = vertex_ranks;
+    vertex_phase_params.sink_delta_buffer = sink_delta_buffer;
+    
+    // the first iteration has no Edge phase, since every rank starts at 0 and changes by (1 - d) / V
+    vertex_phase_params.teleport_weight = 1.0;
+    converge_vote = execution_prd_vertex_phase(&vertex_phase_params);
+    vertex_phase_params.teleport_weight = 0.0;
+    
+    while (0ull != converge_vote)
+    {
+        ctr += 1ull;
+    
+#if defined(EXPERIMENT_EDGE_FORCE_PULL)
+        const uint8_t use_gather_for_processing = 1;
+#elif defined(EXPERIMENT_EDGE_FORCE_PUSH)
+        const uint8_t use_gather_for_processing = 0;
+#else
+#ifdef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+        // without using outdegrees, the condition is based on the number of vertices
+        // converge_vote gets set to the number of active vertices
+        const uint64_t engine_threshold = (graph_num_vertices / 2ull);
+#else
+        // when using outdegrees, the condition is based on the number of edges
+        // converge_vote gets set to the number of active vertices plus their outdegrees
+        const uint64_t engine_threshold = (graph_num_edges / 5ull);
+#endif
+
+        // dynamically select an engine (either Push or Pull) depending on some condition
+        // early on nearly every vertex is active, so Pull is best, but as ranks settle the frontier shrinks and Push skips the vertices with nothing to send
+        // the adaptive method instead picks the engine predicted to be cheaper, based on the measured cost of previous iterations
+        const uint8_t use_gather_for_processing = engineselect_use_pull(converge_vote, engine_threshold);
+#endif
+
+        /* Edge Phase */
+    
+        engineselect_edge_phase_start();
+    
+#ifdef EXPERIMENT_ITERATION_PROFILE
+        if (0 == threads_get_global_thread_id())
+        {
+            iteration_time = benchmark_rdtsc();
+        }
+#endif
+
+        if (use_gather_for_processing)
+        {
+            // if the threshold is met, use the Pull engine to do this round of processing
+            num_iterations_used_gather += 1ull;
+    
+            // perform the Edge-Pull phase
+            // inactive vertices send a change in rank of 0, so this is the same as for PageRank
+            perform_edge_pull_phase(graph_edges_gather_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_gather_list_block_counts_numa[threads_get_thread_group_id()][0]);
+            scheduler_steal_edge_pull_work(NULL);
+            threads_barrier();
+    
+#if !defined(EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE)
+            // first thread performs the actual merge operation between potentially-overlapping accumulators
+            if (0 == threads_get_global_thread_id())
+            {
+                edge_pull_op_merge_with_merge_buffer(graph_vertex_merge_buffer, sched_pull_units_total, graph_vertex_accumulators);
+            }
+    
+            threads_merge_barrier();
+#endif
+        }
+        else
+        {
+            // otherwise, use the Edge-Push phase to do this round of processing
+            num_iterations_used_scatter += 1ull;
+    
+            // list the active vertices so the Edge-Push phase can skip directly between them
+            edge_push_op_build_frontier_queue(graph_frontier_has_info);
+    
+            // perform the Edge-Push phase
+            perform_edge_push_phase(graph_edges_scatter_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_scatter_list_block_counts_numa[threads_get_thread_group_id()][0]);
+            scheduler_steal_edge_push_work(NULL);
+            threads_barrier();
+        }
+    
+        engineselect_edge_phase_end(use_gather_for_processing, converge_vote);
+
+
+        /* Vertex Phase */
+    
+        // the change in rank of active sink vertices in the previous iteration is spread over all vertices
+        vertex_phase_params.sink_correction = execution_prd_combine_sink_delta() / (double)graph_num_vertices;
+    
+        // every thread needs the previous iteration's sink vertex correction before any thread can overwrite it
+        threads_barrier();
+    
+        // the number of active vertices also decides when to stop, which is once no rank changes by enough to matter
+        converge_vote = execution_prd_vertex_phase(&vertex_phase_params);
+    
+#ifdef EXPERIMENT_ITERATION_PROFILE
+        if (0 == threads_get_global_thread_id())
+        {
+            iteration_time = benchmark_rdtsc() - iteration_time;
+            fprintf(stderr, "%llu,%s,%llu,%.10lf\n", (long long unsigned int)ctr, (use_gather_for_processing ? "Pull" : "Push"), (long long unsigned int)iteration_time, (double)converge_vote / iteration_frontier_comparator);
+        }
+    
+        threads_barrier();
+#endif
+
+    }
+    
+    /* Output */
+    
+    // the vertex properties must hold ranks divided by outdegrees, like for PageRank, so each thread converts its own part of the ranks
+    {
+        const uint64_t num_threads = (uint64_t)threads_get_total_threads();
+        const uint64_t thread_id = (uint64_t)threads_get_global_thread_id();
+        const uint64_t first_vertex = graph_num_vertices * thread_id / num_threads;
+        const uint64_t last_vertex = graph_num_vertices * (thread_id + 1ull) / num_threads;
+    
+        for (uint64_t v = first_vertex; v < last_vertex; ++v)
+        {
+            graph_vertex_props[v] = vertex_ranks[v] / (0.0 == graph_vertex_outdegrees[v] ? (double)graph_num_vertices : graph_vertex_outdegrees[v]);
+        }
+    }
+    
+    threads_barrier();
+    
+    // algorithm complete, record the number of iterations run of each type
+    if (0 == threads_get_global_thread_id())
+    {
+        numanodes_free((void*)vertex_ranks, sizeof(double) * (graph_num_vertices + 8ull));
+        vertex_ranks = NULL;
+    
+        total_iterations_executed = ctr;
+        total_iterations_used_gather = num_iterations_used_gather;
+        total_iterations_used_scatter = num_iterations_used_scatter;
+    }
+}
+
+
+/* -------- ALGORITHM DEFINITION ------------------------------------------- */
+// See "execution.h" for documentation.
+
+const execution_algorithm_t execution_algorithm_prd = {
+    .name = "prd",
+    .display_name = "PageRank (Delta)",
+    .converges_dynamically = 1,
+    .output_type = EXECUTION_OUTPUT_RANK,
+    .single_precision = 0,
+    .uses_edge_weights = 0,
+    .search_roots = EXECUTION_SEARCH_ROOTS_NONE,
+    .vertex_id_props = 0,
+    .init = execution_init_prd,
+    .cleanup = execution_cleanup_prd,
+    .accumulator_bits_per_vertex = execution_accumulator_bits_per_vertex_prd,
+    .initialize_frontier_has_info = execution_initialize_frontier_has_info_prd,
+    .initialize_frontier_wants_info = execution_initialize_frontier_wants_info_prd,
+    .initialize_vertex_accum = execution_initialize_vertex_accum_prd,
+    .initialize_vertex_prop = execution_initialize_vertex_prop_prd,
+    .scalar_reduce_op = execution_scalar_reduce_op_prd,
+    .impl = execution_impl_prd
+};
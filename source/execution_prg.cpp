@@ -0,0 +1,187 @@
+/*****************************************************************************
+* Grazelle
+*      High performance, hardware-optimized graph processing engine.
+*      Targets a single machine with one or more x86-based sockets.
+*****************************************************************************
+* Authored by Samuel Grossman
+* Department of Electrical Engineering, Stanford University
+* (c) 2015-2018
+*****************************************************************************
+* execution_prg.cpp
+*      Implementation of PageRank using the Gather-Apply-Scatter interface.
+*      Computes the same ranks as the hand-written PageRank.
+*****************************************************************************/
+
+#include "gas.h"
+
+#include <stdint.h>
+
+
+/* -------- EXTERNALS ------------------------------------------------------ */
+
+// Damping factor used by the hand-written PageRank, one copy per lane.
+extern "C" const double const_damping_factor[4];
+
+
+/* -------- PROGRAM -------------------------------------------------------- */
+
+// PageRank as a Gather-Apply-Scatter program.
+// As in the hand-written PageRank, each vertex property holds the rank divided by the outdegree, which is the message sent along each out-edge.
+// Sink vertices are treated as having an edge to every vertex, so their outdegree is taken to be the number of vertices and the rank they would send is spread evenly using the total of all accumulators.
+struct gas_program_pr_t : gas_program_defaults_t
+{
+    static const uint32_t frontier = GAS_FRONTIER_ALL;
+    static const uint32_t uses_accum_total = 1;
+
+    static inline __m256d identity()
+    {
+        return _mm256_setzero_pd();
+    }
+
+    static inline __m256d gather(const __m256d src_props)
+    {
+        return src_props;
+    }
+
+    static inline __m256d reduce(const __m256d a, const __m256d b)
+    {
+        return _mm256_add_pd(a, b);
+    }
+
+    // Outdegree to divide by, which is the number of vertices for sinks.
+    static inline __m256d adjusted_outdeg(const __m256d outdeg, const gas_globals_t& g)
+    {
+        const __m256d num_vertices = _mm256_set1_pd(g.num_vertices);
+        return _mm256_blendv_pd(outdeg, num_vertices, _mm256_cmp_pd(outdeg, _mm256_setzero_pd(), _CMP_EQ_OQ));
+    }
+
+    static inline __m256d apply(const __m256d accum, const __m256d prop, const __m256d outdeg, const gas_globals_t& g)
+    {
+        const __m256d damping = _mm256_loadu_pd(const_damping_factor);
+        const __m256d num_vertices = _mm256_set1_pd(g.num_vertices);
+        const __m256d sink_correction = _mm256_set1_pd((1.0 - g.accum_total) / g.num_vertices);
+        const __m256d one_minus_d_by_V = _mm256_div_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), damping), num_vertices);
+
+        const __m256d rank = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(accum, sink_correction), damping), one_minus_d_by_V);
+        return _mm256_div_pd(rank, adjusted_outdeg(outdeg, g));
+    }
+
+    static inline __m256d residual(const __m256d new_prop, const __m256d prop, const __m256d outdeg, const gas_globals_t& g)
+    {
+        const __m256d outdeg_adj = adjusted_outdeg(outdeg, g);
+        return gas_program_defaults_t::residual(_mm256_mul_pd(new_prop, outdeg_adj), _mm256_mul_pd(prop, outdeg_adj), outdeg, g);
+    }
+};
+
+
+/* -------- PHASE CONTROL FUNCTIONS ---------------------------------------- */
+// See "phases.h" for documentation.
+
+C_COMPATIBLE_API void __WRITTEN_IN_ASSEMBLY__ perform_edge_pull_phase_prg(const __m256i* edge_list, const uint64_t edge_list_count)
+{
+    gas_edge_pull_phase<gas_program_pr_t>(edge_list, edge_list_count);
+}
+
+// ---------
+
+C_COMPATIBLE_API void __WRITTEN_IN_ASSEMBLY__ perform_edge_push_phase_prg(const __m256i* edge_list, const uint64_t edge_list_count)
+{
+    gas_edge_push_phase<gas_program_pr_t>(edge_list, edge_list_count);
+}
+
+// ---------
+
+C_COMPATIBLE_API void __WRITTEN_IN_ASSEMBLY__ perform_vertex_phase_prg(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer)
+{
+    gas_vertex_phase<gas_program_pr_t>(vertex_start, vertex_count, (const gas_vertex_params_t*)reduce_buffer);
+}
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+// See "execution.h" for documentation.
+
+static void execution_init_prg()
+{
+    gas_init<gas_program_pr_t>();
+}
+
+// ---------
+
+static void execution_cleanup_prg()
+{
+    gas_cleanup<gas_program_pr_t>();
+}
+
+// ---------
+
+static uint64_t execution_accumulator_bits_per_vertex_prg()
+{
+    // the accumulator stores a full vertex property
+    return 8ull * sizeof(double);
+}
+
+// ---------
+
+static uint64_t execution_initialize_frontier_has_info_prg(const uint64_t base)
+{
+    return ~0ull;
+}
+
+// ---------
+
+static uint64_t execution_initialize_frontier_wants_info_prg(const uint64_t base)
+{
+    return ~0ull;
+}
+
+// ---------
+
+static double execution_initialize_vertex_accum_prg(const uint64_t id)
+{
+    return gas_initialize_vertex_accum<gas_program_pr_t>(id);
+}
+
+// ---------
+
+static double execution_initialize_vertex_prop_prg(const uint64_t id)
+{
+    return (1.0 / (double)graph_num_vertices) / (0.0 == graph_vertex_outdegrees[id] ? (double)graph_num_vertices : graph_vertex_outdegrees[id]);
+}
+
+// ---------
+
+static double execution_scalar_reduce_op_prg(const double a, const double b)
+{
+    return gas_scalar_reduce<gas_program_pr_t>(a, b);
+}
+
+// ---------
+
+static void execution_impl_prg(void* unused_arg)
+{
+    gas_impl<gas_program_pr_t>();
+}
+
+
+/* -------- ALGORITHM DEFINITION ------------------------------------------- */
+// See "execution.h" for documentation.
+
+C_COMPATIBLE_API const execution_algorithm_t execution_algorithm_prg = {
+    /* .name = */ "prg",
+    /* .display_name = */ "PageRank (GAS)",
+    /* .converges_dynamically = */ 0,
+    /* .output_type = */ EXECUTION_OUTPUT_RANK,
+    /* .single_precision = */ 0,
+    /* .uses_edge_weights = */ 0,
+    /* .search_roots = */ EXECUTION_SEARCH_ROOTS_NONE,
+    /* .vertex_id_props = */ 0,
+    /* .init = */ execution_init_prg,
+    /* .cleanup = */ execution_cleanup_prg,
+    /* .accumulator_bits_per_vertex = */ execution_accumulator_bits_per_vertex_prg,
+    /* .initialize_frontier_has_info = */ execution_initialize_frontier_has_info_prg,
+    /* .initialize_frontier_wants_info = */ execution_initialize_frontier_wants_info_prg,
+    /* .initialize_vertex_accum = */ execution_initialize_vertex_accum_prg,
+    /* .initialize_vertex_prop = */ execution_initialize_vertex_prop_prg,
+    /* .scalar_reduce_op = */ execution_scalar_reduce_op_prg,
+    /* .impl = */ execution_impl_prg
+};
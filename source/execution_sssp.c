@@ -0,0 +1,326 @@
+/*****************************************************************************
+* Grazelle
+*      High performance, hardware-optimized graph processing engine.
+*      Targets a single machine with one or more x86-based sockets.
+*****************************************************************************
+* Authored by Samuel Grossman
+* Department of Electrical Engineering, Stanford University
+* (c) 2015-2018
+*****************************************************************************
+* execution_sssp.c
+*      Implementation of the algorithm control flow for Single-Source
+*      Shortest Paths, using frontier-driven Bellman-Ford relaxation.
+*****************************************************************************/
+
+#include "benchmark.h"
+#include "cmdline.h"
+#include "engineselect.h"
+#include "execution.h"
+#include "graphdata.h"
+#include "numanodes.h"
+#include "phases.h"
+#include "scheduler.h"
+#include "threads.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+/* -------- LOCALS --------------------------------------------------------- */
+
+// Size of the reduce buffer for inter-phase and inter-thread communication. Measured in number of elements.
+static uint64_t sz_reduce_buffer;
+
+// Pointer to the reduce buffer itself.
+static uint64_t* reduce_buffer;
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+// See "execution.h" for documentation.
+
+void execution_init_sssp()
+{
+    const cmdline_opts_t* cmdline_settings = cmdline_get_current_settings();
+    
+    sz_reduce_buffer = cmdline_settings->num_threads + (8 - (cmdline_settings->num_threads % 8));
+    reduce_buffer = numanodes_malloc(sizeof(double) * sz_reduce_buffer, cmdline_settings->numa_nodes[0]);
+    
+    for (uint64_t i = 0; i < sz_reduce_buffer; ++i) reduce_buffer[i] = 0;
+}
+
+// ---------
+
+void execution_cleanup_sssp()
+{
+    numanodes_free((void *)reduce_buffer, sizeof(double) * sz_reduce_buffer);
+}
+
+// ---------
+
+uint64_t execution_accumulator_bits_per_vertex_sssp()
+{
+    // one bit per vertex is required in the accumulator, which just stores HasInfo*
+    return 1ull;
+}
+
+// ---------
+
+uint64_t execution_initialize_frontier_has_info_sssp(const uint64_t base)
+{
+    const uint64_t top = base + 63ull;
+    const uint64_t search_root = execution_search_root;
+    
+    if (search_root >= base && search_root <= top)
+    {
+        // the search root has info
+        return (1ull << (search_root - base));
+    }
+    else
+    {
+        // all other vertices do not have info
+        return 0ull;
+    }
+}
+
+// ---------
+
+uint64_t execution_initialize_frontier_wants_info_sssp(const uint64_t base)
+{
+    // any vertex might find a shorter path
+    return ~0ull;
+}
+
+// ---------
+
+double execution_initialize_vertex_accum_sssp(const uint64_t id)
+{
+    return 0.0;
+}
+
+// ---------
+
+double execution_initialize_vertex_prop_sssp(const uint64_t id)
+{
+    // the search root is at distance 0 from itself, and all other vertices start out unreachable
+    return ((execution_search_root == id) ? 0.0 : INFINITY);
+}
+
+// ---------
+
+double execution_scalar_reduce_op_sssp(const double a, const double b)
+{
+    // partial values are combined by keeping the shortest
+    return ((a < b) ? a : b);
+}
+
+// ---------
+
+void execution_impl_sssp(void* unused_arg)
+{
+    uint64_t num_iterations_used_gather = 0ull;
+    uint64_t num_iterations_used_scatter = 0ull;
+    
+    uint64_t ctr = 0ull;
+    
+#ifdef EXPERIMENT_ITERATION_PROFILE
+    uint64_t iteration_time = 0ull;
+    double iteration_frontier_comparator = (double)graph_num_edges;
+#endif
+
+    uint64_t converge_vote = 0ull;
+    
+#ifndef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+    converge_vote += (uint64_t)graph_vertex_outdegrees[execution_search_root];
+#else
+#ifdef EXPERIMENT_ITERATION_PROFILE
+    iteration_frontier_comparator = (double)graph_num_vertices;
+#endif
+#endif
+
+#ifndef EXPERIMENT_THRESHOLD_WITHOUT_COUNT
+    converge_vote += 1ull;
+#endif
+    
+    while(1)
+    {
+        ctr += 1ull;
+        
+#if defined(EXPERIMENT_EDGE_FORCE_PULL)
+        const uint8_t use_gather_for_processing = 1;
+#elif defined(EXPERIMENT_EDGE_FORCE_PUSH)
+        const uint8_t use_gather_for_processing = 0;
+#else
+#ifdef EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+        // without using outdegrees, the condition is based on the number of vertices
+        // converge_vote gets set to the number of vertices that "have info"
+        const uint64_t engine_threshold = (graph_num_vertices / 2ull);
+#else
+        // when using outdegrees, the condition is based on the number of edges
+        // converge_vote gets set to the number of vertices that "have info" plus their outdegrees
+        // Ligra uses this method, comparing converge_vote to (graph_num_edges / 20)    
+        const uint64_t engine_threshold = (graph_num_edges / 5ull);
+#endif
+        
+        // dynamically select an engine (either Push or Pull) depending on some condition
+        // the adaptive method instead picks the engine predicted to be cheaper, based on the measured cost of previous iterations
+        const uint8_t use_gather_for_processing = engineselect_use_pull(converge_vote, engine_threshold);
+#endif
+        
+        /* Edge Phase */
+        
+        engineselect_edge_phase_start();
+        
+#ifdef EXPERIMENT_ITERATION_PROFILE
+        if (0 == threads_get_global_thread_id())
+        {
+            iteration_time = benchmark_rdtsc();
+        }
+#endif
+        
+        if (use_gather_for_processing)
+        {
+            // if the threshold is met, use the Pull engine to do this round of processing
+            num_iterations_used_gather += 1ull;
+            
+            // reset the global variable accumulator
+            // this happens immediately before the Edge phase because C code, such as the frontier queue build, does not preserve it
+            phase_op_reset_global_accum();
+            
+            // perform the Edge-Pull phase
+            perform_edge_pull_phase(graph_edges_gather_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_gather_list_block_counts_numa[threads_get_thread_group_id()][0]);
+            
+            // each thread would have a partial value for the global variable which represents the number of vertices changed this algorithm iteration
+            // therefore, each thread should write the partial value to the reduce buffer, to which any units it steals then add
+            phase_op_write_global_accum_to_buf(reduce_buffer);
+            scheduler_steal_edge_pull_work(reduce_buffer);
+            threads_barrier();
+            
+#if !defined(EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE) && defined(EXPERIMENT_EDGE_PULL_FORCE_MERGE)
+            // first thread performs the actual merge operation between potentially-overlapping properties
+            if (0 == threads_get_global_thread_id())
+            {
+                edge_pull_op_merge_with_merge_buffer(graph_vertex_merge_buffer, sched_pull_units_total, graph_vertex_props);
+            }
+            
+            threads_merge_barrier();
+#endif
+        }
+        else
+        {
+            // otherwise, use the Edge-Push phase to do this round of processing
+            num_iterations_used_scatter += 1ull;
+            
+            // list the active vertices so the Edge-Push phase can skip directly between them
+            edge_push_op_build_frontier_queue(graph_frontier_has_info);
+            
+            // reset the global variable accumulator
+            // this happens immediately before the Edge phase because C code, such as the frontier queue build, does not preserve it
+            phase_op_reset_global_accum();
+            
+            // perform the Edge-Push phase
+            perform_edge_push_phase(graph_edges_scatter_list_block_bufs_numa[threads_get_thread_group_id()][0], graph_edges_scatter_list_block_counts_numa[threads_get_thread_group_id()][0]);
+            
+            // each thread would have a partial value for the global variable which represents the number of vertices changed this algorithm iteration
+            // therefore, each thread should write the partial value to the reduce buffer, to which any units it steals then add
+            phase_op_write_global_accum_to_buf(reduce_buffer);
+            scheduler_steal_edge_push_work(reduce_buffer);
+            threads_barrier();
+        }
+        
+        engineselect_edge_phase_end(use_gather_for_processing, converge_vote);
+        
+#ifdef EXPERIMENT_ITERATION_PROFILE
+        if (0 == threads_get_global_thread_id())
+        {
+            iteration_time = benchmark_rdtsc() - iteration_time;
+            fprintf(stderr, "%llu,%s,%llu,%.10lf\n", (long long unsigned int)ctr, (use_gather_for_processing ? "Pull" : "Push"), (long long unsigned int)iteration_time, (double)converge_vote / iteration_frontier_comparator);
+        }
+        
+        threads_barrier();
+#endif
+
+#ifdef EXPERIMENT_ITERATION_STATS
+        if (0 == threads_get_global_thread_id())
+        {
+            const uint32_t num_threads = threads_get_total_threads();
+            uint64_t num_vectors = 0ull;
+            uint64_t num_edges = 0ull;
+            
+            for (uint32_t i = 0; i < num_threads; ++i)
+            {
+                num_vectors += graph_stat_num_vectors_per_thread[i];
+                num_edges += graph_stat_num_edges_per_thread[i];
+                
+                graph_stat_num_vectors_per_thread[i] = 0ull;
+                graph_stat_num_edges_per_thread[i] = 0ull;
+            }
+            
+            graph_stat_num_vectors_per_iteration[ctr - 1ull] = num_vectors;
+            graph_stat_num_edges_per_iteration[ctr - 1ull] = num_edges;
+        }
+        
+        threads_barrier();
+#endif
+        
+        /* Termination Check */
+        
+        // get the number of vertices whose distance shrank this algorithm iteration
+        // if that number is 0, the algorithm is complete and the distances are final
+        converge_vote = phase_op_combine_global_var_from_buf(reduce_buffer);
+        if (0 == converge_vote)
+            break;
+        
+
+        /* Vertex Phase */
+        
+        // only the master thread has to do this, but the idea is to swap the accumulators (HasInfo*) and HasInfo itself
+        // it is easier to do this by swapping pointers than by moving data around
+        if (0 == threads_get_global_thread_id())
+        {
+            uint64_t* temp = graph_frontier_has_info;
+            graph_frontier_has_info = (uint64_t*)graph_vertex_accumulators;
+            graph_vertex_accumulators = (double*)temp;
+        }
+        
+        threads_barrier();
+        
+        // perform the Vertex phase
+        // the only job of this phase is to zero out HasInfo* for the next iteration
+        perform_vertex_phase(graph_vertex_first_numa[threads_get_thread_group_id()], graph_vertex_count_numa[threads_get_thread_group_id()], NULL);
+        
+        threads_barrier();
+    }
+    
+    // algorithm complete, record the number of iterations run of each type
+    if (0 == threads_get_global_thread_id())
+    {
+        total_iterations_executed = ctr;
+        total_iterations_used_gather = num_iterations_used_gather;
+        total_iterations_used_scatter = num_iterations_used_scatter;
+    }
+}
+
+
+/* -------- ALGORITHM DEFINITION ------------------------------------------- */
+// See "execution.h" for documentation.
+
+const execution_algorithm_t execution_algorithm_sssp = {
+    .name = "sssp",
+    .display_name = "Single-Source Shortest Paths",
+    .converges_dynamically = 1,
+    .output_type = EXECUTION_OUTPUT_DISTANCE,
+    .single_precision = 0,
+    .uses_edge_weights = 1,
+    .search_roots = EXECUTION_SEARCH_ROOTS_EACH,
+    .vertex_id_props = 0,
+    .init = execution_init_sssp,
+    .cleanup = execution_cleanup_sssp,
+    .accumulator_bits_per_vertex = execution_accumulator_bits_per_vertex_sssp,
+    .initialize_frontier_has_info = execution_initialize_frontier_has_info_sssp,
+    .initialize_frontier_wants_info = execution_initialize_frontier_wants_info_sssp,
+    .initialize_vertex_accum = execution_initialize_vertex_accum_sssp,
+    .initialize_vertex_prop = execution_initialize_vertex_prop_sssp,
+    .scalar_reduce_op = execution_scalar_reduce_op_sssp,
+    .impl = execution_impl_sssp
+};
@@ -27,7 +27,12 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 
 /* -------- DATA STRUCTURES ------------------------------------------------ */
@@ -35,11 +40,20 @@
 
 uint64_t graph_num_vertices = 0ull;
 uint64_t graph_num_edges = 0ull;
+uint64_t* graph_vertex_original_ids = NULL;
+uint64_t* graph_vertex_reordered_ids = NULL;
+uint64_t* graph_vertex_output_positions = NULL;
 double* graph_vertex_props = NULL;
 double* graph_vertex_accumulators = NULL;
 double* graph_vertex_outdegrees = NULL;
 uint64_t* graph_frontier_has_info = NULL;
 uint64_t* graph_frontier_wants_info = NULL;
+uint64_t* graph_frontier_wants_info_summary = NULL;
+uint64_t* graph_frontier_queue = NULL;
+uint64_t graph_frontier_queue_count = GRAPH_FRONTIER_QUEUE_NONE;
+uint64_t graph_frontier_queue_capacity = 0ull;
+uint64_t* graph_frontier_queue_thread_counts = NULL;
+uint64_t* graph_vertex_search_state = NULL;
 uint64_t graph_edges_gather_list_vector_count = 0ull;
 uint64_t graph_edges_scatter_list_vector_count = 0ull;
 uint64_t graph_edges_gather_list_num_blocks = 0ull;
@@ -54,6 +68,9 @@ __m256i*** graph_edges_gather_list_block_bufs_numa = NULL;
 __m256i*** graph_edges_scatter_list_block_bufs_numa = NULL;
 uint64_t** graph_edges_gather_list_block_counts_numa = NULL;
 uint64_t** graph_edges_scatter_list_block_counts_numa = NULL;
+uint64_t** graph_edges_gather_list_block_info_numa = NULL;
+double** graph_edges_gather_list_block_weights_numa = NULL;
+double** graph_edges_scatter_list_block_weights_numa = NULL;
 uint64_t* graph_vertex_first_numa = NULL;
 uint64_t* graph_vertex_last_numa = NULL;
 uint64_t* graph_vertex_count_numa = NULL;
@@ -75,31 +92,177 @@ uint64_t* graph_stat_num_edges_per_iteration = NULL;
 // Number of NUMA nodes for which the graph data structures are optimized.
 static uint32_t graph_num_numa_nodes = 0;
 
-// Buffers for reading in the graph from a file, used only during ingress.
-static __m256i* graph_edge_list_block_bufs[2] = { NULL, NULL };
+// Number of entries in the vertex merge buffers and the number of NUMA nodes they cover, needed to free them.
+static uint64_t graph_vertex_merge_buffer_count = 0ull;
+static uint32_t graph_vertex_merge_buffer_num_numa_nodes = 0;
 
-// Buffers for storing block counts as a graph is read in from a file, used only during ingress.
-static uint64_t* graph_edge_list_block_counts = NULL;
+// Number of threads for which the frontier queue was allocated, needed to free it.
+static uint64_t graph_frontier_queue_num_threads = 0ull;
 
-// Number of vectors in the edge list, used only during ingress.
-static uint64_t graph_edge_list_vector_count = 0ull;
+// Number of threads for which the statistics arrays were allocated, needed to free them.
+static uint64_t graph_stat_num_threads = 0ull;
 
-// Number of blocks in the edge list, used only during ingress.
-static uint64_t graph_edge_list_num_blocks = 0ull;
+// Allocated addresses of the vertex accumulators and the "has_info" frontier, needed to free them.
+// Some applications swap these two pointers while running, and the arrays are not the same size.
+static double* graph_vertex_accumulators_alloc = NULL;
+static uint64_t* graph_frontier_has_info_alloc = NULL;
 
-// First shared-encoded vertex in each block of the edge list, used only during ingress.
-static uint64_t* graph_edge_list_block_first_shared_vertex = NULL;
+// Edge list currently being built in parallel, used only during ingress.
+// Points to either the in-edge list or the out-edge list data structures, which are filled directly on each NUMA node.
+static __m256i*** graph_ingress_block_bufs_numa = NULL;
+static uint64_t** graph_ingress_block_counts_numa = NULL;
+static uint64_t** graph_ingress_vertex_index_numa = NULL;
+static uint64_t* graph_ingress_vertex_index_start_numa = NULL;
+static uint64_t* graph_ingress_vertex_index_end_numa = NULL;
 
-// Last shared-encoded vertex in each block of the edge list, used only during ingress.
-static uint64_t* graph_edge_list_block_last_shared_vertex = NULL;
+// Per-vector information for the edge list currently being built, or NULL if it uses the standard encoding, and the number of vertex IDs packed into each of its vectors, used only during ingress.
+static uint64_t** graph_ingress_block_info_numa = NULL;
+static uint64_t graph_ingress_vector_lanes = GRAPH_EDGE_VECTOR_LANES;
 
-// Temporary file handle for reading from files
-static FILE* graph_read_file = NULL;
+// Per-lane edge weights for the edge list currently being built, or NULL if the graph is being loaded without weights, used only during ingress.
+static double** graph_ingress_block_weights_numa = NULL;
 
-// Temporary buffer for reading from files, plus size and position information
-static uint64_t* graph_edges_read_buffer[2] = { NULL, NULL };
-static uint64_t graph_edges_read_buffer_max_count = 1024ull*1024ull*1024ull/sizeof(uint64_t);
-static uint64_t graph_edges_read_buffer_count[2] = { 0ull, 0ull };
+// Whether edge weights are to be loaded along with the edge lists, used only during ingress.
+static uint32_t graph_load_edge_weights = 0;
+
+// Edges from which the edge list currently being built is read, each a source-destination pair, used only during ingress.
+// Normally these come straight from the mapped graph file, but they may instead come from an in-memory transpose of the other edge list.
+static const uint64_t* graph_ingress_edges = NULL;
+static uint64_t graph_ingress_num_edges = 0ull;
+
+// Weight of each of the edges above, in the same order, or NULL if every edge has unit weight, used only during ingress.
+static const double* graph_ingress_weights = NULL;
+
+// Edges produced by transposing an edge list in memory, plus temporary space used to produce them, used only during ingress.
+static uint64_t* graph_transpose_edges = NULL;
+static uint64_t* graph_transpose_edges_temp = NULL;
+
+// Weights that accompany the transposed edges, and temporary space used to produce them, if the edges being transposed have weights, used only during ingress.
+static double* graph_transpose_weights = NULL;
+static double* graph_transpose_weights_temp = NULL;
+
+// Position of the vertex by which edges are being sorted when transposing: 0 (source) or 1 (destination), used only during ingress.
+static uint64_t graph_transpose_key_offset = 0ull;
+
+// Number and width (expressed as a shift) of the vertex ranges into which edges are first distributed when transposing, used only during ingress.
+static uint64_t graph_transpose_num_buckets = 0ull;
+static uint64_t graph_transpose_bucket_shift = 0ull;
+
+// Per-thread edge counts and then positions for each vertex range, stored thread-major, used only during ingress.
+static uint64_t* graph_transpose_thread_bucket_positions = NULL;
+
+// First edge in each vertex range, plus one extra element marking the end, used only during ingress.
+static uint64_t* graph_transpose_bucket_first_edge = NULL;
+
+// Next and last vertex range to be sorted by the threads on each NUMA node, used only during ingress.
+static uint64_t* graph_transpose_group_next_bucket = NULL;
+static uint64_t* graph_transpose_group_end_bucket = NULL;
+
+// Set by any thread that finds two consecutive ingress edges out of order, used only during ingress.
+static uint64_t graph_sort_found_unsorted = 0ull;
+
+// Runs of sorted edges spilled to disk during an external sort, mapped into memory while they are merged, used only during ingress.
+static const uint64_t* graph_sort_runs_map = NULL;
+static uint64_t graph_sort_run_edges = 0ull;
+static uint64_t graph_sort_num_runs = 0ull;
+
+// First key vertex to be merged by each thread during an external sort, plus one extra element marking the end, used only during ingress.
+static uint64_t* graph_sort_thread_first_key = NULL;
+
+// Edges produced by an external sort, mapped into memory from a temporary file, used only during ingress.
+static uint64_t* graph_sort_edges_map = NULL;
+
+// NUMA nodes on which the edge list is being built, used only during ingress.
+static const uint32_t* graph_ingress_numa_nodes = NULL;
+
+// Position of the shared vertex within each edge read from the file: 1 (destination) for the in-edge list, 0 (source) for the out-edge list, used only during ingress.
+static uint64_t graph_ingress_shared_vertex_offset = 0ull;
+
+// First edge and first vector assigned to each ingress thread, plus one extra element marking the end, used only during ingress.
+static uint64_t* graph_ingress_thread_first_edge = NULL;
+static uint64_t* graph_ingress_thread_first_vector = NULL;
+
+// First vector assigned to each NUMA node, plus one extra element marking the end, used only during ingress.
+static uint64_t* graph_ingress_node_first_vector = NULL;
+
+// Read-only memory mapping of the graph file currently being read, plus its size in bytes and in 64-bit elements
+static uint64_t* graph_read_file_map = NULL;
+static uint64_t graph_read_file_map_size = 0ull;
+static uint64_t graph_read_file_map_count = 0ull;
+
+// Edges of the graph file currently being read, which point into the mapping for a binary file or to a decoded copy for a compressed file
+static const uint64_t* graph_read_file_edges = NULL;
+static uint64_t graph_read_file_num_edges = 0ull;
+
+// Decoded copy of the edges in a compressed graph file, if the file currently being read is compressed
+static uint64_t* graph_read_file_decoded_edges = NULL;
+
+// Weights of the edges of the graph file currently being read, which point into the mapping of the accompanying weights file for a binary file or to a parsed copy for a text file, or NULL if there are none
+static const double* graph_read_file_weights = NULL;
+
+// Read-only memory mapping of the weights file that accompanies the binary graph file currently being read, plus its size in bytes
+static double* graph_read_file_weights_map = NULL;
+static uint64_t graph_read_file_weights_map_size = 0ull;
+
+// Parsed copy of the edge weights in a text graph file, if the file currently being read is text and any of its edges has a weight
+static double* graph_read_file_decoded_weights = NULL;
+
+// Set by any thread that finds a compressed graph file to be malformed, used only during ingress.
+static uint64_t graph_read_file_decode_failed = 0ull;
+
+// Method used to reorder vertices at ingress, one of the GRAPH_REORDER_* constants, used only during ingress.
+static uint32_t graph_reorder_method = GRAPH_REORDER_NONE;
+
+// Number of out-edges and in-edges of each vertex, used only while reordering vertices.
+static uint64_t* graph_reorder_out_degrees = NULL;
+static uint64_t* graph_reorder_in_degrees = NULL;
+
+// Bulk parts of the snapshot file currently being read, which are read in parallel once all of them are known, used only while reading a snapshot.
+static graphsnapshotread_t* graph_snapshot_reads = NULL;
+static uint64_t graph_snapshot_num_reads = 0ull;
+
+// Descriptors for the snapshot file currently being read, one opened for direct I/O (-1 if not supported) and one for regular I/O, used only while reading a snapshot.
+static int graph_snapshot_direct_fd = -1;
+static int graph_snapshot_buffered_fd = -1;
+
+// Set by any thread that fails to read its part of a snapshot file, used only while reading a snapshot.
+static uint64_t graph_snapshot_read_failed = 0ull;
+
+// Offset within the text graph file currently being read at which edges begin, and whether each edge also implies its reverse, used only during ingress.
+static uint64_t graph_text_data_offset = 0ull;
+static uint64_t graph_text_is_symmetric = 0ull;
+
+// Set by any thread that finds an edge with a weight in a text graph file, used only during ingress.
+static uint64_t graph_text_found_weights = 0ull;
+
+// Per-thread buffers of edges parsed from a text graph file, along with their sizes and the highest vertex ID each contains, used only during ingress.
+static uint64_t** graph_text_thread_edges = NULL;
+static double** graph_text_thread_weights = NULL;
+static uint64_t* graph_text_thread_num_edges = NULL;
+static uint64_t* graph_text_thread_max_vertex_id = NULL;
+
+// Position of each thread's first parsed edge, and then of the first vertex ID it renumbers, plus one extra element marking the end, used only during ingress.
+static uint64_t* graph_text_thread_first_edge = NULL;
+static uint64_t* graph_text_thread_first_vertex = NULL;
+
+// Bitmap of vertex IDs present in a text graph file, and the number of IDs present before each 64-bit word of it, used only during ingress.
+// If the IDs are too sparse for a bitmap, a sorted list of the distinct IDs is used instead.
+static uint64_t* graph_text_vertex_id_bitmap = NULL;
+static uint64_t* graph_text_vertex_id_bitmap_rank = NULL;
+static uint64_t graph_text_vertex_id_bitmap_words = 0ull;
+static uint64_t* graph_text_vertex_id_sorted = NULL;
+
+// Output file being written in parallel, whether it is binary, the kind of value it holds for each vertex, and whether any write to it failed, used only while writing output.
+static int graph_output_file = -1;
+static uint32_t graph_output_is_binary = 0;
+static uint32_t graph_output_type = 0;
+static uint64_t graph_output_write_failed = 0ull;
+
+// Depth of each vertex in the search tree, or UINT32_MAX if it was not reached, used only while writing depth output.
+static uint32_t* graph_output_depths = NULL;
+
+// Number of bytes of text output produced by each thread, then the position of each thread's first byte, used only while writing output.
+static uint64_t* graph_output_thread_first_byte = NULL;
 
 #ifdef EXPERIMENT_MODEL_LONG_VECTORS
 // Model for higher vector lengths
@@ -134,13 +297,23 @@ uint64_t graph_edges_num_vectors_vl16 = 0ull;
         3                                                                                           \
     )
 
+// Gets and returns the shared vertex ID of the specified edge vector, given an edge list and its per-vector information, which is NULL unless the edge list uses the compact encoding.
+#define graph_macro_get_shared_vertex_at(__m256i_ptr_buf, uint64_ptr_info, idx)                   \
+    (NULL == (uint64_ptr_info) ? (uint64_t)graph_macro_get_shared_vertex((__m256i_ptr_buf)[(idx)]) : ((uint64_ptr_info)[(idx)] & GRAPH_EDGE_INFO_VERTEX_MASK))
+
+// Gets and returns the number of bytes per vertex property for the selected algorithm, which stores them as doubles unless it uses single precision or vertex IDs.
+#define graph_macro_vertex_prop_size()                                                              \
+    ((execution_algorithm->single_precision || execution_algorithm->vertex_id_props) ? sizeof(uint32_t) : sizeof(double))
+
+// Gets and returns the vertex whose output belongs at the specified position, which is its ID from before any reordering at ingress.
+#define graph_macro_get_output_vertex(position)                                                     \
+    (NULL == graph_vertex_reordered_ids ? (position) : graph_vertex_reordered_ids[(position)])
+
 
 /* -------- INTERNAL FUNCTIONS --------------------------------------------- */
 
-// Composes an edge vector, given a shared vertex ID and individual vertex IDs.
-// Writes the edge vector to the specified buffer.
-// If block storage is enabled and the block is filled, writes it to the block storage device, with a base offset provided.
-void graph_helper_write_edge_vector(uint64_t shared_vertex_id, uint64_t* individual_vertex_ids, uint64_t individual_vertex_id_count, uint64_t io_block_offset)
+// Composes and returns an edge vector, given a shared vertex ID and individual vertex IDs.
+__m256i graph_helper_compose_edge_vector(const uint64_t shared_vertex_id, const uint64_t* individual_vertex_ids, const uint64_t individual_vertex_id_count)
 {
     // compose the destination ID by splitting it into pieces
     uint64_t edge_shared_vertex_pieces[4] = {
@@ -150,33 +323,51 @@ void graph_helper_write_edge_vector(uint64_t shared_vertex_id, uint64_t* individ
         (shared_vertex_id & 0x0000e00000000000ull) >> 45    /* bits 47:45 */
     };
 
-    // create and write the in-edge list record
+    // create the edge list record
     // upper bit is the "valid" bit, the next 15 bits are parts of the destination vertex ID as pieced out above, and the lower 48 bits are source vertex IDs
     // when gathering, the destination vertex ID will be recovered from this piecewise representation, the "valid" bit is a mask, and the lower 48 bits are used as gather indices
-    graph_edge_list_block_bufs[graph_edge_list_num_blocks & 0x0000000000000001ull][graph_edge_list_block_counts[graph_edge_list_num_blocks]] = _mm256_set_epi64x(
+    return _mm256_set_epi64x(
         ((individual_vertex_id_count > 3 ? 1ull : 0ull) << 63) | (edge_shared_vertex_pieces[3] << 48) | (individual_vertex_ids[3]),
         ((individual_vertex_id_count > 2 ? 1ull : 0ull) << 63) | (edge_shared_vertex_pieces[2] << 48) | (individual_vertex_ids[2]),
         ((individual_vertex_id_count > 1 ? 1ull : 0ull) << 63) | (edge_shared_vertex_pieces[1] << 48) | (individual_vertex_ids[1]),
         ((individual_vertex_id_count > 0 ? 1ull : 0ull) << 63) | (edge_shared_vertex_pieces[0] << 48) | (individual_vertex_ids[0])
         );
+}
 
-    // update the block index, as appropriate
-    if (0 == graph_edge_list_block_counts[graph_edge_list_num_blocks])
-    {
-        graph_edge_list_block_first_shared_vertex[graph_edge_list_num_blocks] = shared_vertex_id;
-    }
-    graph_edge_list_block_last_shared_vertex[graph_edge_list_num_blocks] = shared_vertex_id;
-
-    // increment the block and vector counts
-    graph_edge_list_block_counts[graph_edge_list_num_blocks] += 1;
-    graph_edge_list_vector_count += 1;
+// Composes and returns a compact edge vector, given individual vertex IDs, and fills in its information using the shared vertex ID.
+// Each of the 8 lanes holds a 32-bit individual vertex ID, and the shared vertex ID and mask of valid lanes are kept outside the vector.
+__m256i graph_helper_compose_compact_edge_vector(const uint64_t shared_vertex_id, const uint64_t* individual_vertex_ids, const uint64_t individual_vertex_id_count, uint64_t* edge_vector_info)
+{
+    *edge_vector_info = (shared_vertex_id & GRAPH_EDGE_INFO_VERTEX_MASK) | ((((1ull << individual_vertex_id_count) - 1ull) & 0xffull) << GRAPH_EDGE_INFO_LANE_MASK_SHIFT);
+    
+    return _mm256_set_epi32(
+        (int)individual_vertex_ids[7],
+        (int)individual_vertex_ids[6],
+        (int)individual_vertex_ids[5],
+        (int)individual_vertex_ids[4],
+        (int)individual_vertex_ids[3],
+        (int)individual_vertex_ids[2],
+        (int)individual_vertex_ids[1],
+        (int)individual_vertex_ids[0]
+        );
 }
 
-// Finalizes the edge vector list by committing the last set of records, potentially causing a write to block storage.
-void graph_helper_write_final_edge_vector(uint64_t vertex_common_id, uint64_t* vertex_individual_ids, uint64_t vertex_individual_id_count, uint64_t io_block_offset)
+// Writes a block of compact edge in-edge list records, in edge list form, to the specified stream (most likely a file).
+void graph_helper_write_compact_edges_to_file(FILE* graphfile, __m256i* records, uint64_t* records_info, uint64_t record_count)
 {
-    graph_helper_write_edge_vector(vertex_common_id, vertex_individual_ids, vertex_individual_id_count, io_block_offset);
-    graph_edge_list_num_blocks = 1;
+    for (uint64_t i = 0; i < record_count; ++i)
+    {
+        const uint32_t* edge_sources = (const uint32_t*)&records[i];
+        uint64_t edge_dest = records_info[i] & GRAPH_EDGE_INFO_VERTEX_MASK;
+        
+        for (uint64_t j = 0; j < GRAPH_EDGE_VECTOR_COMPACT_LANES; ++j)
+        {
+            if (records_info[i] & (1ull << (GRAPH_EDGE_INFO_LANE_MASK_SHIFT + j)))
+            {
+                fprintf(graphfile, "%llu %llu\n", (long long unsigned int)edge_sources[j], (long long unsigned int)edge_dest);
+            }
+        }
+    }
 }
 
 // Writes a block of edge in-edge list records, in edge list form, to the specified stream (most likely a file).
@@ -215,30 +406,44 @@ void graph_helper_write_edges_to_file(FILE* graphfile, __m256i* records, uint64_
     }
 }
 
-// Sets up the vertex index for a provided buffer and edge list
-void graph_helper_create_vertex_index(__m256i* const edge_list_buf, const uint64_t edge_list_count, uint64_t* const vertex_index_buf, const uint64_t vertex_buf_count, uint64_t* const vertex_index_start, uint64_t* const vertex_index_end)
+// Sets up part of the vertex index for a provided buffer and edge list, covering the edge vectors from (edge_list_first) up to but not including (edge_list_last).
+// Each vertex's index entry is written by whichever part contains its first edge vector, so disjoint parts of the same edge list can be indexed concurrently.
+// The part containing the first edge vector also marks and records the vertices that precede it, and the part containing the final edge vector does likewise for those that follow it.
+// Per-vector information is needed only for edge lists that use the compact encoding and should otherwise be NULL.
+void graph_helper_create_vertex_index_part(__m256i* const edge_list_buf, const uint64_t* const edge_list_info, const uint64_t edge_list_count, const uint64_t edge_list_first, const uint64_t edge_list_last, uint64_t* const vertex_index_buf, const uint64_t vertex_buf_count, uint64_t* const vertex_index_start, uint64_t* const vertex_index_end)
 {
-    uint64_t last_vertex_indexed = 0ull;
-    uint64_t current_vertex_id = (uint64_t)graph_macro_get_shared_vertex(edge_list_buf[0]);
+    uint64_t last_vertex_indexed;
+    uint64_t current_vertex_id;
     
-    // for any vertices in the index that appear before the first edge in the list, indicate their invalidity
-    for (uint64_t i = 0ull; i < current_vertex_id; ++i)
+    if (edge_list_first >= edge_list_last)
     {
-        vertex_index_buf[i] = 0x7fffffffffffffffull;
+        return;
     }
     
     // handle the first element in the edge list separately so that the loop logic can work for the rest of them
-    vertex_index_buf[current_vertex_id] = 0ull;
-    last_vertex_indexed = current_vertex_id;
+    if (0ull == edge_list_first)
+    {
+        current_vertex_id = graph_macro_get_shared_vertex_at(edge_list_buf, edge_list_info, 0);
+        
+        // for any vertices in the index that appear before the first edge in the list, indicate their invalidity
+        for (uint64_t i = 0ull; i < current_vertex_id; ++i)
+        {
+            vertex_index_buf[i] = 0x7fffffffffffffffull;
+        }
+        
+        vertex_index_buf[current_vertex_id] = 0ull;
+        
+        // record the starting vertex that is valid for this index
+        *vertex_index_start = current_vertex_id;
+    }
     
-    // record the starting vertex that is valid for this index
-    *vertex_index_start = current_vertex_id;
+    last_vertex_indexed = graph_macro_get_shared_vertex_at(edge_list_buf, edge_list_info, (0ull == edge_list_first) ? 0ull : (edge_list_first - 1ull));
     
-    // stream through the rest of the edge list and mark vertices as appropriate
+    // stream through the rest of this part of the edge list and mark vertices as appropriate
     // if present in the edge list, set their edge list position in the index, otherwise indicate invalidity
-    for(uint64_t i = 1ull; i < edge_list_count; ++i)
+    for (uint64_t i = ((0ull == edge_list_first) ? 1ull : edge_list_first); i < edge_list_last; ++i)
     {
-        current_vertex_id = (uint64_t)graph_macro_get_shared_vertex(edge_list_buf[i]);
+        current_vertex_id = graph_macro_get_shared_vertex_at(edge_list_buf, edge_list_info, i);
         
         if (last_vertex_indexed != current_vertex_id)
         {
@@ -255,15 +460,53 @@ void graph_helper_create_vertex_index(__m256i* const edge_list_buf, const uint64
         }
     }
     
-    // record the final vertex that is valid for this index
-    *vertex_index_end = current_vertex_id;
+    if (edge_list_count == edge_list_last)
+    {
+        current_vertex_id = graph_macro_get_shared_vertex_at(edge_list_buf, edge_list_info, edge_list_count - 1ull);
+        
+        // record the final vertex that is valid for this index
+        *vertex_index_end = current_vertex_id;
+        
+        // initialize the extra parts of the vertex index to have the top-most bit set
+        // this is for vertices that have places in the index but are beyond the highest vertex in the edge list
+        for (uint64_t i = current_vertex_id + 1ull; i < vertex_buf_count; ++i)
+        {
+            vertex_index_buf[i] = 0xffffffffffffffffull;
+        }
+    }
+}
+
+// Returns the largest power of two that divides each of the specified byte offsets of the boundaries between the parts of a buffer for different NUMA nodes, for use as the granularity with numanodes_malloc_divisible().
+// Returns 0 if there are no boundaries.
+uint64_t graph_helper_boundary_granularity(const uint64_t combined_offsets)
+{
+    return combined_offsets & (~combined_offsets + 1ull);
+}
+
+// Returns the granularity at which a vertex array with the specified number of bits per vertex is divided among NUMA nodes, given the vertex assignments already made.
+uint64_t graph_helper_vertex_array_granularity(const uint64_t bits_per_vertex)
+{
+    uint64_t combined_offsets = 0ull;
+    
+    for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
+    {
+        combined_offsets |= (graph_vertex_first_numa[i] * bits_per_vertex) >> 3ull;
+    }
+    
+    return graph_helper_boundary_granularity(combined_offsets);
+}
+
+// Returns the granularity at which an ingress edge array with the specified number of bytes per edge is divided among NUMA nodes, each of which gets an equal part of the edges.
+uint64_t graph_helper_edge_array_granularity(const uint64_t num_edges, const uint64_t bytes_per_edge)
+{
+    uint64_t combined_offsets = 0ull;
     
-    // initialize the extra parts of the vertex index to have the top-most bit set
-    // this is for vertices that have places in the index but are beyond the highest vertex in the edge list
-    for (uint64_t i = current_vertex_id + 1ull; i < vertex_buf_count; ++i)
+    for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
     {
-        vertex_index_buf[i] = 0xffffffffffffffffull;
+        combined_offsets |= (num_edges * i / graph_num_numa_nodes) * bytes_per_edge;
     }
+    
+    return graph_helper_boundary_granularity(combined_offsets);
 }
 
 // Allocates the vertex-related arrays
@@ -273,16 +516,67 @@ void graph_helper_create_vertex_info(const uint32_t base_numa_node)
     graph_vertex_props = (double*)numanodes_malloc(sizeof(double) * (graph_num_vertices + 8ull), base_numa_node);
     graph_vertex_accumulators = (double*)numanodes_malloc(sizeof(double) * (graph_num_vertices + 8ull), base_numa_node);
     graph_vertex_outdegrees = (double*)numanodes_malloc(sizeof(double) * (graph_num_vertices + 8ull), base_numa_node);
+    graph_vertex_accumulators_alloc = graph_vertex_accumulators;
 }
 
 // Initializes vertex properties and accumulators
 void graph_helper_initialize_vertex_info()
 {
     // initialize vertex properties and accumulators
-    for (uint64_t i = 0ull; i < graph_num_vertices; ++i)
+    // single-precision algorithms use only the first half of each array, as do algorithms whose properties are vertex IDs, but only for the properties
+    if (execution_algorithm->vertex_id_props)
+    {
+        // all bits set is reserved to mean that there is no vertex
+        if (graph_num_vertices >= (uint64_t)UINT32_MAX)
+        {
+            fprintf(stderr, "Error: %s supports at most %llu vertices\n", execution_algorithm->display_name, (long long unsigned int)(UINT32_MAX - 1u));
+            exit(255);
+        }
+        
+        for (uint64_t i = 0ull; i < graph_num_vertices; ++i)
+        {
+            const double prop = execution_algorithm->initialize_vertex_prop(i);
+            
+            ((uint32_t*)graph_vertex_props)[i] = (prop < 0.0 ? UINT32_MAX : (uint32_t)prop);
+            graph_vertex_accumulators[i] = execution_algorithm->initialize_vertex_accum(i);
+        }
+    }
+    else if (execution_algorithm->single_precision)
+    {
+        for (uint64_t i = 0ull; i < graph_num_vertices; ++i)
+        {
+            ((float*)graph_vertex_props)[i] = (float)execution_algorithm->initialize_vertex_prop(i);
+            ((float*)graph_vertex_accumulators)[i] = (float)execution_algorithm->initialize_vertex_accum(i);
+        }
+    }
+    else
+    {
+        for (uint64_t i = 0ull; i < graph_num_vertices; ++i)
+        {
+            graph_vertex_props[i] = execution_algorithm->initialize_vertex_prop(i);
+            graph_vertex_accumulators[i] = execution_algorithm->initialize_vertex_accum(i);
+        }
+    }
+}
+
+// Initializes frontiers of both types
+void graph_helper_initialize_frontiers()
+{
+    uint64_t frontier_count = (graph_num_vertices >> 6ull) + (graph_num_vertices & 63ull ? 1ull : 0ull);
+    
+    for (uint64_t i = 0ull; i < frontier_count; ++i)
+    {
+        graph_frontier_has_info[i] = execution_algorithm->initialize_frontier_has_info(i << 6ull);
+        graph_frontier_wants_info[i] = execution_algorithm->initialize_frontier_wants_info(i << 6ull);
+    }
+    
+    // summary bits start out set for every block that has a vertex wanting info
+    memset((void*)graph_frontier_wants_info_summary, 0, sizeof(uint64_t) * ((frontier_count >> (GRAPH_FRONTIER_SUMMARY_ELEMENTS_SHIFT + 6ull)) + 1ull));
+    
+    for (uint64_t i = 0ull; i < frontier_count; ++i)
     {
-        graph_vertex_props[i] = execution_initialize_vertex_prop(i);
-        graph_vertex_accumulators[i] = execution_initialize_vertex_accum(i);
+        if (0ull != graph_frontier_wants_info[i])
+            graph_frontier_wants_info_summary[i >> (GRAPH_FRONTIER_SUMMARY_ELEMENTS_SHIFT + 6ull)] |= (1ull << ((i >> GRAPH_FRONTIER_SUMMARY_ELEMENTS_SHIFT) & 63ull));
     }
 }
 
@@ -294,8 +588,12 @@ void graph_helper_create_and_initialize_frontiers(const uint32_t* numa_nodes)
     uint64_t frontier_count = (graph_num_vertices >> 6ull) + (graph_num_vertices & 63ull ? 1ull : 0ull);
     
     // allocate the frontiers
-    graph_frontier_has_info = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * frontier_count, numa_nodes[0]);
-    graph_frontier_wants_info = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * frontier_count, numa_nodes[0]);
+    graph_frontier_has_info = (uint64_t*)numanodes_malloc_divisible(sizeof(uint64_t) * frontier_count, numa_nodes[0], graph_helper_vertex_array_granularity(1ull));
+    graph_frontier_wants_info = (uint64_t*)numanodes_malloc_divisible(sizeof(uint64_t) * frontier_count, numa_nodes[0], graph_helper_vertex_array_granularity(1ull));
+    graph_frontier_has_info_alloc = graph_frontier_has_info;
+    
+    // the summary has one bit per block of frontier elements and is small, so it is not NUMA-ized
+    graph_frontier_wants_info_summary = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * ((frontier_count >> (GRAPH_FRONTIER_SUMMARY_ELEMENTS_SHIFT + 6ull)) + 1ull), numa_nodes[0]);
     
     // NUMA-ize the frontiers
     for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
@@ -309,105 +607,102 @@ void graph_helper_create_and_initialize_frontiers(const uint32_t* numa_nodes)
         numanodes_tonode_buffer(&graph_frontier_has_info[first_frontier_element], frontier_element_count << 3ull, numa_nodes[i]);
         numanodes_tonode_buffer(&graph_frontier_wants_info[first_frontier_element], frontier_element_count << 3ull, numa_nodes[i]);
     }
-   
-    // initialize the frontiers
-    for (uint64_t i = 0ull; i < frontier_count; ++i)
+    
+    graph_helper_initialize_frontiers();
+}
+
+// Allocates the dynamic scheduling counters, one per NUMA node
+void graph_helper_create_dynamic_scheduler_counters(const uint32_t* numa_nodes)
+{
+    graph_scheduler_dynamic_counter_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
     {
-        graph_frontier_has_info[i] = execution_initialize_frontier_has_info(i << 6ull);
-        graph_frontier_wants_info[i] = execution_initialize_frontier_wants_info(i << 6ull);
+        graph_scheduler_dynamic_counter_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t*), numa_nodes[i]);
     }
 }
 
-// Generates the NUMA-aware data structures for the out-edge list, given the standard data structures that have already been filled
-void graph_helper_numaize_scatter(const uint32_t* numa_nodes)
+// Places each NUMA node's part of the vertex properties on that node.
+// Which part that is depends on how many bytes the selected algorithm uses for each vertex property, and the last node's part extends to the end of the array, whether or not the algorithm uses all of it.
+void graph_helper_numaize_vertex_props(const uint32_t* numa_nodes)
 {
-    // allocate the edge list block buffer pointer containers
-    graph_edges_scatter_list_block_bufs_numa = (__m256i***)numanodes_malloc(sizeof(__m256i**) * graph_num_numa_nodes, numa_nodes[0]);
-    graph_edges_scatter_list_block_counts_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
-    
-    // allocate the vertex index pointers
-    graph_vertex_scatter_index_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
-    graph_vertex_scatter_index_start_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
-    graph_vertex_scatter_index_end_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    const uint64_t prop_size = graph_macro_vertex_prop_size();
     
-    // for each NUMA node, create its set of buffer pointers and counts
-    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
     {
-        graph_edges_scatter_list_block_bufs_numa[i] = (__m256i**)numanodes_malloc(sizeof(__m256i*) * 2, numa_nodes[i]);
-        graph_edges_scatter_list_block_counts_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_edges_scatter_list_num_blocks, numa_nodes[i]);
+        const uint64_t first_byte = prop_size * graph_vertex_first_numa[i];
+        const uint64_t end_byte = ((graph_num_numa_nodes - 1 == i) ? (sizeof(double) * (graph_num_vertices + 8ull)) : (prop_size * (graph_vertex_last_numa[i] + 1ull)));
+        
+        numanodes_tonode_buffer((void*)((uint8_t*)graph_vertex_props + first_byte), end_byte - first_byte, numa_nodes[i]);
     }
+}
+
+// Places each NUMA node's part of the accumulators on that node.
+// Which part that is depends on whether the selected algorithm uses the accumulators as full vertex properties, of either precision, or as a bit-mask with one bit per vertex.
+// Either way, the last node's part extends to the end of the array, whether or not the algorithm uses all of it.
+void graph_helper_numaize_accumulators(const uint32_t* numa_nodes)
+{
+    const uint64_t accumulator_bits = execution_algorithm->accumulator_bits_per_vertex();
+    const uint64_t accumulator_is_bitmask = (1ull == accumulator_bits);
     
-    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
     {
-        // assign edges to each NUMA node by dividing the number of edge vectors equally
-        uint64_t start_edge_record = graph_edge_list_block_counts[0] * i / graph_num_numa_nodes;
-        uint64_t end_edge_record = (graph_edge_list_block_counts[0] * (i + 1) / graph_num_numa_nodes) - 1ull;
-
-        // allocate and initialize each NUMA node's edge list
-        if (i > 0)
+        uint64_t first_byte;
+        uint64_t end_byte;
+        
+        if (accumulator_is_bitmask)
         {
-            graph_edges_scatter_list_block_bufs_numa[i][0] = (__m256i*)numanodes_malloc(sizeof(__m256i) * ((graph_num_edges / graph_num_numa_nodes) + graph_num_numa_nodes), numa_nodes[i]);
-            graph_edges_scatter_list_block_bufs_numa[i][1] = graph_edges_scatter_list_block_bufs_numa[i][0];
-            
-            memcpy(graph_edges_scatter_list_block_bufs_numa[i][0], &graph_edge_list_block_bufs[0][start_edge_record], sizeof(__m256i) * (end_edge_record - start_edge_record + 1ull));
+            // vertex boundaries between nodes are multiples of 512, so each node's part is a whole number of bit-mask elements
+            first_byte = graph_vertex_first_numa[i] >> 3ull;
+            end_byte = (graph_vertex_last_numa[i] + 1ull) >> 3ull;
         }
         else
         {
-            graph_edges_scatter_list_block_bufs_numa[i][0] = graph_edge_list_block_bufs[0];
-            graph_edges_scatter_list_block_bufs_numa[i][1] = graph_edges_scatter_list_block_bufs_numa[i][0];
+            first_byte = (accumulator_bits >> 3ull) * graph_vertex_first_numa[i];
+            end_byte = (accumulator_bits >> 3ull) * (graph_vertex_last_numa[i] + 1ull);
         }
         
+        if (graph_num_numa_nodes - 1 == i)
+            end_byte = sizeof(double) * (graph_num_vertices + 8ull);
         
-        graph_edges_scatter_list_block_counts_numa[i][0] = end_edge_record - start_edge_record + 1ull;
-    }
-    
-    // allocate and initialize per-node vertex indices
-    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
-    {
-        graph_vertex_scatter_index_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * (graph_num_vertices + (8ull * sizeof(uint64_t))), numa_nodes[i]);
-        graph_helper_create_vertex_index(graph_edges_scatter_list_block_bufs_numa[i][0], graph_edges_scatter_list_block_counts_numa[i][0], graph_vertex_scatter_index_numa[i], graph_num_vertices + (8ull * sizeof(uint64_t)), &graph_vertex_scatter_index_start_numa[i], &graph_vertex_scatter_index_end_numa[i]);
+        numanodes_tonode_buffer((void*)((uint8_t*)graph_vertex_accumulators + first_byte), end_byte - first_byte, numa_nodes[i]);
     }
 }
 
-// Generates the NUMA-aware data structures for the in-edge list, given the standard data structures that have already been filled
-void graph_helper_numaize_gather(const uint32_t* numa_nodes)
+// Reallocates the vertex properties, accumulators, and outdegrees so that each NUMA node holds the part corresponding to its assigned vertices.
+// Vertex assignments must already have been made, and the existing (non-NUMA) contents are preserved.
+void graph_helper_numaize_vertex_arrays(const uint32_t* numa_nodes)
 {
-    // allocate the edge list block buffer pointer containers
-    graph_edges_gather_list_block_bufs_numa = (__m256i***)numanodes_malloc(sizeof(__m256i**) * graph_num_numa_nodes, numa_nodes[0]);
-    graph_edges_gather_list_block_counts_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    // create some placeholders for the non-NUMA versions of vertices and accumulators
+    double* nonnuma_graph_vertex_props = graph_vertex_props;
+    double* nonnuma_graph_vertex_accumulators = graph_vertex_accumulators;
+    double* nonnuma_graph_vertex_outdegrees = graph_vertex_outdegrees;
     
-    // allocate the vertex index pointers
-    graph_vertex_gather_index_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
-    graph_vertex_gather_index_start_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
-    graph_vertex_gather_index_end_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    // allocate the vertex properties and accumulators
+    // each is divided at the finest granularity of any algorithm's use of it: properties can be single-precision, and accumulators can be a bit-mask
+    graph_vertex_props = (double*)numanodes_malloc_divisible(sizeof(double) * (graph_num_vertices + 8), numa_nodes[0], graph_helper_vertex_array_granularity(32ull));
+    graph_vertex_accumulators = (double*)numanodes_malloc_divisible(sizeof(double) * (graph_num_vertices + 8), numa_nodes[0], graph_helper_vertex_array_granularity(1ull));
+    graph_vertex_outdegrees = (double*)numanodes_malloc_divisible(sizeof(double) * (graph_num_vertices + 8), numa_nodes[0], graph_helper_vertex_array_granularity(64ull));
+    graph_vertex_accumulators_alloc = graph_vertex_accumulators;
     
-    // for each NUMA node, create its set of buffer pointers and counts
-    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    // NUMA-ize the outdegree arrays
+    for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
     {
-        graph_edges_gather_list_block_bufs_numa[i] = (__m256i**)numanodes_malloc(sizeof(__m256i*) * 2, numa_nodes[i]);
-        graph_edges_gather_list_block_counts_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_edges_gather_list_num_blocks, numa_nodes[i]);
+        numanodes_tonode_buffer(&graph_vertex_outdegrees[graph_vertex_first_numa[i]], sizeof(double) * graph_vertex_count_numa[i], numa_nodes[i]);
     }
     
-    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
-    {
-        // assign edges to each NUMA node by dividing the number of edge vectors equally
-        uint64_t start_edge_record = graph_edge_list_block_counts[0] * i / graph_num_numa_nodes;
-        uint64_t end_edge_record = (graph_edge_list_block_counts[0] * (i + 1) / graph_num_numa_nodes) - 1ull;
-
-        // allocate and initialize each NUMA node's edge list
-        graph_edges_gather_list_block_bufs_numa[i][0] = (__m256i*)numanodes_malloc(sizeof(__m256i) * ((graph_num_edges / graph_num_numa_nodes) + graph_num_numa_nodes), numa_nodes[i]);
-        graph_edges_gather_list_block_bufs_numa[i][1] = graph_edges_gather_list_block_bufs_numa[i][0];
-        memcpy(graph_edges_gather_list_block_bufs_numa[i][0], &graph_edge_list_block_bufs[0][start_edge_record], sizeof(__m256i) * (end_edge_record - start_edge_record + 1ull));
-        
-        graph_edges_gather_list_block_counts_numa[i][0] = end_edge_record - start_edge_record + 1ull;
-    }
+    // NUMA-ize the properties and accumulators
+    graph_helper_numaize_vertex_props(numa_nodes);
+    graph_helper_numaize_accumulators(numa_nodes);
     
-    // allocate and initialize per-node vertex indices
-    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
-    {
-        graph_vertex_gather_index_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * (graph_num_vertices + (8ull * sizeof(uint64_t))), numa_nodes[i]);
-        graph_helper_create_vertex_index(graph_edges_gather_list_block_bufs_numa[i][0], graph_edges_gather_list_block_counts_numa[i][0], graph_vertex_gather_index_numa[i], graph_num_vertices + (8ull * sizeof(uint64_t)), &graph_vertex_gather_index_start_numa[i], &graph_vertex_gather_index_end_numa[i]);
-    }
+    // initialize the NUMA-ized properties and accumulator arrays by copying from the non-NUMA versions
+    memcpy((void*)graph_vertex_props, (void*)nonnuma_graph_vertex_props, sizeof(double) * (graph_num_vertices + 8));
+    memcpy((void*)graph_vertex_accumulators, (void*)nonnuma_graph_vertex_accumulators, sizeof(double) * (graph_num_vertices + 8));
+    memcpy((void*)graph_vertex_outdegrees, (void*)nonnuma_graph_vertex_outdegrees, sizeof(double) * (graph_num_vertices + 8));
+    
+    // free the non-NUMA versions of the properties and accumulator arrays
+    numanodes_free((void*)nonnuma_graph_vertex_props, sizeof(double) * (graph_num_vertices + 8));
+    numanodes_free((void*)nonnuma_graph_vertex_accumulators, sizeof(double) * (graph_num_vertices + 8));
+    numanodes_free((void*)nonnuma_graph_vertex_outdegrees, sizeof(double) * (graph_num_vertices + 8));
 }
 
 // Generates the NUMA-aware data structures for vertices, given the standard data structures that have already been filled
@@ -415,18 +710,18 @@ void graph_helper_numaize_vertices(const uint32_t* numa_nodes)
 {
 #ifdef EXPERIMENT_ASSIGN_VERTICES_BY_PUSH
     __m256i*** block_bufs_numa = graph_edges_scatter_list_block_bufs_numa;
+    uint64_t** block_info_numa = NULL;
     uint64_t** block_counts_numa = graph_edges_scatter_list_block_counts_numa;
     const char block_assign_engine[] = "out-edge";
 #else
     __m256i*** block_bufs_numa = graph_edges_gather_list_block_bufs_numa;
+    uint64_t** block_info_numa = graph_edges_gather_list_block_info_numa;
     uint64_t** block_counts_numa = graph_edges_gather_list_block_counts_numa;
     const char block_assign_engine[] = "in-edge";    
 #endif
     
-    // create some placeholders for the non-NUMA versions of vertices and accumulators
-    double* nonnuma_graph_vertex_props = graph_vertex_props;
-    double* nonnuma_graph_vertex_accumulators = graph_vertex_accumulators;
-    double* nonnuma_graph_vertex_outdegrees = graph_vertex_outdegrees;
+    uint64_t vertex_alignments[5];
+    uint32_t num_vertex_alignments = 0;
     
     // allocate the vertex assignment records
     graph_vertex_first_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_numa_nodes, numa_nodes[0]);
@@ -435,29 +730,47 @@ void graph_helper_numaize_vertices(const uint32_t* numa_nodes)
     
     printf("Vertices:  assigned using %s list\n", block_assign_engine);
     
-    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    // boundaries between nodes are placed on a multiple of 512 vertices, as 512 is the combine phase effective vector length when dealing with frontiers
+    // explicit huge pages can only be moved between nodes whole, so if they are requested, boundaries are preferably placed such that each node's part of the vertex arrays is a whole number of them
+    // this is first attempted for every vertex array, including those with one bit per vertex, and then for those with at least 32 bits per vertex, falling back to smaller huge pages and then to 512 if the graph is too small
+    for (uint64_t page_size = ((graph_num_numa_nodes > 1) ? numanodes_get_huge_page_size() : 0ull); page_size >= NUMANODES_HUGE_PAGE_SIZE_2M; page_size >>= 9ull)
+    {
+        vertex_alignments[num_vertex_alignments++] = page_size << 3ull;
+        vertex_alignments[num_vertex_alignments++] = page_size >> 2ull;
+    }
+    
+    vertex_alignments[num_vertex_alignments++] = 512ull;
+    
+    for (uint32_t alignment_idx = 0; alignment_idx < num_vertex_alignments; ++alignment_idx)
     {
+        const uint64_t vertex_alignment = vertex_alignments[alignment_idx];
+        uint32_t alignment_fits = 1;
+        
         // assign vertices to each NUMA node based on the range of destination vertices in each node's part of the edge list
-        // modify the boundaries between nodes to be on an 512-vertex block boundary, as 512 is the combine phase effective vector length when dealing with frontiers
-        if (i > 0)
+        for (uint32_t i = 0; i < (graph_num_numa_nodes - 1); ++i)
         {
-            graph_vertex_first_numa[i] = graph_vertex_last_numa[i - 1] + 1ull;
-        }
-        else
-        {
-            graph_vertex_first_numa[i] = 0ull;
+            graph_vertex_last_numa[i] = graph_macro_get_shared_vertex_at(block_bufs_numa[i][0], ((NULL == block_info_numa) ? NULL : block_info_numa[i]), block_counts_numa[i][0] - 1ull);
+            graph_vertex_last_numa[i] += (vertex_alignment - 1ull) - (graph_vertex_last_numa[i] & (vertex_alignment - 1ull));
+            
+            // every node needs at least one vertex
+            if ((graph_vertex_last_numa[i] >= (graph_num_vertices - 1ull)) || ((i > 0) && (graph_vertex_last_numa[i] <= graph_vertex_last_numa[i - 1])))
+                alignment_fits = 0;
         }
         
-        if (i < (graph_num_numa_nodes - 1ull))
+        if (alignment_fits || (512ull == vertex_alignment))
         {
-            graph_vertex_last_numa[i] = graph_macro_get_shared_vertex(block_bufs_numa[i][0][block_counts_numa[i][0] - 1ull]);
-            graph_vertex_last_numa[i] += 511ull - (graph_vertex_last_numa[i] & 511ull);
-        }
-        else
-        {
-            graph_vertex_last_numa[i] = graph_num_vertices - 1ull;
+            if (512ull != vertex_alignment)
+                printf("Vertices:  boundaries between nodes are multiples of %llu vertices to fit huge pages\n", (long long unsigned int)vertex_alignment);
+            
+            break;
         }
-        
+    }
+    
+    graph_vertex_last_numa[graph_num_numa_nodes - 1] = graph_num_vertices - 1ull;
+    
+    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    {
+        graph_vertex_first_numa[i] = ((i > 0) ? (graph_vertex_last_numa[i - 1] + 1ull) : 0ull);
         graph_vertex_count_numa[i] = graph_vertex_last_numa[i] - graph_vertex_first_numa[i] + 1ull;
         
         printf("Vertices:  node %u gets %llu vertices (%llu to %llu, %.2lf%% of total)\n",
@@ -469,607 +782,3079 @@ void graph_helper_numaize_vertices(const uint32_t* numa_nodes)
         );
     }
     
-    // allocate the vertex properties and accumulators
-    graph_vertex_props = (double*)numanodes_malloc(sizeof(double) * (graph_num_vertices + 8), numa_nodes[0]);
-    graph_vertex_accumulators = (double*)numanodes_malloc(sizeof(double) * (graph_num_vertices + 8), numa_nodes[0]);
-    graph_vertex_outdegrees = (double*)numanodes_malloc(sizeof(double) * (graph_num_vertices + 8), numa_nodes[0]);
+    // move the properties, accumulators, and outdegrees to their assigned nodes
+    graph_helper_numaize_vertex_arrays(numa_nodes);
+}
+
+// Decodes a single varint, advancing the specified pointer past it, but never beyond the specified end.
+uint64_t graph_helper_decode_varint(const uint8_t** ptr, const uint8_t* end)
+{
+    const uint8_t* p = *ptr;
+    uint64_t value = 0ull;
+    uint64_t shift = 0ull;
     
-    // NUMA-ize the properties and outdegree arrays
-    for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
+    // most values in a typical graph fit in one byte, so that case is checked first
+    if ((p < end) && (*p < 0x80))
     {
-        numanodes_tonode_buffer(&graph_vertex_props[graph_vertex_first_numa[i]], sizeof(double) * graph_vertex_count_numa[i], numa_nodes[i]);
-        numanodes_tonode_buffer(&graph_vertex_outdegrees[graph_vertex_first_numa[i]], sizeof(double) * graph_vertex_count_numa[i], numa_nodes[i]);
+        *ptr = p + 1;
+        return (uint64_t)*p;
     }
     
-    // NUMA-ize the accumulators
-    for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
+    while ((p < end) && (shift < 64ull))
     {
-#if defined(BREADTH_FIRST_SEARCH) || defined(CONNECTED_COMPONENTS)
-        uint64_t first_accumulator_element = graph_vertex_first_numa[i] >> 6ull;
-        uint64_t accumulator_element_count = graph_vertex_count_numa[i] >> 6ull;
+        const uint8_t byte = *p++;
         
-        if ((graph_num_numa_nodes - 1ull == i) && !(graph_num_vertices & 63ull))
-            accumulator_element_count += 1ull;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        shift += 7ull;
         
-        numanodes_tonode_buffer(&graph_vertex_accumulators[first_accumulator_element], accumulator_element_count << 3ull, numa_nodes[i]);
-#else
-        numanodes_tonode_buffer(&graph_vertex_accumulators[graph_vertex_first_numa[i]], sizeof(double) * graph_vertex_count_numa[i], numa_nodes[i]);
-#endif
+        if (0 == (byte & 0x80))
+        {
+            *ptr = p;
+            return value;
+        }
     }
     
-    // initialize the NUMA-ized properties and accumulator arrays by copying from the non-NUMA versions
-    memcpy((void*)graph_vertex_props, (void*)nonnuma_graph_vertex_props, sizeof(double) * (graph_num_vertices + 8));
-    memcpy((void*)graph_vertex_accumulators, (void*)nonnuma_graph_vertex_accumulators, sizeof(double) * (graph_num_vertices + 8));
-    memcpy((void*)graph_vertex_outdegrees, (void*)nonnuma_graph_vertex_outdegrees, sizeof(double) * (graph_num_vertices + 8));
-    
-    // free the non-NUMA versions of the properties and accumulator arrays
-    numanodes_free((void*)nonnuma_graph_vertex_props, sizeof(double) * (graph_num_vertices + 8));
-    numanodes_free((void*)nonnuma_graph_vertex_accumulators, sizeof(double) * (graph_num_vertices + 8));
-    numanodes_free((void*)nonnuma_graph_vertex_outdegrees, sizeof(double) * (graph_num_vertices + 8));
+    // ran off the end of the chunk, which can only happen if the file is malformed
+    graph_read_file_decode_failed = 1ull;
+    *ptr = end;
+    return 0ull;
 }
 
-// Closes an open graph file and frees any temporary data structures.
-void graph_helper_close_graph_file()
+// Encodes a single varint into the specified buffer, which must have room for at least 10 bytes, and returns the number of bytes written.
+uint64_t graph_helper_encode_varint(uint64_t value, uint8_t* buf)
 {
-    if (NULL != graph_read_file)
-    {
-        fclose(graph_read_file);
-        graph_read_file = NULL;
-    }
+    uint64_t count = 0ull;
     
-    for (uint32_t i = 0; i < sizeof(graph_edges_read_buffer)/sizeof(uint64_t*); ++i)
+    while (value >= 0x80ull)
     {
-        if (NULL != graph_edges_read_buffer[i])
-        {
-            numanodes_free((void *)graph_edges_read_buffer[i], sizeof(uint64_t) * graph_edges_read_buffer_max_count);
-            graph_edges_read_buffer[i] = NULL;
-            graph_edges_read_buffer_count[i] = 0ull;
-        }
+        buf[count++] = (uint8_t)(value | 0x80ull);
+        value >>= 7ull;
     }
+    
+    buf[count++] = (uint8_t)value;
+    return count;
 }
 
-// Opens and reads the number of edges and vertices from a file that represents a graph.
-// Sets graph_read_file based on the results of this operation.
-void graph_helper_open_file_and_extract_graph_info(const char* filename)
+// Master control function for decoding a compressed graph file in parallel.
+// Chunks are decoded independently, and each thread decodes a contiguous range of them directly into its part of the decoded edges.
+void graph_helper_multithread_control_decode_compressed_edges(void* arg)
 {
-    // file is encoded as binary
-    graph_read_file = fopen(filename, "rb");
+    const graphcompressed_t* const header = (const graphcompressed_t*)graph_read_file_map;
+    const uint64_t* const chunk_offsets = (const uint64_t*)&header[1];
+    const uint64_t key_offset = header->key_offset;
+    const uint64_t thread_first_chunk = header->num_chunks * (uint64_t)threads_get_global_thread_id() / (uint64_t)threads_get_total_threads();
+    const uint64_t thread_last_chunk = header->num_chunks * (uint64_t)(threads_get_global_thread_id() + 1) / (uint64_t)threads_get_total_threads();
     
-    if (NULL != graph_read_file)
+    for (uint64_t c = thread_first_chunk; c < thread_last_chunk; ++c)
     {
-        uint64_t graph_info[2];
+        const uint8_t* ptr = (const uint8_t*)graph_read_file_map + chunk_offsets[c];
+        const uint8_t* const end = (const uint8_t*)graph_read_file_map + chunk_offsets[c + 1];
+        uint64_t edge_idx = c * header->chunk_edges;
+        const uint64_t last_edge_idx = ((edge_idx + header->chunk_edges) < header->num_edges ? (edge_idx + header->chunk_edges) : header->num_edges);
+        uint64_t key_vertex = 0ull;
         
-        // extract the number of vertices and edges
-        if (2 != fread((void *)graph_info, sizeof(uint64_t), 2, graph_read_file))
-        {
-            graph_helper_close_graph_file();
-        }
-        
-        graph_num_vertices = graph_info[0];
-        graph_num_edges = graph_info[1];
-    }
-    
-    // if not already allocated, create the temporary read buffer
-    if (NULL != graph_read_file)
-    {
-        for (uint32_t i = 0; i < sizeof(graph_edges_read_buffer)/sizeof(uint64_t*); ++i)
+        while (edge_idx < last_edge_idx)
         {
-            if (NULL == graph_edges_read_buffer[i])
+            uint64_t other_vertex = 0ull;
+            uint64_t group_count;
+            
+            key_vertex += graph_helper_decode_varint(&ptr, end);
+            group_count = graph_helper_decode_varint(&ptr, end);
+            
+            if ((0ull == group_count) || (group_count > (last_edge_idx - edge_idx)) || (key_vertex >= header->num_vertices))
             {
-                graph_edges_read_buffer[i] = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_read_buffer_max_count);
+                graph_read_file_decode_failed = 1ull;
+                break;
+            }
             
-                if (NULL == graph_edges_read_buffer[i])
-                {
-                    graph_helper_close_graph_file();
-                }
+            for (uint64_t i = 0ull; i < group_count; ++i)
+            {
+                const uint64_t zigzag_delta = graph_helper_decode_varint(&ptr, end);
+                
+                other_vertex += (zigzag_delta >> 1ull) ^ (0ull - (zigzag_delta & 1ull));
+                
+                graph_read_file_decoded_edges[(edge_idx << 1ull) + key_offset] = key_vertex;
+                graph_read_file_decoded_edges[(edge_idx << 1ull) + (key_offset ^ 1ull)] = other_vertex;
+                edge_idx += 1ull;
             }
         }
     }
 }
 
-// Fills the temporary read buffer with edges read from an open graph file.
-void graph_helper_fill_edge_read_buffer_from_file(uint32_t bufidx)
+// Determines if the graph file currently being read is compressed.
+// Returns 0 for NO, 1 for YES.
+uint32_t graph_helper_graph_file_is_compressed()
 {
-    graph_edges_read_buffer_count[bufidx] = fread((void*)graph_edges_read_buffer[bufidx], sizeof(uint64_t), graph_edges_read_buffer_max_count, graph_read_file);
+    return ((graph_read_file_map_size >= sizeof(graphcompressed_t)) && (GRAPH_COMPRESSED_MAGIC == graph_read_file_map[0])) ? 1 : 0;
 }
 
-// Retrieves the next edge from a temporary edge reading buffer.
-// Places the source and destination vertex information into the specified locations.
-// Returns zero on failure (no edges left in buffer), the next position on success.
-uint64_t graph_helper_retrieve_next_edge_from_buf(uint64_t* out_edge_source, uint64_t* out_edge_dest, uint64_t posidx, uint32_t bufidx)
+// Determines if the graph file currently being read is a text edge list rather than binary.
+// Binary files start with a vertex count, which never uses the upper 16 bits, whereas text files never contain zero bytes.
+// Returns 0 for NO, 1 for YES.
+uint32_t graph_helper_graph_file_is_text()
 {
-    // check for remaining edges in the buffer
-    if (posidx >= graph_edges_read_buffer_count[bufidx])
-    {
-        return 0;
-    }
-    
-    *out_edge_source = graph_edges_read_buffer[bufidx][posidx+0ull];
-    *out_edge_dest = graph_edges_read_buffer[bufidx][posidx+1ull];
-    
-    return (posidx + 2ull);
+    return ((graph_read_file_map_size < (sizeof(uint64_t) * 2ull)) || ((0ull != (graph_read_file_map[0] >> 48ull)) && !graph_helper_graph_file_is_compressed())) ? 1 : 0;
 }
 
-// Thread control function for building the edge vector lists.
-// Producer: reads from the file into a buffer.
-void graph_helper_edge_vector_list_file_buf_producer()
+// Unmaps an open graph file and its weights file, and frees its decoded or parsed edges and weights if it is compressed or text.
+void graph_helper_close_graph_file()
 {
-    uint32_t bufidx = 0;
+    if (NULL != graph_read_file_decoded_edges)
+    {
+        numanodes_free((void*)graph_read_file_decoded_edges, sizeof(uint64_t) * 2ull * graph_read_file_num_edges);
+        graph_read_file_decoded_edges = NULL;
+    }
     
-    while(1)
+    if (NULL != graph_read_file_decoded_weights)
     {
-        graph_helper_fill_edge_read_buffer_from_file(bufidx);
-        
-        if (graph_edges_read_buffer_count[bufidx] < 2ull)
-        {
-            break;
-        }
-        
-        bufidx = (bufidx + 1) & 1;
-        
-        threads_barrier();
+        numanodes_free((void*)graph_read_file_decoded_weights, sizeof(double) * graph_read_file_num_edges);
+        graph_read_file_decoded_weights = NULL;
     }
     
-    threads_barrier();
+    if (NULL != graph_read_file_weights_map)
+    {
+        munmap((void*)graph_read_file_weights_map, graph_read_file_weights_map_size);
+        graph_read_file_weights_map = NULL;
+        graph_read_file_weights_map_size = 0ull;
+    }
+    
+    graph_read_file_edges = NULL;
+    graph_read_file_weights = NULL;
+    graph_read_file_num_edges = 0ull;
+    
+    if (NULL != graph_read_file_map)
+    {
+        munmap((void*)graph_read_file_map, graph_read_file_map_size);
+        graph_read_file_map = NULL;
+        graph_read_file_map_size = 0ull;
+        graph_read_file_map_count = 0ull;
+    }
 }
 
-// Thread control function for building the the in-edge list.
-// Consumer: reads from buffers into data structures.
-void graph_helper_gather_list_file_buf_consumer_edge_list()
+// Opens a file that represents a graph, maps it into memory, and reads the number of edges and vertices from it.
+// Sets graph_read_file_map based on the results of this operation.
+void graph_helper_open_file_and_extract_graph_info(const char* filename)
 {
-    uint32_t bufidx = 0;
-    uint64_t posidx = 0ull;
+    struct stat graph_file_info;
+    void* graph_file_map;
+    int graph_file;
     
-    // stash for holding information while building in-edge list records
-    uint64_t graph_edges_gather_stash_srcids[4] = { 0ull, 0ull, 0ull, 0ull };
-    uint64_t graph_edges_gather_stash_dstid = 0ull;
-    uint32_t graph_edges_gather_stash_count = 0;
+    // file is encoded as binary
+    graph_file = open(filename, O_RDONLY);
+    if (0 > graph_file)
+    {
+        return;
+    }
     
-#ifdef EXPERIMENT_MODEL_LONG_VECTORS
-    // models for higher vector lengths
-    uint32_t graph_edges_gather_stash_count_vl8 = 0;
-    uint64_t graph_edges_gather_stash_dstid_vl8 = 0ull;
-    uint32_t graph_edges_gather_stash_count_vl16 = 0;
-    uint64_t graph_edges_gather_stash_dstid_vl16 = 0ull;
-#endif
-
-    // information about the current record that has been read from the file
-    uint64_t edge_source;
-    uint64_t edge_dest;
+    // file must not be empty, although how much it must contain depends on its format
+    if (0 != fstat(graph_file, &graph_file_info) || 0 == graph_file_info.st_size)
+    {
+        close(graph_file);
+        return;
+    }
     
-#ifdef EXPERIMENT_MODEL_LONG_VECTORS
-    graph_edges_num_vectors_vl8 = 0ull;
-    graph_edges_num_vectors_vl16 = 0ull;
-#endif
+    // map the whole file read-only, the mapping remains valid after the descriptor is closed
+    graph_file_map = mmap(NULL, (size_t)graph_file_info.st_size, PROT_READ, MAP_PRIVATE, graph_file, 0);
+    close(graph_file);
     
-    while(1)
+    if (MAP_FAILED == graph_file_map)
     {
-        threads_barrier();
-        
-        if (graph_edges_read_buffer_count[bufidx] < 2ull)
-        {
-            break;
-        }
-        
-        posidx = graph_helper_retrieve_next_edge_from_buf(&edge_source, &edge_dest, posidx, bufidx);
-        while (0 != posidx)
-        {
-#ifdef EXPERIMENT_MODEL_LONG_VECTORS
-            // model this for vector length 8
-            if ((0 != graph_edges_gather_stash_count_vl8 && graph_edges_gather_stash_dstid_vl8 != edge_dest) || (8 == graph_edges_gather_stash_count_vl8))
-            {
-                graph_edges_num_vectors_vl8 += 1;
-                graph_edges_gather_stash_count_vl8 = 0;
-            }
-            graph_edges_gather_stash_dstid_vl8 = edge_dest;
-            graph_edges_gather_stash_count_vl8 += 1;
-            
-            // model this for vector length 16
-            if ((0 != graph_edges_gather_stash_count_vl16 && graph_edges_gather_stash_dstid_vl16 != edge_dest) || (16 == graph_edges_gather_stash_count_vl16))
-            {
-                graph_edges_num_vectors_vl16 += 1;
-                graph_edges_gather_stash_count_vl16 = 0;
-            }
-            graph_edges_gather_stash_dstid_vl16 = edge_dest;
-            graph_edges_gather_stash_count_vl16 += 1;
-#endif
-            
-            // if stash is not empty and the just-read destination is different, or if the stash is full, flush the stash
-            // note that the stash size is 4 to correspond to the number of packed doubles that fit into a 256-bit AVX register
-            if ((0 != graph_edges_gather_stash_count && graph_edges_gather_stash_dstid != edge_dest) || (4 == graph_edges_gather_stash_count))
-            {
-                // compose a record and write out the stash
-                graph_helper_write_edge_vector(graph_edges_gather_stash_dstid, graph_edges_gather_stash_srcids, graph_edges_gather_stash_count, 0ull);
-                
-                // reinitialize the stash to empty
-                graph_edges_gather_stash_count = 0;
-            }
-            
-            // add the new vertex into the stash
-            graph_edges_gather_stash_dstid = edge_dest;
-            graph_edges_gather_stash_srcids[graph_edges_gather_stash_count] = edge_source;
-            graph_edges_gather_stash_count += 1;
-            
-            posidx = graph_helper_retrieve_next_edge_from_buf(&edge_source, &edge_dest, posidx, bufidx);
-        }
-        
-        bufidx = (bufidx + 1) & 1;
+        return;
     }
     
-    // perform one final commit of the stash now that the last edge has been added to it
-    graph_helper_write_final_edge_vector(graph_edges_gather_stash_dstid, graph_edges_gather_stash_srcids, graph_edges_gather_stash_count, 0ull);
+    graph_read_file_map = (uint64_t*)graph_file_map;
+    graph_read_file_map_size = (uint64_t)graph_file_info.st_size;
+    
+    // only whole edges are ever consumed, so round down to an even number of elements
+    graph_read_file_map_count = (graph_read_file_map_size / sizeof(uint64_t)) & ~1ull;
+    
+    // edges are consumed front-to-back exactly once, so request aggressive read-ahead
+    // huge pages are only available for file mappings on some file systems, but the hint is harmless otherwise
+    madvise(graph_file_map, (size_t)graph_read_file_map_size, MADV_SEQUENTIAL);
+    madvise(graph_file_map, (size_t)graph_read_file_map_size, MADV_HUGEPAGE);
+    
+    // extract the number of vertices and edges, the location of which depends on the file format
+    // text files do not specify them, so they are only known once the file is parsed
+    if (graph_helper_graph_file_is_compressed())
+    {
+        graph_num_vertices = ((const graphcompressed_t*)graph_read_file_map)->num_vertices;
+        graph_num_edges = ((const graphcompressed_t*)graph_read_file_map)->num_edges;
+    }
+    else if (!graph_helper_graph_file_is_text())
+    {
+        graph_num_vertices = graph_read_file_map[0];
+        graph_num_edges = graph_read_file_map[1];
+    }
 }
 
-// Thread control function for building the the out-edge list.
-// Consumer: reads from buffers into data structures.
-void graph_helper_scatter_list_file_buf_consumer_edge_list()
+// Maps the weights file that accompanies the binary graph file currently being read, if it exists, and makes its weights those of the edges being read.
+// Prints and terminates if the weights file exists but does not hold exactly one weight per edge.
+void graph_helper_open_edge_weights_file_or_die(const char* filename)
 {
-    uint32_t bufidx = 0;
-    uint64_t posidx = 0ull;
+    char weights_filename[1100];
+    struct stat weights_file_info;
+    void* weights_file_map;
+    int weights_file;
     
-    // stash for holding information while building out-edge list records
-    uint64_t graph_edges_scatter_stash_dstids[4] = { 0ull, 0ull, 0ull, 0ull };
-    uint64_t graph_edges_scatter_stash_srcid = 0ull;
-    uint32_t graph_edges_scatter_stash_count = 0;
+    snprintf(weights_filename, sizeof(weights_filename), "%s%s", filename, GRAPH_EDGE_WEIGHTS_SUFFIX);
     
-#ifdef EXPERIMENT_MODEL_LONG_VECTORS
-    // models for higher vector lengths
-    uint32_t graph_edges_scatter_stash_count_vl8 = 0;
-    uint64_t graph_edges_scatter_stash_srcid_vl8 = 0ull;
-    uint32_t graph_edges_scatter_stash_count_vl16 = 0;
-    uint64_t graph_edges_scatter_stash_srcid_vl16 = 0ull;
-#endif
+    weights_file = open(weights_filename, O_RDONLY);
+    if (0 > weights_file)
+    {
+        return;
+    }
+    
+    if (0 != fstat(weights_file, &weights_file_info) || ((uint64_t)weights_file_info.st_size != (sizeof(double) * graph_read_file_num_edges)))
+    {
+        fprintf(stderr, "Error: weights file \"%s\" must contain exactly one weight for each of the %llu edges in \"%s\"\n", weights_filename, (long long unsigned int)graph_read_file_num_edges, filename);
+        exit(255);
+    }
+    
+    weights_file_map = mmap(NULL, (size_t)weights_file_info.st_size, PROT_READ, MAP_PRIVATE, weights_file, 0);
+    close(weights_file);
+    
+    if (MAP_FAILED == weights_file_map)
+    {
+        fprintf(stderr, "Error: unable to read file \"%s\"\n", weights_filename);
+        exit(255);
+    }
+    
+    madvise(weights_file_map, (size_t)weights_file_info.st_size, MADV_SEQUENTIAL);
+    
+    graph_read_file_weights_map = (double*)weights_file_map;
+    graph_read_file_weights_map_size = (uint64_t)weights_file_info.st_size;
+    graph_read_file_weights = graph_read_file_weights_map;
+}
 
-    // information about the current record that has been read from the file
-    uint64_t edge_source;
-    uint64_t edge_dest;
+// Master control function for transposing an edge list in memory, implemented as a parallel stable radix sort in two digits.
+// First, each thread distributes its slice of the edges into ranges of key vertices, preserving the original order within each range.
+// Then, the threads on each node sort the ranges whose output lies in that node's memory, with a counting sort over the vertices in each range.
+void graph_helper_multithread_control_transpose_edges(void* arg)
+{
+    const uint32_t thread_id = threads_get_global_thread_id();
+    const uint32_t num_threads = threads_get_total_threads();
+    const uint32_t group_id = threads_get_thread_group_id();
     
-#ifdef EXPERIMENT_MODEL_LONG_VECTORS
-    graph_edges_num_vectors_vl8 = 0ull;
-    graph_edges_num_vectors_vl16 = 0ull;
-#endif
+    const uint64_t* const edges = graph_ingress_edges;
+    const double* const weights = graph_ingress_weights;
+    const uint64_t num_edges = graph_ingress_num_edges;
+    const uint64_t key_offset = graph_transpose_key_offset;
+    const uint64_t num_buckets = graph_transpose_num_buckets;
+    const uint64_t bucket_shift = graph_transpose_bucket_shift;
+    
+    const uint64_t thread_first_edge = num_edges * (uint64_t)thread_id / (uint64_t)num_threads;
+    const uint64_t thread_last_edge = num_edges * (uint64_t)(thread_id + 1) / (uint64_t)num_threads;
+    uint64_t* const thread_bucket_positions = &graph_transpose_thread_bucket_positions[num_buckets * (uint64_t)thread_id];
     
-    while(1)
+    uint64_t* key_positions;
+    uint64_t bucket_idx;
+    
+    // first pass: count the number of edges in this thread's slice that belong in each vertex range
+    for (uint64_t i = thread_first_edge; i < thread_last_edge; ++i)
     {
-        threads_barrier();
-        
-        if (graph_edges_read_buffer_count[bufidx] < 2ull)
-        {
-            break;
-        }
+        thread_bucket_positions[edges[(i << 1ull) + key_offset] >> bucket_shift] += 1ull;
+    }
+    
+    threads_barrier();
+    
+    // turn the counts into positions, ordered first by vertex range and then by thread so that the sort is stable
+    // then assign vertex ranges to NUMA nodes based on where their edges will be written
+    if (0 == thread_id)
+    {
+        uint64_t position = 0ull;
         
-        posidx = graph_helper_retrieve_next_edge_from_buf(&edge_source, &edge_dest, posidx, bufidx);
-        while (0 != posidx)
+        for (uint64_t b = 0ull; b < num_buckets; ++b)
         {
-#ifdef EXPERIMENT_MODEL_LONG_VECTORS
-            // model this for vector length 8
-            if ((0 != graph_edges_scatter_stash_count_vl8 && graph_edges_scatter_stash_srcid_vl8 != edge_source) || (8 == graph_edges_scatter_stash_count_vl8))
-            {
-                graph_edges_num_vectors_vl8 += 1;
-                graph_edges_scatter_stash_count_vl8 = 0;
-            }
-            graph_edges_scatter_stash_srcid_vl8 = edge_source;
-            graph_edges_scatter_stash_count_vl8 += 1;
+            graph_transpose_bucket_first_edge[b] = position;
             
-            // model this for vector length 16
-            if ((0 != graph_edges_scatter_stash_count_vl16 && graph_edges_scatter_stash_srcid_vl16 != edge_source) || (16 == graph_edges_scatter_stash_count_vl16))
+            for (uint32_t t = 0; t < num_threads; ++t)
             {
-                graph_edges_num_vectors_vl16 += 1;
-                graph_edges_scatter_stash_count_vl16 = 0;
+                const uint64_t count = graph_transpose_thread_bucket_positions[num_buckets * (uint64_t)t + b];
+                
+                graph_transpose_thread_bucket_positions[num_buckets * (uint64_t)t + b] = position;
+                position += count;
             }
-            graph_edges_scatter_stash_srcid_vl16 = edge_source;
-            graph_edges_scatter_stash_count_vl16 += 1;
-#endif
+        }
+        
+        graph_transpose_bucket_first_edge[num_buckets] = position;
+        
+        bucket_idx = 0ull;
+        for (uint32_t g = 0; g < graph_num_numa_nodes; ++g)
+        {
+            graph_transpose_group_next_bucket[g] = bucket_idx;
             
-            // if stash is not empty and the just-read source is different, or if the stash is full, flush the stash
-            // note that the stash size is 4 to correspond to the number of packed doubles that fit into a 256-bit AVX register
-            if ((0 != graph_edges_scatter_stash_count && graph_edges_scatter_stash_srcid != edge_source) || (4 == graph_edges_scatter_stash_count))
+            while ((bucket_idx < num_buckets) && (graph_transpose_bucket_first_edge[bucket_idx] < (num_edges * (uint64_t)(g + 1) / (uint64_t)graph_num_numa_nodes)))
             {
-                // compose a record and write out the stash
-                graph_helper_write_edge_vector(graph_edges_scatter_stash_srcid, graph_edges_scatter_stash_dstids, graph_edges_scatter_stash_count, graph_edges_gather_list_num_blocks);
-                
-                // reinitialize the stash to empty
-                graph_edges_scatter_stash_count = 0;
+                bucket_idx += 1ull;
             }
             
-            // add the new vertex into the stash
-            graph_edges_scatter_stash_srcid = edge_source;
-            graph_edges_scatter_stash_dstids[graph_edges_scatter_stash_count] = edge_dest;
-            graph_edges_scatter_stash_count += 1;
-            
-            posidx = graph_helper_retrieve_next_edge_from_buf(&edge_source, &edge_dest, posidx, bufidx);
+            graph_transpose_group_end_bucket[g] = bucket_idx;
         }
         
-        bufidx = (bufidx + 1) & 1;
+        graph_transpose_group_end_bucket[graph_num_numa_nodes - 1] = num_buckets;
     }
     
-    // perform one final commit of the stash now that the last edge has been added to it
-    graph_helper_write_final_edge_vector(graph_edges_scatter_stash_srcid, graph_edges_scatter_stash_dstids, graph_edges_scatter_stash_count, 0ull);
-}
-
-// Thread control function for building the the in-edge list.
-// Consumer: reads from buffers and initializes graph properties.
-void graph_helper_gather_list_file_buf_consumer_property_init()
-{
-    uint32_t bufidx = 0;
-    uint64_t posidx = 0ull;
-
-    // information about the current record that has been read from the file
-    uint64_t edge_source;
-    uint64_t edge_dest;
+    threads_barrier();
     
-    while(1)
+    // second pass: distribute this thread's slice into the temporary buffer by vertex range
+    for (uint64_t i = thread_first_edge; i < thread_last_edge; ++i)
     {
-        threads_barrier();
+        const uint64_t position = thread_bucket_positions[edges[(i << 1ull) + key_offset] >> bucket_shift]++;
         
-        if (graph_edges_read_buffer_count[bufidx] < 2ull)
-        {
-            break;
-        }
+        graph_transpose_edges_temp[(position << 1ull) + 0ull] = edges[(i << 1ull) + 0ull];
+        graph_transpose_edges_temp[(position << 1ull) + 1ull] = edges[(i << 1ull) + 1ull];
         
-        posidx = graph_helper_retrieve_next_edge_from_buf(&edge_source, &edge_dest, posidx, bufidx);
-        while (0 != posidx)
+        if (NULL != weights)
         {
-            // give each source vertex outdegree credit for the edge
-            graph_vertex_outdegrees[edge_source] += 1.0;
-            
-            posidx = graph_helper_retrieve_next_edge_from_buf(&edge_source, &edge_dest, posidx, bufidx);
+            graph_transpose_weights_temp[position] = weights[i];
         }
-        
-        bufidx = (bufidx + 1) & 1;
     }
-}
-
-// Thread control function for building the the in-edge list.
-// Consumer: reads from buffers and initializes graph properties.
-void graph_helper_scatter_list_file_buf_consumer_property_init()
-{
-    uint32_t bufidx = 0;
-    uint64_t posidx = 0ull;
-
-    // information about the current record that has been read from the file
-    uint64_t edge_source;
-    uint64_t edge_dest;
     
-    while(1)
+    threads_barrier();
+    
+    // third pass: claim vertex ranges assigned to this node one at a time and sort each one by vertex
+    key_positions = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) << bucket_shift);
+    
+    while ((bucket_idx = __sync_fetch_and_add(&graph_transpose_group_next_bucket[group_id], 1ull)) < graph_transpose_group_end_bucket[group_id])
     {
-        threads_barrier();
+        const uint64_t bucket_first_edge = graph_transpose_bucket_first_edge[bucket_idx];
+        const uint64_t bucket_last_edge = graph_transpose_bucket_first_edge[bucket_idx + 1ull];
+        const uint64_t bucket_first_key = bucket_idx << bucket_shift;
+        uint64_t position = bucket_first_edge;
         
-        if (graph_edges_read_buffer_count[bufidx] < 2ull)
+        if (bucket_first_edge == bucket_last_edge)
         {
-            break;
+            continue;
+        }
+        
+        memset((void*)key_positions, 0, sizeof(uint64_t) << bucket_shift);
+        
+        for (uint64_t i = bucket_first_edge; i < bucket_last_edge; ++i)
+        {
+            key_positions[graph_transpose_edges_temp[(i << 1ull) + key_offset] - bucket_first_key] += 1ull;
         }
         
-        posidx = graph_helper_retrieve_next_edge_from_buf(&edge_source, &edge_dest, posidx, bufidx);
-        while (0 != posidx)
+        for (uint64_t k = 0ull; k < (1ull << bucket_shift); ++k)
         {
-            // no properties to initialize during the out-edge list construction
+            const uint64_t count = key_positions[k];
             
-            posidx = graph_helper_retrieve_next_edge_from_buf(&edge_source, &edge_dest, posidx, bufidx);
+            key_positions[k] = position;
+            position += count;
         }
         
-        bufidx = (bufidx + 1) & 1;
+        for (uint64_t i = bucket_first_edge; i < bucket_last_edge; ++i)
+        {
+            const uint64_t out_position = key_positions[graph_transpose_edges_temp[(i << 1ull) + key_offset] - bucket_first_key]++;
+            
+            graph_transpose_edges[(out_position << 1ull) + 0ull] = graph_transpose_edges_temp[(i << 1ull) + 0ull];
+            graph_transpose_edges[(out_position << 1ull) + 1ull] = graph_transpose_edges_temp[(i << 1ull) + 1ull];
+            
+            if (NULL != weights)
+            {
+                graph_transpose_weights[out_position] = graph_transpose_weights_temp[i];
+            }
+        }
     }
+    
+    numanodes_free((void*)key_positions, sizeof(uint64_t) << bucket_shift);
 }
 
-// Master control function for building the in-edge list.
-void graph_helper_multithread_control_build_gather_list(void* arg)
+// Transposes the current ingress edges in memory, so that they are ordered by source (key offset 0) or destination (key offset 1) instead.
+// The sort is stable, so edges sharing a vertex keep their original relative order, and any weights are moved along with their edges.
+// Uses every core on each of the specified NUMA nodes, and replaces the current ingress edges with the result, which remains allocated until graph_helper_free_sorted_edges() is called.
+void graph_helper_transpose_ingress_edges(const uint64_t key_offset, const uint32_t* numa_nodes)
 {
-    switch (threads_get_local_thread_id())
+    const uint32_t num_threads = graph_num_numa_nodes * numanodes_get_num_processors_on_node(numa_nodes[0]);
+    const uint64_t edge_buf_size = sizeof(uint64_t) * 2ull * graph_ingress_num_edges;
+    const uint64_t weight_buf_size = sizeof(double) * graph_ingress_num_edges;
+    uint64_t vertex_id_bits = 1ull;
+    
+    // split each vertex ID into two digits of roughly equal width, the upper one identifying the vertex range
+    while ((vertex_id_bits < 64ull) && ((graph_num_vertices - 1ull) >> vertex_id_bits))
     {
-        case 0:
-            graph_helper_edge_vector_list_file_buf_producer();
-            break;
-        
-        case 1:
-            graph_helper_gather_list_file_buf_consumer_edge_list();
-            break;
-        
-        case 2:
-            graph_helper_gather_list_file_buf_consumer_property_init();
-            break;
-        
-        default:
-            break;
+        vertex_id_bits += 1ull;
     }
-}
-
-// Master control function for building the out-edge list.
-void graph_helper_multithread_control_build_scatter_list(void* arg)
-{
-    switch (threads_get_local_thread_id())
+    
+    graph_transpose_key_offset = key_offset;
+    graph_transpose_bucket_shift = vertex_id_bits >> 1ull;
+    graph_transpose_num_buckets = ((graph_num_vertices - 1ull) >> graph_transpose_bucket_shift) + 1ull;
+    
+    // allocate the output and temporary buffers, giving each NUMA node an equal part of each
+    graph_transpose_edges = (uint64_t*)numanodes_malloc_divisible(edge_buf_size, numa_nodes[0], graph_helper_edge_array_granularity(graph_ingress_num_edges, sizeof(uint64_t) * 2ull));
+    graph_transpose_edges_temp = (uint64_t*)numanodes_malloc_divisible(edge_buf_size, numa_nodes[0], graph_helper_edge_array_granularity(graph_ingress_num_edges, sizeof(uint64_t) * 2ull));
+    if ((NULL == graph_transpose_edges) || (NULL == graph_transpose_edges_temp))
     {
-        case 0:
-            graph_helper_edge_vector_list_file_buf_producer();
-            break;
-        
-        case 1:
-            graph_helper_scatter_list_file_buf_consumer_edge_list();
-            break;
-        
-        case 2:
-            graph_helper_scatter_list_file_buf_consumer_property_init();
-            break;
-        
-        default:
-            break;
+        fprintf(stderr, "Error: unable to allocate memory to transpose the edge list\n");
+        exit(255);
     }
-}
-
-// Builds the in-edge list, calling the other helper functions as needed.
-// Uses three threads: one to read from the file into a buffer, one to read from the buffer into the in-edge list, and one to initialize other graph properties.
-void graph_helper_build_gather_list(uint32_t on_numa_node)
-{
-    uint32_t numa_nodes[] = {on_numa_node};
-    
-    // spawn three threads to create the in-edge list: one to read from the file, one to set up the in-edge list, and one to initialize graph properties
-    threads_spawn(3, 1, numa_nodes, 0, &graph_helper_multithread_control_build_gather_list, NULL);
     
-    // copy over common edge-list-building values that are specific to the in-edge list
-    graph_edges_gather_list_vector_count = graph_edge_list_vector_count;
-    graph_edges_gather_list_num_blocks = graph_edge_list_num_blocks;
-    graph_edges_gather_list_block_first_dest_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
-    graph_edges_gather_list_block_last_dest_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
-    memcpy((void*)graph_edges_gather_list_block_first_dest_vertex, (void*)graph_edge_list_block_first_shared_vertex, sizeof(uint64_t*) * graph_edges_gather_list_num_blocks);
-    memcpy((void*)graph_edges_gather_list_block_last_dest_vertex, (void*)graph_edge_list_block_last_shared_vertex, sizeof(uint64_t*) * graph_edges_gather_list_num_blocks);
+    if (NULL != graph_ingress_weights)
+    {
+        graph_transpose_weights = (double*)numanodes_malloc_divisible(weight_buf_size, numa_nodes[0], graph_helper_edge_array_granularity(graph_ingress_num_edges, sizeof(double)));
+        graph_transpose_weights_temp = (double*)numanodes_malloc_divisible(weight_buf_size, numa_nodes[0], graph_helper_edge_array_granularity(graph_ingress_num_edges, sizeof(double)));
+        if ((NULL == graph_transpose_weights) || (NULL == graph_transpose_weights_temp))
+        {
+            fprintf(stderr, "Error: unable to allocate memory to transpose the edge list\n");
+            exit(255);
+        }
+    }
     
-    // output the total number of blocks in the in-edge list
-    printf("In-edges:  created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_gather_list_vector_count, (double)graph_num_edges / (double)graph_edges_gather_list_vector_count / 4.0 * 100.0);
+    for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
+    {
+        const uint64_t first_edge = graph_ingress_num_edges * i / graph_num_numa_nodes;
+        const uint64_t edge_count = (graph_ingress_num_edges * (i + 1) / graph_num_numa_nodes) - first_edge;
+        
+        numanodes_tonode_buffer(&graph_transpose_edges[first_edge << 1ull], sizeof(uint64_t) * 2ull * edge_count, numa_nodes[i]);
+        numanodes_tonode_buffer(&graph_transpose_edges_temp[first_edge << 1ull], sizeof(uint64_t) * 2ull * edge_count, numa_nodes[i]);
+        
+        if (NULL != graph_ingress_weights)
+        {
+            numanodes_tonode_buffer(&graph_transpose_weights[first_edge], sizeof(double) * edge_count, numa_nodes[i]);
+            numanodes_tonode_buffer(&graph_transpose_weights_temp[first_edge], sizeof(double) * edge_count, numa_nodes[i]);
+        }
+    }
     
-#ifdef EXPERIMENT_MODEL_LONG_VECTORS
-    // output model results for longer vector lengths
-    printf("In-edges:  VL8: created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_num_vectors_vl8, (double)graph_num_edges / (double)graph_edges_num_vectors_vl8 / 8.0 * 100.0);
-    printf("In-edges:  VL16: created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_num_vectors_vl16, (double)graph_num_edges / (double)graph_edges_num_vectors_vl16 / 16.0 * 100.0);
-#endif
-}
-
-// Builds the out-edge list, calling the other helper functions as needed.
-// Uses three threads: one to read from the file into a buffer, one to read from the buffer into the in-edge list, and one to initialize other graph properties.
-void graph_helper_build_scatter_list(uint32_t on_numa_node)
-{
-    uint32_t numa_nodes[] = {on_numa_node};
+    // allocate the bookkeeping structures
+    graph_transpose_thread_bucket_positions = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_transpose_num_buckets * num_threads);
+    graph_transpose_bucket_first_edge = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * (graph_transpose_num_buckets + 1ull));
+    graph_transpose_group_next_bucket = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_num_numa_nodes);
+    graph_transpose_group_end_bucket = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_num_numa_nodes);
+    memset((void*)graph_transpose_thread_bucket_positions, 0, sizeof(uint64_t) * graph_transpose_num_buckets * num_threads);
     
-    // spawn three threads to create the in-edge list: one to read from the file, one to set up the in-edge list, and one to initialize graph properties
-    threads_spawn(3, 1, numa_nodes, 0, &graph_helper_multithread_control_build_scatter_list, NULL);
+    threads_spawn(num_threads, graph_num_numa_nodes, numa_nodes, 0, &graph_helper_multithread_control_transpose_edges, NULL);
     
-    // copy over common edge-list-building values that are specific to the in-edge list
-    graph_edges_scatter_list_vector_count = graph_edge_list_vector_count;
-    graph_edges_scatter_list_num_blocks = graph_edge_list_num_blocks;
-    graph_edges_scatter_list_block_first_source_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
-    graph_edges_scatter_list_block_last_source_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
-    memcpy((void*)graph_edges_scatter_list_block_first_source_vertex, (void*)graph_edge_list_block_first_shared_vertex, sizeof(uint64_t*) * graph_edges_scatter_list_num_blocks);
-    memcpy((void*)graph_edges_scatter_list_block_last_source_vertex, (void*)graph_edge_list_block_last_shared_vertex, sizeof(uint64_t*) * graph_edges_scatter_list_num_blocks);
+    // free everything except the output
+    numanodes_free((void*)graph_transpose_thread_bucket_positions, sizeof(uint64_t) * graph_transpose_num_buckets * num_threads);
+    numanodes_free((void*)graph_transpose_bucket_first_edge, sizeof(uint64_t) * (graph_transpose_num_buckets + 1ull));
+    numanodes_free((void*)graph_transpose_group_next_bucket, sizeof(uint64_t) * graph_num_numa_nodes);
+    numanodes_free((void*)graph_transpose_group_end_bucket, sizeof(uint64_t) * graph_num_numa_nodes);
+    numanodes_free((void*)graph_transpose_edges_temp, edge_buf_size);
+    graph_transpose_thread_bucket_positions = NULL;
+    graph_transpose_bucket_first_edge = NULL;
+    graph_transpose_group_next_bucket = NULL;
+    graph_transpose_group_end_bucket = NULL;
+    graph_transpose_edges_temp = NULL;
     
-    // output the total number of blocks in the out-edge list
-    printf("Out-edges: created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_scatter_list_vector_count, (double)graph_num_edges / (double)graph_edges_scatter_list_vector_count / 4.0 * 100.0);
+    if (NULL != graph_transpose_weights_temp)
+    {
+        numanodes_free((void*)graph_transpose_weights_temp, weight_buf_size);
+        graph_transpose_weights_temp = NULL;
+    }
     
-#ifdef EXPERIMENT_MODEL_LONG_VECTORS
-    // output model results for longer vector lengths
-    printf("Out-edges: VL8: created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_num_vectors_vl8, (double)graph_num_edges / (double)graph_edges_num_vectors_vl8 / 8.0 * 100.0);
-    printf("Out-edges: VL16: created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_num_vectors_vl16, (double)graph_num_edges / (double)graph_edges_num_vectors_vl16 / 16.0 * 100.0);
-#endif
+    graph_ingress_edges = graph_transpose_edges;
+    graph_ingress_weights = graph_transpose_weights;
 }
 
-
-/* -------- FUNCTIONS ------------------------------------------------------ */
-// See "graphdata.h" for documentation.
-
-void graph_data_read_from_file(const char* filename_gather, const char* filename_scatter, const uint32_t num_numa_nodes, const uint32_t* numa_nodes)
+// Frees the edges produced by sorting an edge list, whether in memory or externally, if any.
+void graph_helper_free_sorted_edges()
 {
-    graph_num_numa_nodes = num_numa_nodes;
-
-    // open the in-edge list file and extract the number of vertices and edges
-    graph_helper_open_file_and_extract_graph_info(filename_gather);
-    if (NULL == graph_read_file)
+    if (NULL != graph_transpose_edges)
     {
-        fprintf(stderr, "Error: unable to read file \"%s\"\n", filename_gather);
-        exit(255);
+        numanodes_free((void*)graph_transpose_edges, sizeof(uint64_t) * 2ull * graph_ingress_num_edges);
+        graph_transpose_edges = NULL;
     }
     
-    // create vertex-related structures
-    graph_helper_create_vertex_info(numa_nodes[0]);
+    if (NULL != graph_transpose_weights)
+    {
+        numanodes_free((void*)graph_transpose_weights, sizeof(double) * graph_ingress_num_edges);
+        graph_transpose_weights = NULL;
+    }
     
-    // slight hack to ensure we can allocate enough memory for larger graphs
-    if (graph_num_edges > 1000000000ull)
+    if (NULL != graph_sort_edges_map)
     {
-        graph_edge_list_block_bufs[0] = (__m256i*)numanodes_malloc(sizeof(__m256i) * graph_num_edges / 2ull, numa_nodes[0]);
+        munmap((void*)graph_sort_edges_map, sizeof(uint64_t) * 2ull * graph_ingress_num_edges);
+        graph_sort_edges_map = NULL;
     }
-    else
+}
+
+// Master control function for checking in parallel whether the current ingress edges are sorted by source (key offset 0) or destination (key offset 1).
+void graph_helper_multithread_control_check_edges_sorted(void* arg)
+{
+    const uint64_t key_offset = *((uint64_t*)arg);
+    const uint64_t thread_first_edge = graph_ingress_num_edges * (uint64_t)threads_get_global_thread_id() / (uint64_t)threads_get_total_threads();
+    uint64_t thread_last_edge = graph_ingress_num_edges * (uint64_t)(threads_get_global_thread_id() + 1) / (uint64_t)threads_get_total_threads();
+    
+    // each thread also compares its last edge with the first edge of the next slice
+    if (thread_last_edge < graph_ingress_num_edges)
     {
-        graph_edge_list_block_bufs[0] = (__m256i*)numanodes_malloc(sizeof(__m256i) * graph_num_edges, numa_nodes[0]);
+        thread_last_edge += 1ull;
     }
     
-    graph_edge_list_block_bufs[1] = graph_edge_list_block_bufs[0];
-
-    // initialize ingress data structures
-    graph_edge_list_vector_count = 0ull;
-    graph_edge_list_num_blocks = 0ull;
-    graph_edge_list_block_counts = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t));
-    graph_edge_list_block_first_shared_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t));
-    graph_edge_list_block_last_shared_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t));
-    memset((void*)graph_edge_list_block_counts, 0, sizeof(uint64_t));
-    memset((void*)graph_edge_list_block_first_shared_vertex, 0, sizeof(uint64_t));
-    memset((void*)graph_edge_list_block_last_shared_vertex, 0, sizeof(uint64_t));
-
-    // build the in-edge list and then close the current file
-    graph_helper_build_gather_list(numa_nodes[0]);
-    graph_helper_close_graph_file();
+    for (uint64_t i = thread_first_edge + 1ull; i < thread_last_edge; ++i)
+    {
+        if (graph_ingress_edges[(i << 1ull) + key_offset] < graph_ingress_edges[((i - 1ull) << 1ull) + key_offset])
+        {
+            graph_sort_found_unsorted = 1ull;
+            break;
+        }
+    }
+}
 
-    // initialize vertex-related data structures
-    graph_helper_initialize_vertex_info();
+// Creates an anonymous temporary file of the specified size for spilling edges to local disk, or prints and terminates on failure.
+// The file is placed in the directory named by the TMPDIR environment variable, or "/tmp" by default, and is deleted once it is no longer mapped or open.
+int graph_helper_create_spill_file_or_die(const uint64_t size)
+{
+    const char* spill_dir = getenv("TMPDIR");
+    char spill_filename[4096];
+    int spill_fd;
     
-    // create NUMA-aware data structures for the in-edge list
-    graph_helper_numaize_gather(numa_nodes);
+    if ((NULL == spill_dir) || ('\0' == spill_dir[0]))
+    {
+        spill_dir = "/tmp";
+    }
     
-    // now that the number of vectors is known, it is not necessary to keep such a large buffer around for ingress
-    // add around 10% slack just in case the out-edge list ends up being slightly bigger
-    numanodes_free((void*)graph_edge_list_block_bufs[0], sizeof(__m256i) * graph_num_edges / 2ull);
-    graph_edge_list_block_bufs[0] = (__m256i*)numanodes_malloc(sizeof(__m256i) * graph_edges_gather_list_vector_count * 11ull / 10ull, numa_nodes[0]);
-    graph_edge_list_block_bufs[1] = graph_edge_list_block_bufs[0];
+    snprintf(spill_filename, sizeof(spill_filename), "%s/grazelle-sort-XXXXXX", spill_dir);
     
-#if !defined(EXPERIMENT_EDGE_FORCE_PULL) || defined(EXPERIMENT_ASSIGN_VERTICES_BY_PUSH)
-    // open the out-edge list file, it does not matter that this also extracts the number of vertices and edges
-    graph_helper_open_file_and_extract_graph_info(filename_scatter);
-    if (NULL == graph_read_file)
+    spill_fd = mkstemp(spill_filename);
+    if (spill_fd < 0)
     {
-        fprintf(stderr, "Error: unable to read file \"%s\"\n", filename_scatter);
+        fprintf(stderr, "Error: unable to create temporary file in \"%s\" to sort the edge list\n", spill_dir);
         exit(255);
     }
     
-    // initialize ingress data structures
-    graph_edge_list_vector_count = 0ull;
-    graph_edge_list_num_blocks = 0ull;
-    graph_edge_list_block_counts = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t));
-    graph_edge_list_block_first_shared_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t));
-    graph_edge_list_block_last_shared_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t));
-    memset((void*)graph_edge_list_block_counts, 0, sizeof(uint64_t));
-    memset((void*)graph_edge_list_block_first_shared_vertex, 0, sizeof(uint64_t));
-    memset((void*)graph_edge_list_block_last_shared_vertex, 0, sizeof(uint64_t));
-    
-    // build the out-edge list and then close the current file
-    graph_helper_build_scatter_list(numa_nodes[0]);
-    graph_helper_close_graph_file();
-    
-    // create NUMA-aware data structures for the out-edge list
-    graph_helper_numaize_scatter(numa_nodes);
-#endif
-
-    // create NUMA-aware data structures for vertices
-    graph_helper_numaize_vertices(numa_nodes);
-    
-    // create and initialize the frontiers
-    graph_helper_create_and_initialize_frontiers(numa_nodes);
+    unlink(spill_filename);
     
-    // initialize the dynamic scheduling counters, one per node
-    graph_scheduler_dynamic_counter_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
-    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    if (0 != ftruncate(spill_fd, (off_t)size))
     {
-        graph_scheduler_dynamic_counter_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t*), numa_nodes[i]);
+        fprintf(stderr, "Error: unable to reserve %llu bytes in \"%s\" to sort the edge list\n", (long long unsigned int)size, spill_dir);
+        exit(255);
     }
+    
+    return spill_fd;
 }
 
-// ---------
-
-void graph_data_allocate_merge_buffers(const uint64_t num_threads, const uint32_t num_numa_nodes, const uint32_t* numa_nodes)
+// Master control function for the merge phase of an external sort.
+// Each thread merges all the runs over its own range of key vertices, locating that range in each run by binary search, so no two threads write the same part of the output.
+void graph_helper_multithread_control_merge_sorted_runs(void* arg)
 {
-    const uint64_t num_blocks_per_node = sched_pull_units_per_node;
-    const uint64_t num_blocks = sched_pull_units_total;
+    const uint32_t thread_id = threads_get_global_thread_id();
+    const uint64_t key_offset = graph_transpose_key_offset;
+    const uint64_t first_key = graph_sort_thread_first_key[thread_id];
+    const uint64_t last_key = graph_sort_thread_first_key[thread_id + 1];
+    const uint64_t num_runs = graph_sort_num_runs;
     
-    graph_vertex_merge_buffer = (mergeaccum_t*)numanodes_malloc(sizeof(mergeaccum_t) * num_blocks, numa_nodes[0]);
-    graph_vertex_merge_buffer_baseptr_numa = (mergeaccum_t**)numanodes_malloc(sizeof(mergeaccum_t*) * num_numa_nodes, numa_nodes[0]);
+    uint64_t* run_next_edge;
+    uint64_t* run_end_edge;
+    uint64_t* heap;
+    uint64_t heap_count = 0ull;
+    uint64_t position = 0ull;
     
-    for (uint64_t i = 0; i < num_blocks; ++i)
+    if (first_key == last_key)
     {
-        graph_vertex_merge_buffer[i].initial_vertex_id = ~0ull;
-        graph_vertex_merge_buffer[i].final_vertex_id = ~0ull;
-        graph_vertex_merge_buffer[i].final_partial_value = 0.0;
+        return;
     }
     
-    for (uint64_t i = 0; i < num_numa_nodes; ++i)
+    run_next_edge = (uint64_t*)malloc(sizeof(uint64_t) * num_runs);
+    run_end_edge = (uint64_t*)malloc(sizeof(uint64_t) * num_runs);
+    heap = (uint64_t*)malloc(sizeof(uint64_t) * num_runs);
+    
+#define GRAPH_SORT_RUN_KEY(r)               (graph_sort_runs_map[(run_next_edge[(r)] << 1ull) + key_offset])
+#define GRAPH_SORT_RUN_PRECEDES(r1, r2)     ((GRAPH_SORT_RUN_KEY(r1) < GRAPH_SORT_RUN_KEY(r2)) || ((GRAPH_SORT_RUN_KEY(r1) == GRAPH_SORT_RUN_KEY(r2)) && ((r1) < (r2))))
+    
+    // locate this thread's range of keys within each run, and figure out where in the output the range begins
+    for (uint64_t r = 0ull; r < num_runs; ++r)
     {
-        graph_vertex_merge_buffer_baseptr_numa[i] = &graph_vertex_merge_buffer[i * num_blocks_per_node];
-    }
-}
+        const uint64_t run_first_edge = r * graph_sort_run_edges;
+        const uint64_t run_last_edge = ((r + 1ull) * graph_sort_run_edges < graph_ingress_num_edges ? (r + 1ull) * graph_sort_run_edges : graph_ingress_num_edges);
+        
+        for (uint32_t which = 0; which < 2; ++which)
+        {
+            const uint64_t key = (0 == which ? first_key : last_key);
+            uint64_t lo = run_first_edge;
+            uint64_t hi = run_last_edge;
+            
+            while (lo < hi)
+            {
+                const uint64_t mid = lo + ((hi - lo) >> 1ull);
+                
+                if (graph_sort_runs_map[(mid << 1ull) + key_offset] < key)
+                    lo = mid + 1ull;
+                else
+                    hi = mid;
+            }
+            
+            if (0 == which)
+                run_next_edge[r] = lo;
+            else
+                run_end_edge[r] = lo;
+        }
+        
+        position += run_next_edge[r] - run_first_edge;
+        
+        // add non-empty runs to the heap, which is ordered by key and then by run so that the merge is stable
+        if (run_next_edge[r] < run_end_edge[r])
+        {
+            uint64_t child = heap_count++;
+            
+            while (child > 0ull && GRAPH_SORT_RUN_PRECEDES(r, heap[(child - 1ull) >> 1ull]))
+            {
+                heap[child] = heap[(child - 1ull) >> 1ull];
+                child = (child - 1ull) >> 1ull;
+            }
+            
+            heap[child] = r;
+        }
+    }
+    
+    // repeatedly move the first edge of the run at the top of the heap to the output
+    while (heap_count > 0ull)
+    {
+        const uint64_t r = heap[0];
+        uint64_t parent = 0ull;
+        uint64_t top;
+        
+        graph_sort_edges_map[(position << 1ull) + 0ull] = graph_sort_runs_map[(run_next_edge[r] << 1ull) + 0ull];
+        graph_sort_edges_map[(position << 1ull) + 1ull] = graph_sort_runs_map[(run_next_edge[r] << 1ull) + 1ull];
+        position += 1ull;
+        run_next_edge[r] += 1ull;
+        
+        // the run either remains at the top, with a new key, or is replaced by the last run in the heap
+        if (run_next_edge[r] < run_end_edge[r])
+        {
+            top = r;
+        }
+        else
+        {
+            top = heap[--heap_count];
+        }
+        
+        while (1)
+        {
+            uint64_t child = (parent << 1ull) + 1ull;
+            
+            if (child >= heap_count)
+                break;
+            
+            if ((child + 1ull < heap_count) && GRAPH_SORT_RUN_PRECEDES(heap[child + 1ull], heap[child]))
+                child += 1ull;
+            
+            if (!GRAPH_SORT_RUN_PRECEDES(heap[child], top))
+                break;
+            
+            heap[parent] = heap[child];
+            parent = child;
+        }
+        
+        if (heap_count > 0ull)
+        {
+            heap[parent] = top;
+        }
+    }
+    
+#undef GRAPH_SORT_RUN_PRECEDES
+#undef GRAPH_SORT_RUN_KEY
+    
+    free((void*)run_next_edge);
+    free((void*)run_end_edge);
+    free((void*)heap);
+}
+
+// Sorts edges that do not fit in memory using an external merge sort, replacing the current ingress edges with the result.
+// Each run is sorted in memory using every core and spilled to a temporary file on local disk, then all runs are merged in parallel into a second temporary file.
+void graph_helper_external_sort_ingress_edges(const uint64_t key_offset, const uint32_t* numa_nodes)
+{
+    const uint32_t num_threads = graph_num_numa_nodes * numanodes_get_num_processors_on_node(numa_nodes[0]);
+    const uint64_t* const unsorted_edges = graph_ingress_edges;
+    const uint64_t num_edges = graph_ingress_num_edges;
+    const uint64_t edge_buf_size = sizeof(uint64_t) * 2ull * num_edges;
+    int spill_fd;
+    
+    graph_sort_run_edges = GRAPH_INGRESS_SORT_RUN_EDGES;
+    graph_sort_num_runs = (num_edges + graph_sort_run_edges - 1ull) / graph_sort_run_edges;
+    
+    // first phase: sort each run in memory and spill it to disk, at the same position it occupies in the input
+    spill_fd = graph_helper_create_spill_file_or_die(edge_buf_size);
+    
+    for (uint64_t r = 0ull; r < graph_sort_num_runs; ++r)
+    {
+        const uint64_t run_first_edge = r * graph_sort_run_edges;
+        const uint64_t run_num_edges = (num_edges - run_first_edge < graph_sort_run_edges ? num_edges - run_first_edge : graph_sort_run_edges);
+        const uint64_t run_buf_size = sizeof(uint64_t) * 2ull * run_num_edges;
+        uint64_t run_bytes_written = 0ull;
+        
+        graph_ingress_edges = &unsorted_edges[run_first_edge << 1ull];
+        graph_ingress_num_edges = run_num_edges;
+        graph_helper_transpose_ingress_edges(key_offset, numa_nodes);
+        
+        while (run_bytes_written < run_buf_size)
+        {
+            const ssize_t result = pwrite(spill_fd, (void*)((uint8_t*)graph_transpose_edges + run_bytes_written), (size_t)(run_buf_size - run_bytes_written), (off_t)((sizeof(uint64_t) * 2ull * run_first_edge) + run_bytes_written));
+            
+            if (result <= 0)
+            {
+                fprintf(stderr, "Error: unable to write a sorted run of edges to a temporary file\n");
+                exit(255);
+            }
+            
+            run_bytes_written += (uint64_t)result;
+        }
+        
+        graph_helper_free_sorted_edges();
+    }
+    
+    graph_ingress_edges = unsorted_edges;
+    graph_ingress_num_edges = num_edges;
+    
+    graph_sort_runs_map = (const uint64_t*)mmap(NULL, (size_t)edge_buf_size, PROT_READ, MAP_PRIVATE, spill_fd, 0);
+    close(spill_fd);
+    
+    // second phase: merge the runs into a new temporary file, which then holds the sorted edges
+    spill_fd = graph_helper_create_spill_file_or_die(edge_buf_size);
+    graph_sort_edges_map = (uint64_t*)mmap(NULL, (size_t)edge_buf_size, PROT_READ | PROT_WRITE, MAP_SHARED, spill_fd, 0);
+    close(spill_fd);
+    
+    if ((MAP_FAILED == (void*)graph_sort_runs_map) || (MAP_FAILED == (void*)graph_sort_edges_map))
+    {
+        fprintf(stderr, "Error: unable to map temporary files to sort the edge list\n");
+        exit(255);
+    }
+    
+    // split the key space among threads so each merges about the same number of edges, using the first run as a sample of the key distribution
+    graph_sort_thread_first_key = (uint64_t*)malloc(sizeof(uint64_t) * (num_threads + 1));
+    graph_sort_thread_first_key[0] = 0ull;
+    graph_sort_thread_first_key[num_threads] = graph_num_vertices;
+    
+    for (uint32_t i = 1; i < num_threads; ++i)
+    {
+        graph_sort_thread_first_key[i] = graph_sort_runs_map[((graph_sort_run_edges * i / num_threads) << 1ull) + key_offset];
+    }
+    
+    graph_transpose_key_offset = key_offset;
+    threads_spawn(num_threads, graph_num_numa_nodes, numa_nodes, 0, &graph_helper_multithread_control_merge_sorted_runs, NULL);
+    
+    free((void*)graph_sort_thread_first_key);
+    graph_sort_thread_first_key = NULL;
+    munmap((void*)graph_sort_runs_map, (size_t)edge_buf_size);
+    graph_sort_runs_map = NULL;
+    
+    graph_ingress_edges = graph_sort_edges_map;
+}
+
+// Ensures the current ingress edges are sorted by source (key offset 0) or destination (key offset 1), as required to build an edge list.
+// Edges that are not already sorted are sorted in memory if they fit within a single run of the external sort, and otherwise externally.
+// Any edges produced by a previous sort are freed once the new sort is complete.
+void graph_helper_sort_ingress_edges(const char* edge_list_name, const uint64_t key_offset, const uint32_t* numa_nodes)
+{
+    const uint32_t num_threads = graph_num_numa_nodes * numanodes_get_num_processors_on_node(numa_nodes[0]);
+    uint64_t* const previous_transpose_edges = graph_transpose_edges;
+    double* const previous_transpose_weights = graph_transpose_weights;
+    uint64_t* const previous_sort_edges_map = graph_sort_edges_map;
+    uint64_t key_offset_arg = key_offset;
+    
+    graph_sort_found_unsorted = 0ull;
+    threads_spawn(num_threads, graph_num_numa_nodes, numa_nodes, 0, &graph_helper_multithread_control_check_edges_sorted, (void*)&key_offset_arg);
+    
+    if (0ull == graph_sort_found_unsorted)
+    {
+        return;
+    }
+    
+    graph_transpose_edges = NULL;
+    graph_transpose_weights = NULL;
+    graph_sort_edges_map = NULL;
+    
+    if (graph_ingress_num_edges <= GRAPH_INGRESS_SORT_RUN_EDGES)
+    {
+        printf("%s sorting %llu edges in memory\n", edge_list_name, (long long unsigned int)graph_ingress_num_edges);
+        graph_helper_transpose_ingress_edges(key_offset, numa_nodes);
+    }
+    else if (NULL != graph_ingress_weights)
+    {
+        // runs spilled to disk hold only the edges themselves, so weights cannot follow their edges through an external sort
+        fprintf(stderr, "Error: weighted edge lists with more than %llu edges must already be in the required order\n", (long long unsigned int)GRAPH_INGRESS_SORT_RUN_EDGES);
+        exit(255);
+    }
+    else
+    {
+        printf("%s sorting %llu edges externally in %llu runs\n", edge_list_name, (long long unsigned int)graph_ingress_num_edges, (long long unsigned int)((graph_ingress_num_edges + GRAPH_INGRESS_SORT_RUN_EDGES - 1ull) / GRAPH_INGRESS_SORT_RUN_EDGES));
+        graph_helper_external_sort_ingress_edges(key_offset, numa_nodes);
+    }
+    
+    if (NULL != previous_transpose_edges)
+    {
+        numanodes_free((void*)previous_transpose_edges, sizeof(uint64_t) * 2ull * graph_ingress_num_edges);
+    }
+    
+    if (NULL != previous_transpose_weights)
+    {
+        numanodes_free((void*)previous_transpose_weights, sizeof(double) * graph_ingress_num_edges);
+    }
+    
+    if (NULL != previous_sort_edges_map)
+    {
+        munmap((void*)previous_sort_edges_map, sizeof(uint64_t) * 2ull * graph_ingress_num_edges);
+    }
+}
+
+// Parses a decimal number, optionally signed and with a fraction and exponent, starting at the specified pointer and advancing it past the number.
+// Returns 1 and writes the number if one is present, or 0 without moving the pointer otherwise.
+uint32_t graph_helper_parse_text_number(const char** ptr, const char* end, double* number)
+{
+    const char* p = *ptr;
+    double mantissa = 0.0;
+    int64_t exponent = 0ll;
+    int64_t exponent_value = 0ll;
+    uint32_t num_digits = 0;
+    uint32_t is_negative = 0;
+    uint32_t is_exponent_negative = 0;
+    
+    if ((p < end) && (('-' == *p) || ('+' == *p)))
+    {
+        is_negative = ('-' == *p);
+        p += 1;
+    }
+    
+    while ((p < end) && (*p >= '0') && (*p <= '9'))
+    {
+        mantissa = (mantissa * 10.0) + (double)(*p - '0');
+        num_digits += 1;
+        p += 1;
+    }
+    
+    if ((p < end) && ('.' == *p))
+    {
+        p += 1;
+        
+        while ((p < end) && (*p >= '0') && (*p <= '9'))
+        {
+            mantissa = (mantissa * 10.0) + (double)(*p - '0');
+            exponent -= 1ll;
+            num_digits += 1;
+            p += 1;
+        }
+    }
+    
+    if (0 == num_digits)
+    {
+        return 0;
+    }
+    
+    if ((p < end) && (('e' == *p) || ('E' == *p)))
+    {
+        p += 1;
+        
+        if ((p < end) && (('-' == *p) || ('+' == *p)))
+        {
+            is_exponent_negative = ('-' == *p);
+            p += 1;
+        }
+        
+        while ((p < end) && (*p >= '0') && (*p <= '9'))
+        {
+            if (exponent_value < 10000ll)
+                exponent_value = (exponent_value * 10ll) + (int64_t)(*p - '0');
+            
+            p += 1;
+        }
+        
+        exponent += (is_exponent_negative ? -exponent_value : exponent_value);
+    }
+    
+    *ptr = p;
+    *number = (is_negative ? -mantissa : mantissa) * pow(10.0, (double)exponent);
+    return 1;
+}
+
+// Parses a single line of a text graph file, advancing the specified pointer to the start of the next line.
+// Accepts any two non-negative integers separated by whitespace, commas, or semicolons.
+// If a weight is requested, a number following them is the weight of the edge, which is 1.0 otherwise. Anything else that follows is ignored.
+// Returns 2 if the line contains an edge with a weight, 1 if it contains an edge without one, or 0 if it is blank, a comment, a header, or otherwise does not start with two integers.
+uint32_t graph_helper_parse_text_line(const char** ptr, const char* end, uint64_t* edge_source, uint64_t* edge_dest, double* edge_weight)
+{
+    const char* p = *ptr;
+    uint64_t values[2] = { 0ull, 0ull };
+    uint32_t num_values = 0;
+    uint32_t has_weight = 0;
+    
+    while (num_values < 2)
+    {
+        while ((p < end) && ((' ' == *p) || ('\t' == *p) || (',' == *p) || (';' == *p)))
+        {
+            p += 1;
+        }
+        
+        if ((p >= end) || (*p < '0') || (*p > '9'))
+        {
+            break;
+        }
+        
+        while ((p < end) && (*p >= '0') && (*p <= '9'))
+        {
+            values[num_values] = (values[num_values] * 10ull) + (uint64_t)(*p - '0');
+            p += 1;
+        }
+        
+        num_values += 1;
+    }
+    
+    if ((2 == num_values) && (NULL != edge_weight))
+    {
+        *edge_weight = 1.0;
+        
+        while ((p < end) && ((' ' == *p) || ('\t' == *p) || (',' == *p) || (';' == *p)))
+        {
+            p += 1;
+        }
+        
+        has_weight = graph_helper_parse_text_number(&p, end, edge_weight);
+    }
+    
+    while ((p < end) && ('\n' != *p))
+    {
+        p += 1;
+    }
+    
+    *ptr = (p < end ? p + 1 : end);
+    
+    *edge_source = values[0];
+    *edge_dest = values[1];
+    return (2 == num_values ? (1 + has_weight) : 0);
+}
+
+// Locates the first line that starts at or after the specified offset in the text graph file currently being read.
+uint64_t graph_helper_find_text_line_start(uint64_t offset)
+{
+    const char* const text = (const char*)graph_read_file_map;
+    
+    if (offset <= graph_text_data_offset)
+    {
+        return graph_text_data_offset;
+    }
+    
+    while ((offset < graph_read_file_map_size) && ('\n' != text[offset - 1ull]))
+    {
+        offset += 1ull;
+    }
+    
+    return offset;
+}
+
+// Compares two vertex IDs, for use with qsort().
+int graph_helper_compare_vertex_ids(const void* a, const void* b)
+{
+    const uint64_t id_a = *((const uint64_t*)a);
+    const uint64_t id_b = *((const uint64_t*)b);
+    
+    return (id_a < id_b ? -1 : (id_a > id_b ? 1 : 0));
+}
+
+// Master control function for parsing a text graph file in parallel.
+// Each thread parses its own range of lines into a local buffer, after which the results are combined and the vertex IDs renumbered densely, preserving their order.
+void graph_helper_multithread_control_parse_text_edges(void* arg)
+{
+    const uint32_t thread_id = threads_get_global_thread_id();
+    const uint32_t num_threads = threads_get_total_threads();
+    const char* const text = (const char*)graph_read_file_map;
+    const uint64_t text_size = graph_read_file_map_size - graph_text_data_offset;
+    const char* ptr = &text[graph_helper_find_text_line_start(graph_text_data_offset + (text_size * (uint64_t)thread_id / (uint64_t)num_threads))];
+    const char* const end = &text[graph_helper_find_text_line_start(graph_text_data_offset + (text_size * (uint64_t)(thread_id + 1) / (uint64_t)num_threads))];
+    
+    uint64_t edge_capacity = 1024ull;
+    uint64_t* edges = (uint64_t*)malloc(sizeof(uint64_t) * 2ull * edge_capacity);
+    double* weights = (graph_load_edge_weights ? (double*)malloc(sizeof(double) * edge_capacity) : NULL);
+    uint64_t num_edges = 0ull;
+    uint64_t max_vertex_id = 0ull;
+    uint64_t thread_first_edge;
+    uint64_t thread_last_edge;
+    uint64_t thread_first_word;
+    uint64_t thread_last_word;
+    
+    // first phase: parse this thread's lines, adding the reverse of each edge if the graph is symmetric
+    while (ptr < end)
+    {
+        uint64_t edge_source;
+        uint64_t edge_dest;
+        double edge_weight;
+        const uint32_t parse_result = graph_helper_parse_text_line(&ptr, end, &edge_source, &edge_dest, (NULL == weights ? NULL : &edge_weight));
+        
+        if (0 == parse_result)
+        {
+            continue;
+        }
+        
+        if ((2 == parse_result) && (0ull == graph_text_found_weights))
+        {
+            graph_text_found_weights = 1ull;
+        }
+        
+        if ((num_edges + 2ull) > edge_capacity)
+        {
+            edge_capacity <<= 1ull;
+            edges = (uint64_t*)realloc((void*)edges, sizeof(uint64_t) * 2ull * edge_capacity);
+            
+            if (NULL != weights)
+            {
+                weights = (double*)realloc((void*)weights, sizeof(double) * edge_capacity);
+            }
+        }
+        
+        edges[(num_edges << 1ull) + 0ull] = edge_source;
+        edges[(num_edges << 1ull) + 1ull] = edge_dest;
+        if (NULL != weights)
+        {
+            weights[num_edges] = edge_weight;
+        }
+        num_edges += 1ull;
+        
+        if (graph_text_is_symmetric && (edge_source != edge_dest))
+        {
+            edges[(num_edges << 1ull) + 0ull] = edge_dest;
+            edges[(num_edges << 1ull) + 1ull] = edge_source;
+            if (NULL != weights)
+            {
+                weights[num_edges] = edge_weight;
+            }
+            num_edges += 1ull;
+        }
+        
+        if (edge_source > max_vertex_id)
+            max_vertex_id = edge_source;
+        
+        if (edge_dest > max_vertex_id)
+            max_vertex_id = edge_dest;
+    }
+    
+    graph_text_thread_edges[thread_id] = edges;
+    graph_text_thread_weights[thread_id] = weights;
+    graph_text_thread_num_edges[thread_id] = num_edges;
+    graph_text_thread_max_vertex_id[thread_id] = max_vertex_id;
+    
+    threads_barrier();
+    
+    // allocate space for all edges, then decide how to renumber vertices based on how sparse their IDs are
+    if (0 == thread_id)
+    {
+        graph_text_thread_first_edge[0] = 0ull;
+        max_vertex_id = 0ull;
+        
+        for (uint32_t i = 0; i < num_threads; ++i)
+        {
+            graph_text_thread_first_edge[i + 1] = graph_text_thread_first_edge[i] + graph_text_thread_num_edges[i];
+            
+            if (graph_text_thread_max_vertex_id[i] > max_vertex_id)
+                max_vertex_id = graph_text_thread_max_vertex_id[i];
+        }
+        
+        graph_read_file_num_edges = graph_text_thread_first_edge[num_threads];
+        graph_read_file_decoded_edges = (uint64_t*)numanodes_malloc_divisible(sizeof(uint64_t) * 2ull * graph_read_file_num_edges, graph_ingress_numa_nodes[0], graph_helper_edge_array_granularity(graph_read_file_num_edges, sizeof(uint64_t) * 2ull));
+        
+        for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
+        {
+            const uint64_t first_edge = graph_read_file_num_edges * i / graph_num_numa_nodes;
+            const uint64_t edge_count = (graph_read_file_num_edges * (i + 1) / graph_num_numa_nodes) - first_edge;
+            
+            numanodes_tonode_buffer(&graph_read_file_decoded_edges[first_edge << 1ull], sizeof(uint64_t) * 2ull * edge_count, graph_ingress_numa_nodes[i]);
+        }
+        
+        // weights are kept only if at least one edge has one, otherwise every edge has unit weight anyway
+        if ((0ull != graph_text_found_weights) && (0ull != graph_read_file_num_edges))
+        {
+            graph_read_file_decoded_weights = (double*)numanodes_malloc_divisible(sizeof(double) * graph_read_file_num_edges, graph_ingress_numa_nodes[0], graph_helper_edge_array_granularity(graph_read_file_num_edges, sizeof(double)));
+            
+            for (uint32_t i = 1; (NULL != graph_read_file_decoded_weights) && (i < graph_num_numa_nodes); ++i)
+            {
+                const uint64_t first_edge = graph_read_file_num_edges * i / graph_num_numa_nodes;
+                const uint64_t edge_count = (graph_read_file_num_edges * (i + 1) / graph_num_numa_nodes) - first_edge;
+                
+                numanodes_tonode_buffer(&graph_read_file_decoded_weights[first_edge], sizeof(double) * edge_count, graph_ingress_numa_nodes[i]);
+            }
+        }
+        
+        // a bitmap is used as long as it would be no larger than the edges themselves
+        graph_text_vertex_id_bitmap_words = (max_vertex_id >> 6ull) + 1ull;
+        
+        if (graph_text_vertex_id_bitmap_words <= (graph_read_file_num_edges << 1ull))
+        {
+            graph_text_vertex_id_bitmap = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_text_vertex_id_bitmap_words, graph_ingress_numa_nodes[0]);
+            graph_text_vertex_id_bitmap_rank = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_text_vertex_id_bitmap_words, graph_ingress_numa_nodes[0]);
+        }
+    }
+    
+    threads_barrier();
+    
+    // nothing more to do if the file contains no edges or there is not enough memory for them
+    if ((0ull == graph_read_file_num_edges) || (NULL == graph_read_file_decoded_edges) || ((0ull != graph_text_found_weights) && (NULL == graph_read_file_decoded_weights)))
+    {
+        free((void*)edges);
+        free((void*)weights);
+        return;
+    }
+    
+    // second phase: move this thread's edges and their weights into place and record the vertex IDs they contain
+    memcpy((void*)&graph_read_file_decoded_edges[graph_text_thread_first_edge[thread_id] << 1ull], (void*)edges, sizeof(uint64_t) * 2ull * num_edges);
+    free((void*)edges);
+    
+    if (NULL != graph_read_file_decoded_weights)
+    {
+        memcpy((void*)&graph_read_file_decoded_weights[graph_text_thread_first_edge[thread_id]], (void*)weights, sizeof(double) * num_edges);
+    }
+    free((void*)weights);
+    
+    thread_first_edge = graph_read_file_num_edges * (uint64_t)thread_id / (uint64_t)num_threads;
+    thread_last_edge = graph_read_file_num_edges * (uint64_t)(thread_id + 1) / (uint64_t)num_threads;
+    thread_first_word = graph_text_vertex_id_bitmap_words * (uint64_t)thread_id / (uint64_t)num_threads;
+    thread_last_word = graph_text_vertex_id_bitmap_words * (uint64_t)(thread_id + 1) / (uint64_t)num_threads;
+    
+    if (NULL != graph_text_vertex_id_bitmap)
+    {
+        for (uint64_t i = graph_text_thread_first_edge[thread_id] << 1ull; i < graph_text_thread_first_edge[thread_id + 1] << 1ull; ++i)
+        {
+            const uint64_t vertex_id = graph_read_file_decoded_edges[i];
+            
+            if (0ull == (graph_text_vertex_id_bitmap[vertex_id >> 6ull] & (1ull << (vertex_id & 63ull))))
+            {
+                __sync_fetch_and_or(&graph_text_vertex_id_bitmap[vertex_id >> 6ull], (1ull << (vertex_id & 63ull)));
+            }
+        }
+        
+        threads_barrier();
+        
+        // count the distinct vertex IDs in this thread's part of the bitmap
+        graph_text_thread_first_vertex[thread_id + 1] = 0ull;
+        for (uint64_t w = thread_first_word; w < thread_last_word; ++w)
+        {
+            graph_text_thread_first_vertex[thread_id + 1] += (uint64_t)__builtin_popcountll(graph_text_vertex_id_bitmap[w]);
+        }
+        
+        threads_barrier();
+        
+        if (0 == thread_id)
+        {
+            graph_text_thread_first_vertex[0] = 0ull;
+            
+            for (uint32_t i = 0; i < num_threads; ++i)
+            {
+                graph_text_thread_first_vertex[i + 1] += graph_text_thread_first_vertex[i];
+            }
+            
+            graph_num_vertices = graph_text_thread_first_vertex[num_threads];
+            
+            // vertex IDs that are already dense need no renumbering
+            if (graph_num_vertices != (max_vertex_id + 1ull))
+            {
+                graph_vertex_original_ids = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_vertices, graph_ingress_numa_nodes[0]);
+            }
+        }
+        
+        threads_barrier();
+        
+        if (NULL != graph_vertex_original_ids)
+        {
+            uint64_t vertex_rank = graph_text_thread_first_vertex[thread_id];
+            
+            // third phase: assign new vertex IDs in order, then use them to renumber this thread's edges
+            for (uint64_t w = thread_first_word; w < thread_last_word; ++w)
+            {
+                uint64_t word = graph_text_vertex_id_bitmap[w];
+                
+                graph_text_vertex_id_bitmap_rank[w] = vertex_rank;
+                
+                while (0ull != word)
+                {
+                    graph_vertex_original_ids[vertex_rank++] = (w << 6ull) + (uint64_t)__builtin_ctzll(word);
+                    word &= (word - 1ull);
+                }
+            }
+            
+            threads_barrier();
+            
+            for (uint64_t i = thread_first_edge << 1ull; i < thread_last_edge << 1ull; ++i)
+            {
+                const uint64_t vertex_id = graph_read_file_decoded_edges[i];
+                
+                graph_read_file_decoded_edges[i] = graph_text_vertex_id_bitmap_rank[vertex_id >> 6ull] + (uint64_t)__builtin_popcountll(graph_text_vertex_id_bitmap[vertex_id >> 6ull] & ((1ull << (vertex_id & 63ull)) - 1ull));
+            }
+        }
+    }
+    else
+    {
+        threads_barrier();
+        
+        // vertex IDs are too sparse for a bitmap, so sort a list of them instead
+        if (0 == thread_id)
+        {
+            uint64_t num_vertex_ids = 0ull;
+            
+            graph_text_vertex_id_sorted = (uint64_t*)malloc(sizeof(uint64_t) * 2ull * graph_read_file_num_edges);
+            memcpy((void*)graph_text_vertex_id_sorted, (void*)graph_read_file_decoded_edges, sizeof(uint64_t) * 2ull * graph_read_file_num_edges);
+            qsort((void*)graph_text_vertex_id_sorted, (size_t)(2ull * graph_read_file_num_edges), sizeof(uint64_t), &graph_helper_compare_vertex_ids);
+            
+            for (uint64_t i = 0ull; i < (2ull * graph_read_file_num_edges); ++i)
+            {
+                if ((0ull == i) || (graph_text_vertex_id_sorted[i] != graph_text_vertex_id_sorted[num_vertex_ids - 1ull]))
+                {
+                    graph_text_vertex_id_sorted[num_vertex_ids++] = graph_text_vertex_id_sorted[i];
+                }
+            }
+            
+            graph_num_vertices = num_vertex_ids;
+            graph_vertex_original_ids = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_vertices, graph_ingress_numa_nodes[0]);
+            memcpy((void*)graph_vertex_original_ids, (void*)graph_text_vertex_id_sorted, sizeof(uint64_t) * graph_num_vertices);
+            free((void*)graph_text_vertex_id_sorted);
+            graph_text_vertex_id_sorted = NULL;
+        }
+        
+        threads_barrier();
+        
+        for (uint64_t i = thread_first_edge << 1ull; i < thread_last_edge << 1ull; ++i)
+        {
+            const uint64_t vertex_id = graph_read_file_decoded_edges[i];
+            uint64_t lo = 0ull;
+            uint64_t hi = graph_num_vertices;
+            
+            while (lo < hi)
+            {
+                const uint64_t mid = lo + ((hi - lo) >> 1ull);
+                
+                if (graph_vertex_original_ids[mid] < vertex_id)
+                    lo = mid + 1ull;
+                else
+                    hi = mid;
+            }
+            
+            graph_read_file_decoded_edges[i] = lo;
+        }
+    }
+}
+
+// Parses the text graph file that is currently open, or prints and terminates on failure.
+// Recognizes SNAP-style, CSV, and Matrix Market edge lists, and renumbers vertices densely if their IDs are not already dense.
+// Uses every core on each of the specified NUMA nodes, giving each NUMA node an equal part of the parsed edges.
+void graph_helper_parse_text_graph_file_or_die(const char* filename, const uint32_t* numa_nodes)
+{
+    const uint32_t num_threads = graph_num_numa_nodes * numanodes_get_num_processors_on_node(numa_nodes[0]);
+    const char* const text = (const char*)graph_read_file_map;
+    
+    graph_text_data_offset = 0ull;
+    graph_text_is_symmetric = 0ull;
+    graph_text_found_weights = 0ull;
+    
+    // Matrix Market files declare whether they are symmetric in their banner, and the first line that is not a comment gives their dimensions rather than an edge
+    if ((graph_read_file_map_size >= 14ull) && (0 == strncmp(text, "%%MatrixMarket", 14)))
+    {
+        uint32_t found_dimensions = 0;
+        char banner[256];
+        uint64_t banner_length = 0ull;
+        
+        while ((graph_text_data_offset < graph_read_file_map_size) && ('\n' != text[graph_text_data_offset]))
+        {
+            if (banner_length < (sizeof(banner) - 1))
+            {
+                banner[banner_length++] = (char)tolower(text[graph_text_data_offset]);
+            }
+            
+            graph_text_data_offset += 1ull;
+        }
+        
+        banner[banner_length] = '\0';
+        if ((NULL != strstr(banner, "symmetric")) || (NULL != strstr(banner, "hermitian")))
+        {
+            graph_text_is_symmetric = 1ull;
+        }
+        
+        while ((graph_text_data_offset < graph_read_file_map_size) && (0 == found_dimensions))
+        {
+            graph_text_data_offset += 1ull;
+            found_dimensions = ((graph_text_data_offset < graph_read_file_map_size) && ('%' != text[graph_text_data_offset]) && ('\n' != text[graph_text_data_offset]));
+            
+            while ((graph_text_data_offset < graph_read_file_map_size) && ('\n' != text[graph_text_data_offset]))
+            {
+                graph_text_data_offset += 1ull;
+            }
+        }
+        
+        if (graph_text_data_offset < graph_read_file_map_size)
+        {
+            graph_text_data_offset += 1ull;
+        }
+    }
+    
+    // allocate the bookkeeping structures
+    graph_text_thread_edges = (uint64_t**)malloc(sizeof(uint64_t*) * num_threads);
+    graph_text_thread_weights = (double**)malloc(sizeof(double*) * num_threads);
+    graph_text_thread_num_edges = (uint64_t*)malloc(sizeof(uint64_t) * num_threads);
+    graph_text_thread_max_vertex_id = (uint64_t*)malloc(sizeof(uint64_t) * num_threads);
+    graph_text_thread_first_edge = (uint64_t*)malloc(sizeof(uint64_t) * (num_threads + 1));
+    graph_text_thread_first_vertex = (uint64_t*)malloc(sizeof(uint64_t) * (num_threads + 1));
+    
+    // any renumbering from a previously-read file is replaced
+    if (NULL != graph_vertex_original_ids)
+    {
+        numanodes_free((void*)graph_vertex_original_ids, sizeof(uint64_t) * graph_num_vertices);
+        graph_vertex_original_ids = NULL;
+    }
+    
+    graph_ingress_numa_nodes = numa_nodes;
+    threads_spawn(num_threads, graph_num_numa_nodes, numa_nodes, 0, &graph_helper_multithread_control_parse_text_edges, NULL);
+    
+    // free everything except the parsed edges and the renumbering
+    if (NULL != graph_text_vertex_id_bitmap)
+    {
+        numanodes_free((void*)graph_text_vertex_id_bitmap, sizeof(uint64_t) * graph_text_vertex_id_bitmap_words);
+        numanodes_free((void*)graph_text_vertex_id_bitmap_rank, sizeof(uint64_t) * graph_text_vertex_id_bitmap_words);
+        graph_text_vertex_id_bitmap = NULL;
+        graph_text_vertex_id_bitmap_rank = NULL;
+    }
+    
+    free((void*)graph_text_thread_edges);
+    free((void*)graph_text_thread_weights);
+    free((void*)graph_text_thread_num_edges);
+    free((void*)graph_text_thread_max_vertex_id);
+    free((void*)graph_text_thread_first_edge);
+    free((void*)graph_text_thread_first_vertex);
+    graph_text_thread_edges = NULL;
+    graph_text_thread_weights = NULL;
+    graph_text_thread_num_edges = NULL;
+    graph_text_thread_max_vertex_id = NULL;
+    graph_text_thread_first_edge = NULL;
+    graph_text_thread_first_vertex = NULL;
+    
+    if (0ull == graph_read_file_num_edges)
+    {
+        return;
+    }
+    
+    if ((NULL == graph_read_file_decoded_edges) || ((0ull != graph_text_found_weights) && (NULL == graph_read_file_decoded_weights)))
+    {
+        fprintf(stderr, "Error: unable to allocate memory to parse text graph file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    printf("Vertices:  parsed %llu edges among %llu vertices from text%s\n", (long long unsigned int)graph_read_file_num_edges, (long long unsigned int)graph_num_vertices, (NULL == graph_vertex_original_ids ? "" : ", renumbered densely"));
+    
+    graph_num_edges = graph_read_file_num_edges;
+    graph_read_file_edges = graph_read_file_decoded_edges;
+    graph_read_file_weights = graph_read_file_decoded_weights;
+}
+
+// Decodes the compressed graph file that is currently open, or prints and terminates on failure.
+// Uses every core on each of the specified NUMA nodes, giving each NUMA node an equal part of the decoded edges.
+void graph_helper_decode_compressed_graph_file_or_die(const char* filename, const uint32_t* numa_nodes)
+{
+    const graphcompressed_t* const header = (const graphcompressed_t*)graph_read_file_map;
+    const uint64_t* const chunk_offsets = (const uint64_t*)&header[1];
+    const uint32_t num_threads = graph_num_numa_nodes * numanodes_get_num_processors_on_node(numa_nodes[0]);
+    
+    // the header and chunk offsets must be consistent with each other and with the size of the file
+    if ((0ull == header->chunk_edges) || (header->num_chunks != ((header->num_edges + header->chunk_edges - 1ull) / header->chunk_edges)) || (header->num_chunks > (graph_read_file_map_size / sizeof(uint64_t))) || (graph_read_file_map_size < (sizeof(graphcompressed_t) + (sizeof(uint64_t) * (header->num_chunks + 1ull)))) || (header->key_offset > 1ull))
+    {
+        fprintf(stderr, "Error: compressed graph file \"%s\" is malformed\n", filename);
+        exit(255);
+    }
+    
+    for (uint64_t c = 0ull; c < header->num_chunks; ++c)
+    {
+        if ((chunk_offsets[c] > chunk_offsets[c + 1]) || (chunk_offsets[c + 1] > graph_read_file_map_size))
+        {
+            fprintf(stderr, "Error: compressed graph file \"%s\" is malformed\n", filename);
+            exit(255);
+        }
+    }
+    
+    graph_read_file_num_edges = header->num_edges;
+    graph_read_file_decoded_edges = (uint64_t*)numanodes_malloc_divisible(sizeof(uint64_t) * 2ull * graph_read_file_num_edges, numa_nodes[0], graph_helper_edge_array_granularity(graph_read_file_num_edges, sizeof(uint64_t) * 2ull));
+    if (NULL == graph_read_file_decoded_edges)
+    {
+        fprintf(stderr, "Error: unable to allocate memory to decode compressed graph file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    for (uint32_t i = 1; i < graph_num_numa_nodes; ++i)
+    {
+        const uint64_t first_edge = graph_read_file_num_edges * i / graph_num_numa_nodes;
+        const uint64_t edge_count = (graph_read_file_num_edges * (i + 1) / graph_num_numa_nodes) - first_edge;
+        
+        numanodes_tonode_buffer(&graph_read_file_decoded_edges[first_edge << 1ull], sizeof(uint64_t) * 2ull * edge_count, numa_nodes[i]);
+    }
+    
+    graph_read_file_decode_failed = 0ull;
+    threads_spawn(num_threads, graph_num_numa_nodes, numa_nodes, 0, &graph_helper_multithread_control_decode_compressed_edges, NULL);
+    
+    if (0ull != graph_read_file_decode_failed)
+    {
+        fprintf(stderr, "Error: compressed graph file \"%s\" is malformed\n", filename);
+        exit(255);
+    }
+    
+    graph_read_file_edges = graph_read_file_decoded_edges;
+}
+
+// Master control function for counting the in-edges and out-edges of each vertex in the graph file currently being read, used only while reordering vertices.
+void graph_helper_multithread_control_count_reorder_degrees(void* arg)
+{
+    const uint64_t thread_first_edge = graph_read_file_num_edges * (uint64_t)threads_get_global_thread_id() / (uint64_t)threads_get_total_threads();
+    const uint64_t thread_last_edge = graph_read_file_num_edges * (uint64_t)(threads_get_global_thread_id() + 1) / (uint64_t)threads_get_total_threads();
+    
+    for (uint64_t i = thread_first_edge; i < thread_last_edge; ++i)
+    {
+        __sync_fetch_and_add(&graph_reorder_out_degrees[graph_read_file_edges[(i << 1ull) + 0ull]], 1ull);
+        __sync_fetch_and_add(&graph_reorder_in_degrees[graph_read_file_edges[(i << 1ull) + 1ull]], 1ull);
+    }
+}
+
+// Master control function for replacing each vertex ID in the graph file currently being read with its new ID after reordering.
+// Writes to the decoded copy of the edges, which may be the same as the edges being read.
+void graph_helper_multithread_control_relabel_edges(void* arg)
+{
+    const uint64_t thread_first_element = (graph_read_file_num_edges * (uint64_t)threads_get_global_thread_id() / (uint64_t)threads_get_total_threads()) << 1ull;
+    const uint64_t thread_last_element = (graph_read_file_num_edges * (uint64_t)(threads_get_global_thread_id() + 1) / (uint64_t)threads_get_total_threads()) << 1ull;
+    
+    for (uint64_t i = thread_first_element; i < thread_last_element; ++i)
+    {
+        graph_read_file_decoded_edges[i] = graph_vertex_reordered_ids[graph_read_file_edges[i]];
+    }
+}
+
+// Compares two vertex IDs by their total number of edges, as counted for reordering, for use with qsort().
+int graph_helper_compare_reorder_degrees(const void* a, const void* b)
+{
+    const uint64_t degree_a = graph_reorder_out_degrees[*(const uint64_t*)a] + graph_reorder_in_degrees[*(const uint64_t*)a];
+    const uint64_t degree_b = graph_reorder_out_degrees[*(const uint64_t*)b] + graph_reorder_in_degrees[*(const uint64_t*)b];
+    
+    if (degree_a != degree_b)
+        return (degree_a < degree_b ? -1 : 1);
+    
+    return graph_helper_compare_vertex_ids(a, b);
+}
+
+// Assigns new vertex IDs in descending order of the number of out-edges of each vertex, keeping the existing order among vertices with equal keys.
+// If hubs_only is set, only vertices with more out-edges than average are sorted, and all other vertices follow them in their existing order.
+void graph_helper_reorder_vertices_by_degree(const uint32_t hubs_only)
+{
+    const uint64_t average_degree = graph_read_file_num_edges / graph_num_vertices;
+    uint64_t max_degree = 0ull;
+    uint64_t* degree_positions;
+    uint64_t position = 0ull;
+    
+    for (uint64_t v = 0ull; v < graph_num_vertices; ++v)
+    {
+        if (graph_reorder_out_degrees[v] > max_degree)
+            max_degree = graph_reorder_out_degrees[v];
+    }
+    
+    // counting sort by degree, with the positions for higher degrees coming first
+    degree_positions = (uint64_t*)malloc(sizeof(uint64_t) * (max_degree + 1ull));
+    memset((void*)degree_positions, 0, sizeof(uint64_t) * (max_degree + 1ull));
+    
+    for (uint64_t v = 0ull; v < graph_num_vertices; ++v)
+    {
+        const uint64_t key = ((hubs_only && graph_reorder_out_degrees[v] <= average_degree) ? 0ull : graph_reorder_out_degrees[v]);
+        degree_positions[key] += 1ull;
+    }
+    
+    for (uint64_t d = max_degree + 1ull; d > 0ull; --d)
+    {
+        const uint64_t count = degree_positions[d - 1ull];
+        
+        degree_positions[d - 1ull] = position;
+        position += count;
+    }
+    
+    for (uint64_t v = 0ull; v < graph_num_vertices; ++v)
+    {
+        const uint64_t key = ((hubs_only && graph_reorder_out_degrees[v] <= average_degree) ? 0ull : graph_reorder_out_degrees[v]);
+        graph_vertex_reordered_ids[v] = degree_positions[key]++;
+    }
+    
+    free((void*)degree_positions);
+}
+
+// Assigns new vertex IDs using the Reverse Cuthill-McKee algorithm, treating each edge as undirected.
+// Each connected component is visited breadth-first from its vertex with the fewest edges, visiting the neighbors of each vertex in ascending order of their number of edges, and the resulting order is reversed.
+void graph_helper_reorder_vertices_by_rcm()
+{
+    uint64_t* const adjacency_first = (uint64_t*)malloc(sizeof(uint64_t) * (graph_num_vertices + 1ull));
+    uint64_t* const adjacency = (uint64_t*)malloc(sizeof(uint64_t) * 2ull * graph_read_file_num_edges);
+    uint64_t* const start_order = (uint64_t*)malloc(sizeof(uint64_t) * graph_num_vertices);
+    uint64_t* const visit_order = (uint64_t*)malloc(sizeof(uint64_t) * graph_num_vertices);
+    uint64_t num_visited = 0ull;
+    
+    // build the undirected adjacency lists
+    adjacency_first[0] = 0ull;
+    for (uint64_t v = 0ull; v < graph_num_vertices; ++v)
+    {
+        adjacency_first[v + 1ull] = adjacency_first[v] + graph_reorder_out_degrees[v] + graph_reorder_in_degrees[v];
+        graph_vertex_reordered_ids[v] = adjacency_first[v];
+    }
+    
+    for (uint64_t i = 0ull; i < graph_read_file_num_edges; ++i)
+    {
+        const uint64_t source = graph_read_file_edges[(i << 1ull) + 0ull];
+        const uint64_t dest = graph_read_file_edges[(i << 1ull) + 1ull];
+        
+        adjacency[graph_vertex_reordered_ids[source]++] = dest;
+        adjacency[graph_vertex_reordered_ids[dest]++] = source;
+    }
+    
+    // each component starts from its unvisited vertex with the fewest edges
+    for (uint64_t v = 0ull; v < graph_num_vertices; ++v)
+    {
+        start_order[v] = v;
+        graph_vertex_reordered_ids[v] = UINT64_MAX;
+    }
+    
+    qsort((void*)start_order, (size_t)graph_num_vertices, sizeof(uint64_t), &graph_helper_compare_reorder_degrees);
+    
+    for (uint64_t s = 0ull; s < graph_num_vertices; ++s)
+    {
+        uint64_t num_processed = num_visited;
+        
+        if (UINT64_MAX != graph_vertex_reordered_ids[start_order[s]])
+            continue;
+        
+        graph_vertex_reordered_ids[start_order[s]] = num_visited;
+        visit_order[num_visited++] = start_order[s];
+        
+        // the list of visited vertices doubles as the queue
+        while (num_processed < num_visited)
+        {
+            const uint64_t u = visit_order[num_processed++];
+            const uint64_t first_neighbor = num_visited;
+            
+            for (uint64_t i = adjacency_first[u]; i < adjacency_first[u + 1ull]; ++i)
+            {
+                if (UINT64_MAX == graph_vertex_reordered_ids[adjacency[i]])
+                {
+                    graph_vertex_reordered_ids[adjacency[i]] = num_visited;
+                    visit_order[num_visited++] = adjacency[i];
+                }
+            }
+            
+            qsort((void*)&visit_order[first_neighbor], (size_t)(num_visited - first_neighbor), sizeof(uint64_t), &graph_helper_compare_reorder_degrees);
+        }
+    }
+    
+    // reverse the visit order to obtain the new IDs
+    for (uint64_t i = 0ull; i < graph_num_vertices; ++i)
+    {
+        graph_vertex_reordered_ids[visit_order[i]] = graph_num_vertices - 1ull - i;
+    }
+    
+    free((void*)adjacency_first);
+    free((void*)adjacency);
+    free((void*)start_order);
+    free((void*)visit_order);
+}
+
+// Computes the output position of each vertex, which is the inverse of the new ID of each vertex after reordering.
+void graph_helper_compute_vertex_output_positions(const uint32_t numa_node)
+{
+    graph_vertex_output_positions = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_vertices, numa_node);
+    
+    for (uint64_t position = 0ull; position < graph_num_vertices; ++position)
+    {
+        graph_vertex_output_positions[graph_vertex_reordered_ids[position]] = position;
+    }
+}
+
+// Reorders the vertices of the graph file currently being read, using the method in graph_reorder_method, and replaces its edges with a relabeled copy.
+// The new ID of each vertex is determined when the first graph file is read and reused for any other graph file, so both edge lists are relabeled in the same way.
+// Also updates the original ID of each vertex, which is required if vertices were renumbered when parsing this graph file as text or when they were not renumbered at all.
+void graph_helper_reorder_read_file_edges(const uint32_t is_text, const uint32_t* numa_nodes)
+{
+    const uint32_t num_threads = graph_num_numa_nodes * numanodes_get_num_processors_on_node(numa_nodes[0]);
+    
+    if (NULL == graph_vertex_reordered_ids)
+    {
+        const char* method_name = "";
+        
+        graph_vertex_reordered_ids = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_vertices, numa_nodes[0]);
+        graph_reorder_out_degrees = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_vertices, numa_nodes[0]);
+        graph_reorder_in_degrees = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_vertices, numa_nodes[0]);
+        threads_spawn(num_threads, graph_num_numa_nodes, numa_nodes, 0, &graph_helper_multithread_control_count_reorder_degrees, NULL);
+        
+        switch (graph_reorder_method)
+        {
+        case GRAPH_REORDER_DEGREE:
+            method_name = "degree";
+            graph_helper_reorder_vertices_by_degree(0);
+            break;
+        
+        case GRAPH_REORDER_HUB:
+            method_name = "hub";
+            graph_helper_reorder_vertices_by_degree(1);
+            break;
+        
+        case GRAPH_REORDER_RCM:
+            method_name = "RCM";
+            graph_helper_reorder_vertices_by_rcm();
+            break;
+        }
+        
+        numanodes_free((void*)graph_reorder_out_degrees, sizeof(uint64_t) * graph_num_vertices);
+        numanodes_free((void*)graph_reorder_in_degrees, sizeof(uint64_t) * graph_num_vertices);
+        graph_reorder_out_degrees = NULL;
+        graph_reorder_in_degrees = NULL;
+        
+        graph_helper_compute_vertex_output_positions(numa_nodes[0]);
+        
+        printf("Vertices:  reordered using %s ordering\n", method_name);
+    }
+    
+    // the original ID of each vertex must be looked up by its new ID
+    if (is_text || (NULL == graph_vertex_original_ids))
+    {
+        uint64_t* const reordered_original_ids = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_vertices, numa_nodes[0]);
+        
+        for (uint64_t v = 0ull; v < graph_num_vertices; ++v)
+        {
+            reordered_original_ids[graph_vertex_reordered_ids[v]] = (NULL == graph_vertex_original_ids ? v : graph_vertex_original_ids[v]);
+        }
+        
+        if (NULL != graph_vertex_original_ids)
+        {
+            numanodes_free((void*)graph_vertex_original_ids, sizeof(uint64_t) * graph_num_vertices);
+        }
+        
+        graph_vertex_original_ids = reordered_original_ids;
+    }
+    
+    // relabel the edges, in place if they are already a copy and otherwise into a new copy
+    if (NULL == graph_read_file_decoded_edges)
+    {
+        graph_read_file_decoded_edges = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * 2ull * graph_read_file_num_edges, numa_nodes[0]);
+    }
+    
+    threads_spawn(num_threads, graph_num_numa_nodes, numa_nodes, 0, &graph_helper_multithread_control_relabel_edges, NULL);
+    graph_read_file_edges = graph_read_file_decoded_edges;
+}
+
+// Opens a file that represents a graph, or prints and terminates on failure.
+// Makes the edges it contains the current ingress edges, first decoding or parsing them using the specified NUMA nodes if the file is compressed or text.
+void graph_helper_open_edge_list_file_or_die(const char* filename, const uint32_t* numa_nodes)
+{
+    uint32_t is_text;
+    
+    graph_helper_open_file_and_extract_graph_info(filename);
+    if (NULL == graph_read_file_map)
+    {
+        fprintf(stderr, "Error: unable to read file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    is_text = graph_helper_graph_file_is_text();
+    
+    if (graph_helper_graph_file_is_compressed())
+    {
+        if (0ull != graph_num_edges)
+        {
+            graph_helper_decode_compressed_graph_file_or_die(filename, numa_nodes);
+        }
+    }
+    else if (is_text)
+    {
+        graph_helper_parse_text_graph_file_or_die(filename, numa_nodes);
+    }
+    else
+    {
+        // edges begin immediately after the number of vertices and edges
+        graph_read_file_edges = &graph_read_file_map[2];
+        graph_read_file_num_edges = (graph_read_file_map_count - 2ull) >> 1ull;
+        
+        // binary files have no room for weights, so they come from a separate file if at all
+        if (graph_load_edge_weights)
+        {
+            graph_helper_open_edge_weights_file_or_die(filename);
+        }
+    }
+    
+    // the edge list must not be empty, as vertex assignment and indexing depend on the vectors it contains
+    if (0ull == graph_read_file_num_edges)
+    {
+        fprintf(stderr, "Error: graph file \"%s\" contains no edges\n", filename);
+        exit(255);
+    }
+    
+    if (graph_load_edge_weights)
+    {
+        printf("Weights:   %s\n", (NULL == graph_read_file_weights ? "none in input, using unit weights" : (is_text ? "parsed from text" : "read from weights file")));
+    }
+    
+    // reordering only relabels edges in place, so their weights stay where they are
+    if (GRAPH_REORDER_NONE != graph_reorder_method)
+    {
+        graph_helper_reorder_read_file_edges(is_text, numa_nodes);
+    }
+    
+    graph_ingress_edges = graph_read_file_edges;
+    graph_ingress_weights = graph_read_file_weights;
+    graph_ingress_num_edges = graph_read_file_num_edges;
+}
+
+// Master control function for building an edge list in parallel from the current ingress edges.
+// Each thread packs the edge vectors for its own slice of the edges, and slices start only where the shared vertex changes so that no edge vector spans two slices.
+// Vectors are written directly to their final positions in NUMA-local memory, after which the threads on each node build that node's vertex index.
+void graph_helper_multithread_control_build_edge_list(void* arg)
+{
+    const uint32_t thread_id = threads_get_global_thread_id();
+    const uint32_t num_threads = threads_get_total_threads();
+    const uint32_t group_id = threads_get_thread_group_id();
+    const uint32_t local_thread_id = threads_get_local_thread_id();
+    const uint32_t threads_per_group = threads_get_threads_per_group();
+    
+    const uint64_t* const edges = graph_ingress_edges;
+    const double* const weights = graph_ingress_weights;
+    const uint64_t num_edges = graph_ingress_num_edges;
+    const uint64_t shared_offset = graph_ingress_shared_vertex_offset;
+    const uint64_t individual_offset = 1ull - graph_ingress_shared_vertex_offset;
+    const uint64_t vector_lanes = graph_ingress_vector_lanes;
+    
+    uint64_t thread_first_edge;
+    uint64_t thread_last_edge;
+    uint64_t thread_vector_count = 0ull;
+    
+    // find the start of this thread's slice by moving forward from an even split until the shared vertex changes
+    thread_first_edge = num_edges * (uint64_t)thread_id / (uint64_t)num_threads;
+    while ((thread_first_edge > 0ull) && (thread_first_edge < num_edges) && (edges[(thread_first_edge << 1ull) + shared_offset] == edges[((thread_first_edge - 1ull) << 1ull) + shared_offset]))
+    {
+        thread_first_edge += 1ull;
+    }
+    
+    graph_ingress_thread_first_edge[thread_id] = thread_first_edge;
+    if (0 == thread_id)
+    {
+        graph_ingress_thread_first_edge[num_threads] = num_edges;
+    }
+    
+    threads_barrier();
+    
+    thread_last_edge = graph_ingress_thread_first_edge[thread_id + 1];
+    
+    // first pass: count the vectors this slice will produce, one for each group of up to 4 (or 8, if compact) consecutive edges that share a vertex
+    for (uint64_t i = thread_first_edge; i < thread_last_edge; )
+    {
+        const uint64_t shared_vertex_id = edges[(i << 1ull) + shared_offset];
+        uint64_t run_end = i + 1ull;
+        
+        while ((run_end < thread_last_edge) && (edges[(run_end << 1ull) + shared_offset] == shared_vertex_id))
+        {
+            run_end += 1ull;
+        }
+        
+        thread_vector_count += (run_end - i + vector_lanes - 1ull) / vector_lanes;
+        
+#ifdef EXPERIMENT_MODEL_LONG_VECTORS
+        // model this for vector lengths 8 and 16
+        __sync_fetch_and_add(&graph_edges_num_vectors_vl8, (run_end - i + 7ull) >> 3ull);
+        __sync_fetch_and_add(&graph_edges_num_vectors_vl16, (run_end - i + 15ull) >> 4ull);
+#endif
+        
+        i = run_end;
+    }
+    
+    // when building the in-edge list, give each source vertex outdegree credit for the edge
+    // sources are in no particular order, so count them atomically as integers in place and convert them once all threads are done
+    if (1ull == shared_offset)
+    {
+        for (uint64_t i = thread_first_edge; i < thread_last_edge; ++i)
+        {
+            __sync_fetch_and_add((uint64_t*)&graph_vertex_outdegrees[edges[i << 1ull]], 1ull);
+        }
+    }
+    
+    graph_ingress_thread_first_vector[thread_id + 1] = thread_vector_count;
+    
+    threads_barrier();
+    
+    // compute the starting position of each thread's vectors and divide the vectors equally among NUMA nodes
+    if (0 == thread_id)
+    {
+        graph_ingress_thread_first_vector[0] = 0ull;
+        for (uint32_t i = 1; i <= num_threads; ++i)
+        {
+            graph_ingress_thread_first_vector[i] += graph_ingress_thread_first_vector[i - 1];
+        }
+        
+        for (uint32_t i = 0; i <= graph_num_numa_nodes; ++i)
+        {
+            graph_ingress_node_first_vector[i] = graph_ingress_thread_first_vector[num_threads] * i / graph_num_numa_nodes;
+        }
+    }
+    
+    if (1ull == shared_offset)
+    {
+        for (uint64_t i = graph_num_vertices * thread_id / num_threads; i < graph_num_vertices * (thread_id + 1) / num_threads; ++i)
+        {
+            uint64_t outdegree_count;
+            
+            memcpy((void*)&outdegree_count, (void*)&graph_vertex_outdegrees[i], sizeof(outdegree_count));
+            graph_vertex_outdegrees[i] = (double)outdegree_count;
+        }
+    }
+    
+    threads_barrier();
+    
+    // each node allocates its own part of the edge list and its own vertex index
+    if (0 == local_thread_id)
+    {
+        const uint64_t node_vector_count = graph_ingress_node_first_vector[group_id + 1] - graph_ingress_node_first_vector[group_id];
+        
+        graph_ingress_block_bufs_numa[group_id][0] = (__m256i*)numanodes_malloc(sizeof(__m256i) * node_vector_count, graph_ingress_numa_nodes[group_id]);
+        graph_ingress_block_bufs_numa[group_id][1] = graph_ingress_block_bufs_numa[group_id][0];
+        graph_ingress_block_counts_numa[group_id][0] = node_vector_count;
+        graph_ingress_vertex_index_numa[group_id] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * (graph_num_vertices + (8ull * sizeof(uint64_t))), graph_ingress_numa_nodes[group_id]);
+        
+        if (NULL != graph_ingress_block_info_numa)
+        {
+            graph_ingress_block_info_numa[group_id] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * node_vector_count, graph_ingress_numa_nodes[group_id]);
+        }
+        
+        if (NULL != graph_ingress_block_weights_numa)
+        {
+            graph_ingress_block_weights_numa[group_id] = (double*)numanodes_malloc(sizeof(double) * vector_lanes * node_vector_count, graph_ingress_numa_nodes[group_id]);
+        }
+    }
+    
+    threads_barrier();
+    
+    // second pass: pack this slice's vectors, writing each one to the node that owns its final position
+    {
+        uint64_t individual_vertex_ids[GRAPH_EDGE_VECTOR_COMPACT_LANES] = { 0ull, 0ull, 0ull, 0ull, 0ull, 0ull, 0ull, 0ull };
+        double individual_weights[GRAPH_EDGE_VECTOR_COMPACT_LANES] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        uint64_t individual_vertex_id_count = 0ull;
+        uint64_t vector_idx = graph_ingress_thread_first_vector[thread_id];
+        uint32_t node_idx = 0;
+        
+        for (uint64_t i = thread_first_edge; i < thread_last_edge; ++i)
+        {
+            const uint64_t shared_vertex_id = edges[(i << 1ull) + shared_offset];
+            
+            individual_vertex_ids[individual_vertex_id_count] = edges[(i << 1ull) + individual_offset];
+            individual_weights[individual_vertex_id_count] = (NULL == weights ? 1.0 : weights[i]);
+            individual_vertex_id_count += 1ull;
+            
+            // write out a vector once it is full or the next edge has a different shared vertex
+            // note that the vector size is normally 4 to correspond to the number of packed doubles that fit into a 256-bit AVX register, or 8 for 32-bit compact IDs
+            if ((vector_lanes == individual_vertex_id_count) || ((i + 1ull) == thread_last_edge) || (edges[((i + 1ull) << 1ull) + shared_offset] != shared_vertex_id))
+            {
+                while (vector_idx >= graph_ingress_node_first_vector[node_idx + 1])
+                {
+                    node_idx += 1;
+                }
+                
+                if (NULL == graph_ingress_block_info_numa)
+                {
+                    graph_ingress_block_bufs_numa[node_idx][0][vector_idx - graph_ingress_node_first_vector[node_idx]] = graph_helper_compose_edge_vector(shared_vertex_id, individual_vertex_ids, individual_vertex_id_count);
+                }
+                else
+                {
+                    graph_ingress_block_bufs_numa[node_idx][0][vector_idx - graph_ingress_node_first_vector[node_idx]] = graph_helper_compose_compact_edge_vector(shared_vertex_id, individual_vertex_ids, individual_vertex_id_count, &graph_ingress_block_info_numa[node_idx][vector_idx - graph_ingress_node_first_vector[node_idx]]);
+                }
+                
+                // weights go in the same lanes as their edges, and unused lanes are masked off by the kernels so their weights do not matter
+                if (NULL != graph_ingress_block_weights_numa)
+                {
+                    double* const vector_weights = &graph_ingress_block_weights_numa[node_idx][(vector_idx - graph_ingress_node_first_vector[node_idx]) * vector_lanes];
+                    
+                    for (uint64_t lane = 0ull; lane < vector_lanes; ++lane)
+                    {
+                        vector_weights[lane] = (lane < individual_vertex_id_count ? individual_weights[lane] : 0.0);
+                    }
+                }
+                
+                vector_idx += 1ull;
+                individual_vertex_id_count = 0ull;
+            }
+        }
+    }
+    
+    threads_barrier();
+    
+    // build this node's vertex index, dividing the node's vectors equally among its threads
+    {
+        const uint64_t node_vector_count = graph_ingress_block_counts_numa[group_id][0];
+        
+        graph_helper_create_vertex_index_part(
+            graph_ingress_block_bufs_numa[group_id][0],
+            ((NULL == graph_ingress_block_info_numa) ? NULL : graph_ingress_block_info_numa[group_id]),
+            node_vector_count,
+            node_vector_count * local_thread_id / threads_per_group,
+            node_vector_count * (local_thread_id + 1) / threads_per_group,
+            graph_ingress_vertex_index_numa[group_id],
+            graph_num_vertices + (8ull * sizeof(uint64_t)),
+            &graph_ingress_vertex_index_start_numa[group_id],
+            &graph_ingress_vertex_index_end_numa[group_id]
+        );
+    }
+}
+
+// Builds an edge list from the current ingress edges, calling the other helper functions as needed.
+// Uses every core on each of the specified NUMA nodes, and fills in the graph_ingress_* data structures, which must point to the right edge list.
+// Returns the total number of vectors in the edge list.
+uint64_t graph_helper_build_edge_list(const uint32_t* numa_nodes)
+{
+    const uint32_t num_threads = graph_num_numa_nodes * numanodes_get_num_processors_on_node(numa_nodes[0]);
+    uint64_t vector_count;
+    
+    // for each NUMA node, create its set of buffer pointers and counts
+    // the buffers themselves are allocated by the threads on each node, once the number of vectors is known
+    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    {
+        graph_ingress_block_bufs_numa[i] = (__m256i**)numanodes_malloc(sizeof(__m256i*) * 2, numa_nodes[i]);
+        graph_ingress_block_counts_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t), numa_nodes[i]);
+    }
+    
+    // allocate the per-thread and per-node boundaries
+    graph_ingress_numa_nodes = numa_nodes;
+    graph_ingress_thread_first_edge = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * (num_threads + 1));
+    graph_ingress_thread_first_vector = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * (num_threads + 1));
+    graph_ingress_node_first_vector = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * (graph_num_numa_nodes + 1));
+    
+#ifdef EXPERIMENT_MODEL_LONG_VECTORS
+    graph_edges_num_vectors_vl8 = 0ull;
+    graph_edges_num_vectors_vl16 = 0ull;
+#endif
+    
+    threads_spawn(num_threads, graph_num_numa_nodes, numa_nodes, 0, &graph_helper_multithread_control_build_edge_list, NULL);
+    
+    vector_count = graph_ingress_node_first_vector[graph_num_numa_nodes];
+    
+    // free the per-thread and per-node boundaries
+    numanodes_free((void*)graph_ingress_thread_first_edge, sizeof(uint64_t) * (num_threads + 1));
+    numanodes_free((void*)graph_ingress_thread_first_vector, sizeof(uint64_t) * (num_threads + 1));
+    numanodes_free((void*)graph_ingress_node_first_vector, sizeof(uint64_t) * (graph_num_numa_nodes + 1));
+    graph_ingress_thread_first_edge = NULL;
+    graph_ingress_thread_first_vector = NULL;
+    graph_ingress_node_first_vector = NULL;
+    
+    return vector_count;
+}
+
+// Builds the in-edge list, directly into its NUMA-aware data structures.
+void graph_helper_build_gather_list(const uint32_t* numa_nodes)
+{
+    // allocate the edge list block buffer pointer containers and the vertex index pointers
+    graph_edges_gather_list_block_bufs_numa = (__m256i***)numanodes_malloc(sizeof(__m256i**) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_edges_gather_list_block_counts_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_gather_index_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_gather_index_start_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_gather_index_end_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    
+#ifdef EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    // compact edge vectors hold 32-bit source vertex IDs, with each vector's destination and valid lanes kept alongside it
+    if (graph_num_vertices > 0x100000000ull)
+    {
+        fprintf(stderr, "Error: Compact edge vectors require at most 2^32 vertices, but the graph has %llu.\n", (long long unsigned int)graph_num_vertices);
+        exit(255);
+    }
+    
+    graph_edges_gather_list_block_info_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+#endif
+    
+    if (graph_load_edge_weights)
+    {
+        graph_edges_gather_list_block_weights_numa = (double**)numanodes_malloc(sizeof(double*) * graph_num_numa_nodes, numa_nodes[0]);
+    }
+    
+    // the shared vertex in the in-edge list is the destination
+    graph_ingress_block_bufs_numa = graph_edges_gather_list_block_bufs_numa;
+    graph_ingress_block_counts_numa = graph_edges_gather_list_block_counts_numa;
+    graph_ingress_vertex_index_numa = graph_vertex_gather_index_numa;
+    graph_ingress_vertex_index_start_numa = graph_vertex_gather_index_start_numa;
+    graph_ingress_vertex_index_end_numa = graph_vertex_gather_index_end_numa;
+    graph_ingress_block_info_numa = graph_edges_gather_list_block_info_numa;
+    graph_ingress_block_weights_numa = graph_edges_gather_list_block_weights_numa;
+    graph_ingress_vector_lanes = GRAPH_GATHER_LIST_LANES;
+    graph_ingress_shared_vertex_offset = 1ull;
+    
+    graph_edges_gather_list_vector_count = graph_helper_build_edge_list(numa_nodes);
+    
+    // the edge list forms a single block, so the block table just records its first and last destination vertices
+    graph_edges_gather_list_num_blocks = 1ull;
+    graph_edges_gather_list_block_first_dest_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+    graph_edges_gather_list_block_last_dest_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+    graph_edges_gather_list_block_first_dest_vertex[0] = graph_macro_get_shared_vertex_at(graph_edges_gather_list_block_bufs_numa[0][0], ((NULL == graph_edges_gather_list_block_info_numa) ? NULL : graph_edges_gather_list_block_info_numa[0]), 0ull);
+    graph_edges_gather_list_block_last_dest_vertex[0] = graph_macro_get_shared_vertex_at(graph_edges_gather_list_block_bufs_numa[graph_num_numa_nodes - 1][0], ((NULL == graph_edges_gather_list_block_info_numa) ? NULL : graph_edges_gather_list_block_info_numa[graph_num_numa_nodes - 1]), graph_edges_gather_list_block_counts_numa[graph_num_numa_nodes - 1][0] - 1ull);
+    
+    // output the total number of blocks in the in-edge list
+    printf("In-edges:  created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_gather_list_vector_count, (double)graph_num_edges / (double)graph_edges_gather_list_vector_count / (double)GRAPH_GATHER_LIST_LANES * 100.0);
+    
+#ifdef EXPERIMENT_MODEL_LONG_VECTORS
+    // output model results for longer vector lengths
+    printf("In-edges:  VL8: created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_num_vectors_vl8, (double)graph_num_edges / (double)graph_edges_num_vectors_vl8 / 8.0 * 100.0);
+    printf("In-edges:  VL16: created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_num_vectors_vl16, (double)graph_num_edges / (double)graph_edges_num_vectors_vl16 / 16.0 * 100.0);
+#endif
+}
+
+// Builds the out-edge list, directly into its NUMA-aware data structures.
+void graph_helper_build_scatter_list(const uint32_t* numa_nodes)
+{
+    // allocate the edge list block buffer pointer containers and the vertex index pointers
+    graph_edges_scatter_list_block_bufs_numa = (__m256i***)numanodes_malloc(sizeof(__m256i**) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_edges_scatter_list_block_counts_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_scatter_index_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_scatter_index_start_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_scatter_index_end_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    
+    if (graph_load_edge_weights)
+    {
+        graph_edges_scatter_list_block_weights_numa = (double**)numanodes_malloc(sizeof(double*) * graph_num_numa_nodes, numa_nodes[0]);
+    }
+    
+    // the shared vertex in the out-edge list is the source
+    graph_ingress_block_bufs_numa = graph_edges_scatter_list_block_bufs_numa;
+    graph_ingress_block_counts_numa = graph_edges_scatter_list_block_counts_numa;
+    graph_ingress_vertex_index_numa = graph_vertex_scatter_index_numa;
+    graph_ingress_vertex_index_start_numa = graph_vertex_scatter_index_start_numa;
+    graph_ingress_vertex_index_end_numa = graph_vertex_scatter_index_end_numa;
+    graph_ingress_block_info_numa = NULL;
+    graph_ingress_block_weights_numa = graph_edges_scatter_list_block_weights_numa;
+    graph_ingress_vector_lanes = GRAPH_EDGE_VECTOR_LANES;
+    graph_ingress_shared_vertex_offset = 0ull;
+    
+    graph_edges_scatter_list_vector_count = graph_helper_build_edge_list(numa_nodes);
+    
+    // the edge list forms a single block, so the block table just records its first and last source vertices
+    graph_edges_scatter_list_num_blocks = 1ull;
+    graph_edges_scatter_list_block_first_source_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+    graph_edges_scatter_list_block_last_source_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+    graph_edges_scatter_list_block_first_source_vertex[0] = graph_macro_get_shared_vertex(graph_edges_scatter_list_block_bufs_numa[0][0][0]);
+    graph_edges_scatter_list_block_last_source_vertex[0] = graph_macro_get_shared_vertex(graph_edges_scatter_list_block_bufs_numa[graph_num_numa_nodes - 1][0][graph_edges_scatter_list_block_counts_numa[graph_num_numa_nodes - 1][0] - 1ull]);
+    
+    // output the total number of blocks in the out-edge list
+    printf("Out-edges: created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_scatter_list_vector_count, (double)graph_num_edges / (double)graph_edges_scatter_list_vector_count / 4.0 * 100.0);
+    
+#ifdef EXPERIMENT_MODEL_LONG_VECTORS
+    // output model results for longer vector lengths
+    printf("Out-edges: VL8: created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_num_vectors_vl8, (double)graph_num_edges / (double)graph_edges_num_vectors_vl8 / 8.0 * 100.0);
+    printf("Out-edges: VL16: created %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_num_vectors_vl16, (double)graph_num_edges / (double)graph_edges_num_vectors_vl16 / 16.0 * 100.0);
+#endif
+}
+
+// Writes the specified buffer to an open snapshot file, or prints and terminates on failure.
+void graph_helper_snapshot_write_or_die(FILE* snapshotfile, const char* filename, const void* buf, const uint64_t size)
+{
+    if (size != (uint64_t)fwrite(buf, 1, (size_t)size, snapshotfile))
+    {
+        fprintf(stderr, "Error: unable to write file \"%s\"\n", filename);
+        exit(255);
+    }
+}
+
+// Fills the specified buffer from an open snapshot file, or prints and terminates on failure.
+void graph_helper_snapshot_read_or_die(FILE* snapshotfile, const char* filename, void* buf, const uint64_t size)
+{
+    if (size != (uint64_t)fread(buf, 1, (size_t)size, snapshotfile))
+    {
+        fprintf(stderr, "Error: unable to read file \"%s\"\n", filename);
+        exit(255);
+    }
+}
+
+// Pads an open snapshot file with zeroes up to the next multiple of GRAPH_SNAPSHOT_ALIGNMENT, or prints and terminates on failure.
+void graph_helper_snapshot_align_or_die(FILE* snapshotfile, const char* filename)
+{
+    static const uint8_t zeroes[GRAPH_SNAPSHOT_ALIGNMENT] = { 0 };
+    const long position = ftell(snapshotfile);
+    
+    if (0 > position)
+    {
+        fprintf(stderr, "Error: unable to write file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)zeroes, (GRAPH_SNAPSHOT_ALIGNMENT - ((uint64_t)position & (GRAPH_SNAPSHOT_ALIGNMENT - 1ull))) & (GRAPH_SNAPSHOT_ALIGNMENT - 1ull));
+}
+
+// Records that the specified buffer, owned by the specified NUMA node, is to be filled from the bulk part of a snapshot file that comes next, and skips past it.
+// The bulk part starts at the next multiple of GRAPH_SNAPSHOT_ALIGNMENT. Prints and terminates on failure.
+void graph_helper_snapshot_defer_read_or_die(FILE* snapshotfile, const char* filename, void* buf, const uint64_t size, const uint32_t group_id)
+{
+    const long position = ftell(snapshotfile);
+    const uint64_t offset = ((uint64_t)position + (GRAPH_SNAPSHOT_ALIGNMENT - 1ull)) & ~(GRAPH_SNAPSHOT_ALIGNMENT - 1ull);
+    
+    if (0 > position || 0 != fseek(snapshotfile, (long)(offset + size), SEEK_SET))
+    {
+        fprintf(stderr, "Error: unable to read file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    graph_snapshot_reads[graph_snapshot_num_reads].buf = buf;
+    graph_snapshot_reads[graph_snapshot_num_reads].offset = offset;
+    graph_snapshot_reads[graph_snapshot_num_reads].size = size;
+    graph_snapshot_reads[graph_snapshot_num_reads].group_id = group_id;
+    graph_snapshot_num_reads += 1ull;
+}
+
+// Skips past the bulk part of a snapshot file that comes next without reading it, or prints and terminates on failure.
+void graph_helper_snapshot_skip_or_die(FILE* snapshotfile, const char* filename, const uint64_t size)
+{
+    const long position = ftell(snapshotfile);
+    const uint64_t offset = ((uint64_t)position + (GRAPH_SNAPSHOT_ALIGNMENT - 1ull)) & ~(GRAPH_SNAPSHOT_ALIGNMENT - 1ull);
+    
+    if (0 > position || 0 != fseek(snapshotfile, (long)(offset + size), SEEK_SET))
+    {
+        fprintf(stderr, "Error: unable to read file \"%s\"\n", filename);
+        exit(255);
+    }
+}
+
+// Fills the specified buffer from the specified position in the snapshot file currently being read.
+// As much as possible is read using direct I/O, which bypasses the page cache, and the rest, or everything if direct I/O fails, using regular I/O.
+// Returns 1 on success, 0 on failure.
+uint32_t graph_helper_snapshot_read_chunk(uint8_t* buf, const uint64_t size, const uint64_t offset)
+{
+    const uint64_t direct_size = (0 > graph_snapshot_direct_fd) ? 0ull : (size & ~(GRAPH_SNAPSHOT_ALIGNMENT - 1ull));
+    uint64_t bytes_read = 0ull;
+    
+    while (bytes_read < direct_size)
+    {
+        const ssize_t result = pread(graph_snapshot_direct_fd, (void*)&buf[bytes_read], (size_t)(direct_size - bytes_read), (off_t)(offset + bytes_read));
+        
+        if (0 >= result)
+            break;
+        
+        bytes_read += (uint64_t)result;
+    }
+    
+    while (bytes_read < size)
+    {
+        const ssize_t result = pread(graph_snapshot_buffered_fd, (void*)&buf[bytes_read], (size_t)(size - bytes_read), (off_t)(offset + bytes_read));
+        
+        if (0 >= result)
+            return 0;
+        
+        bytes_read += (uint64_t)result;
+    }
+    
+    return 1;
+}
+
+// Master control function for reading the bulk parts of a snapshot file.
+// The threads on each NUMA node read the parts owned by that node, divided into chunks that are distributed among them, so that many large reads are in flight at once.
+void graph_helper_multithread_control_read_snapshot(void* arg)
+{
+    const uint32_t group_id = threads_get_thread_group_id();
+    const uint32_t local_thread_id = threads_get_local_thread_id();
+    const uint32_t threads_per_group = threads_get_threads_per_group();
+    uint64_t chunk_idx = 0ull;
+    
+    for (uint64_t i = 0ull; i < graph_snapshot_num_reads; ++i)
+    {
+        const graphsnapshotread_t* const read = &graph_snapshot_reads[i];
+        
+        if (group_id != read->group_id)
+            continue;
+        
+        for (uint64_t position = 0ull; position < read->size; position += GRAPH_SNAPSHOT_READ_CHUNK_BYTES, ++chunk_idx)
+        {
+            const uint64_t chunk_size = ((read->size - position) < GRAPH_SNAPSHOT_READ_CHUNK_BYTES ? (read->size - position) : GRAPH_SNAPSHOT_READ_CHUNK_BYTES);
+            
+            if ((uint32_t)(chunk_idx % (uint64_t)threads_per_group) != local_thread_id)
+                continue;
+            
+            if (!graph_helper_snapshot_read_chunk(&((uint8_t*)read->buf)[position], chunk_size, read->offset + position))
+                graph_snapshot_read_failed = 1ull;
+        }
+    }
+}
+
+// Reads all of the bulk parts of a snapshot file recorded so far, in parallel using every core on each of the specified NUMA nodes, or prints and terminates on failure.
+void graph_helper_snapshot_read_deferred_or_die(const char* filename, const uint32_t* numa_nodes)
+{
+    const uint32_t num_threads = graph_num_numa_nodes * numanodes_get_num_processors_on_node(numa_nodes[0]);
+    
+    // direct I/O is not supported by every file system, in which case only regular I/O is used
+    graph_snapshot_direct_fd = open(filename, O_RDONLY | O_DIRECT);
+    graph_snapshot_buffered_fd = open(filename, O_RDONLY);
+    if (0 > graph_snapshot_buffered_fd)
+    {
+        fprintf(stderr, "Error: unable to read file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    graph_snapshot_read_failed = 0ull;
+    threads_spawn(num_threads, graph_num_numa_nodes, numa_nodes, 0, &graph_helper_multithread_control_read_snapshot, NULL);
+    
+    if (0 <= graph_snapshot_direct_fd)
+        close(graph_snapshot_direct_fd);
+    
+    close(graph_snapshot_buffered_fd);
+    graph_snapshot_direct_fd = -1;
+    graph_snapshot_buffered_fd = -1;
+    
+    if (0ull != graph_snapshot_read_failed)
+    {
+        fprintf(stderr, "Error: unable to read file \"%s\"\n", filename);
+        exit(255);
+    }
+}
+
+// Encodes a group of edges sharing a key vertex into the specified buffer, which must have room for 10 bytes per edge plus 20 bytes, and returns the number of bytes written.
+uint64_t graph_helper_encode_edge_group(const uint64_t key_vertex_delta, const uint64_t* other_vertices, const uint64_t count, uint8_t* buf)
+{
+    uint64_t other_vertex = 0ull;
+    uint64_t size = 0ull;
+    
+    size += graph_helper_encode_varint(key_vertex_delta, &buf[size]);
+    size += graph_helper_encode_varint(count, &buf[size]);
+    
+    for (uint64_t i = 0ull; i < count; ++i)
+    {
+        const int64_t delta = (int64_t)(other_vertices[i] - other_vertex);
+        
+        size += graph_helper_encode_varint(((uint64_t)delta << 1ull) ^ (uint64_t)(delta >> 63), &buf[size]);
+        other_vertex = other_vertices[i];
+    }
+    
+    return size;
+}
+
+// Writes the edges in the specified edge list, as split up across all NUMA nodes, to a compressed edge list file, or prints and terminates on failure.
+// Edges are written in the same order as they appear in the edge list, and key offset indicates whether the shared vertex of each vector is the source (0) or destination (1).
+// Per-vector information is needed only for edge lists that use the compact encoding and should otherwise be NULL.
+void graph_helper_write_compressed_edge_list(const char* filename, __m256i*** block_bufs_numa, uint64_t** block_info_numa, uint64_t** block_counts_numa, const uint64_t key_offset)
+{
+    graphcompressed_t header;
+    uint64_t* chunk_offsets;
+    uint64_t* group_other_vertices;
+    uint8_t* chunk_buf;
+    uint64_t chunk_buf_size = 0ull;
+    uint64_t chunk_idx = 0ull;
+    uint64_t chunk_edge_count = 0ull;
+    uint64_t chunk_prev_key_vertex = 0ull;
+    uint64_t group_key_vertex = 0ull;
+    uint64_t group_count = 0ull;
+    uint64_t file_offset;
+    FILE* graphfile;
+    
+    // count the valid edges, which determines the number of chunks
+    header.magic = GRAPH_COMPRESSED_MAGIC;
+    header.num_vertices = graph_num_vertices;
+    header.num_edges = 0ull;
+    header.key_offset = key_offset;
+    header.chunk_edges = GRAPH_COMPRESSED_CHUNK_EDGES;
+    
+    for (uint32_t n = 0; n < graph_num_numa_nodes; ++n)
+    {
+        for (uint64_t i = 0ull; i < block_counts_numa[n][0]; ++i)
+        {
+            if (NULL == block_info_numa)
+            {
+                header.num_edges += (uint64_t)__builtin_popcount((unsigned int)_mm256_movemask_pd(_mm256_castsi256_pd(block_bufs_numa[n][0][i])));
+            }
+            else
+            {
+                header.num_edges += (uint64_t)__builtin_popcountll(block_info_numa[n][i] >> GRAPH_EDGE_INFO_LANE_MASK_SHIFT);
+            }
+        }
+    }
+    
+    header.num_chunks = (header.num_edges + header.chunk_edges - 1ull) / header.chunk_edges;
+    
+    graphfile = fopen(filename, "wb");
+    if (NULL == graphfile)
+    {
+        fprintf(stderr, "Error: unable to write file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    chunk_offsets = (uint64_t*)malloc(sizeof(uint64_t) * (header.num_chunks + 1ull));
+    group_other_vertices = (uint64_t*)malloc(sizeof(uint64_t) * header.chunk_edges);
+    chunk_buf = (uint8_t*)malloc(30ull * header.chunk_edges);
+    
+    // chunk offsets are filled in as chunks are written, so write placeholders now and the real values at the end
+    file_offset = sizeof(header) + (sizeof(uint64_t) * (header.num_chunks + 1ull));
+    memset((void*)chunk_offsets, 0, sizeof(uint64_t) * (header.num_chunks + 1ull));
+    graph_helper_snapshot_write_or_die(graphfile, filename, &header, sizeof(header));
+    graph_helper_snapshot_write_or_die(graphfile, filename, chunk_offsets, sizeof(uint64_t) * (header.num_chunks + 1ull));
+    
+    for (uint32_t n = 0; n < graph_num_numa_nodes; ++n)
+    {
+        for (uint64_t i = 0ull; i < block_counts_numa[n][0]; ++i)
+        {
+            const uint64_t key_vertex = graph_macro_get_shared_vertex_at(block_bufs_numa[n][0], ((NULL == block_info_numa) ? NULL : block_info_numa[n]), i);
+            uint64_t lanes[GRAPH_EDGE_VECTOR_COMPACT_LANES];
+            uint64_t lane_count;
+            uint64_t lane_valid_mask;
+            
+            // extract the other vertex in each lane and which of the lanes are valid, according to the encoding
+            if (NULL == block_info_numa)
+            {
+                _mm256_storeu_si256((__m256i*)lanes, block_bufs_numa[n][0][i]);
+                lane_count = GRAPH_EDGE_VECTOR_LANES;
+                lane_valid_mask = (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(block_bufs_numa[n][0][i]));
+                
+                for (uint32_t lane = 0; lane < lane_count; ++lane)
+                {
+                    lanes[lane] &= 0x0000ffffffffffffull;
+                }
+            }
+            else
+            {
+                const uint32_t* compact_lanes = (const uint32_t*)&block_bufs_numa[n][0][i];
+                
+                lane_count = GRAPH_EDGE_VECTOR_COMPACT_LANES;
+                lane_valid_mask = block_info_numa[n][i] >> GRAPH_EDGE_INFO_LANE_MASK_SHIFT;
+                
+                for (uint32_t lane = 0; lane < lane_count; ++lane)
+                {
+                    lanes[lane] = (uint64_t)compact_lanes[lane];
+                }
+            }
+            
+            for (uint32_t lane = 0; lane < lane_count; ++lane)
+            {
+                if (0ull == (lane_valid_mask & (1ull << lane)))
+                {
+                    continue;
+                }
+                
+                // the current group ends when the key vertex changes or the current chunk is full
+                if ((0ull != group_count) && ((key_vertex != group_key_vertex) || (header.chunk_edges == chunk_edge_count)))
+                {
+                    chunk_buf_size += graph_helper_encode_edge_group(group_key_vertex - chunk_prev_key_vertex, group_other_vertices, group_count, &chunk_buf[chunk_buf_size]);
+                    chunk_prev_key_vertex = group_key_vertex;
+                    group_count = 0ull;
+                }
+                
+                // the current chunk is written out once it is full
+                if (header.chunk_edges == chunk_edge_count)
+                {
+                    graph_helper_snapshot_write_or_die(graphfile, filename, chunk_buf, chunk_buf_size);
+                    chunk_offsets[chunk_idx++] = file_offset;
+                    file_offset += chunk_buf_size;
+                    
+                    chunk_buf_size = 0ull;
+                    chunk_edge_count = 0ull;
+                    chunk_prev_key_vertex = 0ull;
+                }
+                
+                group_key_vertex = key_vertex;
+                group_other_vertices[group_count++] = lanes[lane];
+                chunk_edge_count += 1ull;
+            }
+        }
+    }
+    
+    // write out the final group and chunk
+    if (0ull != group_count)
+    {
+        chunk_buf_size += graph_helper_encode_edge_group(group_key_vertex - chunk_prev_key_vertex, group_other_vertices, group_count, &chunk_buf[chunk_buf_size]);
+        graph_helper_snapshot_write_or_die(graphfile, filename, chunk_buf, chunk_buf_size);
+        chunk_offsets[chunk_idx++] = file_offset;
+        file_offset += chunk_buf_size;
+    }
+    
+    chunk_offsets[header.num_chunks] = file_offset;
+    
+    if (0 != fseek(graphfile, (long)sizeof(header), SEEK_SET))
+    {
+        fprintf(stderr, "Error: unable to write file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    graph_helper_snapshot_write_or_die(graphfile, filename, chunk_offsets, sizeof(uint64_t) * (header.num_chunks + 1ull));
+    
+    if (0 != fclose(graphfile))
+    {
+        fprintf(stderr, "Error: unable to write file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    free((void*)chunk_offsets);
+    free((void*)group_other_vertices);
+    free((void*)chunk_buf);
+}
+
+
+// Retrieves the property of the specified vertex, which single-precision algorithms store as a float and some others store as a 32-bit vertex ID.
+double graph_helper_get_vertex_prop(const uint64_t vertex)
+{
+    if (execution_algorithm->vertex_id_props)
+    {
+        const uint32_t vertex_prop = ((uint32_t*)graph_vertex_props)[vertex];
+        return (UINT32_MAX == vertex_prop ? -1.0 : (double)vertex_prop);
+    }
+    else if (execution_algorithm->single_precision)
+    {
+        return (double)((float*)graph_vertex_props)[vertex];
+    }
+    else
+    {
+        return graph_vertex_props[vertex];
+    }
+}
+
+// Retrieves the output value of the specified vertex, as written by graph_data_write_ranks_to_file().
+// For PageRank this is the final rank, for shortest paths it is the distance from the root, for search depths it is the number of edges from the root, and for other applications it is a vertex ID, or a component label, translated to the input graph's original IDs, or -1 if there is none.
+double graph_helper_get_vertex_output_value(const uint64_t vertex)
+{
+    if (EXECUTION_OUTPUT_RANK == graph_output_type)
+    {
+        return graph_helper_get_vertex_prop(vertex) * (0.0 == graph_vertex_outdegrees[vertex] ? (double)graph_num_vertices : graph_vertex_outdegrees[vertex]);
+    }
+    else if (EXECUTION_OUTPUT_DISTANCE == graph_output_type)
+    {
+        return graph_helper_get_vertex_prop(vertex);
+    }
+    else if (EXECUTION_OUTPUT_DEPTH == graph_output_type)
+    {
+        return (UINT32_MAX == graph_output_depths[vertex] ? -1.0 : (double)graph_output_depths[vertex]);
+    }
+    else
+    {
+        // component labels and parents are themselves vertex IDs, so they are translated in the same way as vertices
+        // component labels identify vertices by output position, however, so that the lowest label in a component does not depend on reordering
+        double vertex_prop = graph_helper_get_vertex_prop(vertex);
+        if ((NULL != graph_vertex_original_ids) && (vertex_prop >= 0.0) && (vertex_prop < (double)graph_num_vertices))
+        {
+            const uint64_t label_vertex = ((EXECUTION_OUTPUT_COMPONENT == graph_output_type) ? graph_macro_get_output_vertex((uint64_t)vertex_prop) : (uint64_t)vertex_prop);
+            vertex_prop = (double)graph_vertex_original_ids[label_vertex];
+        }
+        
+        return vertex_prop;
+    }
+}
+
+// Formats the specified vertex as a line of text output into the specified buffer, which must have room for at least 96 characters, and returns the number of characters written.
+uint64_t graph_helper_format_vertex_output(const uint64_t vertex, char* buf)
+{
+    // vertices are identified as they were in the input graph, even if they were renumbered
+    const uint64_t vertex_id = (NULL == graph_vertex_original_ids ? vertex : graph_vertex_original_ids[vertex]);
+    
+    if (EXECUTION_OUTPUT_SEARCH_TOTALS == graph_output_type)
+    {
+        // search totals follow the searches that have reached the vertex in the search state
+        const uint64_t* const search_totals = &graph_vertex_search_state[(GRAPH_SEARCH_STATE_WORDS * vertex) + 1ull];
+        return (uint64_t)snprintf(buf, 96, "%llu %llu %llu %llu\n", (long long unsigned int)vertex_id, (long long unsigned int)search_totals[0], (long long unsigned int)search_totals[1], (long long unsigned int)search_totals[2]);
+    }
+    else if (EXECUTION_OUTPUT_RANK == graph_output_type)
+    {
+        return (uint64_t)snprintf(buf, 96, "%llu %.5le\n", (long long unsigned int)vertex_id, graph_helper_get_vertex_output_value(vertex));
+    }
+    else if (EXECUTION_OUTPUT_DISTANCE == graph_output_type)
+    {
+        return (uint64_t)snprintf(buf, 96, "%llu %.10lg\n", (long long unsigned int)vertex_id, graph_helper_get_vertex_output_value(vertex));
+    }
+    else
+    {
+        return (uint64_t)snprintf(buf, 96, "%llu %.0lf\n", (long long unsigned int)vertex_id, graph_helper_get_vertex_output_value(vertex));
+    }
+}
+
+// Writes the specified buffer to the output file at the specified position, recording any failure.
+void graph_helper_write_output_buffer(const void* buf, const uint64_t size, const uint64_t offset)
+{
+    uint64_t bytes_written = 0ull;
+    
+    while (bytes_written < size)
+    {
+        const ssize_t result = pwrite(graph_output_file, (const void*)((const uint8_t*)buf + bytes_written), (size_t)(size - bytes_written), (off_t)(offset + bytes_written));
+        
+        if (result <= 0)
+        {
+            graph_output_write_failed = 1ull;
+            return;
+        }
+        
+        bytes_written += (uint64_t)result;
+    }
+}
+
+// Master control function for writing output in parallel.
+// Each thread writes a part of the output positions corresponding to the vertices assigned to its NUMA node, formatting them into its own buffer and writing it directly to its position in the file.
+// Positions and vertices differ only if vertices were reordered at ingress, in which case output is still in the original order.
+// Text output is formatted twice, once to measure each thread's part of the file and then again to write it, so that memory use does not depend on the size of the graph.
+void graph_helper_multithread_control_write_output(void* arg)
+{
+    const uint32_t thread_id = threads_get_global_thread_id();
+    const uint32_t num_threads = threads_get_total_threads();
+    const uint32_t group_id = threads_get_thread_group_id();
+    const uint32_t local_thread_id = threads_get_local_thread_id();
+    const uint32_t threads_per_group = threads_get_threads_per_group();
+    
+    const uint64_t group_first_vertex = graph_vertex_first_numa[group_id];
+    const uint64_t group_count = graph_vertex_count_numa[group_id];
+    const uint64_t thread_first_vertex = group_first_vertex + (group_count * (uint64_t)local_thread_id / (uint64_t)threads_per_group);
+    const uint64_t thread_last_vertex = group_first_vertex + (group_count * (uint64_t)(local_thread_id + 1) / (uint64_t)threads_per_group);
+    
+    const uint64_t buf_vertices = 65536ull;
+    uint8_t* const buf = (uint8_t*)malloc(96ull * buf_vertices);
+    
+    if (graph_output_is_binary)
+    {
+        // binary output is a fixed size per vertex, so each thread's position in the file is known in advance
+        const uint64_t values_per_vertex = ((EXECUTION_OUTPUT_SEARCH_TOTALS == graph_output_type) ? 3ull : 1ull);
+        
+        for (uint64_t v = thread_first_vertex; v < thread_last_vertex; v += buf_vertices)
+        {
+            const uint64_t count = ((thread_last_vertex - v) < buf_vertices ? (thread_last_vertex - v) : buf_vertices);
+            
+            for (uint64_t i = 0ull; i < count; ++i)
+            {
+                if (EXECUTION_OUTPUT_SEARCH_TOTALS == graph_output_type)
+                {
+                    // search totals follow the searches that have reached the vertex in the search state
+                    const uint64_t* const search_totals = &graph_vertex_search_state[(GRAPH_SEARCH_STATE_WORDS * graph_macro_get_output_vertex(v + i)) + 1ull];
+                    
+                    ((uint64_t*)buf)[(3ull * i) + 0ull] = search_totals[0];
+                    ((uint64_t*)buf)[(3ull * i) + 1ull] = search_totals[1];
+                    ((uint64_t*)buf)[(3ull * i) + 2ull] = search_totals[2];
+                }
+                else if (EXECUTION_OUTPUT_RANK == graph_output_type || EXECUTION_OUTPUT_DISTANCE == graph_output_type)
+                {
+                    ((double*)buf)[i] = graph_helper_get_vertex_output_value(graph_macro_get_output_vertex(v + i));
+                }
+                else
+                {
+                    const double vertex_value = graph_helper_get_vertex_output_value(graph_macro_get_output_vertex(v + i));
+                    ((uint64_t*)buf)[i] = (vertex_value < 0.0 ? UINT64_MAX : (uint64_t)vertex_value);
+                }
+            }
+            
+            graph_helper_write_output_buffer(buf, sizeof(uint64_t) * values_per_vertex * count, sizeof(uint64_t) * values_per_vertex * v);
+        }
+    }
+    else
+    {
+        uint64_t offset = 0ull;
+        
+        // first pass: measure this thread's part of the output
+        for (uint64_t v = thread_first_vertex; v < thread_last_vertex; ++v)
+        {
+            offset += graph_helper_format_vertex_output(graph_macro_get_output_vertex(v), (char*)buf);
+        }
+        
+        graph_output_thread_first_byte[thread_id + 1] = offset;
+        
+        threads_barrier();
+        
+        if (0 == thread_id)
+        {
+            graph_output_thread_first_byte[0] = 0ull;
+            
+            for (uint32_t i = 0; i < num_threads; ++i)
+            {
+                graph_output_thread_first_byte[i + 1] += graph_output_thread_first_byte[i];
+            }
+        }
+        
+        threads_barrier();
+        
+        // second pass: format and write this thread's part of the output
+        offset = graph_output_thread_first_byte[thread_id];
+        
+        for (uint64_t v = thread_first_vertex; v < thread_last_vertex; v += buf_vertices)
+        {
+            const uint64_t count = ((thread_last_vertex - v) < buf_vertices ? (thread_last_vertex - v) : buf_vertices);
+            uint64_t size = 0ull;
+            
+            for (uint64_t i = 0ull; i < count; ++i)
+            {
+                size += graph_helper_format_vertex_output(graph_macro_get_output_vertex(v + i), (char*)&buf[size]);
+            }
+            
+            graph_helper_write_output_buffer(buf, size, offset);
+            offset += size;
+        }
+    }
+    
+    free((void*)buf);
+}
+
+// Writes the output file in parallel, with the kind of value for each vertex already selected.
+void graph_helper_write_output_file(const char* filename, const uint32_t binary, const uint64_t num_threads, const uint32_t num_numa_nodes, const uint32_t* numa_nodes)
+{
+    // open the file for writing, discarding any previous contents
+    graph_output_file = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (0 > graph_output_file)
+    {
+        fprintf(stderr, "Error: unable to write file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    graph_output_is_binary = binary;
+    graph_output_write_failed = 0ull;
+    graph_output_thread_first_byte = (uint64_t*)malloc(sizeof(uint64_t) * (num_threads + 1ull));
+    
+    // all threads write their parts of the output concurrently
+    threads_spawn((uint32_t)num_threads, num_numa_nodes, numa_nodes, 0, &graph_helper_multithread_control_write_output, NULL);
+    
+    free((void*)graph_output_thread_first_byte);
+    graph_output_thread_first_byte = NULL;
+    
+    if ((0 != close(graph_output_file)) || (0ull != graph_output_write_failed))
+    {
+        fprintf(stderr, "Error: unable to write file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    graph_output_file = -1;
+}
+
+// Computes the depth of each vertex in the search tree formed by the parent of each vertex, which is its vertex property, rooted at the specified vertex.
+// Each vertex not yet assigned a depth is handled by walking up its parents until reaching one that has a depth and then assigning depths on the way back down, so each vertex is assigned exactly once.
+void graph_helper_compute_search_depths(const uint64_t root_vertex)
+{
+    const uint32_t depth_pending = UINT32_MAX - 1u;
+    
+    for (uint64_t i = 0ull; i < graph_num_vertices; ++i)
+    {
+        graph_output_depths[i] = ((graph_helper_get_vertex_prop(i) < 0.0) ? UINT32_MAX : depth_pending);
+    }
+    
+    // the root is the only vertex reached without having a parent
+    graph_output_depths[root_vertex] = 0u;
+    
+    for (uint64_t i = 0ull; i < graph_num_vertices; ++i)
+    {
+        uint64_t vertex = i;
+        uint32_t depth = 0u;
+        uint32_t base_depth;
+        
+        while (depth_pending == graph_output_depths[vertex])
+        {
+            vertex = (uint64_t)graph_helper_get_vertex_prop(vertex);
+            depth += 1u;
+        }
+        
+        // a vertex whose parent was never reached is itself unreachable
+        base_depth = graph_output_depths[vertex];
+        
+        for (vertex = i; depth_pending == graph_output_depths[vertex]; vertex = (uint64_t)graph_helper_get_vertex_prop(vertex))
+        {
+            graph_output_depths[vertex] = ((UINT32_MAX == base_depth) ? UINT32_MAX : (base_depth + depth));
+            depth -= 1u;
+        }
+    }
+}
+
+
+// Prints the kind of pages backing the part of a graph data structure on the specified NUMA node, if the structure is present.
+void graph_helper_print_pages(const char* structure_name, const uint32_t node_idx, const void* mem)
+{
+    char description[64];
+    
+    if (NULL == mem)
+        return;
+    
+    numanodes_describe_pages(mem, description, sizeof(description));
+    printf("Pages:     %s (node %u) = %s\n", structure_name, node_idx, description);
+}
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+// See "graphdata.h" for documentation.
+
+void graph_data_read_from_file(const char* filename, const char* filename_gather, const char* filename_scatter, const uint32_t reorder_method, const uint32_t with_weights, const uint32_t num_numa_nodes, const uint32_t* numa_nodes)
+{
+    // if neither edge list file exists, a single file in any order may be supplied instead, from which both edge lists are produced
+    const uint32_t has_single_file = (0 != access(filename_gather, R_OK)) && (0 != access(filename_scatter, R_OK)) && (0 == access(filename, R_OK));
+    
+    // either edge list file may be missing, in which case that edge list is produced by transposing the other one
+    // if both are missing, attempting to open the in-edge list file reports the error
+    const uint32_t has_gather_file = !has_single_file && ((0 == access(filename_gather, R_OK)) || (0 != access(filename_scatter, R_OK)));
+    
+    graph_num_numa_nodes = num_numa_nodes;
+    graph_reorder_method = reorder_method;
+    graph_load_edge_weights = with_weights;
+
+    // open the in-edge list file and extract the number of vertices and edges
+    // if only the out-edge list file exists, open it instead and transpose it in memory to produce the in-edge list
+    graph_helper_open_edge_list_file_or_die((has_single_file ? filename : (has_gather_file ? filename_gather : filename_scatter)), numa_nodes);
+    
+    // create vertex-related structures
+    graph_helper_create_vertex_info(numa_nodes[0]);
+    
+    if (!has_gather_file && !has_single_file)
+    {
+        printf("In-edges:  transposing out-edge list\n");
+    }
+    
+    // edges must be grouped by destination to build the in-edge list, so sort them if the file does not already have them in that order
+    graph_helper_sort_ingress_edges("In-edges: ", 1ull, numa_nodes);
+
+    // build the in-edge list
+    graph_helper_build_gather_list(numa_nodes);
+
+    // initialize vertex-related data structures
+    graph_helper_initialize_vertex_info();
+    
+#if !defined(EXPERIMENT_EDGE_FORCE_PULL) || defined(EXPERIMENT_ASSIGN_VERTICES_BY_PUSH)
+    const uint32_t has_scatter_file = !has_single_file && ((0 == access(filename_scatter, R_OK)) || !has_gather_file);
+    
+    if (!has_scatter_file)
+    {
+        // if there is no out-edge list file, the edges already read are transposed to produce the out-edge list
+        if (has_gather_file)
+        {
+            printf("Out-edges: transposing in-edge list\n");
+        }
+    }
+    else if (has_gather_file)
+    {
+        // open the out-edge list file, it does not matter that this also extracts the number of vertices and edges
+        graph_helper_free_sorted_edges();
+        graph_helper_close_graph_file();
+        graph_helper_open_edge_list_file_or_die(filename_scatter, numa_nodes);
+    }
+    else
+    {
+        // the out-edge list file is already open, so just go back to reading from it
+        graph_helper_free_sorted_edges();
+        graph_ingress_edges = graph_read_file_edges;
+        graph_ingress_weights = graph_read_file_weights;
+    }
+    
+    // edges must be grouped by source to build the out-edge list
+    graph_helper_sort_ingress_edges("Out-edges:", 0ull, numa_nodes);
+    
+    // build the out-edge list
+    graph_helper_build_scatter_list(numa_nodes);
+#endif
+    
+    // the edge list files and any sorted edges are no longer needed
+    graph_helper_free_sorted_edges();
+    graph_helper_close_graph_file();
+
+    // create NUMA-aware data structures for vertices
+    graph_helper_numaize_vertices(numa_nodes);
+    
+    // create and initialize the frontiers
+    graph_helper_create_and_initialize_frontiers(numa_nodes);
+    
+    // initialize the dynamic scheduling counters, one per node
+    graph_helper_create_dynamic_scheduler_counters(numa_nodes);
+}
+
+// ---------
+
+void graph_data_read_snapshot(const char* filename, const uint32_t with_weights, const uint32_t num_numa_nodes, const uint32_t* numa_nodes)
+{
+    graphsnapshot_t snapshot_info;
+    FILE* snapshotfile;
+    
+    graph_num_numa_nodes = num_numa_nodes;
+    
+    // open the snapshot file and verify that it is compatible with the current configuration
+    snapshotfile = fopen(filename, "rb");
+    if (NULL == snapshotfile)
+    {
+        fprintf(stderr, "Error: unable to read file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)&snapshot_info, sizeof(snapshot_info));
+    
+    if (GRAPH_SNAPSHOT_MAGIC != snapshot_info.magic || GRAPH_SNAPSHOT_VERSION != snapshot_info.version)
+    {
+        fprintf(stderr, "Error: \"%s\" is not a valid graph snapshot\n", filename);
+        exit(255);
+    }
+    
+    if (GRAPH_GATHER_LIST_LANES != snapshot_info.gather_list_lanes)
+    {
+        fprintf(stderr, "Error: snapshot \"%s\" has %llu vertex IDs per in-edge vector but this build expects %llu\n", filename, (long long unsigned int)snapshot_info.gather_list_lanes, (long long unsigned int)GRAPH_GATHER_LIST_LANES);
+        exit(255);
+    }
+    
+    if ((uint64_t)graph_num_numa_nodes != snapshot_info.num_numa_nodes)
+    {
+        fprintf(stderr, "Error: snapshot \"%s\" is partitioned for %llu NUMA node(s) but %u were requested\n", filename, (long long unsigned int)snapshot_info.num_numa_nodes, graph_num_numa_nodes);
+        exit(255);
+    }
+    
+#if !defined(EXPERIMENT_EDGE_FORCE_PULL) || defined(EXPERIMENT_ASSIGN_VERTICES_BY_PUSH)
+    if (0ull == snapshot_info.scatter_list_vector_count)
+    {
+        fprintf(stderr, "Error: snapshot \"%s\" does not contain an out-edge list\n", filename);
+        exit(255);
+    }
+#endif
+    
+    graph_num_vertices = snapshot_info.num_vertices;
+    graph_num_edges = snapshot_info.num_edges;
+    
+    // the edge vectors, compact vector information, edge weights, and vertex index of each edge list are read in parallel once everything else has been read, at most 7 parts per NUMA node
+    graph_snapshot_reads = (graphsnapshotread_t*)malloc(sizeof(graphsnapshotread_t) * 7ull * graph_num_numa_nodes);
+    graph_snapshot_num_reads = 0ull;
+    
+    graph_edges_gather_list_vector_count = snapshot_info.gather_list_vector_count;
+    graph_edges_gather_list_num_blocks = snapshot_info.gather_list_num_blocks;
+    
+    // read the in-edge list block information
+    graph_edges_gather_list_block_first_dest_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+    graph_edges_gather_list_block_last_dest_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_first_dest_vertex, sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_last_dest_vertex, sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+    
+    // read the vertex assignments
+    graph_vertex_first_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_last_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_count_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_vertex_first_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_vertex_last_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_vertex_count_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    
+    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    {
+        printf("Vertices:  node %u gets %llu vertices (%llu to %llu, %.2lf%% of total)\n",
+            numa_nodes[i],
+            (long long unsigned int)graph_vertex_count_numa[i],
+            (long long unsigned int)graph_vertex_first_numa[i],
+            (long long unsigned int)graph_vertex_last_numa[i],
+            (double)graph_vertex_count_numa[i] / (double)graph_num_vertices * 100.0
+        );
+    }
+    
+    // read the outdegrees and use them to initialize the rest of the vertex-related data structures
+    graph_helper_create_vertex_info(numa_nodes[0]);
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_vertex_outdegrees, sizeof(double) * graph_num_vertices);
+    graph_helper_initialize_vertex_info();
+    graph_helper_numaize_vertex_arrays(numa_nodes);
+    
+    // read the in-edge list and its vertex index directly into memory on each NUMA node, deferring the bulk parts
+    graph_edges_gather_list_block_bufs_numa = (__m256i***)numanodes_malloc(sizeof(__m256i**) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_edges_gather_list_block_counts_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_gather_index_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_gather_index_start_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_gather_index_end_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+#ifdef EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    graph_edges_gather_list_block_info_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+#endif
+    if (with_weights)
+    {
+        graph_edges_gather_list_block_weights_numa = (double**)numanodes_malloc(sizeof(double*) * graph_num_numa_nodes, numa_nodes[0]);
+    }
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_vertex_gather_index_start_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_vertex_gather_index_end_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    
+    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    {
+        graph_edges_gather_list_block_bufs_numa[i] = (__m256i**)numanodes_malloc(sizeof(__m256i*) * 2, numa_nodes[i]);
+        graph_edges_gather_list_block_counts_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_edges_gather_list_num_blocks, numa_nodes[i]);
+        graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_counts_numa[i], sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+        
+        graph_edges_gather_list_block_bufs_numa[i][0] = (__m256i*)numanodes_malloc(sizeof(__m256i) * graph_edges_gather_list_block_counts_numa[i][0], numa_nodes[i]);
+        graph_edges_gather_list_block_bufs_numa[i][1] = graph_edges_gather_list_block_bufs_numa[i][0];
+        graph_helper_snapshot_defer_read_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_bufs_numa[i][0], sizeof(__m256i) * graph_edges_gather_list_block_counts_numa[i][0], i);
+        
+        if (NULL != graph_edges_gather_list_block_info_numa)
+        {
+            graph_edges_gather_list_block_info_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_edges_gather_list_block_counts_numa[i][0], numa_nodes[i]);
+            graph_helper_snapshot_defer_read_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_info_numa[i], sizeof(uint64_t) * graph_edges_gather_list_block_counts_numa[i][0], i);
+        }
+        
+        // edge weights are read only if they are needed, and are otherwise skipped
+        if (NULL != graph_edges_gather_list_block_weights_numa)
+        {
+            graph_edges_gather_list_block_weights_numa[i] = (double*)numanodes_malloc(sizeof(double) * GRAPH_GATHER_LIST_LANES * graph_edges_gather_list_block_counts_numa[i][0], numa_nodes[i]);
+            
+            if (0ull != snapshot_info.has_edge_weights)
+            {
+                graph_helper_snapshot_defer_read_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_weights_numa[i], sizeof(double) * GRAPH_GATHER_LIST_LANES * graph_edges_gather_list_block_counts_numa[i][0], i);
+            }
+        }
+        else if (0ull != snapshot_info.has_edge_weights)
+        {
+            graph_helper_snapshot_skip_or_die(snapshotfile, filename, sizeof(double) * GRAPH_GATHER_LIST_LANES * graph_edges_gather_list_block_counts_numa[i][0]);
+        }
+        
+        graph_vertex_gather_index_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * (graph_num_vertices + (8ull * sizeof(uint64_t))), numa_nodes[i]);
+        graph_helper_snapshot_defer_read_or_die(snapshotfile, filename, (void*)graph_vertex_gather_index_numa[i], sizeof(uint64_t) * (graph_num_vertices + (8ull * sizeof(uint64_t))), i);
+    }
+    
+    printf("In-edges:  loaded %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_gather_list_vector_count, (double)graph_num_edges / (double)graph_edges_gather_list_vector_count / (double)GRAPH_GATHER_LIST_LANES * 100.0);
+    
+#if !defined(EXPERIMENT_EDGE_FORCE_PULL) || defined(EXPERIMENT_ASSIGN_VERTICES_BY_PUSH)
+    graph_edges_scatter_list_vector_count = snapshot_info.scatter_list_vector_count;
+    graph_edges_scatter_list_num_blocks = snapshot_info.scatter_list_num_blocks;
+    
+    // read the out-edge list block information
+    graph_edges_scatter_list_block_first_source_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+    graph_edges_scatter_list_block_last_source_vertex = (uint64_t*)numanodes_malloc_local(sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_edges_scatter_list_block_first_source_vertex, sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_edges_scatter_list_block_last_source_vertex, sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+    
+    // read the out-edge list and its vertex index directly into memory on each NUMA node, deferring the bulk parts
+    graph_edges_scatter_list_block_bufs_numa = (__m256i***)numanodes_malloc(sizeof(__m256i**) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_edges_scatter_list_block_counts_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_scatter_index_numa = (uint64_t**)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_scatter_index_start_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    graph_vertex_scatter_index_end_numa = (uint64_t*)numanodes_malloc(sizeof(uint64_t*) * graph_num_numa_nodes, numa_nodes[0]);
+    if (with_weights)
+    {
+        graph_edges_scatter_list_block_weights_numa = (double**)numanodes_malloc(sizeof(double*) * graph_num_numa_nodes, numa_nodes[0]);
+    }
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_vertex_scatter_index_start_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_vertex_scatter_index_end_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    
+    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    {
+        graph_edges_scatter_list_block_bufs_numa[i] = (__m256i**)numanodes_malloc(sizeof(__m256i*) * 2, numa_nodes[i]);
+        graph_edges_scatter_list_block_counts_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_edges_scatter_list_num_blocks, numa_nodes[i]);
+        graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_edges_scatter_list_block_counts_numa[i], sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+        
+        graph_edges_scatter_list_block_bufs_numa[i][0] = (__m256i*)numanodes_malloc(sizeof(__m256i) * graph_edges_scatter_list_block_counts_numa[i][0], numa_nodes[i]);
+        graph_edges_scatter_list_block_bufs_numa[i][1] = graph_edges_scatter_list_block_bufs_numa[i][0];
+        graph_helper_snapshot_defer_read_or_die(snapshotfile, filename, (void*)graph_edges_scatter_list_block_bufs_numa[i][0], sizeof(__m256i) * graph_edges_scatter_list_block_counts_numa[i][0], i);
+        
+        if (NULL != graph_edges_scatter_list_block_weights_numa)
+        {
+            graph_edges_scatter_list_block_weights_numa[i] = (double*)numanodes_malloc(sizeof(double) * GRAPH_EDGE_VECTOR_LANES * graph_edges_scatter_list_block_counts_numa[i][0], numa_nodes[i]);
+            
+            if (0ull != snapshot_info.has_edge_weights)
+            {
+                graph_helper_snapshot_defer_read_or_die(snapshotfile, filename, (void*)graph_edges_scatter_list_block_weights_numa[i], sizeof(double) * GRAPH_EDGE_VECTOR_LANES * graph_edges_scatter_list_block_counts_numa[i][0], i);
+            }
+        }
+        else if (0ull != snapshot_info.has_edge_weights)
+        {
+            graph_helper_snapshot_skip_or_die(snapshotfile, filename, sizeof(double) * GRAPH_EDGE_VECTOR_LANES * graph_edges_scatter_list_block_counts_numa[i][0]);
+        }
+        
+        graph_vertex_scatter_index_numa[i] = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * (graph_num_vertices + (8ull * sizeof(uint64_t))), numa_nodes[i]);
+        graph_helper_snapshot_defer_read_or_die(snapshotfile, filename, (void*)graph_vertex_scatter_index_numa[i], sizeof(uint64_t) * (graph_num_vertices + (8ull * sizeof(uint64_t))), i);
+    }
+    
+    printf("Out-edges: loaded %llu vectors, efficiency = %.1lf%%\n", (long long unsigned int)graph_edges_scatter_list_vector_count, (double)graph_num_edges / (double)graph_edges_scatter_list_vector_count / 4.0 * 100.0);
+#endif
+    
+    // read the bulk parts of both edge lists in parallel
+    graph_helper_snapshot_read_deferred_or_die(filename, numa_nodes);
+    free((void*)graph_snapshot_reads);
+    graph_snapshot_reads = NULL;
+    graph_snapshot_num_reads = 0ull;
+    
+    // a snapshot written without edge weights gives every edge unit weight, if weights are needed
+    if (with_weights)
+    {
+        if (0ull == snapshot_info.has_edge_weights)
+        {
+            for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+            {
+                for (uint64_t j = 0ull; j < GRAPH_GATHER_LIST_LANES * graph_edges_gather_list_block_counts_numa[i][0]; ++j)
+                {
+                    graph_edges_gather_list_block_weights_numa[i][j] = 1.0;
+                }
+                
+                if (NULL != graph_edges_scatter_list_block_weights_numa)
+                {
+                    for (uint64_t j = 0ull; j < GRAPH_EDGE_VECTOR_LANES * graph_edges_scatter_list_block_counts_numa[i][0]; ++j)
+                    {
+                        graph_edges_scatter_list_block_weights_numa[i][j] = 1.0;
+                    }
+                }
+            }
+            
+            printf("Weights:   none in snapshot, using unit weights\n");
+        }
+        else
+        {
+            printf("Weights:   loaded from snapshot\n");
+        }
+    }
+    
+    // read the original vertex IDs, if vertices were renumbered, and the new vertex IDs, if vertices were reordered
+    // these come last, in that order, after the out-edge list even if it was skipped above
+    if (0ull != snapshot_info.has_original_ids)
+    {
+        if (0 != fseek(snapshotfile, -(long)(sizeof(uint64_t) * graph_num_vertices * (0ull != snapshot_info.has_reordered_ids ? 2ull : 1ull)), SEEK_END))
+        {
+            fprintf(stderr, "Error: unable to read file \"%s\"\n", filename);
+            exit(255);
+        }
+        
+        graph_vertex_original_ids = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_vertices, numa_nodes[0]);
+        graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_vertex_original_ids, sizeof(uint64_t) * graph_num_vertices);
+    }
+    
+    if (0ull != snapshot_info.has_reordered_ids)
+    {
+        if (0 != fseek(snapshotfile, -(long)(sizeof(uint64_t) * graph_num_vertices), SEEK_END))
+        {
+            fprintf(stderr, "Error: unable to read file \"%s\"\n", filename);
+            exit(255);
+        }
+        
+        graph_vertex_reordered_ids = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_num_vertices, numa_nodes[0]);
+        graph_helper_snapshot_read_or_die(snapshotfile, filename, (void*)graph_vertex_reordered_ids, sizeof(uint64_t) * graph_num_vertices);
+        graph_helper_compute_vertex_output_positions(numa_nodes[0]);
+        
+        // some algorithms start from the output positions, which were not yet known when the vertex properties were initialized above
+        graph_helper_initialize_vertex_info();
+    }
+    
+    fclose(snapshotfile);
+    
+    // create and initialize the frontiers
+    graph_helper_create_and_initialize_frontiers(numa_nodes);
+    
+    // initialize the dynamic scheduling counters, one per node
+    graph_helper_create_dynamic_scheduler_counters(numa_nodes);
+}
+
+// ---------
+
+void graph_data_initialize_vertex_state(const uint32_t* numa_nodes)
+{
+    // algorithms that use the accumulators as a frontier may have swapped them with the HasInfo frontier, so go back to the original arrays
+    graph_vertex_accumulators = graph_vertex_accumulators_alloc;
+    graph_frontier_has_info = graph_frontier_has_info_alloc;
+    
+    // the part of the properties and accumulators each NUMA node uses may differ from the previous algorithm, so place them again
+    graph_helper_numaize_vertex_props(numa_nodes);
+    graph_helper_numaize_accumulators(numa_nodes);
+    
+    graph_helper_initialize_vertex_info();
+    graph_helper_initialize_frontiers();
+}
+
+// ---------
+
+void graph_data_allocate_merge_buffers(const uint64_t num_threads, const uint32_t num_numa_nodes, const uint32_t* numa_nodes)
+{
+    const uint64_t num_blocks_per_node = sched_pull_units_per_node;
+    const uint64_t num_blocks = sched_pull_units_total;
+    
+    graph_vertex_merge_buffer = (mergeaccum_t*)numanodes_malloc(sizeof(mergeaccum_t) * num_blocks, numa_nodes[0]);
+    graph_vertex_merge_buffer_baseptr_numa = (mergeaccum_t**)numanodes_malloc(sizeof(mergeaccum_t*) * num_numa_nodes, numa_nodes[0]);
+    graph_vertex_merge_buffer_count = num_blocks;
+    graph_vertex_merge_buffer_num_numa_nodes = num_numa_nodes;
+    
+    for (uint64_t i = 0; i < num_blocks; ++i)
+    {
+        graph_vertex_merge_buffer[i].initial_vertex_id = ~0ull;
+        graph_vertex_merge_buffer[i].final_vertex_id = ~0ull;
+        graph_vertex_merge_buffer[i].final_partial_value = 0.0;
+    }
+    
+    for (uint64_t i = 0; i < num_numa_nodes; ++i)
+    {
+        graph_vertex_merge_buffer_baseptr_numa[i] = &graph_vertex_merge_buffer[i * num_blocks_per_node];
+    }
+}
+
+// ---------
+
+void graph_data_allocate_frontier_queue(const uint64_t num_threads, const uint32_t* numa_nodes)
+{
+    graph_frontier_queue_capacity = (graph_num_vertices >> GRAPH_FRONTIER_QUEUE_CAPACITY_SHIFT) + 64ull;
+    graph_frontier_queue_num_threads = num_threads;
+    graph_frontier_queue_count = GRAPH_FRONTIER_QUEUE_NONE;
+    
+    graph_frontier_queue = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * graph_frontier_queue_capacity, numa_nodes[0]);
+    graph_frontier_queue_thread_counts = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * num_threads, numa_nodes[0]);
+}
+
+// ---------
+
+void graph_data_allocate_search_state(const uint32_t num_numa_nodes, const uint32_t* numa_nodes)
+{
+    graph_vertex_search_state = (uint64_t*)numanodes_malloc_divisible(sizeof(uint64_t) * GRAPH_SEARCH_STATE_WORDS * (graph_num_vertices + 8ull), numa_nodes[0], graph_helper_vertex_array_granularity(64ull * GRAPH_SEARCH_STATE_WORDS));
+    
+    // each NUMA node gets the part corresponding to its assigned vertices, like the other vertex arrays
+    for (uint32_t i = 1; i < num_numa_nodes; ++i)
+    {
+        numanodes_tonode_buffer(&graph_vertex_search_state[GRAPH_SEARCH_STATE_WORDS * graph_vertex_first_numa[i]], sizeof(uint64_t) * GRAPH_SEARCH_STATE_WORDS * graph_vertex_count_numa[i], numa_nodes[i]);
+    }
+    
+    for (uint64_t i = 0ull; i < GRAPH_SEARCH_STATE_WORDS * (graph_num_vertices + 8ull); ++i)
+    {
+        graph_vertex_search_state[i] = 0ull;
+    }
+}
 
 // ---------
 
@@ -1081,6 +3866,8 @@ void graph_data_allocate_stats(const uint64_t num_threads, const uint32_t numa_n
     graph_stat_num_vectors_per_iteration = (uint64_t*)numanodes_malloc(sizeof(uint64_t) * 20000ull, numa_node);
     graph_stat_num_edges_per_iteration = &graph_stat_num_vectors_per_iteration[10000];
     
+    graph_stat_num_threads = num_threads;
+    
     for (uint64_t i = 0; i < num_threads; ++i)
     {
         graph_stat_num_vectors_per_thread[i] = 0ull;
@@ -1108,7 +3895,14 @@ void graph_data_write_to_file(const char* filename)
     // iterate over the in-edge list, as split up across all NUMA nodes, and write out each edge
     for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
     {
-        graph_helper_write_edges_to_file(graphfile, graph_edges_gather_list_block_bufs_numa[i][0], graph_edges_gather_list_block_counts_numa[i][0]);
+        if (NULL == graph_edges_gather_list_block_info_numa)
+        {
+            graph_helper_write_edges_to_file(graphfile, graph_edges_gather_list_block_bufs_numa[i][0], graph_edges_gather_list_block_counts_numa[i][0]);
+        }
+        else
+        {
+            graph_helper_write_compact_edges_to_file(graphfile, graph_edges_gather_list_block_bufs_numa[i][0], graph_edges_gather_list_block_info_numa[i], graph_edges_gather_list_block_counts_numa[i][0]);
+        }
     }
 
     fclose(graphfile);
@@ -1116,31 +3910,471 @@ void graph_data_write_to_file(const char* filename)
 
 // ---------
 
-void graph_data_write_ranks_to_file(char* filename)
+void graph_data_write_snapshot(const char* filename)
 {
+    graphsnapshot_t snapshot_info;
+    FILE* snapshotfile;
+    
+    // the out-edge list is not built when forcing the pull engine, in which case the snapshot omits it
+    const uint32_t has_scatter_list = (NULL != graph_edges_scatter_list_block_bufs_numa) ? 1 : 0;
+    
     // open the file for writing
-    FILE* graphfile = fopen(filename, "w");
-    if (NULL == graphfile) return;
+    snapshotfile = fopen(filename, "wb");
+    if (NULL == snapshotfile)
+    {
+        fprintf(stderr, "Error: unable to write file \"%s\"\n", filename);
+        exit(255);
+    }
+    
+    // write the header
+    snapshot_info.magic = GRAPH_SNAPSHOT_MAGIC;
+    snapshot_info.version = GRAPH_SNAPSHOT_VERSION;
+    snapshot_info.num_numa_nodes = (uint64_t)graph_num_numa_nodes;
+    snapshot_info.num_vertices = graph_num_vertices;
+    snapshot_info.num_edges = graph_num_edges;
+    snapshot_info.gather_list_vector_count = graph_edges_gather_list_vector_count;
+    snapshot_info.gather_list_num_blocks = graph_edges_gather_list_num_blocks;
+    snapshot_info.scatter_list_vector_count = (has_scatter_list ? graph_edges_scatter_list_vector_count : 0ull);
+    snapshot_info.scatter_list_num_blocks = (has_scatter_list ? graph_edges_scatter_list_num_blocks : 0ull);
+    snapshot_info.has_original_ids = (NULL != graph_vertex_original_ids ? 1ull : 0ull);
+    snapshot_info.has_reordered_ids = (NULL != graph_vertex_reordered_ids ? 1ull : 0ull);
+    snapshot_info.gather_list_lanes = GRAPH_GATHER_LIST_LANES;
+    snapshot_info.has_edge_weights = (NULL != graph_edges_gather_list_block_weights_numa ? 1ull : 0ull);
+    graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)&snapshot_info, sizeof(snapshot_info));
+    
+    // write the in-edge list block information and the vertex assignments
+    graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_first_dest_vertex, sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+    graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_last_dest_vertex, sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+    graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_first_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_last_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_count_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    
+    // write the outdegrees, from which the rest of the vertex-related data structures are initialized when the snapshot is read
+    graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_outdegrees, sizeof(double) * graph_num_vertices);
+    
+    // write each NUMA node's part of the in-edge list and its vertex index
+    graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_gather_index_start_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_gather_index_end_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    
+    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    {
+        graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_counts_numa[i], sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+        graph_helper_snapshot_align_or_die(snapshotfile, filename);
+        graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_bufs_numa[i][0], sizeof(__m256i) * graph_edges_gather_list_block_counts_numa[i][0]);
+        graph_helper_snapshot_align_or_die(snapshotfile, filename);
+        
+        if (NULL != graph_edges_gather_list_block_info_numa)
+        {
+            graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_info_numa[i], sizeof(uint64_t) * graph_edges_gather_list_block_counts_numa[i][0]);
+            graph_helper_snapshot_align_or_die(snapshotfile, filename);
+        }
+        
+        if (NULL != graph_edges_gather_list_block_weights_numa)
+        {
+            graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_gather_list_block_weights_numa[i], sizeof(double) * GRAPH_GATHER_LIST_LANES * graph_edges_gather_list_block_counts_numa[i][0]);
+            graph_helper_snapshot_align_or_die(snapshotfile, filename);
+        }
+        
+        graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_gather_index_numa[i], sizeof(uint64_t) * (graph_num_vertices + (8ull * sizeof(uint64_t))));
+    }
+    
+    // write the out-edge list in the same way, if it exists
+    if (has_scatter_list)
+    {
+        graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_scatter_list_block_first_source_vertex, sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+        graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_scatter_list_block_last_source_vertex, sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+        graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_scatter_index_start_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+        graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_scatter_index_end_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+        
+        for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+        {
+            graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_scatter_list_block_counts_numa[i], sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+            graph_helper_snapshot_align_or_die(snapshotfile, filename);
+            graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_scatter_list_block_bufs_numa[i][0], sizeof(__m256i) * graph_edges_scatter_list_block_counts_numa[i][0]);
+            graph_helper_snapshot_align_or_die(snapshotfile, filename);
+            
+            if (NULL != graph_edges_scatter_list_block_weights_numa)
+            {
+                graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_edges_scatter_list_block_weights_numa[i], sizeof(double) * GRAPH_EDGE_VECTOR_LANES * graph_edges_scatter_list_block_counts_numa[i][0]);
+                graph_helper_snapshot_align_or_die(snapshotfile, filename);
+            }
+            
+            graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_scatter_index_numa[i], sizeof(uint64_t) * (graph_num_vertices + (8ull * sizeof(uint64_t))));
+        }
+    }
+    
+    // write the original vertex IDs, if vertices were renumbered
+    if (NULL != graph_vertex_original_ids)
+    {
+        graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_original_ids, sizeof(uint64_t) * graph_num_vertices);
+    }
+    
+    // write the new vertex IDs, if vertices were reordered
+    if (NULL != graph_vertex_reordered_ids)
+    {
+        graph_helper_snapshot_write_or_die(snapshotfile, filename, (void*)graph_vertex_reordered_ids, sizeof(uint64_t) * graph_num_vertices);
+    }
+    
+    if (0 != fclose(snapshotfile))
+    {
+        fprintf(stderr, "Error: unable to write file \"%s\"\n", filename);
+        exit(255);
+    }
+}
 
-    // iterate through the rank list and write out each vertex number and rank
-    for (uint64_t i = 0; i < graph_num_vertices; ++i)
+// ---------
+
+void graph_data_write_compressed_edge_lists(const char* filename_gather, const char* filename_scatter)
+{
+    graph_helper_write_compressed_edge_list(filename_gather, graph_edges_gather_list_block_bufs_numa, graph_edges_gather_list_block_info_numa, graph_edges_gather_list_block_counts_numa, 1ull);
+    
+    // the out-edge list is only present if the build uses it, otherwise it is produced by transposing the in-edge list when read back
+    if (NULL != graph_edges_scatter_list_block_bufs_numa)
     {
-#if !defined(CONNECTED_COMPONENTS) && !defined(BREADTH_FIRST_SEARCH)
-        double vertex_prop = graph_vertex_props[i] * (0.0 == graph_vertex_outdegrees[i] ? (double)graph_num_vertices : graph_vertex_outdegrees[i]);
-        fprintf(graphfile, "%llu %.5le\n", (long long unsigned int)i, vertex_prop);
-#else
-        double vertex_prop = graph_vertex_props[i];
-        fprintf(graphfile, "%llu %.0lf\n", (long long unsigned int)i, vertex_prop);
-#endif
+        graph_helper_write_compressed_edge_list(filename_scatter, graph_edges_scatter_list_block_bufs_numa, NULL, graph_edges_scatter_list_block_counts_numa, 0ull);
     }
+}
 
-    fclose(graphfile);
+// ---------
+
+void graph_data_write_ranks_to_file(const char* filename, const uint32_t binary, const uint64_t num_threads, const uint32_t num_numa_nodes, const uint32_t* numa_nodes)
+{
+    graph_output_type = execution_algorithm->output_type;
+    graph_helper_write_output_file(filename, binary, num_threads, num_numa_nodes, numa_nodes);
+}
+
+// ---------
+
+void graph_data_write_depths_to_file(const char* filename, const uint32_t binary, const uint64_t num_threads, const uint32_t num_numa_nodes, const uint32_t* numa_nodes)
+{
+    graph_output_depths = (uint32_t*)malloc(sizeof(uint32_t) * graph_num_vertices);
+    graph_helper_compute_search_depths(execution_search_root);
+    
+    graph_output_type = EXECUTION_OUTPUT_DEPTH;
+    graph_helper_write_output_file(filename, binary, num_threads, num_numa_nodes, numa_nodes);
+    
+    free((void*)graph_output_depths);
+    graph_output_depths = NULL;
+}
+
+// ---------
+
+uint64_t graph_data_find_vertex(const uint64_t original_id)
+{
+    uint64_t position = original_id;
+    
+    // vertices renumbered at ingress keep the order of their original IDs, so the position of a vertex in that order can be found by binary search
+    if (NULL != graph_vertex_original_ids)
+    {
+        uint64_t hi = graph_num_vertices;
+        
+        position = 0ull;
+        
+        while (position < hi)
+        {
+            const uint64_t mid = position + ((hi - position) >> 1ull);
+            
+            if (graph_vertex_original_ids[graph_macro_get_output_vertex(mid)] < original_id)
+                position = mid + 1ull;
+            else
+                hi = mid;
+        }
+        
+        if ((position < graph_num_vertices) && (graph_vertex_original_ids[graph_macro_get_output_vertex(position)] != original_id))
+        {
+            return graph_num_vertices;
+        }
+    }
+    
+    if (position >= graph_num_vertices)
+    {
+        return graph_num_vertices;
+    }
+    
+    return graph_macro_get_output_vertex(position);
+}
+
+// ---------
+
+double graph_data_get_vertex_prop(const uint64_t vertex)
+{
+    return graph_helper_get_vertex_prop(vertex);
+}
+
+// ---------
+
+uint64_t graph_data_vertex_array_granularity(const uint64_t bits_per_vertex)
+{
+    return graph_helper_vertex_array_granularity(bits_per_vertex);
+}
+
+// ---------
+
+void graph_data_print_pages()
+{
+    const uint64_t huge_page_size = numanodes_get_huge_page_size();
+    char unfit_structures[128] = "";
+    
+
+    for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+    {
+        const uint64_t first_vertex = graph_vertex_first_numa[i];
+        const uint64_t first_frontier_element = first_vertex >> 6ull;
+        const uint64_t prop_size = graph_macro_vertex_prop_size();
+        const uint64_t accumulator_bits = execution_algorithm->accumulator_bits_per_vertex();
+        
+        if (NULL != graph_edges_gather_list_block_bufs_numa)
+        {
+            graph_helper_print_pages("in-edge list", i, graph_edges_gather_list_block_bufs_numa[i][0]);
+            graph_helper_print_pages("in-edge index", i, graph_vertex_gather_index_numa[i]);
+        }
+        
+        if (NULL != graph_edges_scatter_list_block_bufs_numa)
+        {
+            graph_helper_print_pages("out-edge list", i, graph_edges_scatter_list_block_bufs_numa[i][0]);
+            graph_helper_print_pages("out-edge index", i, graph_vertex_scatter_index_numa[i]);
+        }
+        
+        // vertex arrays and frontiers are contiguous, so describe the part assigned to this node
+        if (NULL != graph_vertex_props)
+        {
+            graph_helper_print_pages("vertex properties", i, (uint8_t*)graph_vertex_props + (prop_size * first_vertex));
+            graph_helper_print_pages("vertex accumulators", i, ((1ull == accumulator_bits) ? (void*)&graph_vertex_accumulators[first_frontier_element] : (void*)((uint8_t*)graph_vertex_accumulators + ((accumulator_bits >> 3ull) * first_vertex))));
+            graph_helper_print_pages("vertex outdegrees", i, &graph_vertex_outdegrees[first_vertex]);
+            graph_helper_print_pages("has-info frontier", i, &graph_frontier_has_info[first_frontier_element]);
+            graph_helper_print_pages("wants-info frontier", i, &graph_frontier_wants_info[first_frontier_element]);
+        }
+        
+        if (NULL != graph_vertex_search_state)
+        {
+            graph_helper_print_pages("search state", i, &graph_vertex_search_state[GRAPH_SEARCH_STATE_WORDS * first_vertex]);
+        }
+    }
+    
+    // vertex boundaries between nodes are placed to fit explicit huge pages if possible, but that may not be possible for every structure if the graph is too small
+    if ((0ull != huge_page_size) && (NULL != graph_vertex_props))
+    {
+        if (0ull != (graph_helper_vertex_array_granularity(32ull) & (huge_page_size - 1ull)))
+            strcat(unfit_structures, ", vertex properties");
+        
+        if (0ull != (graph_helper_vertex_array_granularity(64ull) & (huge_page_size - 1ull)))
+            strcat(unfit_structures, ", vertex outdegrees");
+        
+        if (0ull != (graph_helper_vertex_array_granularity(1ull) & (huge_page_size - 1ull)))
+            strcat(unfit_structures, ", vertex accumulators, frontiers");
+        
+        if ((NULL != graph_vertex_search_state) && (0ull != (graph_helper_vertex_array_granularity(64ull * GRAPH_SEARCH_STATE_WORDS) & (huge_page_size - 1ull))))
+            strcat(unfit_structures, ", search state");
+        
+        if ('\0' != unfit_structures[0])
+            printf("Pages:     %s huge pages not used for%s, as the graph is too small to give each NUMA node a whole number of them\n", ((NUMANODES_HUGE_PAGE_SIZE_1G == huge_page_size) ? "1 GiB" : "2 MiB"), &unfit_structures[1]);
+    }
+    
+    if (0 != numanodes_get_num_misplaced_buffers())
+    {
+        printf("Pages:     %u buffer parts could not be placed on their NUMA nodes\n", numanodes_get_num_misplaced_buffers());
+    }
 }
 
 // ---------
 
 void graph_data_clear()
 {
-    // TODO: This needs to be implemented properly for NUMA.
-    return;
+    const uint64_t vertex_array_size = sizeof(double) * (graph_num_vertices + 8ull);
+    const uint64_t vertex_index_size = sizeof(uint64_t) * (graph_num_vertices + (8ull * sizeof(uint64_t)));
+    const uint64_t frontier_size = sizeof(uint64_t) * ((graph_num_vertices >> 6ull) + (graph_num_vertices & 63ull ? 1ull : 0ull));
+    
+    // free the in-edge list, its vertex index, and its block information, each part from its own NUMA node
+    if (NULL != graph_edges_gather_list_block_bufs_numa)
+    {
+        for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+        {
+            if (NULL != graph_edges_gather_list_block_info_numa)
+            {
+                numanodes_free((void*)graph_edges_gather_list_block_info_numa[i], sizeof(uint64_t) * graph_edges_gather_list_block_counts_numa[i][0]);
+            }
+            
+            if (NULL != graph_edges_gather_list_block_weights_numa)
+            {
+                numanodes_free((void*)graph_edges_gather_list_block_weights_numa[i], sizeof(double) * GRAPH_GATHER_LIST_LANES * graph_edges_gather_list_block_counts_numa[i][0]);
+            }
+            
+            numanodes_free((void*)graph_edges_gather_list_block_bufs_numa[i][0], sizeof(__m256i) * graph_edges_gather_list_block_counts_numa[i][0]);
+            numanodes_free((void*)graph_edges_gather_list_block_bufs_numa[i], sizeof(__m256i*) * 2);
+            numanodes_free((void*)graph_edges_gather_list_block_counts_numa[i], sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+            numanodes_free((void*)graph_vertex_gather_index_numa[i], vertex_index_size);
+        }
+        
+        if (NULL != graph_edges_gather_list_block_info_numa)
+        {
+            numanodes_free((void*)graph_edges_gather_list_block_info_numa, sizeof(uint64_t*) * graph_num_numa_nodes);
+        }
+        
+        if (NULL != graph_edges_gather_list_block_weights_numa)
+        {
+            numanodes_free((void*)graph_edges_gather_list_block_weights_numa, sizeof(double*) * graph_num_numa_nodes);
+        }
+        
+        numanodes_free((void*)graph_edges_gather_list_block_bufs_numa, sizeof(__m256i**) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_edges_gather_list_block_counts_numa, sizeof(uint64_t*) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_vertex_gather_index_numa, sizeof(uint64_t*) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_vertex_gather_index_start_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_vertex_gather_index_end_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_edges_gather_list_block_first_dest_vertex, sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+        numanodes_free((void*)graph_edges_gather_list_block_last_dest_vertex, sizeof(uint64_t) * graph_edges_gather_list_num_blocks);
+    }
+    
+    // free the out-edge list, its vertex index, and its block information, which may not have been loaded
+    if (NULL != graph_edges_scatter_list_block_bufs_numa)
+    {
+        for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+        {
+            if (NULL != graph_edges_scatter_list_block_weights_numa)
+            {
+                numanodes_free((void*)graph_edges_scatter_list_block_weights_numa[i], sizeof(double) * GRAPH_EDGE_VECTOR_LANES * graph_edges_scatter_list_block_counts_numa[i][0]);
+            }
+            
+            numanodes_free((void*)graph_edges_scatter_list_block_bufs_numa[i][0], sizeof(__m256i) * graph_edges_scatter_list_block_counts_numa[i][0]);
+            numanodes_free((void*)graph_edges_scatter_list_block_bufs_numa[i], sizeof(__m256i*) * 2);
+            numanodes_free((void*)graph_edges_scatter_list_block_counts_numa[i], sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+            numanodes_free((void*)graph_vertex_scatter_index_numa[i], vertex_index_size);
+        }
+        
+        if (NULL != graph_edges_scatter_list_block_weights_numa)
+        {
+            numanodes_free((void*)graph_edges_scatter_list_block_weights_numa, sizeof(double*) * graph_num_numa_nodes);
+        }
+        
+        numanodes_free((void*)graph_edges_scatter_list_block_bufs_numa, sizeof(__m256i**) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_edges_scatter_list_block_counts_numa, sizeof(uint64_t*) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_vertex_scatter_index_numa, sizeof(uint64_t*) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_vertex_scatter_index_start_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_vertex_scatter_index_end_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_edges_scatter_list_block_first_source_vertex, sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+        numanodes_free((void*)graph_edges_scatter_list_block_last_source_vertex, sizeof(uint64_t) * graph_edges_scatter_list_num_blocks);
+    }
+    
+    // free the vertex-related arrays, which are contiguous even though they are spread across NUMA nodes
+    if (NULL != graph_vertex_props)
+    {
+        numanodes_free((void*)graph_vertex_props, vertex_array_size);
+        numanodes_free((void*)graph_vertex_accumulators_alloc, vertex_array_size);
+        numanodes_free((void*)graph_vertex_outdegrees, vertex_array_size);
+    }
+    
+    if (NULL != graph_frontier_has_info)
+    {
+        numanodes_free((void*)graph_frontier_has_info_alloc, frontier_size);
+        numanodes_free((void*)graph_frontier_wants_info, frontier_size);
+        numanodes_free((void*)graph_frontier_wants_info_summary, sizeof(uint64_t) * (((frontier_size >> 3ull) >> (GRAPH_FRONTIER_SUMMARY_ELEMENTS_SHIFT + 6ull)) + 1ull));
+    }
+    
+    if (NULL != graph_vertex_original_ids)
+    {
+        numanodes_free((void*)graph_vertex_original_ids, sizeof(uint64_t) * graph_num_vertices);
+    }
+    
+    if (NULL != graph_vertex_reordered_ids)
+    {
+        numanodes_free((void*)graph_vertex_reordered_ids, sizeof(uint64_t) * graph_num_vertices);
+        numanodes_free((void*)graph_vertex_output_positions, sizeof(uint64_t) * graph_num_vertices);
+    }
+    
+    if (NULL != graph_vertex_first_numa)
+    {
+        numanodes_free((void*)graph_vertex_first_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_vertex_last_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+        numanodes_free((void*)graph_vertex_count_numa, sizeof(uint64_t) * graph_num_numa_nodes);
+    }
+    
+    // free the dynamic scheduling counters, one per node
+    if (NULL != graph_scheduler_dynamic_counter_numa)
+    {
+        for (uint32_t i = 0; i < graph_num_numa_nodes; ++i)
+        {
+            numanodes_free((void*)graph_scheduler_dynamic_counter_numa[i], sizeof(uint64_t*));
+        }
+        
+        numanodes_free((void*)graph_scheduler_dynamic_counter_numa, sizeof(uint64_t*) * graph_num_numa_nodes);
+    }
+    
+    // free the frontier queue, search state, merge buffers, and statistics arrays, if they were allocated
+    if (NULL != graph_frontier_queue)
+    {
+        numanodes_free((void*)graph_frontier_queue, sizeof(uint64_t) * graph_frontier_queue_capacity);
+        numanodes_free((void*)graph_frontier_queue_thread_counts, sizeof(uint64_t) * graph_frontier_queue_num_threads);
+    }
+    
+    if (NULL != graph_vertex_search_state)
+    {
+        numanodes_free((void*)graph_vertex_search_state, sizeof(uint64_t) * GRAPH_SEARCH_STATE_WORDS * (graph_num_vertices + 8ull));
+    }
+    
+    if (NULL != graph_vertex_merge_buffer)
+    {
+        numanodes_free((void*)graph_vertex_merge_buffer, sizeof(mergeaccum_t) * graph_vertex_merge_buffer_count);
+        numanodes_free((void*)graph_vertex_merge_buffer_baseptr_numa, sizeof(mergeaccum_t*) * graph_vertex_merge_buffer_num_numa_nodes);
+    }
+    
+    if (NULL != graph_stat_num_vectors_per_thread)
+    {
+        numanodes_free((void*)graph_stat_num_vectors_per_thread, sizeof(uint64_t) * 2ull * graph_stat_num_threads);
+        numanodes_free((void*)graph_stat_num_vectors_per_iteration, sizeof(uint64_t) * 20000ull);
+    }
+    
+    // reset everything to its initial state so that another graph can be loaded
+    graph_num_vertices = 0ull;
+    graph_num_edges = 0ull;
+    graph_vertex_original_ids = NULL;
+    graph_vertex_reordered_ids = NULL;
+    graph_vertex_output_positions = NULL;
+    graph_vertex_props = NULL;
+    graph_vertex_accumulators = NULL;
+    graph_vertex_accumulators_alloc = NULL;
+    graph_vertex_outdegrees = NULL;
+    graph_frontier_has_info = NULL;
+    graph_frontier_has_info_alloc = NULL;
+    graph_frontier_wants_info = NULL;
+    graph_frontier_wants_info_summary = NULL;
+    graph_frontier_queue = NULL;
+    graph_frontier_queue_count = GRAPH_FRONTIER_QUEUE_NONE;
+    graph_frontier_queue_capacity = 0ull;
+    graph_frontier_queue_thread_counts = NULL;
+    graph_frontier_queue_num_threads = 0ull;
+    graph_vertex_search_state = NULL;
+    graph_edges_gather_list_vector_count = 0ull;
+    graph_edges_scatter_list_vector_count = 0ull;
+    graph_edges_gather_list_num_blocks = 0ull;
+    graph_edges_scatter_list_num_blocks = 0ull;
+    graph_edges_gather_list_block_first_dest_vertex = NULL;
+    graph_edges_scatter_list_block_first_source_vertex = NULL;
+    graph_edges_gather_list_block_last_dest_vertex = NULL;
+    graph_edges_scatter_list_block_last_source_vertex = NULL;
+    graph_vertex_merge_buffer = NULL;
+    graph_vertex_merge_buffer_baseptr_numa = NULL;
+    graph_vertex_merge_buffer_count = 0ull;
+    graph_vertex_merge_buffer_num_numa_nodes = 0;
+    graph_edges_gather_list_block_bufs_numa = NULL;
+    graph_edges_scatter_list_block_bufs_numa = NULL;
+    graph_edges_gather_list_block_counts_numa = NULL;
+    graph_edges_scatter_list_block_counts_numa = NULL;
+    graph_edges_gather_list_block_info_numa = NULL;
+    graph_edges_gather_list_block_weights_numa = NULL;
+    graph_edges_scatter_list_block_weights_numa = NULL;
+    graph_vertex_first_numa = NULL;
+    graph_vertex_last_numa = NULL;
+    graph_vertex_count_numa = NULL;
+    graph_vertex_gather_index_numa = NULL;
+    graph_vertex_gather_index_start_numa = NULL;
+    graph_vertex_gather_index_end_numa = NULL;
+    graph_vertex_scatter_index_numa = NULL;
+    graph_vertex_scatter_index_start_numa = NULL;
+    graph_vertex_scatter_index_end_numa = NULL;
+    graph_scheduler_dynamic_counter_numa = NULL;
+    graph_stat_num_vectors_per_thread = NULL;
+    graph_stat_num_edges_per_thread = NULL;
+    graph_stat_num_vectors_per_iteration = NULL;
+    graph_stat_num_edges_per_iteration = NULL;
+    graph_stat_num_threads = 0ull;
+    graph_num_numa_nodes = 0;
 }
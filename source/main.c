@@ -21,9 +21,11 @@
 
 #include "benchmark.h"
 #include "cmdline.h"
+#include "engineselect.h"
 #include "execution.h"
 #include "graphdata.h"
 #include "numanodes.h"
+#include "phases.h"
 #include "scheduler.h"
 #include "threads.h"
 #include "versioninfo.h"
@@ -35,11 +37,17 @@
 int main(int argc, char* argv[])
 {
     const cmdline_opts_t* cmdline_settings = NULL;
+    uint32_t num_graphs;
+    char ranks_output_filename[1200];
+    char engine_calibration_filename[1200];
+    uint32_t phase_isa;
     double time_elapsed;
     uint64_t cycles_elapsed = 0ull;
-#if !defined(CONNECTED_COMPONENTS) && !defined(BREADTH_FIRST_SEARCH)
     double test_sum;
-#endif
+    uint32_t with_weights = 0;
+    uint32_t with_search_root = 0;
+    uint32_t with_search_state = 0;
+    uint64_t search_root_vertices[CMDLINE_MAX_NUM_SEARCH_ROOTS];
 #ifdef EXPERIMENT_ITERATION_PROFILE
 
 #if defined(EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES) && defined(EXPERIMENT_THRESHOLD_WITHOUT_COUNT)
@@ -63,105 +71,285 @@ int main(int argc, char* argv[])
     
     cmdline_parse_options_or_die(argc, argv);
     cmdline_settings = cmdline_get_current_settings();
+    numanodes_set_page_policy(cmdline_settings->page_policy);
     
+    phase_isa = phases_select_isa(cmdline_settings->phase_isa);
     
-    execution_init();
-    
-    benchmark_start();
-    cycles_elapsed = benchmark_rdtsc();
+    if (PHASES_ISA_AVX512 == phase_isa)
+    {
+        printf("Kernels:   AVX-512\n");
+    }
+    else
+    {
+        printf("Kernels:   AVX2\n");
+    }
     
-    graph_data_read_from_file(cmdline_settings->graph_input_filename_gather, cmdline_settings->graph_input_filename_scatter, cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes);
     
-    if (0ull == cmdline_settings->sched_granularity)
+    // edge weights are loaded only if at least one of the algorithms to run uses them, and likewise search roots are looked up and state is allocated for searches run all at once
+    for (uint32_t algorithm_idx = 0; algorithm_idx < cmdline_settings->num_algorithms; ++algorithm_idx)
     {
-        sched_pull_units_per_node = (cmdline_settings->num_threads / cmdline_settings->num_numa_nodes) << 5ull;
+        execution_algorithms[cmdline_settings->algorithms[algorithm_idx]]->init();
+        with_weights |= execution_algorithms[cmdline_settings->algorithms[algorithm_idx]]->uses_edge_weights;
+        with_search_root |= (EXECUTION_SEARCH_ROOTS_NONE != execution_algorithms[cmdline_settings->algorithms[algorithm_idx]]->search_roots);
+        with_search_state |= (EXECUTION_SEARCH_ROOTS_ALL == execution_algorithms[cmdline_settings->algorithms[algorithm_idx]]->search_roots);
     }
-    else
+    
+    num_graphs = ((NULL != cmdline_settings->graph_snapshot_input_filename) ? 1 : cmdline_settings->num_input_graphs);
+    
+    // each graph is loaded, processed, and then cleared to make room for the next one
+    for (uint32_t graph_idx = 0; graph_idx < num_graphs; ++graph_idx)
     {
-        sched_pull_units_per_node = graph_edges_gather_list_vector_count / (uint64_t)cmdline_settings->num_numa_nodes / cmdline_settings->sched_granularity;
+        // loading the graph initializes its vertex state for the first algorithm
+        // search roots are not known to be valid until the graph is loaded, so searches start from the first vertex until then
+        execution_select_algorithm(cmdline_settings->algorithms[0]);
+        execution_search_root = 0ull;
+        
+        benchmark_start();
+        cycles_elapsed = benchmark_rdtsc();
         
-        if (0ull == sched_pull_units_per_node)
+        if (NULL != cmdline_settings->graph_snapshot_input_filename)
         {
-            printf("Unable to set requested scheduler granularity because the graph is too small.\n");
-            return 1;
+            graph_data_read_snapshot(cmdline_settings->graph_snapshot_input_filename, with_weights, cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes);
+        }
+        else
+        {
+            if (num_graphs > 1)
+            {
+                printf("Graph:     %s\n", cmdline_settings->graph_input_filename[graph_idx]);
+            }
+            
+            graph_data_read_from_file(cmdline_settings->graph_input_filename[graph_idx], cmdline_settings->graph_input_filename_gather[graph_idx], cmdline_settings->graph_input_filename_scatter[graph_idx], cmdline_settings->vertex_reorder_method, with_weights, cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes);
+        }
+        
+        if (0ull == cmdline_settings->sched_granularity)
+        {
+            sched_pull_units_per_node = (cmdline_settings->num_threads / cmdline_settings->num_numa_nodes) << 5ull;
+        }
+        else
+        {
+            sched_pull_units_per_node = graph_edges_gather_list_vector_count / (uint64_t)cmdline_settings->num_numa_nodes / cmdline_settings->sched_granularity;
+            
+            if (0ull == sched_pull_units_per_node)
+            {
+                printf("Unable to set requested scheduler granularity because the graph is too small.\n");
+                return 1;
+            }
+        }
+        
+        sched_pull_units_total = sched_pull_units_per_node * cmdline_settings->num_numa_nodes;
+        scheduler_init_stealing(cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes);
+        printf("Scheduler: total units = %llu, vectors per unit = %llu\n", (long long unsigned int)(sched_pull_units_total), (long long unsigned int)(graph_edges_gather_list_vector_count / sched_pull_units_total));
+        
+        graph_data_allocate_merge_buffers(cmdline_settings->num_threads, cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes);
+        graph_data_allocate_frontier_queue(cmdline_settings->num_threads, cmdline_settings->numa_nodes);
+        
+        if (with_search_state)
+        {
+            graph_data_allocate_search_state(cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes);
         }
-    }
-    
-    sched_pull_units_total = sched_pull_units_per_node * cmdline_settings->num_numa_nodes;
-    printf("Scheduler: total units = %llu, vectors per unit = %llu\n", (long long unsigned int)(sched_pull_units_total), (long long unsigned int)(graph_edges_gather_list_vector_count / sched_pull_units_total));
-    
-    graph_data_allocate_merge_buffers(cmdline_settings->num_threads, cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes);
 
 #ifdef EXPERIMENT_ITERATION_STATS
-    graph_data_allocate_stats(cmdline_settings->num_threads, cmdline_settings->numa_nodes[0]);
+        graph_data_allocate_stats(cmdline_settings->num_threads, cmdline_settings->numa_nodes[0]);
 #endif
-    
-    cycles_elapsed = benchmark_rdtsc() - cycles_elapsed;
-    time_elapsed = benchmark_stop();
-    printf("Loading graph took %.2lfms.\n", time_elapsed);
-    
+        
+        cycles_elapsed = benchmark_rdtsc() - cycles_elapsed;
+        time_elapsed = benchmark_stop();
+        printf("Loading graph took %.2lfms.\n", time_elapsed);
+        
+        if (with_search_root)
+        {
+            for (uint32_t root_idx = 0; root_idx < cmdline_settings->num_search_roots; ++root_idx)
+            {
+                search_root_vertices[root_idx] = graph_data_find_vertex(cmdline_settings->search_roots[root_idx]);
+                
+                if (graph_num_vertices == search_root_vertices[root_idx])
+                {
+                    fprintf(stderr, "Error: search root %llu is not a vertex in the graph\n", (long long unsigned int)cmdline_settings->search_roots[root_idx]);
+                    exit(255);
+                }
+            }
+        }
+        
+        graph_data_print_pages();
+        
+        if (NULL != cmdline_settings->graph_snapshot_output_filename)
+        {
+            graph_data_write_snapshot(cmdline_settings->graph_snapshot_output_filename);
+            printf("Wrote graph snapshot to %s.\n", cmdline_settings->graph_snapshot_output_filename);
+        }
+        
+        if ('\0' != cmdline_settings->graph_compressed_output_filename_gather[0])
+        {
+            graph_data_write_compressed_edge_lists(cmdline_settings->graph_compressed_output_filename_gather, cmdline_settings->graph_compressed_output_filename_scatter);
+            printf("Wrote compressed graph to %s.\n", cmdline_settings->graph_compressed_output_filename_gather);
+        }
+        
 #ifdef EXPERIMENT_MODEL_LONG_VECTORS
-    printf("Not executing application, since this was a modelling experiment.\n");
-    return 0;
+        printf("Not executing application, since this was a modelling experiment.\n");
+        graph_data_clear();
+        continue;
 #endif
-    
-    printf("Starting execution.\n");
-    
+        
+        // engine selection starts out with no measurements for each graph, unless they were kept from earlier runs on it
+        engineselect_reset(cmdline_settings->engine_select_method, cmdline_settings->num_threads, phase_isa);
+        
+        if (cmdline_settings->engine_calibration_persist)
+        {
+            snprintf(engine_calibration_filename, sizeof(engine_calibration_filename), "%s-engine", ((NULL != cmdline_settings->graph_snapshot_input_filename) ? cmdline_settings->graph_snapshot_input_filename : cmdline_settings->graph_input_filename[graph_idx]));
+            
+            if (engineselect_read_calibration(engine_calibration_filename))
+            {
+                printf("Read engine calibration from %s.\n", engine_calibration_filename);
+            }
+        }
+        
+        // each algorithm runs on the same loaded graph, starting from vertex state initialized for it
+        // searches run once from each search root, starting from vertex state initialized again for each of them, unless they run from all of the search roots at once
+        for (uint32_t algorithm_idx = 0; algorithm_idx < cmdline_settings->num_algorithms; ++algorithm_idx)
+        {
+            const uint32_t num_runs = ((EXECUTION_SEARCH_ROOTS_EACH == execution_algorithms[cmdline_settings->algorithms[algorithm_idx]]->search_roots) ? cmdline_settings->num_search_roots : 1);
+            
+            for (uint32_t run_idx = 0; run_idx < num_runs; ++run_idx)
+            {
+                if (algorithm_idx > 0 || run_idx > 0 || (EXECUTION_SEARCH_ROOTS_EACH == execution_algorithm->search_roots && execution_search_root != search_root_vertices[run_idx]))
+                {
+                    execution_select_algorithm(cmdline_settings->algorithms[algorithm_idx]);
+                    
+                    if (EXECUTION_SEARCH_ROOTS_EACH == execution_algorithm->search_roots)
+                    {
+                        execution_search_root = search_root_vertices[run_idx];
+                    }
+                    
+                    graph_data_initialize_vertex_state(cmdline_settings->numa_nodes);
+                }
+                
+                printf("Algorithm: %s\n", execution_algorithm->display_name);
+                
+                if (EXECUTION_SEARCH_ROOTS_EACH == execution_algorithm->search_roots)
+                {
+                    printf("Root:      %llu\n", (long long unsigned int)cmdline_settings->search_roots[run_idx]);
+                }
+                else if (EXECUTION_SEARCH_ROOTS_ALL == execution_algorithm->search_roots)
+                {
+                    execution_search_roots = search_root_vertices;
+                    execution_num_search_roots = cmdline_settings->num_search_roots;
+                    printf("Roots:     %u\n", cmdline_settings->num_search_roots);
+                }
+                
+                printf("Starting execution.\n");
+                
 #ifdef EXPERIMENT_ITERATION_PROFILE
-    fprintf(stderr, "Iteration,Selected Engine,Edge Phase Execution Time (Cycles),%s\n", iteration_profile_frontier_string);
+                fprintf(stderr, "Iteration,Selected Engine,Edge Phase Execution Time (Cycles),%s\n", iteration_profile_frontier_string);
 #endif
-    
-    benchmark_start();
-    cycles_elapsed = benchmark_rdtsc();
-    
-    threads_spawn(cmdline_settings->num_threads, cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes, 0, execution_impl, NULL);
-    
-    cycles_elapsed = benchmark_rdtsc() - cycles_elapsed;
-    time_elapsed = benchmark_stop();
-    
-    printf("Execution completed.\n");
-    
-    printf("\n------------ EXECUTION STATISTICS ------------\n");
-    printf("%-25s = %.2lfms\n", "Running Time", time_elapsed);
-#if !defined(CONNECTED_COMPONENTS) && !defined(BREADTH_FIRST_SEARCH)
-    printf("%-25s = %.0lf Medges/sec\n", "Processing Rate", (double)graph_num_edges * (double)(cmdline_settings->num_iterations) / (double)time_elapsed / 1000.0);
-#else
-    printf("%-25s = %.0lf Medges/sec\n", "Effective Processing Rate", (double)graph_num_edges * (double)(total_iterations_executed) / (double)time_elapsed / 1000.0);
-#endif
-    
-#if !defined(CONNECTED_COMPONENTS) && !defined(BREADTH_FIRST_SEARCH)
-    test_sum = 0.0;
-    for (uint64_t i = 0; i < graph_num_vertices; ++i)
-    {
-        test_sum += graph_vertex_props[i] * (0.0 == graph_vertex_outdegrees[i] ? (double)graph_num_vertices : graph_vertex_outdegrees[i]);
-    }
-    printf("%-25s = %.10lf\n", "PageRank Sum", test_sum);
-#endif
-    
-    printf("%-25s = %llu\n", "Total Iterations", (long long unsigned int)total_iterations_executed);
-    printf("%-25s = %llu\n", "Pull-Based Iterations", (long long unsigned int)total_iterations_used_gather);
-    printf("%-25s = %llu\n", "Push-Based Iterations", (long long unsigned int)total_iterations_used_scatter);
+                
+                // algorithms that compute the residual replace this value
+                total_residual = -1.0;
+                
+                engineselect_select_algorithm(cmdline_settings->algorithms[algorithm_idx]);
+                sched_units_stolen = 0ull;
+                
+                benchmark_start();
+                cycles_elapsed = benchmark_rdtsc();
+                
+                threads_spawn(cmdline_settings->num_threads, cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes, 0, execution_algorithm->impl, NULL);
+                
+                cycles_elapsed = benchmark_rdtsc() - cycles_elapsed;
+                time_elapsed = benchmark_stop();
+                
+                printf("Execution completed.\n");
+                
+                printf("\n------------ EXECUTION STATISTICS ------------\n");
+                printf("%-25s = %.2lfms\n", "Running Time", time_elapsed);
+                if (!execution_algorithm->converges_dynamically)
+                {
+                    printf("%-25s = %.0lf Medges/sec\n", "Processing Rate", (double)graph_num_edges * (double)(total_iterations_executed) / (double)time_elapsed / 1000.0);
+                }
+                else
+                {
+                    printf("%-25s = %.0lf Medges/sec\n", "Effective Processing Rate", (double)graph_num_edges * (double)(total_iterations_executed) / (double)time_elapsed / 1000.0);
+                }
+                
+                if (EXECUTION_OUTPUT_RANK == execution_algorithm->output_type)
+                {
+                    test_sum = 0.0;
+                    for (uint64_t i = 0; i < graph_num_vertices; ++i)
+                    {
+                        test_sum += graph_data_get_vertex_prop(i) * (0.0 == graph_vertex_outdegrees[i] ? (double)graph_num_vertices : graph_vertex_outdegrees[i]);
+                    }
+                    printf("%-25s = %.10lf\n", "PageRank Sum", test_sum);
+                }
+                
+                if (0.0 <= total_residual)
+                {
+                    printf("%-25s = %.10le\n", "Final Residual", total_residual);
+                }
+                
+                printf("%-25s = %llu\n", "Total Iterations", (long long unsigned int)total_iterations_executed);
+                printf("%-25s = %llu\n", "Pull-Based Iterations", (long long unsigned int)total_iterations_used_gather);
+                printf("%-25s = %llu\n", "Push-Based Iterations", (long long unsigned int)total_iterations_used_scatter);
+                printf("%-25s = %llu\n", "Stolen Work Units", (long long unsigned int)sched_units_stolen);
 
-    printf("----------------------------------------------\n");
-        
+                printf("----------------------------------------------\n");
+                    
 #ifdef EXPERIMENT_ITERATION_STATS
-    fprintf(stderr, "%s,%s,%s\n", "Iteration", "# Vectors", "Packing Efficiency");
-    
-    for (uint64_t i = 0; i < total_iterations_executed; ++i)
-    {
-        const uint64_t stat_iter_num_vectors = graph_stat_num_vectors_per_iteration[i];
-        const double stat_iter_packing_efficiency = ((0ull == stat_iter_num_vectors) ? 0.0 : ((double)graph_stat_num_edges_per_iteration[i] / (4.0 * (double)stat_iter_num_vectors)));
+                fprintf(stderr, "%s,%s,%s\n", "Iteration", "# Vectors", "Packing Efficiency");
+                
+                for (uint64_t i = 0; i < total_iterations_executed; ++i)
+                {
+                    const uint64_t stat_iter_num_vectors = graph_stat_num_vectors_per_iteration[i];
+                    const double stat_iter_packing_efficiency = ((0ull == stat_iter_num_vectors) ? 0.0 : ((double)graph_stat_num_edges_per_iteration[i] / (4.0 * (double)stat_iter_num_vectors)));
+                    
+                    fprintf(stderr, "%llu,%llu,%lf\n", (long long unsigned int)(1ull + i), (long long unsigned int)stat_iter_num_vectors, stat_iter_packing_efficiency);
+                }
+#endif
+                
+                if (NULL != cmdline_settings->graph_ranks_output_filename)
+                {
+                    // with several graphs, each one gets its own output file, named by appending its position on the command line
+                    // likewise, with several algorithms, each one gets its own output file, named by appending the name of the algorithm
+                    // searches from several roots are named further by appending the root
+                    snprintf(ranks_output_filename, sizeof(ranks_output_filename), "%s", cmdline_settings->graph_ranks_output_filename);
+                    
+                    if (num_graphs > 1)
+                    {
+                        snprintf(ranks_output_filename + strlen(ranks_output_filename), sizeof(ranks_output_filename) - strlen(ranks_output_filename), "-%u", graph_idx);
+                    }
+                    
+                    if (cmdline_settings->num_algorithms > 1)
+                    {
+                        snprintf(ranks_output_filename + strlen(ranks_output_filename), sizeof(ranks_output_filename) - strlen(ranks_output_filename), "-%s", execution_algorithm->name);
+                    }
+                    
+                    if (num_runs > 1)
+                    {
+                        snprintf(ranks_output_filename + strlen(ranks_output_filename), sizeof(ranks_output_filename) - strlen(ranks_output_filename), "-root%llu", (long long unsigned int)cmdline_settings->search_roots[run_idx]);
+                    }
+                    
+                    graph_data_write_ranks_to_file(ranks_output_filename, cmdline_settings->graph_ranks_output_binary, cmdline_settings->num_threads, cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes);
+                    
+                    // searches that output the parent of each vertex can also output its depth, to a file named by appending "-depth"
+                    if (cmdline_settings->graph_depths_output && EXECUTION_SEARCH_ROOTS_EACH == execution_algorithm->search_roots && EXECUTION_OUTPUT_VERTEX_ID == execution_algorithm->output_type)
+                    {
+                        snprintf(ranks_output_filename + strlen(ranks_output_filename), sizeof(ranks_output_filename) - strlen(ranks_output_filename), "-depth");
+                        graph_data_write_depths_to_file(ranks_output_filename, cmdline_settings->graph_ranks_output_binary, cmdline_settings->num_threads, cmdline_settings->num_numa_nodes, cmdline_settings->numa_nodes);
+                    }
+                }
+            }
+        }
+        
+        if (cmdline_settings->engine_calibration_persist)
+        {
+            engineselect_write_calibration(engine_calibration_filename);
+            printf("Wrote engine calibration to %s.\n", engine_calibration_filename);
+        }
         
-        fprintf(stderr, "%llu,%llu,%lf\n", (long long unsigned int)(1ull + i), (long long unsigned int)stat_iter_num_vectors, stat_iter_packing_efficiency);
+        graph_data_clear();
     }
-#endif
     
-    if (NULL != cmdline_settings->graph_ranks_output_filename)
+    for (uint32_t algorithm_idx = 0; algorithm_idx < cmdline_settings->num_algorithms; ++algorithm_idx)
     {
-        graph_data_write_ranks_to_file(cmdline_settings->graph_ranks_output_filename);
+        execution_algorithms[cmdline_settings->algorithms[algorithm_idx]]->cleanup();
     }
     
-    execution_cleanup();
-    
     return 0;
 }
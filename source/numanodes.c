@@ -17,13 +17,20 @@
 #include <malloc.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #ifdef GRAZELLE_WINDOWS
 #include <Windows.h>
 #else
+#include <linux/mman.h>
 #include <numa.h>
+#include <numaif.h>
 #include <sched.h>
 #include <sys/mman.h>
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE                     23
+#endif
 #endif
 
 
@@ -41,6 +48,24 @@ static uint32_t** numanodes_node_processors = NULL;
 // Array of counts of processors on each NUMA node.
 static uint32_t* numanodes_node_counts = NULL;
 
+// Kind of pages requested for large allocations, one of the NUMANODES_PAGES_* constants.
+static uint32_t numanodes_page_policy = NUMANODES_PAGES_TRANSPARENT;
+
+// Base address of each allocation currently backed by explicit huge pages, or NULL for unused slots.
+static void* numanodes_hugetlb_mem[NUMANODES_MAX_HUGETLB_ALLOCATIONS];
+
+// Size, rounded up to a whole number of huge pages, of each allocation currently backed by explicit huge pages.
+static size_t numanodes_hugetlb_size[NUMANODES_MAX_HUGETLB_ALLOCATIONS];
+
+// Size of the huge pages backing each allocation currently backed by explicit huge pages.
+static size_t numanodes_hugetlb_page_size[NUMANODES_MAX_HUGETLB_ALLOCATIONS];
+
+// Lock protecting the list of allocations backed by explicit huge pages, which threads on different nodes update concurrently.
+static volatile uint32_t numanodes_hugetlb_lock = 0;
+
+// Number of buffers that could not be placed entirely on the NUMA node requested for them.
+static volatile uint32_t numanodes_num_misplaced_buffers = 0;
+
 
 /* -------- INTERNAL FUNCTIONS --------------------------------------------- */
 
@@ -92,6 +117,88 @@ void numanodes_retrieve_num_processors()
 }
 
 
+#ifndef GRAZELLE_WINDOWS
+// Finds the allocation backed by explicit huge pages that contains the specified address.
+// Returns the index of its slot, or NUMANODES_MAX_HUGETLB_ALLOCATIONS if the address is not backed by explicit huge pages.
+uint32_t numanodes_hugetlb_find(const void* mem)
+{
+    uint32_t slot;
+    
+    while (__sync_lock_test_and_set(&numanodes_hugetlb_lock, 1));
+    
+    for (slot = 0; slot < NUMANODES_MAX_HUGETLB_ALLOCATIONS; ++slot)
+    {
+        if ((NULL != numanodes_hugetlb_mem[slot]) && ((const char*)mem >= (const char*)numanodes_hugetlb_mem[slot]) && ((const char*)mem < ((const char*)numanodes_hugetlb_mem[slot] + numanodes_hugetlb_size[slot])))
+            break;
+    }
+    
+    __sync_lock_release(&numanodes_hugetlb_lock);
+    
+    return slot;
+}
+
+// Allocates a memory buffer on the specified NUMA node backed by explicit huge pages of the specified size.
+// All pages are allocated up-front so that a lack of huge pages on the node is detected here rather than on first touch.
+// Returns NULL if the system cannot supply enough huge pages on the node, so that the caller can fall back.
+void* numanodes_malloc_hugetlb(size_t size, uint32_t node, size_t page_size)
+{
+    const size_t alloc_size = (size + page_size - 1) & ~(page_size - 1);
+    void* mem;
+    uint32_t slot;
+    
+    mem = mmap(NULL, alloc_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | ((NUMANODES_HUGE_PAGE_SIZE_1G == page_size) ? MAP_HUGE_1GB : MAP_HUGE_2MB), -1, 0);
+    if (MAP_FAILED == mem)
+        return NULL;
+    
+    // bind the memory to the node exactly as numa_alloc_onnode() would, then fault it in, which fails cleanly if the node is out of huge pages
+    numa_tonode_memory(mem, alloc_size, (int)node);
+    if (0 != madvise(mem, alloc_size, MADV_POPULATE_WRITE))
+    {
+        munmap(mem, alloc_size);
+        return NULL;
+    }
+    
+    // record the allocation so it can be freed and moved correctly later
+    while (__sync_lock_test_and_set(&numanodes_hugetlb_lock, 1));
+    
+    for (slot = 0; slot < NUMANODES_MAX_HUGETLB_ALLOCATIONS; ++slot)
+    {
+        if (NULL == numanodes_hugetlb_mem[slot])
+        {
+            numanodes_hugetlb_mem[slot] = mem;
+            numanodes_hugetlb_size[slot] = alloc_size;
+            numanodes_hugetlb_page_size[slot] = page_size;
+            break;
+        }
+    }
+    
+    __sync_lock_release(&numanodes_hugetlb_lock);
+    
+    if (NUMANODES_MAX_HUGETLB_ALLOCATIONS == slot)
+    {
+        munmap(mem, alloc_size);
+        return NULL;
+    }
+    
+    return mem;
+}
+
+// Allocates a memory buffer on the specified NUMA node backed by regular pages, or by transparent huge pages if the buffer is large and the page policy allows them.
+// Returns NULL on failure.
+void* numanodes_malloc_regular(size_t size, uint32_t node)
+{
+    void* mem = numa_alloc_onnode(size, node);
+    
+    if ((NULL != mem) && (NUMANODES_PAGES_SMALL == numanodes_page_policy))
+        madvise(mem, size, MADV_NOHUGEPAGE);
+    else if ((NULL != mem) && (size > 1048576))
+        madvise(mem, size, MADV_HUGEPAGE);
+    
+    return mem;
+}
+#endif
+
+
 /* -------- FUNCTIONS ------------------------------------------------------ */
 // See "numanodes.h" for documentation.
 
@@ -180,17 +287,49 @@ uint32_t numanodes_get_nth_processor_on_node(uint32_t n, uint32_t node)
 
 // ---------
 
+uint32_t numanodes_get_distance(uint32_t node_from, uint32_t node_to)
+{
+    int distance = 0;
+    
+#ifndef GRAZELLE_WINDOWS
+    distance = numa_distance((int)node_from, (int)node_to);
+#endif
+    
+    // distances use the ACPI SLIT convention, in which a node is 10 away from itself and 20 is typical for a remote node
+    if (distance <= 0)
+    {
+        return ((node_from == node_to) ? 10 : 20);
+    }
+    
+    return (uint32_t)distance;
+}
+
+// ---------
+
 void* numanodes_malloc(size_t size, uint32_t node)
+{
+    return numanodes_malloc_divisible(size, node, 0);
+}
+
+// ---------
+
+void* numanodes_malloc_divisible(size_t size, uint32_t node, size_t granularity)
 {
     void* mem = 0;
     
 #ifdef GRAZELLE_WINDOWS
     mem = (void*)VirtualAllocExNuma(GetCurrentProcess(), NULL, (SIZE_T)(size), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE, node);
 #else
-    mem = numa_alloc_onnode(size, node);
+    // explicit huge pages are only worth using for allocations of at least one huge page, and each size falls back to the next-smaller one
+    // they can only be moved between nodes whole, so they are not used for a buffer divided among nodes anywhere other than on a huge page boundary
+    if ((NUMANODES_PAGES_HUGE_1G == numanodes_page_policy) && (size >= NUMANODES_HUGE_PAGE_SIZE_1G) && (0 == (granularity & (NUMANODES_HUGE_PAGE_SIZE_1G - 1))))
+        mem = numanodes_malloc_hugetlb(size, node, NUMANODES_HUGE_PAGE_SIZE_1G);
     
-    if ((NULL != mem) && (size > 1048576))
-        madvise(mem, size, MADV_HUGEPAGE);
+    if ((NULL == mem) && (numanodes_page_policy >= NUMANODES_PAGES_HUGE_2M) && (size >= NUMANODES_HUGE_PAGE_SIZE_2M) && (0 == (granularity & (NUMANODES_HUGE_PAGE_SIZE_2M - 1))))
+        mem = numanodes_malloc_hugetlb(size, node, NUMANODES_HUGE_PAGE_SIZE_2M);
+    
+    if (NULL == mem)
+        mem = numanodes_malloc_regular(size, node);
 #endif
     
     return mem;
@@ -210,7 +349,19 @@ void numanodes_free(void* mem, size_t size)
 #ifdef GRAZELLE_WINDOWS
     VirtualFree((LPVOID)mem, (SIZE_T)0, MEM_RELEASE);
 #else
-    numa_free(mem, size);
+    const uint32_t slot = numanodes_hugetlb_find(mem);
+    
+    if (NUMANODES_MAX_HUGETLB_ALLOCATIONS == slot)
+    {
+        numa_free(mem, size);
+        return;
+    }
+    
+    munmap(numanodes_hugetlb_mem[slot], numanodes_hugetlb_size[slot]);
+    
+    while (__sync_lock_test_and_set(&numanodes_hugetlb_lock, 1));
+    numanodes_hugetlb_mem[slot] = NULL;
+    __sync_lock_release(&numanodes_hugetlb_lock);
 #endif
 }
 
@@ -219,6 +370,130 @@ void numanodes_free(void* mem, size_t size)
 void numanodes_tonode_buffer(void* mem, size_t size, uint32_t node)
 {
 #ifdef GRAZELLE_LINUX
-    numa_tonode_memory((void *)((size_t)mem & (size_t)0xfffffffffffff000ull), size + (4096 - (size % 4096)), (int)node);
+    const uint32_t slot = numanodes_hugetlb_find(mem);
+    struct bitmask* node_mask = numa_allocate_nodemask();
+    uint32_t placed = 1;
+    
+    numa_bitmask_setbit(node_mask, node);
+    
+    if (NUMANODES_MAX_HUGETLB_ALLOCATIONS == slot)
+    {
+        // same binding as numa_tonode_memory(), but with the result checked
+        placed = (0 == mbind((void *)((size_t)mem & (size_t)0xfffffffffffff000ull), size + (4096 - (size % 4096)), MPOL_BIND, node_mask->maskp, node_mask->size + 1, 0));
+    }
+    else
+    {
+        // huge pages were faulted in at allocation time, so they must be migrated, and only whole huge pages within the buffer can be bound to the node
+        // a buffer ending in the last huge page of the allocation takes the rest of that page with it, as nothing follows it there but padding
+        const size_t page_size = numanodes_hugetlb_page_size[slot];
+        const size_t alloc_end = (size_t)numanodes_hugetlb_mem[slot] + numanodes_hugetlb_size[slot];
+        const size_t first_page = ((size_t)mem + page_size - 1) & ~(page_size - 1);
+        const size_t last_page = (((size_t)mem + size + page_size) > alloc_end) ? alloc_end : (((size_t)mem + size) & ~(page_size - 1));
+        
+        placed = (first_page == (size_t)mem) && (last_page >= (size_t)mem + size);
+        
+        if (last_page > first_page)
+            placed = (0 == mbind((void*)first_page, last_page - first_page, MPOL_BIND, node_mask->maskp, node_mask->size + 1, MPOL_MF_MOVE | MPOL_MF_STRICT)) && placed;
+    }
+    
+    numa_bitmask_free(node_mask);
+    
+    if (!placed)
+        __sync_fetch_and_add(&numanodes_num_misplaced_buffers, 1);
+#endif
+}
+
+// ---------
+
+uint32_t numanodes_get_num_misplaced_buffers()
+{
+    return numanodes_num_misplaced_buffers;
+}
+
+// ---------
+
+void numanodes_set_page_policy(uint32_t policy)
+{
+    numanodes_page_policy = policy;
+}
+
+// ---------
+
+size_t numanodes_get_huge_page_size()
+{
+#ifdef GRAZELLE_WINDOWS
+    return 0;
+#else
+    switch (numanodes_page_policy)
+    {
+        case NUMANODES_PAGES_HUGE_1G:
+            return NUMANODES_HUGE_PAGE_SIZE_1G;
+        
+        case NUMANODES_PAGES_HUGE_2M:
+            return NUMANODES_HUGE_PAGE_SIZE_2M;
+        
+        default:
+            return 0;
+    }
+#endif
+}
+
+// ---------
+
+void numanodes_describe_pages(const void* mem, char* description, size_t description_size)
+{
+#ifdef GRAZELLE_WINDOWS
+    snprintf(description, description_size, "unknown");
+#else
+    const uint32_t slot = numanodes_hugetlb_find(mem);
+    FILE* smaps;
+    char line[256];
+    unsigned long region_start, region_end;
+    unsigned long long field_kb;
+    unsigned long long region_kb = 0ull;
+    unsigned long long kernel_page_kb = 4ull;
+    unsigned long long anon_huge_kb = 0ull;
+    uint32_t in_region = 0;
+    
+    if (NUMANODES_MAX_HUGETLB_ALLOCATIONS != slot)
+    {
+        snprintf(description, description_size, "%s huge pages", (NUMANODES_HUGE_PAGE_SIZE_1G == numanodes_hugetlb_page_size[slot]) ? "1 GiB" : "2 MiB");
+        return;
+    }
+    
+    // transparent huge pages are granted by the kernel at its discretion, so ask it how much of the memory region containing the buffer they cover
+    smaps = fopen("/proc/self/smaps", "r");
+    if (NULL == smaps)
+    {
+        snprintf(description, description_size, "unknown");
+        return;
+    }
+    
+    while (NULL != fgets(line, sizeof(line), smaps))
+    {
+        if (2 == sscanf(line, "%lx-%lx ", &region_start, &region_end))
+        {
+            if (in_region)
+                break;
+            
+            in_region = (((unsigned long)mem >= region_start) && ((unsigned long)mem < region_end));
+        }
+        else if (in_region)
+        {
+            if (1 == sscanf(line, "Size: %llu kB", &field_kb))
+                region_kb = field_kb;
+            else if (1 == sscanf(line, "KernelPageSize: %llu kB", &field_kb))
+                kernel_page_kb = field_kb;
+            else if (1 == sscanf(line, "AnonHugePages: %llu kB", &field_kb))
+                anon_huge_kb = field_kb;
+        }
+    }
+    
+    fclose(smaps);
+    
+    if (0ull != anon_huge_kb && 0ull != region_kb)
+        snprintf(description, description_size, "2 MiB transparent huge pages (%.0lf%%)", 100.0 * (double)anon_huge_kb / (double)region_kb);
+    else
+        snprintf(description, description_size, "%llu KiB pages", kernel_page_kb);
 #endif
 }
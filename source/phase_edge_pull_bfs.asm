@@ -30,7 +30,7 @@ edge_pull_op_initialize                     MACRO
     
     ; perform common initialization tasks
     phase_helper_set_base_addrs
-    phase_helper_set_graph_info
+    phase_helper_set_graph_info_traversal
     
     ; place the address of the weak frontier type and the outdegree array into the address stash
     mov                     rax,                    QWORD PTR [graph_vertex_outdegrees]
@@ -43,14 +43,24 @@ edge_pull_op_initialize                     MACRO
     ; get the address of the strong frontier
     mov                     r_frontier,             QWORD PTR [graph_frontier_wants_info]
     
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; compact edge vectors need the per-lane mask bits and their per-vector information instead of bitwise-AND masks
+    phase_helper_compact_initialize
+ELSE
     ; initialize the bitwise-AND masks used throughout this phase
     vmovapd                 ymm_vid_and_mask,       YMMWORD PTR [const_vid_and_mask]
     vmovapd                 ymm_elist_and_mask,     YMMWORD PTR [const_edge_list_and_mask]
     vmovapd                 ymm_emask_and_mask,     YMMWORD PTR [const_edge_mask_and_mask]
+ENDIF
 ENDM
 
 ; Performs an iteration of the Edge-Pull phase at the specified index.
 edge_pull_op_iteration_at_index             MACRO
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; load the information that accompanies the compact edge list element at the specified index
+    mov                     r8,                     QWORD PTR [r_edgeinfo+8*rcx]
+ENDIF
+    
     ; load the edge list element at the specified index
     shl                     rcx,                    5
     add                     rcx,                    r_edgelist
@@ -79,6 +89,14 @@ IFNDEF EXPERIMENT_WITHOUT_PREFETCH
     prefetchnta             BYTE PTR [rcx+256]
 ENDIF
 
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+IFDEF EXPERIMENT_ITERATION_STATS
+    phase_helper_iteration_stats_compact
+ENDIF
+    
+    ; expand the valid-lane mask and extract the destination vertex ID from the information that accompanies the edge vector
+    phase_helper_compact_decode
+ELSE
 IFDEF EXPERIMENT_ITERATION_STATS
     phase_helper_iteration_stats
 ENDIF
@@ -100,14 +118,19 @@ ENDIF
     vpextrw                 rcx,                    xmm_edgevec,            3
     or                      rcx,                    rdx
     or                      r8,                     rcx                                         ; r8 has the current destination vertex ID
+ENDIF
 
     ; verify that the target has not yet been visited
     ; check the strong frontier in case this vertex can be skipped
+IFDEF EXPERIMENT_FRONTIERS_WITHOUT_SUMMARY
     phase_helper_strong_frontier_check              r8,                     rsi,                    edge_pull_iteration_done,                       done_edge_pull_phase
+ELSE
+    phase_helper_strong_frontier_check_summary      r8,                     rsi,                    edge_pull_iteration_done,                       done_edge_pull_phase
+ENDIF
     
 IFNDEF EXPERIMENT_WITHOUT_PREFETCH
     ; prefetch, with intention to write, the vertex property for the unvisited current destination
-    prefetchw               QWORD PTR [r_vprop+8*r8]
+    prefetchw               DWORD PTR [r_vprop+4*r8]
 ENDIF
     
     ; verify that at least one source has been visited
@@ -118,14 +141,40 @@ ENDIF
     vpextrq                 rax,                    xmm_addrstash,          1
     
     ; perform a weak frontier check and skip this iteration if all values are 0
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    phase_helper_weak_frontier_check_compact        rax,                    ymm0,                   ymm_edgevec,            ymm_emask,              edge_pull_iteration_done
+ELSE
 IFDEF EXPERIMENT_WITHOUT_VECTORS
     phase_helper_weak_frontier_check_novec          rax,                    ymm0,                   ymm_elist,              ymm_emask,              edge_pull_iteration_done
 ELSE
     phase_helper_weak_frontier_check                rax,                    ymm0,                   ymm_elist,              ymm_emask,              edge_pull_iteration_done
+ENDIF
 ENDIF
     
     vmovapd                 ymm_emask,              ymm0
     
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; the mask specifies if any of the sources have been visited, and at this point it is guaranteed to have at least one
+IFDEF ISA_AVX512
+    ; move the upper-most bit of each 32-bit lane into a mask register and use it to zero out the sources not present
+    vpmovd2m                k1,                     ymm_emask
+    vmovdqa32               ymm_elist{k1}{z},       ymm_edgevec
+ELSE
+    ; spread the upper-most bit of each 32-bit lane to produce the mask, then zero out the sources not present
+    vpsrad                  ymm_emask,              ymm_emask,              31
+    vpand                   ymm_elist,              ymm_emask,              ymm_edgevec
+ENDIF
+    
+    ; pick a parent valid for a BFS traversal by computing the max of all 32-bit source IDs present in ymm_elist
+    ; the selected parent is zero-extended into the lower 64 bits of xmm1
+    vextracti128            xmm1,                   ymm_elist,              1
+    vpmaxud                 xmm1,                   xmm1,                   xmm_elist
+    vpshufd                 xmm0,                   xmm1,                   4eh
+    vpmaxud                 xmm1,                   xmm1,                   xmm0
+    vpshufd                 xmm0,                   xmm1,                   0b1h
+    vpmaxud                 xmm1,                   xmm1,                   xmm0
+    vpmovzxdq               xmm1,                   xmm1
+ELSE
 IFDEF EXPERIMENT_WITHOUT_VECTORS
     ; pick a parent valid for a BFS traversal by looking at each source vertex in order
     ; once a parent is found, this process is complete
@@ -173,13 +222,20 @@ IFDEF EXPERIMENT_WITHOUT_VECTORS
   bfs_found_parent:
 ELSE
     ; the mask specifies if any of the sources have been visited, and at this point it is guaranteed to have at least one
+IFDEF ISA_AVX512
+    ; move the upper-most bit of each lane into a mask register and use it to zero out the sources not present
+    vpmovq2m                k1,                     ymm_emask
+    vmovdqa64               ymm_elist{k1}{z},       ymm_elist
+ELSE
     ; since there is not a right-shift-arithmetic-packed instruction, produce the mask by comparing against zero
     vxorpd                  ymm0,                   ymm0,                   ymm0
     vpcmpgtq                ymm_emask,              ymm0,                   ymm_emask
     
     ; sources not present will be zero, otherwise they will be an actual value
-    ; note that 0 is actually a valid source ID, but because of the weak frontier check above we do not need to worry about distinguishing valid and invalid values of 0
     vandpd                  ymm_elist,              ymm_emask,              ymm_elist
+ENDIF
+    
+    ; note that 0 is actually a valid source ID, but because of the weak frontier check above we do not need to worry about distinguishing valid and invalid values of 0
     
     ; pick a parent valid for a BFS traversal by computing the max of all values present in ymm_elist
     ; max is arbitrary (as opposed to min) for selecting which parent
@@ -187,13 +243,12 @@ ELSE
     vmaxpd                  xmm0,                   xmm0,                   xmm_elist
     vpsrldq                 xmm1,                   xmm0,                   8
     vmaxpd                  xmm1,                   xmm1,                   xmm0
+ENDIF
 ENDIF
     
     ; selected parent is in the lower position of xmm1, so write it to the vertex property for the current vertex
-    ; need to do some format conversion for correctness in writing to the vertex properties
-    vmovq                   rax,                    xmm1
-    vcvtsi2sd               xmm1,                   xmm1,                   rax
-    vmovq                   QWORD PTR [r_vprop+8*r8],                       xmm1
+    ; vertex properties are 32-bit vertex IDs, so no format conversion is needed
+    vmovd                   DWORD PTR [r_vprop+4*r8],                       xmm1
     
     ; set the bit in HasInfo* for the current vertex
     phase_helper_bitmask_set                        r_vaccum,               r8
@@ -214,7 +269,11 @@ ENDM
 ; --------- PHASE CONTROL FUNCTION --------------------------------------------
 ; See "phases.h" for documentation.
 
+IFDEF ISA_AVX512
+perform_edge_pull_phase_bfs_avx512          PROC PUBLIC
+ELSE
 perform_edge_pull_phase_bfs                 PROC PUBLIC
+ENDIF
     ; save non-volatile registers used throughout this phase
     push                    rbx
     push                    rsi
@@ -223,6 +282,11 @@ perform_edge_pull_phase_bfs                 PROC PUBLIC
     push                    r13
     push                    r14
     push                    r15
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; the pointer to compact vector information lives in rbp, and the extra slot keeps the stack aligned for calls
+    push                    rbp
+    sub                     rsp,                    8
+ENDIF
     
     ; set the base address for the current edge list block
     mov                     r_edgelist,             rcx
@@ -300,6 +364,10 @@ perform_edge_pull_phase_bfs                 PROC PUBLIC
   
   done_edge_pull_phase:  
     ; restore non-volatile registers and return
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    add                     rsp,                    8
+    pop                     rbp
+ENDIF
     pop                     r15
     pop                     r14
     pop                     r13
@@ -308,7 +376,11 @@ perform_edge_pull_phase_bfs                 PROC PUBLIC
     pop                     rsi
     pop                     rbx
     ret
+IFDEF ISA_AVX512
+perform_edge_pull_phase_bfs_avx512          ENDP
+ELSE
 perform_edge_pull_phase_bfs                 ENDP
+ENDIF
 
 
 _TEXT                                       ENDS
@@ -30,7 +30,7 @@ edge_pull_op_initialize                        MACRO
     
     ; perform common initialization tasks
     phase_helper_set_base_addrs
-    phase_helper_set_graph_info
+    phase_helper_set_graph_info_traversal
     
     ; place the address of the weak frontier type and the outdegree array into the address stash
     mov                     rax,                    QWORD PTR [graph_vertex_outdegrees]
@@ -40,14 +40,24 @@ edge_pull_op_initialize                        MACRO
     vpinsrq                 xmm0,                   xmm0,                   rcx,                    1
     vinserti128             ymm_addrstash,          ymm_addrstash,          xmm0,                   0
     
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; compact edge vectors need the per-lane mask bits and their per-vector information instead of bitwise-AND masks
+    phase_helper_compact_initialize
+ELSE
     ; initialize the bitwise-AND masks used throughout this phase
     vmovapd                 ymm_vid_and_mask,       YMMWORD PTR [const_vid_and_mask]
     vmovapd                 ymm_elist_and_mask,     YMMWORD PTR [const_edge_list_and_mask]
     vmovapd                 ymm_emask_and_mask,     YMMWORD PTR [const_edge_mask_and_mask]
+ENDIF
 ENDM
 
 ; Performs an iteration of the Edge-Pull phase at the specified index.
 edge_pull_op_iteration_at_index                MACRO
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; load the information that accompanies the compact edge list element at the specified index
+    mov                     r8,                     QWORD PTR [r_edgeinfo+8*rcx]
+ENDIF
+    
     ; load the edge list element at the specified index
     shl                     rcx,                    5
     add                     rcx,                    r_edgelist
@@ -76,6 +86,18 @@ IFNDEF EXPERIMENT_WITHOUT_PREFETCH
     prefetchnta             BYTE PTR [rcx+256]
 ENDIF
 
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+IFDEF EXPERIMENT_ITERATION_STATS
+    phase_helper_iteration_stats_compact
+ENDIF
+    
+    ; expand the valid-lane mask and extract the destination vertex ID from the information that accompanies the edge vector
+    phase_helper_compact_decode
+    
+    ; initialize the gather result register
+    ; CC uses +INFINITY
+    vmovapd                 ymm_gresult,            ymm_infinity
+ELSE
 IFDEF EXPERIMENT_ITERATION_STATS
     phase_helper_iteration_stats
 ENDIF
@@ -101,6 +123,7 @@ ENDIF
     vpextrw                 rcx,                    xmm_edgevec,            3
     or                      rcx,                    rdx
     or                      r8,                     rcx                                         ; r8 has the current destination vertex ID
+ENDIF
 
 IFDEF EXPERIMENT_FRONTIERS_WEAK_PULL
     ; check each source to make sure it has updated information
@@ -110,10 +133,14 @@ IFDEF EXPERIMENT_FRONTIERS_WEAK_PULL
     vpextrq                 rax,                    xmm_addrstash,          1
     
     ; perform a weak frontier check and skip this iteration if all values are 0
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    phase_helper_weak_frontier_check_compact        rax,                    ymm0,                   ymm_edgevec,            ymm_emask,              edge_pull_iteration_done
+ELSE
 IFDEF EXPERIMENT_WITHOUT_VECTORS
     phase_helper_weak_frontier_check_novec          rax,                    ymm0,                   ymm_elist,              ymm_emask,              edge_pull_iteration_done
 ELSE
     phase_helper_weak_frontier_check                rax,                    ymm0,                   ymm_elist,              ymm_emask,              edge_pull_iteration_done
+ENDIF
 ENDIF
     
     vmovapd                 ymm_emask,              ymm0
@@ -121,11 +148,30 @@ ENDIF
     
     ; perform the main gather operation
     ; wait until after frontier detection in case it might be skipped
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+IFDEF ISA_AVX512
+    ; the whole edge vector is gathered at once into all eight lanes, so combine the upper four lanes with the lower four
+    vbroadcastsd            zmm_gresult,            xmm_infinity
+    phase_helper_compact_vgatherdpd_avx512          zmm_gresult,            r_vprop
+    vextractf64x4           ymm1,                   zmm_gresult,            1
+    vminpd                  ymm_gresult,            ymm_gresult,            ymm1
+ELSE
+    ; both halves of the edge vector are gathered separately, so combine the results
+    vmovapd                 ymm1,                   ymm_infinity
+    phase_helper_compact_vgatherdpd                 ymm_gresult,            ymm1,                   r_vprop
+    vminpd                  ymm_gresult,            ymm_gresult,            ymm1
+ENDIF
+ELSE
 IFDEF EXPERIMENT_WITHOUT_VECTORS
     phase_helper_vgatherqpd_novec                   ymm_gresult,            r_vprop,                ymm_elist,              ymm_emask
+ELSE
+IFDEF ISA_AVX512
+    phase_helper_vgatherqpd_avx512                  ymm_gresult,            r_vprop,                ymm_elist,              ymm_emask
 ELSE
     vgatherqpd              ymm_gresult,            QWORD PTR [r_vprop+8*ymm_elist],                ymm_emask
 ENDIF
+ENDIF
+ENDIF
     
 IFNDEF EXPERIMENT_WITHOUT_PREFETCH
     ; write here either now or later, so issue a prefetch
@@ -395,7 +441,11 @@ ENDM
 ; --------- PHASE CONTROL FUNCTION --------------------------------------------
 ; See "phases.h" for documentation.
 
+IFDEF ISA_AVX512
+perform_edge_pull_phase_cc_avx512           PROC PUBLIC
+ELSE
 perform_edge_pull_phase_cc                  PROC PUBLIC
+ENDIF
     ; save non-volatile registers used throughout this phase
     push                    rbx
     push                    rsi
@@ -404,6 +454,11 @@ perform_edge_pull_phase_cc                  PROC PUBLIC
     push                    r13
     push                    r14
     push                    r15
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; the pointer to compact vector information lives in rbp, and the extra slot keeps the stack aligned for calls
+    push                    rbp
+    sub                     rsp,                    8
+ENDIF
     
     ; set the base address for the current gather list block
     mov                     r_edgelist,             rcx
@@ -456,6 +511,12 @@ IFNDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
     ; initialize the "previous destination" indicator to the first destination that this thread will see
     ; this avoids accidentally, and incorrectly, triggering a write to accumulator for vertex 0 on the first iteration of the gather loop
     ; it also causes a prefetch of the first element of the gather list, so there is no real added cost
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; the first destination ID is kept in the information that accompanies the edge vector
+    mov                     r8,                     QWORD PTR [r_edgeinfo+8*rsi]
+    shl                     r8,                     16
+    shr                     r8,                     16
+ELSE
     mov                     rcx,                    rsi
     shl                     rcx,                    5
     add                     rcx,                    r_edgelist
@@ -474,6 +535,7 @@ IFNDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
     vpextrw                 rcx,                    xmm_edgevec,            3
     or                      rcx,                    rdx
     or                      r8,                     rcx
+ENDIF
     
     ; use the value obtained to initialize the "previous destination" indicator
     mov                     r_prevvid,              r8
@@ -518,6 +580,10 @@ ENDIF
   
   done_edge_pull_phase:  
     ; restore non-volatile registers and return
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    add                     rsp,                    8
+    pop                     rbp
+ENDIF
     pop                     r15
     pop                     r14
     pop                     r13
@@ -526,7 +592,11 @@ ENDIF
     pop                     rsi
     pop                     rbx
     ret
+IFDEF ISA_AVX512
+perform_edge_pull_phase_cc_avx512           ENDP
+ELSE
 perform_edge_pull_phase_cc                  ENDP
+ENDIF
 
 
 _TEXT                                       ENDS
@@ -0,0 +1,371 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Grazelle
+;      High performance, hardware-optimized graph processing engine.
+;      Targets a single machine with one or more x86-based sockets.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Authored by Samuel Grossman
+; Department of Electrical Engineering, Stanford University
+; (c) 2015-2018
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; phase_edge_pull_msbfs.asm
+;      Implementation of the Edge-Pull phase for Multi-Source BFS.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+
+INCLUDE constants.inc
+INCLUDE phasehelpers.inc
+INCLUDE registers.inc
+INCLUDE scheduler_pull.inc
+INCLUDE threadhelpers.inc
+
+
+_TEXT                                       SEGMENT
+
+
+; --------- MACROS ------------------------------------------------------------
+
+; Initializes required state for the Edge-Pull phase.
+edge_pull_op_initialize                     MACRO
+    ; initialize the work scheduler
+    scheduler_phase_init
+    
+    ; perform common initialization tasks
+    phase_helper_set_base_addrs
+    phase_helper_set_graph_info
+    
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; compact edge vectors need the per-lane mask bits and their per-vector information instead of bitwise-AND masks
+    phase_helper_compact_initialize
+ELSE
+    ; initialize the bitwise-AND masks used throughout this phase
+    vmovapd                 ymm_vid_and_mask,       YMMWORD PTR [const_vid_and_mask]
+    vmovapd                 ymm_elist_and_mask,     YMMWORD PTR [const_edge_list_and_mask]
+    vmovapd                 ymm_emask_and_mask,     YMMWORD PTR [const_edge_mask_and_mask]
+ENDIF
+    
+    ; initialize accumulator values with initial values (Multi-Source BFS uses 0, meaning no searches)
+    vxorpd                  ymm_gaccum,             ymm_gaccum,             ymm_gaccum
+ENDM
+
+; Performs an iteration of the Edge-Pull phase at the specified index.
+edge_pull_op_iteration_at_index             MACRO
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; load the information that accompanies the compact edge list element at the specified index
+    mov                     r8,                     QWORD PTR [r_edgeinfo+8*rcx]
+ENDIF
+    
+    ; load the edge list element at the specified index
+    shl                     rcx,                    5
+    add                     rcx,                    r_edgelist
+IFDEF EXPERIMENT_WITHOUT_VECTORS
+    ; non-vectorized load of 4 scalar elements
+    mov                     rax,                    QWORD PTR [rcx]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    0
+    mov                     rax,                    QWORD PTR [rcx+8]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    1
+    vinserti128             ymm_edgevec,            ymm_edgevec,            xmm0,                   0
+    
+    mov                     rax,                    QWORD PTR [rcx+16]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    0
+    mov                     rax,                    QWORD PTR [rcx+24]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    1
+    vinserti128             ymm_edgevec,            ymm_edgevec,            xmm0,                   1
+ELSE
+    ; vectorized load
+    vmovapd                 ymm_edgevec,            YMMWORD PTR [rcx]
+ENDIF
+    
+IFNDEF EXPERIMENT_WITHOUT_PREFETCH
+    ; prefetch the next several edge list elements whenever the processor has some free time
+    ; this will produce a stream of far-ahead prefetches every iteration of the Edge-Pull phase
+    ; the "sweet spot" number of cache lines ahead to prefetch was determined experimentally
+    prefetchnta             BYTE PTR [rcx+256]
+ENDIF
+    
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; expand the valid-lane mask and extract the destination vertex ID from the information that accompanies the edge vector
+    phase_helper_compact_decode
+    
+IFDEF ISA_AVX512
+    ; initialize all eight lanes of the gather result register
+    ; Multi-Source BFS uses 0, meaning no searches
+    vpxorq                  zmm_gresult,            zmm_gresult,            zmm_gresult
+    
+    ; perform the main gather operation on the whole edge vector at once, then combine the upper four lanes with the lower four
+    phase_helper_compact_vgatherdpd_avx512          zmm_gresult,            r_vprop
+    vextractf64x4           ymm1,                   zmm_gresult,            1
+    vorpd                   ymm_gresult,            ymm_gresult,            ymm1
+ELSE
+    ; initialize the gather result registers, one for each half of the edge vector
+    ; Multi-Source BFS uses 0, meaning no searches
+    vxorpd                  ymm_gresult,            ymm_gresult,            ymm_gresult
+    vxorpd                  ymm1,                   ymm1,                   ymm1
+    
+    ; perform the main gather operation on both halves and combine the results
+    phase_helper_compact_vgatherdpd                 ymm_gresult,            ymm1,                   r_vprop
+    vorpd                   ymm_gresult,            ymm_gresult,            ymm1
+ENDIF
+ELSE
+    ; perform the bitwise AND operations with the required masks
+    vandpd                  ymm_elist,              ymm_edgevec,            ymm_elist_and_mask
+    vandpd                  ymm_emask,              ymm_edgevec,            ymm_emask_and_mask
+    vandpd                  ymm_edgevec,            ymm_edgevec,            ymm_vid_and_mask
+    
+    ; initialize the gather result register
+    ; Multi-Source BFS uses 0, meaning no searches
+    vxorpd                  ymm_gresult,            ymm_gresult,            ymm_gresult
+    
+    ; perform the main gather operation
+    ; vertex properties are bit-masks of the searches whose frontier includes each source, which gathering as doubles leaves intact
+    ; it takes a while, so issue it as soon as possible
+IFDEF EXPERIMENT_WITHOUT_VECTORS
+    phase_helper_vgatherqpd_novec                   ymm_gresult,      r_vprop,                ymm_elist,              ymm_emask
+ELSE
+IFDEF ISA_AVX512
+    phase_helper_vgatherqpd_avx512                  ymm_gresult,            r_vprop,                ymm_elist,              ymm_emask
+ELSE
+    vgatherqpd              ymm_gresult,            QWORD PTR [r_vprop+8*ymm_elist],                ymm_emask
+ENDIF
+ENDIF
+    
+    ; extract the destination vertex ID by extracting individual 16-bit words as needed, shifting, and bitwise-ORing
+    vextracti128            xmm1,                   ymm_edgevec,            1
+    vpextrw                 r8,                     xmm1,                   7
+    shl                     r8,                     45
+    vpextrw                 rcx,                    xmm1,                   3
+    shl                     rcx,                    30
+    or                      r8,                     rcx
+    vpextrw                 rdx,                    xmm_edgevec,            7
+    shl                     rdx,                    15
+    vpextrw                 rcx,                    xmm_edgevec,            3
+    or                      rcx,                    rdx
+    or                      r8,                     rcx                                         ; r8 has the current destination vertex ID
+ENDIF
+    
+IFNDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+IFNDEF EXPERIMENT_WITHOUT_PREFETCH
+    ; write here either now or later, so issue a prefetch
+    prefetchw               QWORD PTR [r_vaccum+8*r_prevvid]
+ENDIF
+
+    ; conditionally write the accumulator to memory, if the previous destination vertex ID and the current destination vertex ID are different
+    ; also reinitialize the vertex accumulator
+    cmp                     r_prevvid,              r8
+    je                      edge_pull_iteration_skip_write
+  edge_pull_iteration_do_write:
+    vmovq                   rcx,                    xmm_gaccum
+    mov                     QWORD PTR [r_vaccum+8*r_prevvid],               rcx
+    vxorpd                  ymm_gaccum,             ymm_gaccum,             ymm_gaccum
+
+  edge_pull_iteration_skip_write:
+    ; capture the current destination vertex ID for the next iteration
+    mov                     r_prevvid,              r8
+ENDIF
+    
+    ; perform a bitwise-OR reduction on the gather results, including the previously-set accumulator, then save back to the accumulator
+    ; the result is the set of searches whose frontier includes at least one source of the destination
+IFDEF EXPERIMENT_WITHOUT_VECTORS
+    vpextrq                 rax,                    xmm_gresult,            0
+    vmovq                   xmm0,                   rax
+    
+    vpextrq                 rax,                    xmm_gresult,            1
+    vmovq                   xmm1,                   rax
+    vorpd                   xmm0,                   xmm0,                   xmm1
+    
+    vextractf128            xmm_gresult,            ymm_gresult,            1
+    
+    vpextrq                 rax,                    xmm_gresult,            0
+    vmovq                   xmm1,                   rax
+    vorpd                   xmm0,                   xmm0,                   xmm1
+    
+    vpextrq                 rax,                    xmm_gresult,            1
+    vmovq                   xmm1,                   rax
+    vorpd                   xmm0,                   xmm0,                   xmm1
+    
+    vorpd                   xmm_gaccum,             xmm0,                   xmm_gaccum
+ELSE
+    vextractf128            xmm0,                   ymm_gresult,            1
+    vorpd                   xmm0,                   xmm0,                   xmm_gresult
+    vpsrldq                 xmm1,                   xmm0,                   8
+    vorpd                   xmm0,                   xmm0,                   xmm1
+    vorpd                   xmm_gaccum,             xmm0,                   xmm_gaccum
+ENDIF
+    
+IFDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+    ; aggregate the just-computed result with the accumulator, which a bitwise-OR does in a single instruction
+    vmovq                   rax,                    xmm_gaccum
+IFDEF EXPERIMENT_EDGE_PULL_WITHOUT_SYNC
+    or                      QWORD PTR [r_vaccum+8*r8],                      rax
+ELSE
+    lock or                 QWORD PTR [r_vaccum+8*r8],                      rax
+ENDIF
+    ; reset the per-vertex accumulator
+    vxorpd                  ymm_gaccum,             ymm_gaccum,             ymm_gaccum
+ENDIF
+    ; iteration complete
+  edge_pull_iteration_done:
+ENDM
+
+; Writes a final Edge-Pull phase result to the correct merge buffer entry for the current thread.
+edge_pull_op_write_to_merge_buffer_entry    MACRO
+    ; obtain the value to write
+    vmovq                   rax,                    xmm_gaccum
+    
+    ; write the destinaion vertex ID (offset 8) and the partial value (offset 16) to the merge buffer record
+    ; record base is in rcx as a parameter
+    mov                     QWORD PTR [r10+8],      r_prevvid
+    mov                     QWORD PTR [r10+16],     rax
+ENDM
+
+
+; --------- PHASE CONTROL FUNCTION --------------------------------------------
+; See "phases.h" for documentation.
+
+IFDEF ISA_AVX512
+perform_edge_pull_phase_msbfs_avx512        PROC PUBLIC
+ELSE
+perform_edge_pull_phase_msbfs               PROC PUBLIC
+ENDIF
+    ; save non-volatile registers used throughout this phase
+    push                    rbx
+    push                    rsi
+    push                    rdi
+    push                    r12
+    push                    r13
+    push                    r14
+    push                    r15
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; the pointer to compact vector information lives in rbp, and the extra slot keeps the stack aligned for calls
+    push                    rbp
+    sub                     rsp,                    8
+ENDIF
+    
+    ; set the base address for the current gather list block
+    mov                     r_edgelist,             rcx
+    
+    ; set aside the number of vectors (parameter, rdx)
+    vextracti128            xmm0,                   ymm_addrstash,          1
+    vpinsrq                 xmm0,                   xmm0,                   rdx,                    1
+    vinserti128             ymm_addrstash,          ymm_addrstash,          xmm0,                   1
+    
+    ; initialize
+    edge_pull_op_initialize
+    
+    ; get this thread's first work assignment
+    scheduler_get_first_assigned_unit
+    
+  edge_pull_phase_work_start:
+    ; check if there is a work assignment for this thread and, if not, the Edge-Pull phase is done
+    cmp                     rax,                    0
+    jl                      done_edge_pull_phase
+    
+IFNDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+    ; get the address of the merge buffer for this block of work
+    ; first get a pointer to the start of the merge buffers for the current group (NUMA node)
+    ; then get a 32-byte offset into the array based on the work unit number obtained from the scheduler
+    ; stash away the address for later, using the stack
+    mov                     r10,                    QWORD PTR [graph_vertex_merge_buffer_baseptr_numa]
+    threads_helper_get_thread_group_id              ecx
+    mov                     r10,                    QWORD PTR [r10+8*rcx]
+    mov                     rcx,                    rax
+    shl                     rcx,                    5
+    add                     r10,                    rcx
+    vextracti128            xmm0,                   ymm_addrstash,          0
+    vpinsrq                 xmm0,                   xmm0,                   r10,                    0
+    vinserti128             ymm_addrstash,          ymm_addrstash,          xmm0,                   0
+ENDIF
+    
+    ; retrieve the number of vectors into rdx
+    vextracti128            xmm0,                   ymm_addrstash,          1
+    vpextrq                 rdx,                    xmm0,                   1
+    
+    ; get the work assignment for this thread
+    mov                     rcx,                    rax
+    scheduler_assign_work_for_unit
+    cmp                     rsi,                    rdi
+    jge                     edge_pull_phase_next_work
+    
+IFNDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+    ; initialize the "previous destination" indicator to the first destination that this thread will see
+    ; this avoids accidentally, and incorrectly, triggering a write to accumulator for vertex 0 on the first iteration of the gather loop
+    ; it also causes a prefetch of the first element of the gather list, so there is no real added cost
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; the first destination ID is kept in the information that accompanies the edge vector
+    mov                     r8,                     QWORD PTR [r_edgeinfo+8*rsi]
+    shl                     r8,                     16
+    shr                     r8,                     16
+ELSE
+    mov                     rcx,                    rsi
+    shl                     rcx,                    5
+    add                     rcx,                    r_edgelist
+    vmovapd                 ymm_edgevec,            YMMWORD PTR [rcx]
+    vandpd                  ymm_edgevec,            ymm_edgevec,            ymm_vid_and_mask
+    
+    ; as part of the initialization, extract the first destination ID
+    vextracti128            xmm1,                   ymm_edgevec,            1
+    vpextrw                 r8,                     xmm1,                   7
+    shl                     r8,                     45
+    vpextrw                 rcx,                    xmm1,                   3
+    shl                     rcx,                    30
+    or                      r8,                     rcx
+    vpextrw                 rdx,                    xmm_edgevec,            7
+    shl                     rdx,                    15
+    vpextrw                 rcx,                    xmm_edgevec,            3
+    or                      rcx,                    rdx
+    or                      r8,                     rcx
+ENDIF
+    
+    ; use the value obtained to initialize the "previous destination" indicator and write into the merge buffer (at offset 0)
+    mov                     r_prevvid,              r8
+    mov                     QWORD PTR [r10+0],      r8
+ENDIF
+    
+    ; initialize the accumulator
+    vxorpd                  ymm_gaccum,             ymm_gaccum,             ymm_gaccum
+    
+    ; main Edge-Pull phase loop
+  edge_pull_phase_loop:
+    cmp                     rsi,                    rdi
+    jae                     done_edge_pull_loop
+    
+    mov                     rcx,                    rsi
+    edge_pull_op_iteration_at_index
+    
+    inc                     rsi
+    jmp                     edge_pull_phase_loop
+  done_edge_pull_loop:
+IFNDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+    ; write to the merge buffer, for merging between overlapping accumulators between successive units of work
+    vmovq                   r10,                    xmm_addrstash
+    edge_pull_op_write_to_merge_buffer_entry
+ENDIF
+    
+  edge_pull_phase_next_work:
+    ; get this thread's next work assignment
+    scheduler_get_next_assigned_unit
+    jmp                     edge_pull_phase_work_start
+  
+  done_edge_pull_phase:  
+    ; restore non-volatile registers and return
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    add                     rsp,                    8
+    pop                     rbp
+ENDIF
+    pop                     r15
+    pop                     r14
+    pop                     r13
+    pop                     r12
+    pop                     rdi
+    pop                     rsi
+    pop                     rbx
+    ret
+IFDEF ISA_AVX512
+perform_edge_pull_phase_msbfs_avx512        ENDP
+ELSE
+perform_edge_pull_phase_msbfs               ENDP
+ENDIF
+
+
+_TEXT                                       ENDS
+
+
+END
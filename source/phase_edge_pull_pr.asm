@@ -30,12 +30,17 @@ edge_pull_op_initialize                     MACRO
     
     ; perform common initialization tasks
     phase_helper_set_base_addrs
-    phase_helper_set_graph_info
+    phase_helper_set_graph_info_pr
     
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; compact edge vectors need the per-lane mask bits and their per-vector information instead of bitwise-AND masks
+    phase_helper_compact_initialize
+ELSE
     ; initialize the bitwise-AND masks used throughout this phase
     vmovapd                 ymm_vid_and_mask,       YMMWORD PTR [const_vid_and_mask]
     vmovapd                 ymm_elist_and_mask,     YMMWORD PTR [const_edge_list_and_mask]
     vmovapd                 ymm_emask_and_mask,     YMMWORD PTR [const_edge_mask_and_mask]
+ENDIF
     
     ; initialize accumulator values with initial values (PageRank uses 0)
     vxorpd                  ymm_gaccum,             ymm_gaccum,             ymm_gaccum
@@ -43,6 +48,11 @@ ENDM
 
 ; Performs an iteration of the Edge-Pull phase at the specified index.
 edge_pull_op_iteration_at_index             MACRO
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; load the information that accompanies the compact edge list element at the specified index
+    mov                     r8,                     QWORD PTR [r_edgeinfo+8*rcx]
+ENDIF
+    
     ; load the edge list element at the specified index
     shl                     rcx,                    5
     add                     rcx,                    r_edgelist
@@ -71,6 +81,30 @@ IFNDEF EXPERIMENT_WITHOUT_PREFETCH
     prefetchnta             BYTE PTR [rcx+256]
 ENDIF
     
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; expand the valid-lane mask and extract the destination vertex ID from the information that accompanies the edge vector
+    phase_helper_compact_decode
+    
+IFDEF ISA_AVX512
+    ; initialize all eight lanes of the gather result register
+    ; PageRank uses 0
+    vpxorq                  zmm_gresult,            zmm_gresult,            zmm_gresult
+    
+    ; perform the main gather operation on the whole edge vector at once, then add the upper four lanes to the lower four
+    phase_helper_compact_vgatherdpd_avx512          zmm_gresult,            r_vprop
+    vextractf64x4           ymm1,                   zmm_gresult,            1
+    vaddpd                  ymm_gresult,            ymm_gresult,            ymm1
+ELSE
+    ; initialize the gather result registers, one for each half of the edge vector
+    ; PageRank uses 0
+    vxorpd                  ymm_gresult,            ymm_gresult,            ymm_gresult
+    vxorpd                  ymm1,                   ymm1,                   ymm1
+    
+    ; perform the main gather operation on both halves and combine the results
+    phase_helper_compact_vgatherdpd                 ymm_gresult,            ymm1,                   r_vprop
+    vaddpd                  ymm_gresult,            ymm_gresult,            ymm1
+ENDIF
+ELSE
     ; perform the bitwise AND operations with the required masks
     vandpd                  ymm_elist,              ymm_edgevec,            ymm_elist_and_mask
     vandpd                  ymm_emask,              ymm_edgevec,            ymm_emask_and_mask
@@ -84,8 +118,12 @@ ENDIF
     ; it takes a while, so issue it as soon as possible
 IFDEF EXPERIMENT_WITHOUT_VECTORS
     phase_helper_vgatherqpd_novec                   ymm_gresult,      r_vprop,                ymm_elist,              ymm_emask
+ELSE
+IFDEF ISA_AVX512
+    phase_helper_vgatherqpd_avx512                  ymm_gresult,            r_vprop,                ymm_elist,              ymm_emask
 ELSE
     vgatherqpd              ymm_gresult,            QWORD PTR [r_vprop+8*ymm_elist],                ymm_emask
+ENDIF
 ENDIF
     
     ; extract the destination vertex ID by extracting individual 16-bit words as needed, shifting, and bitwise-ORing
@@ -100,6 +138,7 @@ ENDIF
     vpextrw                 rcx,                    xmm_edgevec,            3
     or                      rcx,                    rdx
     or                      r8,                     rcx                                         ; r8 has the current destination vertex ID
+ENDIF
     
 IFNDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
 IFNDEF EXPERIMENT_WITHOUT_PREFETCH
@@ -186,7 +225,11 @@ ENDM
 ; --------- PHASE CONTROL FUNCTION --------------------------------------------
 ; See "phases.h" for documentation.
 
+IFDEF ISA_AVX512
+perform_edge_pull_phase_pr_avx512           PROC PUBLIC
+ELSE
 perform_edge_pull_phase_pr                  PROC PUBLIC
+ENDIF
     ; save non-volatile registers used throughout this phase
     push                    rbx
     push                    rsi
@@ -195,6 +238,11 @@ perform_edge_pull_phase_pr                  PROC PUBLIC
     push                    r13
     push                    r14
     push                    r15
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; the pointer to compact vector information lives in rbp, and the extra slot keeps the stack aligned for calls
+    push                    rbp
+    sub                     rsp,                    8
+ENDIF
     
     ; set the base address for the current gather list block
     mov                     r_edgelist,             rcx
@@ -245,6 +293,12 @@ IFNDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
     ; initialize the "previous destination" indicator to the first destination that this thread will see
     ; this avoids accidentally, and incorrectly, triggering a write to accumulator for vertex 0 on the first iteration of the gather loop
     ; it also causes a prefetch of the first element of the gather list, so there is no real added cost
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    ; the first destination ID is kept in the information that accompanies the edge vector
+    mov                     r8,                     QWORD PTR [r_edgeinfo+8*rsi]
+    shl                     r8,                     16
+    shr                     r8,                     16
+ELSE
     mov                     rcx,                    rsi
     shl                     rcx,                    5
     add                     rcx,                    r_edgelist
@@ -263,6 +317,7 @@ IFNDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
     vpextrw                 rcx,                    xmm_edgevec,            3
     or                      rcx,                    rdx
     or                      r8,                     rcx
+ENDIF
     
     ; use the value obtained to initialize the "previous destination" indicator and write into the merge buffer (at offset 0)
     mov                     r_prevvid,              r8
@@ -296,6 +351,10 @@ ENDIF
   
   done_edge_pull_phase:  
     ; restore non-volatile registers and return
+IFDEF EXPERIMENT_EDGE_PULL_COMPACT_VECTORS
+    add                     rsp,                    8
+    pop                     rbp
+ENDIF
     pop                     r15
     pop                     r14
     pop                     r13
@@ -304,7 +363,11 @@ ENDIF
     pop                     rsi
     pop                     rbx
     ret
+IFDEF ISA_AVX512
+perform_edge_pull_phase_pr_avx512           ENDP
+ELSE
 perform_edge_pull_phase_pr                  ENDP
+ENDIF
 
 
 _TEXT                                       ENDS
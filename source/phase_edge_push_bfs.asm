@@ -30,7 +30,7 @@ edge_push_op_initialize                     MACRO
     
     ; perform common initialization tasks
     phase_helper_set_base_addrs
-    phase_helper_set_graph_info
+    phase_helper_set_graph_info_traversal
     
     ; place the address of the weak frontier type and the outdegree array into the address stash
     mov                     rax,                    QWORD PTR [graph_vertex_outdegrees]
@@ -103,7 +103,7 @@ ENDIF
     
     ; verify that the source was visited in the last algorithm implementation
     ; check the strong frontier in case this vertex can be skipped
-    phase_helper_strong_frontier_check              r8,                     rsi,                    edge_push_iteration_done,                       done_edge_push_phase
+    phase_helper_strong_frontier_check_queue        r8,                     rsi,                    edge_push_iteration_done,                       done_edge_push_phase
     
     ; check each destination to make sure it wishes to receive information
     ; this is a weak frontier type for the push-based engine
@@ -123,11 +123,48 @@ ENDIF
     ; obtain the address of the WantsInfo frontier from the address stash
     vpextrq                 r12,                    xmm_addrstash,          1
     
-    ; a format conversion is required before writing the curent source ID to the various destinations
-    vcvtsi2sd               xmm0,                   xmm0,                   r8
+    ; vertex properties are 32-bit vertex IDs, so the current source ID is written to the various destinations as-is
+    vmovq                   xmm0,                   r8
     
     ; for each vector element, check its mask bit and "visit" it accordingly if the bit is set
     ; the mask bit will be set if the edge in the vector is valid and the vertex has not yet been visited, otherwise it will be cleared
+IFDEF ISA_AVX512
+    ; AVX-512 visits them all at once, but if multiple edges in the present vector go to the same place, only the first of them needs to visit it
+    ; use conflict detection to find the others, which are the ones with a bit set for an earlier lane whose mask bit is set
+    vpmovq2m                k1,                     ymm_emask
+    vpconflictq             ymm1,                   ymm_elist
+    vpbroadcastmb2q         ymm_emask,              k1
+    vpandq                  ymm1,                   ymm1,                   ymm_emask
+    vptestnmq               k1{k1},                 ymm1,                   ymm1
+    
+    ; write to each destination vertex's property the ID of the current source, as its parent
+    vpbroadcastd            xmm0,                   xmm0
+    kmovb                   k2,                     k1
+    vpscatterqd             DWORD PTR [r_vprop+4*ymm_elist]{k2},           xmm0
+    
+    ; pack the destinations into the lowest lanes and update the frontiers for each of them in turn
+    ; the weak frontier check guarantees there is at least one
+    vpcompressq             ymm_emask{k1}{z},       ymm_elist
+    kmovb                   r8d,                    k1
+    popcnt                  r8d,                    r8d
+  edge_push_update_loop:
+    vmovq                   r9,                     xmm_emask
+    valignq                 ymm_emask,              ymm_emask,              ymm_emask,              1
+    
+    ; remove the vertex from WantsInfo
+    phase_helper_bitmask_clear                      r12,                    r9
+    
+    ; add the vertex to HasInfo for next algorithm iteration
+    phase_helper_bitmask_set                        r_vaccum,               r9
+    
+    ; increment the global variable that stores the number of vertices changed this algorithm iteration
+    vpextrq                 rax,                    xmm_globaccum,          0
+    phase_helper_add_frontier_stat                  rax,                    r9
+    vpinsrq                 xmm_globaccum,          xmm_globaccum,          rax,                    0
+    
+    dec                     r8
+    jnz                     edge_push_update_loop
+ELSE
   edge_push_update_1:
     ; extract the mask bit
     vpextrq                 r9,                     xmm_emask,              0
@@ -148,7 +185,7 @@ ENDIF
     phase_helper_bitmask_set                        r_vaccum,               r9
     
     ; write to the vertex's property the ID of the current source, as its parent
-    vmovq                   QWORD PTR [r_vprop+8*r9],                       xmm0
+    vmovd                   DWORD PTR [r_vprop+4*r9],                       xmm0
     
     ; increment the global variable that stores the number of vertices changed this algorithm iteration
     vpextrq                 rax,                    xmm_globaccum,          0
@@ -163,7 +200,7 @@ ENDIF
     vpextrq                 r9,                     xmm_elist,              1
     phase_helper_bitmask_clear                      r12,                    r9
     phase_helper_bitmask_set                        r_vaccum,               r9
-    vmovq                   QWORD PTR [r_vprop+8*r9],                       xmm0
+    vmovd                   DWORD PTR [r_vprop+4*r9],                       xmm0
     vpextrq                 rax,                    xmm_globaccum,          0
     phase_helper_add_frontier_stat                  rax,                    r9
     vpinsrq                 xmm_globaccum,          xmm_globaccum,          rax,                    0
@@ -179,7 +216,7 @@ ENDIF
     vpextrq                 r9,                     xmm_elist,              0
     phase_helper_bitmask_clear                      r12,                    r9
     phase_helper_bitmask_set                        r_vaccum,               r9
-    vmovq                   QWORD PTR [r_vprop+8*r9],                       xmm0
+    vmovd                   DWORD PTR [r_vprop+4*r9],                       xmm0
     vpextrq                 rax,                    xmm_globaccum,          0
     phase_helper_add_frontier_stat                  rax,                    r9
     vpinsrq                 xmm_globaccum,          xmm_globaccum,          rax,                    0
@@ -192,10 +229,11 @@ ENDIF
     vpextrq                 r9,                     xmm_elist,              1
     phase_helper_bitmask_clear                      r12,                    r9
     phase_helper_bitmask_set                        r_vaccum,               r9
-    vmovq                   QWORD PTR [r_vprop+8*r9],                       xmm0
+    vmovd                   DWORD PTR [r_vprop+4*r9],                       xmm0
     vpextrq                 rax,                    xmm_globaccum,          0
     phase_helper_add_frontier_stat                  rax,                    r9
     vpinsrq                 xmm_globaccum,          xmm_globaccum,          rax,                    0
+ENDIF
     
     ; iteration complete
   edge_push_iteration_done:
@@ -205,7 +243,11 @@ ENDM
 ; --------- PHASE CONTROL FUNCTION --------------------------------------------
 ; See "phases.h" for documentation.
 
+IFDEF ISA_AVX512
+perform_edge_push_phase_bfs_avx512          PROC PUBLIC
+ELSE
 perform_edge_push_phase_bfs                 PROC PUBLIC
+ENDIF
     ; save non-volatile registers used throughout this phase
     push                    rbx
     push                    rsi
@@ -299,7 +341,11 @@ perform_edge_push_phase_bfs                 PROC PUBLIC
     pop                     rsi
     pop                     rbx
     ret
+IFDEF ISA_AVX512
+perform_edge_push_phase_bfs_avx512          ENDP
+ELSE
 perform_edge_push_phase_bfs                 ENDP
+ENDIF
 
 
 _TEXT                                       ENDS
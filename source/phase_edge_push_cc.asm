@@ -30,7 +30,7 @@ edge_push_op_initialize                     MACRO
     
     ; perform common initialization tasks
     phase_helper_set_base_addrs
-    phase_helper_set_graph_info
+    phase_helper_set_graph_info_traversal
     
     ; get the address of the "has_info" (strong) frontier
     mov                     r_frontier,             QWORD PTR [graph_frontier_has_info]
@@ -101,7 +101,7 @@ ENDIF
     
 IFNDEF EXPERIMENT_FRONTIERS_NOSTRONG_PUSH
     ; check the strong frontier in case this iteration can be skipped
-    phase_helper_strong_frontier_check              r8,                     rsi,                    edge_push_iteration_done,                       done_edge_push_phase
+    phase_helper_strong_frontier_check_queue        r8,                     rsi,                    edge_push_iteration_done,                       done_edge_push_phase
 ENDIF
     
     ; prepare the message the source vertex will send to its neighbors
@@ -109,6 +109,52 @@ ENDIF
     ; this is a scalar but floating-point quantity
     vmovq                   xmm_smsgout,            QWORD PTR [r_vprop+8*r8]
     
+IFDEF EDGE_PUSH_NATIVE_SCATTER
+    ; AVX-512 has scatter instructions and updates need not be atomic, so perform a vector gather, vector update, and vector write-back
+    vpmovq2m                k1,                     ymm_emask
+    vbroadcastsd            ymm_smsgout,            xmm_smsgout
+    
+    ; read the destination vertices' current values and find those the message changes using the "min" operation for CC
+    kmovb                   k2,                     k1
+    vgatherqpd              ymm_gresult{k2},        QWORD PTR [r_vprop+8*ymm_elist]
+    vcmpltpd                k1{k1},                 ymm_smsgout,            ymm_gresult
+    
+    ; every edge carries the same message, so if multiple edges in the present vector go to the same place, only the first of them needs to do anything
+    ; use conflict detection to find the others, which are the ones with a bit set for an earlier lane still in k1
+    vpconflictq             ymm0,                   ymm_elist
+    vpbroadcastmb2q         ymm1,                   k1
+    vpandq                  ymm0,                   ymm0,                   ymm1
+    vptestnmq               k1{k1},                 ymm0,                   ymm0
+    
+    ; write back the aggregated properties
+    kmovb                   k2,                     k1
+    vscatterqpd             QWORD PTR [r_vprop+8*ymm_elist]{k2},           ymm_smsgout
+    
+    ; pack the destinations that changed into the lowest lanes and update the frontiers for each of them in turn
+    vpcompressq             ymm_emask{k1}{z},       ymm_elist
+    kmovb                   r9d,                    k1
+    popcnt                  r9d,                    r9d
+    jz                      edge_push_iteration_done
+  edge_push_iteration_changed_loop:
+    vmovq                   r8,                     xmm_emask
+    valignq                 ymm_emask,              ymm_emask,              ymm_emask,              1
+    
+IFNDEF EXPERIMENT_FRONTIERS_WITHOUT_ASYNC
+    ; immediately add the vertex to HasInfo (an asynchronous frontier update)
+    phase_helper_bitmask_set_nosync                 r_frontier,             r8
+ENDIF
+    
+    ; add the vertex to HasInfo*
+    phase_helper_bitmask_set_nosync                 r_vaccum,               r8
+    
+    ; increase the count of vertices that changed, for convergence detection and next algorithm iteration's engine selection
+    vpextrq                 rax,                    xmm_globaccum,          0
+    phase_helper_add_frontier_stat                  rax,                    r8
+    vpinsrq                 xmm_globaccum,          xmm_globaccum,          rax,                    0
+    
+    dec                     r9
+    jnz                     edge_push_iteration_changed_loop
+ELSE
     ; there are currently no scatter instructions capable of performing updates
     ; it is also possible that there are multiple edges in the present vector going to the same place
     ; so it would not be correct to perform a vector gather, vector update, and vector write-back
@@ -566,6 +612,7 @@ ENDIF
   edge_push_fallback_iteration_done:
 ENDIF
 ENDIF
+ENDIF
 ENDIF
     
     ; iteration complete
@@ -576,7 +623,11 @@ ENDM
 ; --------- PHASE CONTROL FUNCTION --------------------------------------------
 ; See "phases.h" for documentation.
 
+IFDEF ISA_AVX512
+perform_edge_push_phase_cc_avx512           PROC PUBLIC
+ELSE
 perform_edge_push_phase_cc                  PROC PUBLIC
+ENDIF
     ; save non-volatile registers used throughout this phase
     push                    rbx
     push                    rsi
@@ -670,7 +721,11 @@ perform_edge_push_phase_cc                  PROC PUBLIC
     pop                     rsi
     pop                     rbx
     ret
+IFDEF ISA_AVX512
+perform_edge_push_phase_cc_avx512           ENDP
+ELSE
 perform_edge_push_phase_cc                  ENDP
+ENDIF
 
 
 _TEXT                                       ENDS
@@ -30,7 +30,7 @@ edge_push_op_initialize                     MACRO
     
     ; perform common initialization tasks
     phase_helper_set_base_addrs
-    phase_helper_set_graph_info
+    phase_helper_set_graph_info_pr
     
     ; initialize the bitwise-AND masks used throughout this phase
     vmovapd                 ymm_vid_and_mask,       YMMWORD PTR [const_vid_and_mask]
@@ -91,6 +91,43 @@ ENDIF
     ; this is a scalar but floating-point quantity
     vmovq                   xmm_smsgout,            QWORD PTR [r_vprop+8*r8]
     
+IFDEF EDGE_PUSH_NATIVE_SCATTER
+    ; AVX-512 has scatter instructions and updates need not be atomic, so perform a vector gather, vector update, and vector write-back
+    ; it is still possible that there are multiple edges in the present vector going to the same place, so use conflict detection to find them
+    ; each lane of ymm_emask then holds a bit for every earlier lane that goes to the same place
+    vpmovq2m                k1,                     ymm_emask
+    vbroadcastsd            ymm_smsgout,            xmm_smsgout
+    vpconflictq             ymm_emask,              ymm_elist
+    
+    ; for PageRank, add to the total ranks passed this iteration (for handling sink vertices properly), once for each edge
+    kmovb                   eax,                    k1
+    popcnt                  eax,                    eax
+    jz                      edge_push_iteration_done
+  edge_push_iteration_globaccum_loop:
+    vaddsd                  xmm_globaccum,          xmm_globaccum,          xmm_smsgout
+    dec                     eax
+    jnz                     edge_push_iteration_globaccum_loop
+    
+    ; k1 holds the edges whose destinations have not yet been updated
+    ; each time around, update those that do not go to the same place as an earlier edge still in k1, so every edge is aggregated exactly once
+  edge_push_iteration_update_loop:
+    vpbroadcastmb2q         ymm0,                   k1
+    vpandq                  ymm0,                   ymm0,                   ymm_emask
+    vptestnmq               k2{k1},                 ymm0,                   ymm0
+    
+    ; read the destination vertices' current accumulator values and aggregate with the outgoing message in an application-specific way
+    ; PageRank: sum
+    kmovb                   k3,                     k2
+    vgatherqpd              ymm_gresult{k3},        QWORD PTR [r_vaccum+8*ymm_elist]
+    vaddpd                  ymm_gresult,            ymm_gresult,            ymm_smsgout
+    
+    ; write back the aggregated accumulators and remove the updated edges from k1
+    kmovb                   k3,                     k2
+    vscatterqpd             QWORD PTR [r_vaccum+8*ymm_elist]{k3},          ymm_gresult
+    kandnb                  k1,                     k2,                     k1
+    kortestb                k1,                     k1
+    jnz                     edge_push_iteration_update_loop
+ELSE
     ; there are currently no scatter instructions capable of performing updates
     ; it is also possible that there are multiple edges in the present vector going to the same place
     ; so it would not be correct to perform a vector gather, vector update, and vector write-back
@@ -270,6 +307,7 @@ ENDIF
 ENDIF
     
     vaddpd                  xmm_globaccum,          xmm_globaccum,          xmm_smsgout
+ENDIF
     
     ; iteration complete
   edge_push_iteration_done:
@@ -357,7 +395,11 @@ ENDM
 ; --------- PHASE CONTROL FUNCTION --------------------------------------------
 ; See "phases.h" for documentation.
 
+IFDEF ISA_AVX512
+perform_edge_push_phase_pr_avx512           PROC PUBLIC
+ELSE
 perform_edge_push_phase_pr                  PROC PUBLIC
+ENDIF
     ; save non-volatile registers used throughout this phase
     push                    rbx
     push                    rsi
@@ -422,7 +464,11 @@ perform_edge_push_phase_pr                  PROC PUBLIC
     pop                     rsi
     pop                     rbx
     ret
+IFDEF ISA_AVX512
+perform_edge_push_phase_pr_avx512           ENDP
+ELSE
 perform_edge_push_phase_pr                  ENDP
+ENDIF
 
 
 _TEXT                                       ENDS
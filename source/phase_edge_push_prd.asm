@@ -0,0 +1,306 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Grazelle
+;      High performance, hardware-optimized graph processing engine.
+;      Targets a single machine with one or more x86-based sockets.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Authored by Samuel Grossman
+; Department of Electrical Engineering, Stanford University
+; (c) 2015-2018
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; phase_edge_push_prd.asm
+;      Implementation of the Edge-Push phase for Delta PageRank.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+
+INCLUDE constants.inc
+INCLUDE phasehelpers.inc
+INCLUDE registers.inc
+INCLUDE scheduler_push.inc
+INCLUDE threadhelpers.inc
+
+
+_TEXT                                       SEGMENT
+
+
+; --------- MACROS ------------------------------------------------------------
+
+; Initializes required state for the Edge-Push phase.
+edge_push_op_initialize                     MACRO
+    ; initialize the work scheduler
+    scheduler_phase_init
+    
+    ; perform common initialization tasks
+    phase_helper_set_base_addrs
+    phase_helper_set_graph_info_pr
+    
+    ; get the address of the "has_info" (strong) frontier, which holds the vertices whose ranks changed enough to be propagated
+    mov                     r_frontier,             QWORD PTR [graph_frontier_has_info]
+    
+    ; initialize the bitwise-AND masks used throughout this phase
+    vmovapd                 ymm_vid_and_mask,       YMMWORD PTR [const_vid_and_mask]
+    vmovapd                 ymm_elist_and_mask,     YMMWORD PTR [const_edge_list_and_mask]
+    vmovapd                 ymm_emask_and_mask,     YMMWORD PTR [const_edge_mask_and_mask]
+ENDM
+
+; Sends the message in the lower position of xmm_smsgout along a single edge, whose destination is in r8 and valid bit is the top bit of r9.
+; Uses rax and rcx as scratch registers.
+edge_push_op_update_lane                    MACRO lbl_loop, lbl_next
+    bt                      r9,                     63
+    jnc                     lbl_next
+    
+  lbl_loop:
+    ; read the destination vertex's current accumulator value
+    ; set aside the current value for "cmpxchg" below, which implicitly uses rax
+    vmovq                   xmm0,                   QWORD PTR [r_vaccum+8*r8]
+    vmovq                   rax,                    xmm0
+    
+    ; aggregate with the outgoing message in an application-specific way
+    ; Delta PageRank: sum
+    vaddpd                  xmm1,                   xmm0,                   xmm_smsgout
+    
+IFDEF EXPERIMENT_EDGE_PUSH_WITHOUT_SYNC
+    ; write back the aggregated accumulator
+    vmovq                   QWORD PTR [r_vaccum+8*r8],                      xmm1
+ELSE
+    ; atomically update the aggregated accumulator
+    vmovq                   rcx,                    xmm1
+    lock cmpxchg            QWORD PTR [r_vaccum+8*r8],                      rcx
+    jne                     lbl_loop
+ENDIF
+
+  lbl_next:
+ENDM
+
+; Performs an iteration of the Edge-Push phase at the specified index.
+edge_push_op_iteration_at_index             MACRO
+    ; load the edge list element at the specified index
+    shl                     rcx,                    5
+    add                     rcx,                    r_edgelist
+IFDEF EXPERIMENT_WITHOUT_VECTORS
+    ; non-vectorized load of 4 scalar elements
+    mov                     rax,                    QWORD PTR [rcx]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    0
+    mov                     rax,                    QWORD PTR [rcx+8]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    1
+    vinserti128             ymm_edgevec,            ymm_edgevec,            xmm0,                   0
+    
+    mov                     rax,                    QWORD PTR [rcx+16]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    0
+    mov                     rax,                    QWORD PTR [rcx+24]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    1
+    vinserti128             ymm_edgevec,            ymm_edgevec,            xmm0,                   1
+ELSE
+    ; vectorized load
+    vmovapd                 ymm_edgevec,            YMMWORD PTR [rcx]
+ENDIF
+
+IFNDEF EXPERIMENT_WITHOUT_PREFETCH
+    ; prefetch the next several edge list elements whenever the processor has some free time
+    ; this will produce a stream of far-ahead prefetches every iteration of the Edge-Push phase
+    ; the "sweet spot" number of cache lines ahead to prefetch was determined experimentally
+    prefetchnta             BYTE PTR [rcx+256]
+ENDIF
+
+IFDEF EXPERIMENT_ITERATION_STATS
+    phase_helper_iteration_stats
+ENDIF
+
+    ; perform the bitwise AND operations with the required masks
+    vandpd                  ymm_elist,              ymm_edgevec,            ymm_elist_and_mask
+    vandpd                  ymm_emask,              ymm_edgevec,            ymm_emask_and_mask
+    vandpd                  ymm_edgevec,            ymm_edgevec,            ymm_vid_and_mask
+    
+    ; extract the source vertex ID by extracting individual 16-bit words as needed, shifting, and bitwise-ORing
+    vextracti128            xmm1,                   ymm_edgevec,            1
+    vpextrw                 r8,                     xmm1,                   7
+    shl                     r8,                     45
+    vpextrw                 rcx,                    xmm1,                   3
+    shl                     rcx,                    30
+    or                      r8,                     rcx
+    vpextrw                 rdx,                    xmm_edgevec,            7
+    shl                     rdx,                    15
+    vpextrw                 rcx,                    xmm_edgevec,            3
+    or                      rcx,                    rdx
+    or                      r8,                     rcx                                         ; r8 has the current source vertex ID
+    
+IFNDEF EXPERIMENT_FRONTIERS_NOSTRONG_PUSH
+    ; check the strong frontier in case this iteration can be skipped
+    ; vertices whose ranks did not change enough have nothing to send, so this is where Delta PageRank saves work over PageRank
+    phase_helper_strong_frontier_check_queue        r8,                     rsi,                    edge_push_iteration_done,                       done_edge_push_phase
+ENDIF
+
+    ; prepare the message the source vertex will send to its neighbors, which is the change in its rank divided by its outdegree
+    ; from above, r8 currently holds the source vertex ID
+    vmovq                   xmm_smsgout,            QWORD PTR [r_vprop+8*r8]
+    
+IFDEF EDGE_PUSH_NATIVE_SCATTER
+    ; AVX-512 has scatter instructions and updates need not be atomic, so perform a vector gather, vector update, and vector write-back
+    ; it is still possible that there are multiple edges in the present vector going to the same place, so use conflict detection to find them
+    ; each lane of ymm_emask then holds a bit for every earlier lane that goes to the same place
+    vpmovq2m                k1,                     ymm_emask
+    vbroadcastsd            ymm_smsgout,            xmm_smsgout
+    vpconflictq             ymm_emask,              ymm_elist
+    kortestb                k1,                     k1
+    jz                      edge_push_iteration_done
+    
+    ; k1 holds the edges whose destinations have not yet been updated
+    ; each time around, update those that do not go to the same place as an earlier edge still in k1, so every edge is aggregated exactly once
+  edge_push_iteration_update_loop:
+    vpbroadcastmb2q         ymm0,                   k1
+    vpandq                  ymm0,                   ymm0,                   ymm_emask
+    vptestnmq               k2{k1},                 ymm0,                   ymm0
+    
+    ; read the destination vertices' current accumulator values and aggregate with the outgoing message in an application-specific way
+    ; Delta PageRank: sum
+    kmovb                   k3,                     k2
+    vgatherqpd              ymm_gresult{k3},        QWORD PTR [r_vaccum+8*ymm_elist]
+    vaddpd                  ymm_gresult,            ymm_gresult,            ymm_smsgout
+    
+    ; write back the aggregated accumulators and remove the updated edges from k1
+    kmovb                   k3,                     k2
+    vscatterqpd             QWORD PTR [r_vaccum+8*ymm_elist]{k3},          ymm_gresult
+    kandnb                  k1,                     k2,                     k1
+    kortestb                k1,                     k1
+    jnz                     edge_push_iteration_update_loop
+ELSE
+    ; there are currently no scatter instructions capable of performing atomic updates, and multiple edges in the present vector may go to the same place
+    ; update each destination vertex in turn, in scalar form
+    vpextrq                 r8,                     xmm_elist,              0
+    vpextrq                 r9,                     xmm_emask,              0
+    edge_push_op_update_lane                        edge_push_iteration_update_1_loop,              edge_push_iteration_update_2_start
+    
+  edge_push_iteration_update_2_start:
+    vpextrq                 r8,                     xmm_elist,              1
+    vpextrq                 r9,                     xmm_emask,              1
+    edge_push_op_update_lane                        edge_push_iteration_update_2_loop,              edge_push_iteration_update_3_start
+    
+    ; same as above, except move to the upper 128 bits of the edge list and mask registers
+  edge_push_iteration_update_3_start:
+    vextracti128            xmm_elist,              ymm_elist,              1
+    vextracti128            xmm_emask,              ymm_emask,              1
+    vpextrq                 r8,                     xmm_elist,              0
+    vpextrq                 r9,                     xmm_emask,              0
+    edge_push_op_update_lane                        edge_push_iteration_update_3_loop,              edge_push_iteration_update_4_start
+    
+  edge_push_iteration_update_4_start:
+    vpextrq                 r8,                     xmm_elist,              1
+    vpextrq                 r9,                     xmm_emask,              1
+    edge_push_op_update_lane                        edge_push_iteration_update_4_loop,              edge_push_iteration_done
+ENDIF
+
+    ; iteration complete
+  edge_push_iteration_done:
+ENDM
+
+
+; --------- PHASE CONTROL FUNCTION --------------------------------------------
+; See "phases.h" for documentation.
+
+IFDEF ISA_AVX512
+perform_edge_push_phase_prd_avx512          PROC PUBLIC
+ELSE
+perform_edge_push_phase_prd                 PROC PUBLIC
+ENDIF
+    ; save non-volatile registers used throughout this phase
+    push                    rbx
+    push                    rsi
+    push                    rdi
+    push                    r12
+    push                    r13
+    push                    r14
+    push                    r15
+    
+    ; set the base address for the current edge list block
+    mov                     r_edgelist,             rcx
+    
+    ; set aside the number of vectors (parameter, rdx)
+    vextracti128            xmm0,                   ymm_addrstash,          1
+    vpinsrq                 xmm0,                   xmm0,                   rdx,                    1
+    vinserti128             ymm_addrstash,          ymm_addrstash,          xmm0,                   1
+    
+    ; initialize
+    edge_push_op_initialize
+    
+    ; get this thread's first work assignment
+    scheduler_get_first_assigned_unit
+    xor                     rsi,                    rsi
+    
+  edge_push_phase_work_start:
+    ; check if there is a work assignment for this thread and, if not, the Edge-Push phase is done
+    cmp                     rax,                    0
+    jl                      done_edge_push_phase
+    
+    ; retrieve the number of vectors into rdx
+    vextracti128            xmm0,                   ymm_addrstash,          1
+    vpextrq                 rdx,                    xmm0,                   1
+    
+    ; get the work assignment for this thread
+    mov                     rcx,                    rax
+    mov                     r8,                     rsi
+    scheduler_assign_work_for_unit
+    
+    ; if the last time around we found that no vertices were active until after this unit of work, skip this unit of work
+    cmp                     r8,                     rdi
+    cmova                   rsi,                    r8
+    ja                      done_edge_push_loop
+    
+    ; if the last time around we found an active vertex somewhere in the middle of this unit of work, skip to that vertex
+    cmp                     r8,                     rsi
+    cmova                   rsi,                    r8
+    
+    ; verify we still have work to do, and if not, skip this unit of work
+    cmp                     rsi,                    rdi
+    jge                     done_edge_push_loop
+    
+    ; load the vertex index
+    threads_helper_get_thread_group_id              eax
+    mov                     r_vindex,               QWORD PTR [graph_vertex_scatter_index_numa]
+    mov                     r_vindex,               QWORD PTR [r_vindex+8*rax]
+    
+    ; compute the number of elements valid for this NUMA node's frontier searches
+    ; valid frontier bits are numbered from 0 to the last shared vertex in this node's edge list
+    ; of course, this node will only start searching based on its edge list assignment
+    ; each frontier element holds 64 vertices, so divide by 64 (shift right by 6) to obtain the proper element count
+    ; increment once more to compensate for any remainders left over
+    mov                     r_frontiercount,        QWORD PTR [graph_vertex_scatter_index_end_numa]
+    mov                     r_frontiercount,        QWORD PTR [r_frontiercount+8*rax]
+    inc                     r_frontiercount
+    shr                     r_frontiercount,        6
+    inc                     r_frontiercount
+    
+    ; main Edge-Push phase loop
+  edge_push_phase_loop:
+    cmp                     rsi,                    rdi
+    jae                     done_edge_push_loop
+    
+    mov                     rcx,                    rsi
+    edge_push_op_iteration_at_index
+    
+    inc                     rsi
+    jmp                     edge_push_phase_loop
+  done_edge_push_loop:
+    
+    ; get this thread's next work assignment
+    scheduler_get_next_assigned_unit
+    jmp                     edge_push_phase_work_start
+    
+  done_edge_push_phase:
+    ; restore non-volatile registers and return
+    pop                     r15
+    pop                     r14
+    pop                     r13
+    pop                     r12
+    pop                     rdi
+    pop                     rsi
+    pop                     rbx
+    ret
+IFDEF ISA_AVX512
+perform_edge_push_phase_prd_avx512          ENDP
+ELSE
+perform_edge_push_phase_prd                 ENDP
+ENDIF
+
+
+_TEXT                                       ENDS
+
+
+END
@@ -0,0 +1,270 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Grazelle
+;      High performance, hardware-optimized graph processing engine.
+;      Targets a single machine with one or more x86-based sockets.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Authored by Samuel Grossman
+; Department of Electrical Engineering, Stanford University
+; (c) 2015-2018
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; phase_edge_push_prf.asm
+;      Implementation of the Edge-Push phase for single-precision PageRank.
+;      Vertex properties and accumulators are 32-bit floats, and updates to
+;      the accumulators are atomic unless synchronization is omitted. This
+;      phase does not use transactional memory.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+
+INCLUDE constants.inc
+INCLUDE phasehelpers.inc
+INCLUDE registers.inc
+INCLUDE scheduler_push.inc
+INCLUDE threadhelpers.inc
+
+
+_TEXT                                       SEGMENT
+
+
+; --------- MACROS ------------------------------------------------------------
+
+; Initializes required state for the Edge-Push phase.
+edge_push_op_initialize                     MACRO
+    ; initialize the work scheduler
+    scheduler_phase_init
+    
+    ; perform common initialization tasks
+    phase_helper_set_base_addrs
+    phase_helper_set_graph_info_pr
+    
+    ; initialize the bitwise-AND masks used throughout this phase
+    vmovapd                 ymm_vid_and_mask,       YMMWORD PTR [const_vid_and_mask]
+    vmovapd                 ymm_elist_and_mask,     YMMWORD PTR [const_edge_list_and_mask]
+    vmovapd                 ymm_emask_and_mask,     YMMWORD PTR [const_edge_mask_and_mask]
+ENDM
+
+; Adds the outgoing message to the accumulator of the destination vertex in the specified lane of xmm_elist, provided that the lane is valid in xmm_emask.
+; Labels must be unique per use, so they are specified as parameters.
+; Uses rax, rcx, r8, r9, xmm0, and xmm1 as scratch registers.
+edge_push_op_update_lane                    MACRO lane_idx, lbl_update_loop, lbl_update_skip
+    ; extract the destination vertex identifier and mask bit
+    ; verify that the top bit is set and, if not, skip the vertex entirely
+    vpextrq                 r8,                     xmm_elist,              lane_idx
+    vpextrq                 r9,                     xmm_emask,              lane_idx
+    bt                      r9,                     63
+    jnc                     lbl_update_skip
+    
+  lbl_update_loop:
+    ; read the destination vertex's current accumulator value
+    ; "cmpxchg" below implicitly uses eax as the expected value
+    mov                     eax,                    DWORD PTR [r_vaccum+4*r8]
+    vmovd                   xmm0,                   eax
+    
+    ; aggregate with the outgoing message in an application-specific way
+    ; PageRank: sum
+    vaddss                  xmm1,                   xmm0,                   xmm_smsgout
+    
+IFDEF EXPERIMENT_EDGE_PUSH_WITHOUT_SYNC
+    ; write back the aggregated accumulator
+    vmovd                   DWORD PTR [r_vaccum+4*r8],                      xmm1
+ELSE
+    ; atomically update the aggregated accumulator
+    vmovd                   ecx,                    xmm1
+    lock cmpxchg            DWORD PTR [r_vaccum+4*r8],                      ecx
+    jne                     lbl_update_loop
+ENDIF
+    
+  lbl_update_skip:
+ENDM
+
+; Performs an iteration of the Edge-Push phase at the specified index.
+edge_push_op_iteration_at_index             MACRO
+    ; load the edge list element at the specified index
+    shl                     rcx,                    5
+    add                     rcx,                    r_edgelist
+IFDEF EXPERIMENT_WITHOUT_VECTORS
+    ; non-vectorized load of 4 scalar elements
+    mov                     rax,                    QWORD PTR [rcx]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    0
+    mov                     rax,                    QWORD PTR [rcx+8]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    1
+    vinserti128             ymm_edgevec,            ymm_edgevec,            xmm0,                   0
+    
+    mov                     rax,                    QWORD PTR [rcx+16]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    0
+    mov                     rax,                    QWORD PTR [rcx+24]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    1
+    vinserti128             ymm_edgevec,            ymm_edgevec,            xmm0,                   1
+ELSE
+    ; vectorized load
+    vmovapd                 ymm_edgevec,            YMMWORD PTR [rcx]
+ENDIF
+    
+IFNDEF EXPERIMENT_WITHOUT_PREFETCH
+    ; prefetch the next several edge list elements whenever the processor has some free time
+    ; this will produce a stream of far-ahead prefetches every iteration of the Edge-Push phase
+    ; the "sweet spot" number of cache lines ahead to prefetch was determined experimentally
+    prefetchnta             BYTE PTR [rcx+256]
+ENDIF
+    
+    ; perform the bitwise AND operations with the required masks
+    vandpd                  ymm_elist,              ymm_edgevec,            ymm_elist_and_mask
+    vandpd                  ymm_emask,              ymm_edgevec,            ymm_emask_and_mask
+    vandpd                  ymm_edgevec,            ymm_edgevec,            ymm_vid_and_mask
+    
+    ; extract the source vertex ID by extracting individual 16-bit words as needed, shifting, and bitwise-ORing
+    vextracti128            xmm1,                   ymm_edgevec,            1
+    vpextrw                 r8,                     xmm1,                   7
+    shl                     r8,                     45
+    vpextrw                 rcx,                    xmm1,                   3
+    shl                     rcx,                    30
+    or                      r8,                     rcx
+    vpextrw                 rdx,                    xmm_edgevec,            7
+    shl                     rdx,                    15
+    vpextrw                 rcx,                    xmm_edgevec,            3
+    or                      rcx,                    rdx
+    or                      r8,                     rcx                                         ; r8 has the current source vertex ID
+
+    ; prepare the message the source vertex will send to its neighbors
+    ; from above, r8 currently holds the source vertex ID
+    ; this is a scalar but floating-point quantity
+    vmovd                   xmm_smsgout,            DWORD PTR [r_vprop+4*r8]
+    
+    ; for PageRank, add to the total ranks passed this iteration (for handling sink vertices properly), once for each edge
+    ; the total is kept in double precision, so add the message multiplied by the number of valid edges in the vector
+    vmovmskpd               eax,                    ymm_emask
+    popcnt                  eax,                    eax
+    jz                      edge_push_iteration_done
+    vcvtsi2sd               xmm0,                   xmm0,                   eax
+    vcvtss2sd               xmm1,                   xmm1,                   xmm_smsgout
+    vmulsd                  xmm0,                   xmm0,                   xmm1
+    vaddsd                  xmm_globaccum,          xmm_globaccum,          xmm0
+    
+IFDEF EDGE_PUSH_NATIVE_SCATTER
+    ; AVX-512 has scatter instructions and updates need not be atomic, so perform a vector gather, vector update, and vector write-back
+    ; it is still possible that there are multiple edges in the present vector going to the same place, so use conflict detection to find them
+    ; each lane of ymm_emask then holds a bit for every earlier lane that goes to the same place
+    vpmovq2m                k1,                     ymm_emask
+    vbroadcastss            xmm_smsgout,            xmm_smsgout
+    vpconflictq             ymm_emask,              ymm_elist
+    
+    ; k1 holds the edges whose destinations have not yet been updated
+    ; each time around, update those that do not go to the same place as an earlier edge still in k1, so every edge is aggregated exactly once
+  edge_push_iteration_update_loop:
+    vpbroadcastmb2q         ymm0,                   k1
+    vpandq                  ymm0,                   ymm0,                   ymm_emask
+    vptestnmq               k2{k1},                 ymm0,                   ymm0
+    
+    ; read the destination vertices' current accumulator values and aggregate with the outgoing message in an application-specific way
+    ; PageRank: sum
+    kmovb                   k3,                     k2
+    vgatherqps              xmm_gresult{k3},        DWORD PTR [r_vaccum+4*ymm_elist]
+    vaddps                  xmm_gresult,            xmm_gresult,            xmm_smsgout
+    
+    ; write back the aggregated accumulators and remove the updated edges from k1
+    kmovb                   k3,                     k2
+    vscatterqps             DWORD PTR [r_vaccum+4*ymm_elist]{k3},          xmm_gresult
+    kandnb                  k1,                     k2,                     k1
+    kortestb                k1,                     k1
+    jnz                     edge_push_iteration_update_loop
+ELSE
+    ; there are currently no scatter instructions capable of performing updates
+    ; it is also possible that there are multiple edges in the present vector going to the same place
+    ; so it would not be correct to perform a vector gather, vector update, and vector write-back
+    ; in the absence of instructions that can aggregate updates and perform them atomically, this needs to be done in scalar form
+    edge_push_op_update_lane                        0,                      edge_push_iteration_update_1_loop,              edge_push_iteration_update_2_start
+    edge_push_op_update_lane                        1,                      edge_push_iteration_update_2_loop,              edge_push_iteration_update_3_start
+    
+    ; same as above, except move to the upper 128 bits of the edge list and mask registers
+    vextracti128            xmm_elist,              ymm_elist,              1
+    vextracti128            xmm_emask,              ymm_emask,              1
+    edge_push_op_update_lane                        0,                      edge_push_iteration_update_3_loop,              edge_push_iteration_update_4_start
+    edge_push_op_update_lane                        1,                      edge_push_iteration_update_4_loop,              edge_push_iteration_update_4_skip
+ENDIF
+    
+    ; iteration complete
+  edge_push_iteration_done:
+ENDM
+
+
+; --------- PHASE CONTROL FUNCTION --------------------------------------------
+; See "phases.h" for documentation.
+
+IFDEF ISA_AVX512
+perform_edge_push_phase_prf_avx512          PROC PUBLIC
+ELSE
+perform_edge_push_phase_prf                 PROC PUBLIC
+ENDIF
+    ; save non-volatile registers used throughout this phase
+    push                    rbx
+    push                    rsi
+    push                    rdi
+    push                    r12
+    push                    r13
+    push                    r14
+    push                    r15
+    
+    ; set the base address for the current edge list block
+    mov                     r_edgelist,             rcx
+    
+    ; set aside the number of vectors (parameter, rdx)
+    vextracti128            xmm0,                   ymm_addrstash,          1
+    vpinsrq                 xmm0,                   xmm0,                   rdx,                    1
+    vinserti128             ymm_addrstash,          ymm_addrstash,          xmm0,                   1
+    
+    ; initialize
+    edge_push_op_initialize
+    
+    ; get this thread's first work assignment
+    scheduler_get_first_assigned_unit
+    
+  edge_push_phase_work_start:
+    ; check if there is a work assignment for this thread and, if not, the Edge-Push phase is done
+    cmp                     rax,                    0
+    jl                      done_edge_push_phase
+    
+    ; retrieve the number of vectors into rdx
+    vextracti128            xmm0,                   ymm_addrstash,          1
+    vpextrq                 rdx,                    xmm0,                   1
+    
+    ; get the work assignment for this thread
+    mov                     rcx,                    rax
+    scheduler_assign_work_for_unit
+    cmp                     rsi,                    rdi
+    jge                     done_edge_push_loop
+    
+    ; main Edge-Push phase loop
+  edge_push_phase_loop:
+    cmp                     rsi,                    rdi
+    jae                     done_edge_push_loop
+    
+    mov                     rcx,                    rsi
+    edge_push_op_iteration_at_index
+    
+    inc                     rsi
+    jmp                     edge_push_phase_loop
+  done_edge_push_loop:
+    
+    ; get this thread's next work assignment
+    scheduler_get_next_assigned_unit
+    jmp                     edge_push_phase_work_start
+  
+  done_edge_push_phase:  
+    ; restore non-volatile registers and return
+    pop                     r15
+    pop                     r14
+    pop                     r13
+    pop                     r12
+    pop                     rdi
+    pop                     rsi
+    pop                     rbx
+    ret
+IFDEF ISA_AVX512
+perform_edge_push_phase_prf_avx512          ENDP
+ELSE
+perform_edge_push_phase_prf                 ENDP
+ENDIF
+
+
+_TEXT                                       ENDS
+
+
+END
@@ -0,0 +1,319 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Grazelle
+;      High performance, hardware-optimized graph processing engine.
+;      Targets a single machine with one or more x86-based sockets.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Authored by Samuel Grossman
+; Department of Electrical Engineering, Stanford University
+; (c) 2015-2018
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; phase_edge_push_sssp.asm
+;      Implementation of the Edge-Push phase for Single-Source Shortest Paths.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+
+INCLUDE constants.inc
+INCLUDE phasehelpers.inc
+INCLUDE registers.inc
+INCLUDE scheduler_push.inc
+INCLUDE threadhelpers.inc
+
+
+_TEXT                                       SEGMENT
+
+
+; --------- MACROS ------------------------------------------------------------
+
+; Initializes required state for the Edge-Push phase.
+edge_push_op_initialize                     MACRO
+    ; initialize the work scheduler
+    scheduler_phase_init
+    
+    ; perform common initialization tasks
+    phase_helper_set_base_addrs
+    phase_helper_set_graph_info_traversal
+    
+    ; get the address of the "has_info" (strong) frontier
+    mov                     r_frontier,             QWORD PTR [graph_frontier_has_info]
+    
+    ; place the address of the outdegree array into the address stash
+    mov                     rax,                    QWORD PTR [graph_vertex_outdegrees]
+    vextracti128            xmm0,                   ymm_addrstash,          0
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    0
+    vinserti128             ymm_addrstash,          ymm_addrstash,          xmm0,                   0
+    
+    ; initialize the bitwise-AND masks used throughout this phase
+    vmovapd                 ymm_vid_and_mask,       YMMWORD PTR [const_vid_and_mask]
+    vmovapd                 ymm_elist_and_mask,     YMMWORD PTR [const_edge_list_and_mask]
+    vmovapd                 ymm_emask_and_mask,     YMMWORD PTR [const_edge_mask_and_mask]
+    
+    ; the address of this node's edge weights lives in rbp
+    mov                     rax,                    QWORD PTR [graph_edges_scatter_list_block_weights_numa]
+    threads_helper_get_thread_group_id              ecx
+    mov                     rbp,                    QWORD PTR [rax+8*rcx]
+ENDM
+
+; Sends the message in the lower position of xmm_smsgout along a single edge, whose destination is in r8 and valid bit is the top bit of r9.
+; Messages differ from lane to lane because each edge has its own weight, so there is no vector or transactional version of this update.
+; Uses rax, rcx, and rdx as scratch registers.
+edge_push_op_update_lane                    MACRO lbl_loop, lbl_write, lbl_next
+    bt                      r9,                     63
+    jnc                     lbl_next
+    
+  lbl_loop:
+    ; read the destination vertex's current value
+    ; set aside the current value for "cmpxchg" below, which implicitly uses rax
+    vmovq                   xmm0,                   QWORD PTR [r_vprop+8*r8]
+    vmovq                   rax,                    xmm0
+    
+    ; aggregate with the outgoing message using the "min" operation for SSSP
+    ; if the message does not change the value of the vertex, skip to the next one
+    vminpd                  xmm1,                   xmm0,                   xmm_smsgout
+    vcmpneqpd               xmm0,                   xmm0,                   xmm1
+    vmovq                   rdx,                    xmm0
+    bt                      rdx,                    63
+    jnc                     lbl_next
+    
+  lbl_write:
+IFDEF EXPERIMENT_EDGE_PUSH_WITHOUT_SYNC
+    ; write back the aggregated property
+    vmovq                   QWORD PTR [r_vprop+8*r8],                       xmm1
+    
+IFNDEF EXPERIMENT_FRONTIERS_WITHOUT_ASYNC
+    ; immediately add the vertex to HasInfo (an asynchronous frontier update)
+    phase_helper_bitmask_set_nosync                 r_frontier,             r8
+ENDIF
+    
+    ; add the vertex to HasInfo*
+    phase_helper_bitmask_set_nosync                 r_vaccum,               r8
+ELSE
+    ; atomically update the aggregated property
+    vmovq                   rcx,                    xmm1
+    lock cmpxchg            QWORD PTR [r_vprop+8*r8],                       rcx
+    jne                     lbl_loop
+    
+IFNDEF EXPERIMENT_FRONTIERS_WITHOUT_ASYNC
+    ; immediately add the vertex to HasInfo (an asynchronous frontier update)
+    phase_helper_bitmask_set                        r_frontier,             r8
+ENDIF
+    
+    ; add the vertex to HasInfo*
+    phase_helper_bitmask_set                        r_vaccum,               r8
+ENDIF
+    
+    ; increase the count of vertices that changed, for convergence detection and next algorithm iteration's engine selection
+    vpextrq                 rax,                    xmm_globaccum,          0
+    phase_helper_add_frontier_stat                  rax,                    r8
+    vpinsrq                 xmm_globaccum,          xmm_globaccum,          rax,                    0
+    
+  lbl_next:
+ENDM
+
+; Performs an iteration of the Edge-Push phase at the specified index.
+edge_push_op_iteration_at_index             MACRO
+    ; load the edge list element at the specified index
+    shl                     rcx,                    5
+    add                     rcx,                    r_edgelist
+IFDEF EXPERIMENT_WITHOUT_VECTORS
+    ; non-vectorized load of 4 scalar elements
+    mov                     rax,                    QWORD PTR [rcx]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    0
+    mov                     rax,                    QWORD PTR [rcx+8]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    1
+    vinserti128             ymm_edgevec,            ymm_edgevec,            xmm0,                   0
+    
+    mov                     rax,                    QWORD PTR [rcx+16]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    0
+    mov                     rax,                    QWORD PTR [rcx+24]
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    1
+    vinserti128             ymm_edgevec,            ymm_edgevec,            xmm0,                   1
+ELSE
+    ; vectorized load
+    vmovapd                 ymm_edgevec,            YMMWORD PTR [rcx]
+ENDIF
+    
+IFNDEF EXPERIMENT_WITHOUT_PREFETCH
+    ; prefetch the next several edge list elements whenever the processor has some free time
+    ; this will produce a stream of far-ahead prefetches every iteration of the Edge-Push phase
+    ; the "sweet spot" number of cache lines ahead to prefetch was determined experimentally
+    prefetchnta             BYTE PTR [rcx+256]
+ENDIF
+    
+IFDEF EXPERIMENT_ITERATION_STATS
+    phase_helper_iteration_stats
+ENDIF
+    
+    ; perform the bitwise AND operations with the required masks
+    vandpd                  ymm_elist,              ymm_edgevec,            ymm_elist_and_mask
+    vandpd                  ymm_emask,              ymm_edgevec,            ymm_emask_and_mask
+    vandpd                  ymm_edgevec,            ymm_edgevec,            ymm_vid_and_mask
+    
+    ; extract the source vertex ID by extracting individual 16-bit words as needed, shifting, and bitwise-ORing
+    vextracti128            xmm1,                   ymm_edgevec,            1
+    vpextrw                 r8,                     xmm1,                   7
+    shl                     r8,                     45
+    vpextrw                 rcx,                    xmm1,                   3
+    shl                     rcx,                    30
+    or                      r8,                     rcx
+    vpextrw                 rdx,                    xmm_edgevec,            7
+    shl                     rdx,                    15
+    vpextrw                 rcx,                    xmm_edgevec,            3
+    or                      rcx,                    rdx
+    or                      r8,                     rcx                                         ; r8 has the current source vertex ID
+    
+IFNDEF EXPERIMENT_FRONTIERS_NOSTRONG_PUSH
+    ; check the strong frontier in case this iteration can be skipped
+    phase_helper_strong_frontier_check_queue        r8,                     rsi,                    edge_push_iteration_done,                       done_edge_push_phase
+ENDIF
+    
+    ; prepare the messages the source vertex will send to its neighbors, which are its distance plus the weight of each edge
+    ; from above, r8 currently holds the source vertex ID, and rsi holds the index of the edge vector, which the frontier check may have advanced
+    vbroadcastsd            ymm_gresult,            QWORD PTR [r_vprop+8*r8]
+    mov                     rax,                    rsi
+    shl                     rax,                    5
+    vaddpd                  ymm_gresult,            ymm_gresult,            YMMWORD PTR [rbp+rax]
+    
+    ; update each destination vertex in turn, in scalar form since multiple edges in the present vector may go to the same place
+    vmovapd                 xmm_smsgout,            xmm_gresult
+    vpextrq                 r8,                     xmm_elist,              0
+    vpextrq                 r9,                     xmm_emask,              0
+    edge_push_op_update_lane                        edge_push_iteration_update_1_loop,              edge_push_iteration_update_1_write,             edge_push_iteration_update_2_start
+    
+    vpermilpd               xmm_smsgout,            xmm_gresult,            1
+    vpextrq                 r8,                     xmm_elist,              1
+    vpextrq                 r9,                     xmm_emask,              1
+    edge_push_op_update_lane                        edge_push_iteration_update_2_loop,              edge_push_iteration_update_2_write,             edge_push_iteration_update_3_start
+    
+    ; same as above, except move to the upper 128 bits of the message, edge list, and mask registers
+    vextractf128            xmm_gresult,            ymm_gresult,            1
+    vextracti128            xmm_elist,              ymm_elist,              1
+    vextracti128            xmm_emask,              ymm_emask,              1
+    vmovapd                 xmm_smsgout,            xmm_gresult
+    vpextrq                 r8,                     xmm_elist,              0
+    vpextrq                 r9,                     xmm_emask,              0
+    edge_push_op_update_lane                        edge_push_iteration_update_3_loop,              edge_push_iteration_update_3_write,             edge_push_iteration_update_4_start
+    
+    vpermilpd               xmm_smsgout,            xmm_gresult,            1
+    vpextrq                 r8,                     xmm_elist,              1
+    vpextrq                 r9,                     xmm_emask,              1
+    edge_push_op_update_lane                        edge_push_iteration_update_4_loop,              edge_push_iteration_update_4_write,             edge_push_iteration_done
+ENDM
+
+
+; --------- PHASE CONTROL FUNCTION --------------------------------------------
+; See "phases.h" for documentation.
+
+IFDEF ISA_AVX512
+perform_edge_push_phase_sssp_avx512         PROC PUBLIC
+ELSE
+perform_edge_push_phase_sssp                PROC PUBLIC
+ENDIF
+    ; save non-volatile registers used throughout this phase
+    push                    rbx
+    push                    rsi
+    push                    rdi
+    push                    r12
+    push                    r13
+    push                    r14
+    push                    r15
+    
+    ; the address of the edge weights lives in rbp, and the extra slot keeps the stack aligned for calls
+    push                    rbp
+    sub                     rsp,                    8
+    
+    ; set the base address for the current edge list block
+    mov                     r_edgelist,             rcx
+    
+    ; set aside the number of vectors (parameter, rdx)
+    vextracti128            xmm0,                   ymm_addrstash,          1
+    vpinsrq                 xmm0,                   xmm0,                   rdx,                    1
+    vinserti128             ymm_addrstash,          ymm_addrstash,          xmm0,                   1
+    
+    ; initialize
+    edge_push_op_initialize
+    
+    ; get this thread's first work assignment
+    scheduler_get_first_assigned_unit
+    xor                     rsi,                    rsi
+    
+  edge_push_phase_work_start:
+    ; check if there is a work assignment for this thread and, if not, the Edge-Push phase is done
+    cmp                     rax,                    0
+    jl                      done_edge_push_phase
+    
+    ; retrieve the number of vectors into rdx
+    vextracti128            xmm0,                   ymm_addrstash,          1
+    vpextrq                 rdx,                    xmm0,                   1
+    
+    ; get the work assignment for this thread
+    mov                     rcx,                    rax
+    mov                     r8,                     rsi
+    scheduler_assign_work_for_unit
+    
+    ; if the last time around we found that no vertices were active until after this unit of work, skip this unit of work
+    cmp                     r8,                     rdi
+    cmova                   rsi,                    r8
+    ja                      done_edge_push_loop
+    
+    ; if the last time around we found an active vertex somewhere in the middle of this unit of work, skip to that vertex
+    cmp                     r8,                     rsi
+    cmova                   rsi,                    r8
+    
+    ; verify we still have work to do, and if not, skip this unit of work
+    cmp                     rsi,                    rdi
+    jge                     done_edge_push_loop
+    
+    ; load the vertex index
+    threads_helper_get_thread_group_id              eax
+    mov                     r_vindex,               QWORD PTR [graph_vertex_scatter_index_numa]
+    mov                     r_vindex,               QWORD PTR [r_vindex+8*rax]
+    
+    ; compute the number of elements valid for this NUMA node's frontier searches
+    ; valid frontier bits are numbered from 0 to the last shared vertex in this node's edge list
+    ; of course, this node will only start searching based on its edge list assignment
+    ; each frontier element holds 64 vertices, so divide by 64 (shift right by 6) to obtain the proper element count
+    ; increment once more to compensate for any remainders left over
+    mov                     r_frontiercount,        QWORD PTR [graph_vertex_scatter_index_end_numa]
+    mov                     r_frontiercount,        QWORD PTR [r_frontiercount+8*rax]
+    inc                     r_frontiercount
+    shr                     r_frontiercount,        6
+    inc                     r_frontiercount
+    
+    ; main Edge-Push phase loop
+  edge_push_phase_loop:
+    cmp                     rsi,                    rdi
+    jae                     done_edge_push_loop
+    
+    mov                     rcx,                    rsi
+    edge_push_op_iteration_at_index
+    
+    inc                     rsi
+    jmp                     edge_push_phase_loop
+  done_edge_push_loop:
+    
+    ; get this thread's next work assignment
+    scheduler_get_next_assigned_unit
+    jmp                     edge_push_phase_work_start
+  
+  done_edge_push_phase:  
+    ; restore non-volatile registers and return
+    add                     rsp,                    8
+    pop                     rbp
+    pop                     r15
+    pop                     r14
+    pop                     r13
+    pop                     r12
+    pop                     rdi
+    pop                     rsi
+    pop                     rbx
+    ret
+IFDEF ISA_AVX512
+perform_edge_push_phase_sssp_avx512         ENDP
+ELSE
+perform_edge_push_phase_sssp                ENDP
+ENDIF
+
+
+_TEXT                                       ENDS
+
+
+END
@@ -41,8 +41,12 @@ vertex_op_iteration_at_index                MACRO
     shl                     r_woffset,              6
     
     ; zero out the assigned vertices in the accumulators
+IFDEF ISA_AVX512
+    vmovntpd                ZMMWORD PTR [r_vaccum+r_woffset],               zmm_caccum1
+ELSE
     vmovntpd                YMMWORD PTR [r_vaccum+r_woffset+0],             ymm_caccum1
     vmovntpd                YMMWORD PTR [r_vaccum+r_woffset+32],            ymm_caccum2
+ENDIF
 ENDM
 
 ; Performs an iteration of the Vertex phase at the specified index.
@@ -61,7 +65,11 @@ ENDM
 ; --------- PHASE CONTROL FUNCTION --------------------------------------------
 ; See "phases.h" for documentation.
 
+IFDEF ISA_AVX512
+perform_vertex_phase_cc_avx512              PROC PUBLIC
+ELSE
 perform_vertex_phase_cc                     PROC PUBLIC
+ENDIF
     ; save non-volatile registers used throughout this phase
     push                    rbx
     push                    rsi
@@ -79,8 +87,12 @@ IFDEF EXPERIMENT_WITHOUT_VECTORS
     xor                     r10,                    r10
 ELSE
     ; the job of this phase is to zero out the accumulator, so initialize some AVX registers for that purpose
+IFDEF ISA_AVX512
+    vpxorq                  zmm_caccum1,            zmm_caccum1,            zmm_caccum1
+ELSE
     vxorpd                  ymm_caccum1,            ymm_caccum1,            ymm_caccum1
     vxorpd                  ymm_caccum2,            ymm_caccum2,            ymm_caccum2
+ENDIF
 ENDIF
     
     ; calculate the number of total iterations across all threads based on the number of vertices
@@ -167,7 +179,11 @@ ENDIF
     pop                     rsi
     pop                     rbx
     ret
+IFDEF ISA_AVX512
+perform_vertex_phase_cc_avx512              ENDP
+ELSE
 perform_vertex_phase_cc                     ENDP
+ENDIF
 
 
 _TEXT                                       ENDS
@@ -0,0 +1,249 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Grazelle
+;      High performance, hardware-optimized graph processing engine.
+;      Targets a single machine with one or more x86-based sockets.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Authored by Samuel Grossman
+; Department of Electrical Engineering, Stanford University
+; (c) 2015-2018
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; phase_vertex_msbfs.asm
+;      Implementation of the Vertex phase for Multi-Source BFS.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+
+INCLUDE constants.inc
+INCLUDE graphdata.inc
+INCLUDE phasehelpers.inc
+INCLUDE registers.inc
+INCLUDE threadhelpers.inc
+
+
+_TEXT                                       SEGMENT
+
+
+; --------- MACROS ------------------------------------------------------------
+
+; Initializes required state for the Vertex phase.
+vertex_op_initialize                        MACRO
+    ; perform common initialization tasks
+    phase_helper_set_base_addrs
+    
+    ; get the addresses of both frontiers, the search state, and the outdegrees
+    mov                     r_frontier,             QWORD PTR [graph_frontier_has_info]
+    mov                     rbp,                    QWORD PTR [graph_frontier_wants_info]
+    mov                     r12,                    QWORD PTR [graph_vertex_search_state]
+    mov                     rax,                    QWORD PTR [graph_vertex_outdegrees]
+    
+    ; compensate for the first vertex assigned to be processed (assignment passed as a parameter in rcx)
+    ; vertex arrays hold 8 bytes per vertex, the search state 32 bytes per vertex, and the frontiers 1 bit per vertex
+    mov                     r10,                    rcx
+    shl                     r10,                    3
+    add                     r_vprop,                r10
+    add                     r_vaccum,               r10
+    add                     rax,                    r10
+    shl                     r10,                    2
+    add                     r12,                    r10
+    shr                     rcx,                    3
+    add                     r_frontier,             rcx
+    add                     rbp,                    rcx
+    
+    ; place the address of the outdegree array and the number of vertices to process (parameter, rdx) into the address stash
+    vextracti128            xmm0,                   ymm_addrstash,          0
+    vpinsrq                 xmm0,                   xmm0,                   rax,                    0
+    vpinsrq                 xmm0,                   xmm0,                   rdx,                    1
+    vinserti128             ymm_addrstash,          ymm_addrstash,          xmm0,                   0
+    
+    ; read the current search level and the mask of searches in the current batch, passed as a parameter in r8
+    vmovq                   xmm_globvars,           QWORD PTR [r8]
+    mov                     r9,                     QWORD PTR [r8+8]
+ENDM
+
+; Performs an iteration of the Vertex phase at the specified index.
+; Each iteration handles 64 vertices, which share a single element of each frontier, so no other thread touches those elements.
+vertex_op_iteration_at_index                MACRO
+    ; calculate the range of vertices to process, which is (index << 6) up to 64 vertices later but no further than the number of vertices
+    mov                     r11,                    rcx
+    shl                     r11,                    6
+    lea                     r10,                    [r11+64]
+    vpextrq                 rax,                    xmm_addrstash,          1
+    cmp                     r10,                    rax
+    cmova                   r10,                    rax
+    
+    ; the HasInfo frontier element for these vertices is built up in r8
+    xor                     r8,                     r8
+    
+  vertex_phase_vertex_loop:
+    cmp                     r11,                    r10
+    jae                     done_vertex_phase_vertex_loop
+    
+    ; the accumulator holds the searches that reached the vertex during the Edge phase, so read it and, if not empty, reset it for the next iteration
+    mov                     rax,                    QWORD PTR [r_vaccum+8*r11]
+    test                    rax,                    rax
+    jz                      vertex_phase_no_searches_arrived
+    mov                     QWORD PTR [r_vaccum+8*r11],                     rbx
+    
+    ; searches that had not already reached the vertex form its new vertex property, which is the set of searches whose frontier includes it
+    ; first word of the search state is the set of searches that have reached the vertex
+    mov                     rcx,                    r11
+    shl                     rcx,                    5
+    add                     rcx,                    r12
+    mov                     rdx,                    QWORD PTR [rcx]
+    andn                    rax,                    rdx,                    rax
+    mov                     QWORD PTR [r_vprop+8*r11],                      rax
+    jz                      vertex_phase_next_vertex
+    
+    ; record that these searches have reached the vertex and add the vertex to HasInfo
+    or                      rdx,                    rax
+    mov                     QWORD PTR [rcx],        rdx
+    bts                     r8,                     r11
+    
+    ; once every search in the batch has reached the vertex, remove it from WantsInfo
+    cmp                     rdx,                    r9
+    jne                     vertex_phase_update_totals
+    btr                     QWORD PTR [rbp],        r11
+    
+  vertex_phase_update_totals:
+    ; update the totals in the rest of the search state: the number of searches that reached the vertex, the sum of their distances to it, and the largest of those distances
+    ; each search reaching the vertex now is at a distance equal to the current search level
+    popcnt                  rdx,                    rax
+    add                     QWORD PTR [rcx+8],      rdx
+    vmovq                   rax,                    xmm_globvars
+    imul                    rdx,                    rax
+    add                     QWORD PTR [rcx+16],     rdx
+    cmp                     QWORD PTR [rcx+24],     rax
+    jae                     vertex_phase_update_frontier_stat
+    mov                     QWORD PTR [rcx+24],     rax
+    
+  vertex_phase_update_frontier_stat:
+    ; increment the global variable that stores the number of vertices in the frontier of at least one search
+    vpextrq                 rax,                    xmm_globaccum,          0
+    phase_helper_add_frontier_stat                  rax,                    r11
+    vpinsrq                 xmm_globaccum,          xmm_globaccum,          rax,                    0
+    jmp                     vertex_phase_next_vertex
+    
+  vertex_phase_no_searches_arrived:
+    ; no searches reached the vertex, so it leaves the frontier of any search it was in
+    cmp                     QWORD PTR [r_vprop+8*r11],                      rbx
+    je                      vertex_phase_next_vertex
+    mov                     QWORD PTR [r_vprop+8*r11],                      rbx
+    
+  vertex_phase_next_vertex:
+    inc                     r11
+    jmp                     vertex_phase_vertex_loop
+    
+  done_vertex_phase_vertex_loop:
+    ; write the HasInfo frontier element, whose index is that of the last vertex processed divided by 64
+    lea                     rax,                    [r10-1]
+    shr                     rax,                    6
+    mov                     QWORD PTR [r_frontier+8*rax],                   r8
+ENDM
+
+
+; --------- PHASE CONTROL FUNCTION --------------------------------------------
+; See "phases.h" for documentation.
+
+IFDEF ISA_AVX512
+perform_vertex_phase_msbfs_avx512           PROC PUBLIC
+ELSE
+perform_vertex_phase_msbfs                  PROC PUBLIC
+ENDIF
+    ; save non-volatile registers used throughout this phase
+    push                    rbx
+    push                    rbp
+    push                    rsi
+    push                    rdi
+    push                    r12
+    push                    r13
+    push                    r14
+    push                    r15
+    
+    ; initialize
+    vertex_op_initialize
+    
+    ; calculate the number of total iterations across all threads based on the number of vertices
+    ; by the time this is done, rdx stores the number of iterations
+    ; where V is the number of vertices, number of iterations is equal to (V/64) + (V%64 ? 1 : 0)
+    ; number of vertices is passed in rdx
+    mov                     rcx,                    rdx
+    shr                     rdx,                    6
+    and                     rcx,                    63
+    je                      skip_add_extra_iteration
+    inc                     rdx
+  skip_add_extra_iteration:
+    
+    ; extract thread information useful as loop controls, assigning chunks to each thread round-robin
+    ; formulas:
+    ;    assignment  = #iterations / #total_threads
+    ;    addon       = #iterations % #total_threads < global_thread_id ? 1 : 0
+    ;    prev_addons = min(#iterations % #total_threads, global_thread_id)
+    ;
+    ;    base (rsi)  = (assignment * global_thread_id) + prev_addons
+    ;    inc         = 1
+    ;    max  (rdi)  = base + assignment + addon - 1
+    
+    ; first, perform the unsigned division by setting rdx:rax = #iterations and dividing by #total_threads
+    ; afterwards, rax contains the quotient ("assignment" in the formulas above) and rdx contains the remainder
+    mov                     rax,                    rdx
+    xor                     rdx,                    rdx
+    xor                     rcx,                    rcx
+    threads_helper_get_threads_per_group            ecx
+    div                     rcx
+    
+    ; to calculate other values using total_threads, extract it to rcx
+    ; can be used directly to obtain "addon" (rbx) and "prev_addons" (rsi)
+    threads_helper_get_local_thread_id              ecx
+    xor                     rbx,                    rbx
+    mov                     rsi,                    rdx
+    mov                     rdi,                    0000000000000001h
+    cmp                     rcx,                    rdx
+    cmovl                   rbx,                    rdi
+    cmovl                   rsi,                    rcx
+    
+    ; create some partial values using the calculated quantities
+    ; rsi (base) = prev_addons - this was done above, rdi (max) = assignment + addon - 1
+    ; note that because we are using "jge" below and not "jg", we skip the -1, since "jge" requires that rdi be (last index to process + 1)
+    mov                     rdi,                    rax
+    add                     rdi,                    rbx
+    
+    ; perform multiplication of assignment * total_threads, result in rax
+    ; use the result to add to rsi and figure out "base", then add to rdi to get "max"
+    mul                     rcx
+    add                     rsi,                    rax
+    add                     rdi,                    rsi
+    
+    ; accumulators are reset by writing zero to them, so create a zero-valued register for that purpose
+    xor                     rbx,                    rbx
+    
+    ; main Vertex phase loop
+  vertex_phase_loop:
+    cmp                     rsi,                    rdi
+    jge                     done_vertex_loop
+    
+    mov                     rcx,                    rsi
+    vertex_op_iteration_at_index
+    
+    inc                     rsi
+    jmp                     vertex_phase_loop
+  done_vertex_loop:
+
+    ; restore non-volatile registers and return
+    pop                     r15
+    pop                     r14
+    pop                     r13
+    pop                     r12
+    pop                     rdi
+    pop                     rsi
+    pop                     rbp
+    pop                     rbx
+    ret
+IFDEF ISA_AVX512
+perform_vertex_phase_msbfs_avx512           ENDP
+ELSE
+perform_vertex_phase_msbfs                  ENDP
+ENDIF
+
+
+_TEXT                                       ENDS
+
+
+END
@@ -27,7 +27,7 @@ _TEXT                                       SEGMENT
 vertex_op_initialize                        MACRO
     ; perform common initialization tasks
     phase_helper_set_base_addrs
-    phase_helper_set_graph_info
+    phase_helper_set_graph_info_pr
     
     ; initialize the array of vertex outdegrees
     mov                     r_outdeglist,           QWORD PTR [graph_vertex_outdegrees]
@@ -38,6 +38,12 @@ vertex_op_initialize                        MACRO
     add                     r_vaccum,               rcx
     add                     r_outdeglist,           rcx
     
+    ; the parameter in r8 points to the address of the reduce buffer, followed by the address of the residual buffer or NULL if the residual is not needed
+    ; keep the address of the residual buffer in r9 and clear the accumulator for this thread's part of the residual
+    mov                     r9,                     QWORD PTR [r8+8]
+    mov                     r8,                     QWORD PTR [r8]
+    vxorpd                  ymm_globaccum,          ymm_globaccum,          ymm_globaccum
+    
     ; compute the number of loads that need to be performed on the reduce buffer
     ; there is one entry in that buffer per thread, and loads happen in blocks of 4
     ; formula for number of loads is 1 + ((total number of threads - 1) / 4), can skip the first increment and take care of it later
@@ -50,7 +56,6 @@ vertex_op_initialize                        MACRO
     xor                     r10,                    r10
 
     ; load and add the entire content of the reduce buffer, which contains partial PageRank sums from the gather phase
-    ; base address was passed as a parameter in r8
   sum_reduce_loop:
     vaddpd                  ymm1,                   ymm1,                   YMMWORD PTR [r8+r10]
     add                     r10,                    32
@@ -69,6 +74,14 @@ vertex_op_initialize                        MACRO
     vsubpd                  xmm_globvars,           xmm_globvars,           xmm0
     vdivpd                  xmm_globvars,           xmm_globvars,           xmm_numvertices
     vbroadcastsd            ymm_globvars,           xmm_globvars
+    
+IFDEF ISA_AVX512
+    ; each iteration works on eight vertices in a single register, so broadcast the constants it needs to all eight lanes
+    vbroadcastsd            zmm_globvars,           xmm_globvars
+    vbroadcastsd            zmm_numvertices,        xmm_numvertices
+    vbroadcastsd            zmm_damping,            xmm_damping
+    vbroadcastsd            zmm_1_minus_d_by_V,     xmm_1_minus_d_by_V
+ENDIF
 ENDM
 
 ; Performs an iteration of the Vertex phase at the specified index.
@@ -78,16 +91,65 @@ vertex_op_iteration_at_index                MACRO
     mov                     r_woffset,              rcx
     shl                     r_woffset,              6
     
+IFDEF ISA_AVX512
+    ; load from the outdegree array to properly divide by a vertex's outdegree
+    vmovntdqa               zmm1,                   ZMMWORD PTR [r_outdeglist+r_woffset]
+    
+    ; if an outdegree happens to be equal to zero, it must be set instead to the number of vertices in the graph
+    vxorpd                  ymm0,                   ymm0,                   ymm0
+    vcmpeqpd                k1,                     zmm1,                   zmm0
+    vmovapd                 zmm1{k1},               zmm_numvertices
+    
+    ; base address for read is just equal to the vertex index, which is 8 * the iteration index
+    ; to get a byte offset, just multiply by 8 (or << 3)
+    shl                     rcx,                    6
+    add                     rcx,                    r_vaccum
+    
+    ; read from the accumulators
+    vmovntdqa               zmm_caccum1,            ZMMWORD PTR [rcx]
+    
+IFDEF EXPERIMENT_EDGE_FORCE_PUSH
+    ; reset the accumulators if using Edge-Push for PageRank
+    vmovntpd                ZMMWORD PTR [rcx],      zmm0
+ELSE
+IFDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+    ; reset the accumulators if using Edge-Pull without scheduler awareness for PageRank
+    vmovntpd                ZMMWORD PTR [rcx],      zmm0
+ENDIF
+ENDIF
+    
+    ; add the sink vertex constant correction factor, multiply by the damping factor, and add to the constant ((1 + d) / V)
+    vaddpd                  zmm_caccum1,            zmm_caccum1,            zmm_globvars
+    vmulpd                  zmm_caccum1,            zmm_caccum1,            zmm_damping
+    vaddpd                  zmm_caccum1,            zmm_caccum1,            zmm_1_minus_d_by_V
+    
+    ; if requested, add the amount by which each rank changed to this thread's part of the residual
+    ; previous ranks are recovered from the vertex properties by multiplying by the outdegree, and the absolute difference is the larger of the two differences
+    test                    r9,                     r9
+    jz                      vertex_skip_residual
+    vmulpd                  zmm3,                   zmm1,                   ZMMWORD PTR [r_vprop+r_woffset]
+    vsubpd                  zmm4,                   zmm_caccum1,            zmm3
+    vsubpd                  zmm3,                   zmm3,                   zmm_caccum1
+    vmaxpd                  zmm3,                   zmm3,                   zmm4
+    vaddpd                  zmm_globaccum,          zmm_globaccum,          zmm3
+  vertex_skip_residual:
+    
+    ; divide by the outdegree to calculate the final outbound message
+    vdivpd                  zmm_caccum1,            zmm_caccum1,            zmm1
+    
+    ; final store to the vertex properties
+    vmovntpd                ZMMWORD PTR [r_vprop+r_woffset],                zmm_caccum1
+ELSE
     ; load from the outdegree array to properly divide by a vertex's outdegree
     vmovntdqa               ymm1,                   YMMWORD PTR [r_outdeglist+r_woffset+0]
-    vmovntdqa               ymm2,                   YMMWORD PTR [r_outdeglist+r_woffset+32]
+    vmovntdqa               ymm3,                   YMMWORD PTR [r_outdeglist+r_woffset+32]
     
     ; if an outdegree happens to be equal to zero, it must be set instead to the number of vertices in the graph
     vxorpd                  ymm0,                   ymm0,                   ymm0
     vcmpeqpd                ymm6,                   ymm0,                   ymm1
-    vcmpeqpd                ymm7,                   ymm0,                   ymm2
+    vcmpeqpd                ymm7,                   ymm0,                   ymm3
     vblendvpd               ymm1,                   ymm1,                   ymm_numvertices,        ymm6
-    vblendvpd               ymm2,                   ymm2,                   ymm_numvertices,        ymm7
+    vblendvpd               ymm3,                   ymm3,                   ymm_numvertices,        ymm7
     
     ; base address for read is just equal to the vertex index, which is 8 * the iteration index
     ; to get a byte offset, just multiply by 8 (or << 3)
@@ -122,13 +184,30 @@ ENDIF
     vaddpd                  ymm_caccum1,            ymm_caccum1,            ymm_1_minus_d_by_V
     vaddpd                  ymm_caccum2,            ymm_caccum2,            ymm_1_minus_d_by_V
     
+    ; if requested, add the amount by which each rank changed to this thread's part of the residual
+    ; previous ranks are recovered from the vertex properties by multiplying by the outdegree, and the absolute difference is the larger of the two differences
+    test                    r9,                     r9
+    jz                      vertex_skip_residual
+    vmulpd                  ymm6,                   ymm1,                   YMMWORD PTR [r_vprop+r_woffset+0]
+    vmulpd                  ymm7,                   ymm3,                   YMMWORD PTR [r_vprop+r_woffset+32]
+    vsubpd                  ymm4,                   ymm_caccum1,            ymm6
+    vsubpd                  ymm5,                   ymm_caccum2,            ymm7
+    vsubpd                  ymm6,                   ymm6,                   ymm_caccum1
+    vsubpd                  ymm7,                   ymm7,                   ymm_caccum2
+    vmaxpd                  ymm4,                   ymm4,                   ymm6
+    vmaxpd                  ymm5,                   ymm5,                   ymm7
+    vaddpd                  ymm_globaccum,          ymm_globaccum,          ymm4
+    vaddpd                  ymm_globaccum,          ymm_globaccum,          ymm5
+  vertex_skip_residual:
+    
     ; divide by the outdegree to calculate the final outbound message
     vdivpd                  ymm_caccum1,            ymm_caccum1,            ymm1
-    vdivpd                  ymm_caccum2,            ymm_caccum2,            ymm2
+    vdivpd                  ymm_caccum2,            ymm_caccum2,            ymm3
     
     ; final store to the vertex properties
     vmovntpd                YMMWORD PTR [r_vprop+r_woffset+0],              ymm_caccum1
     vmovntpd                YMMWORD PTR [r_vprop+r_woffset+32],             ymm_caccum2
+ENDIF
     
     ; finished this iteration of the Vertex phase
 ENDM
@@ -173,6 +252,17 @@ ENDIF
     vmulpd                  xmm_caccum1,            xmm_caccum1,            xmm_damping
     vaddpd                  xmm_caccum1,            xmm_caccum1,            xmm_1_minus_d_by_V
     
+    ; if requested, add the amount by which the rank changed to this thread's part of the residual
+    test                    r9,                     r9
+    jz                      vertex_skip_residual_novec
+    vmovq                   xmm3,                   QWORD PTR [r_vprop+r_woffset]
+    vmulsd                  xmm3,                   xmm3,                   xmm1
+    vsubsd                  xmm4,                   xmm_caccum1,            xmm3
+    vsubsd                  xmm3,                   xmm3,                   xmm_caccum1
+    vmaxsd                  xmm3,                   xmm3,                   xmm4
+    vaddsd                  xmm_globaccum,          xmm_globaccum,          xmm3
+  vertex_skip_residual_novec:
+    
     ; divide by the outdegree to calculate the final outbound message
     vdivpd                  xmm_caccum1,            xmm_caccum1,            xmm1
     
@@ -187,7 +277,11 @@ ENDM
 ; --------- PHASE CONTROL FUNCTION --------------------------------------------
 ; See "phases.h" for documentation.
 
+IFDEF ISA_AVX512
+perform_vertex_phase_pr_avx512              PROC PUBLIC
+ELSE
 perform_vertex_phase_pr                     PROC PUBLIC
+ENDIF
     ; save non-volatile registers used throughout this phase
     push                    rbx
     push                    rsi
@@ -272,6 +366,20 @@ ENDIF
     inc                     rsi
     jmp                     vertex_phase_loop
   done_vertex_loop:
+    
+    ; if requested, reduce this thread's part of the residual to a single value and write it to this thread's position in the residual buffer
+    test                    r9,                     r9
+    jz                      skip_write_residual
+IFDEF ISA_AVX512
+    vextractf64x4           ymm0,                   zmm_globaccum,          1
+    vaddpd                  ymm_globaccum,          ymm_globaccum,          ymm0
+ENDIF
+    vextractf128            xmm0,                   ymm_globaccum,          1
+    vaddpd                  xmm0,                   xmm0,                   xmm_globaccum
+    vhaddpd                 xmm0,                   xmm0,                   xmm0
+    threads_helper_get_global_thread_id             eax
+    vmovq                   QWORD PTR [r9+8*rax],   xmm0
+  skip_write_residual:
 
     ; restore non-volatile registers and return
     pop                     r15
@@ -282,7 +390,11 @@ ENDIF
     pop                     rsi
     pop                     rbx
     ret
+IFDEF ISA_AVX512
+perform_vertex_phase_pr_avx512              ENDP
+ELSE
 perform_vertex_phase_pr                     ENDP
+ENDIF
 
 
 _TEXT                                       ENDS
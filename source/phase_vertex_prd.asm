@@ -0,0 +1,450 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Grazelle
+;      High performance, hardware-optimized graph processing engine.
+;      Targets a single machine with one or more x86-based sockets.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Authored by Samuel Grossman
+; Department of Electrical Engineering, Stanford University
+; (c) 2015-2018
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; phase_vertex_prd.asm
+;      Implementation of the Vertex phase for Delta PageRank.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+
+INCLUDE constants.inc
+INCLUDE graphdata.inc
+INCLUDE phasehelpers.inc
+INCLUDE registers.inc
+INCLUDE threadhelpers.inc
+
+
+_TEXT                                       SEGMENT
+
+
+; --------- MACROS ------------------------------------------------------------
+
+; Initializes required state for the Vertex phase.
+vertex_op_initialize                        MACRO
+    ; perform common initialization tasks
+    phase_helper_set_base_addrs
+    phase_helper_set_graph_info_pr
+    
+    ; get the addresses of the "has_info" frontier and the outdegrees
+    mov                     r_frontier,             QWORD PTR [graph_frontier_has_info]
+    mov                     r_outdeglist,           QWORD PTR [graph_vertex_outdegrees]
+    
+    ; the parameter in r8 points to the sink vertex correction, the threshold for a vertex to be active, the weight of the teleport term, the ranks, and the buffer that receives the change in rank of active sink vertices
+    ; the change in each vertex's rank is (d * accumulator) + (d * correction) + (weight * ((1 - d) / V)), of which everything but the first term is constant, so keep that in the global variables register
+    vmovq                   xmm_globvars,           QWORD PTR [r8]
+    vmulsd                  xmm_globvars,           xmm_globvars,           xmm_damping
+    vmovq                   xmm0,                   QWORD PTR [r8+16]
+    vmulsd                  xmm0,                   xmm0,                   xmm_1_minus_d_by_V
+    vaddsd                  xmm_globvars,           xmm_globvars,           xmm0
+    vbroadcastsd            ymm_globvars,           xmm_globvars
+    vbroadcastsd            ymm9,                   QWORD PTR [r8+8]
+    mov                     rbp,                    QWORD PTR [r8+24]
+    mov                     r9,                     QWORD PTR [r8+32]
+    
+    ; compensate for the first vertex assigned to be processed (assignment passed as a parameter in rcx)
+    ; vertex arrays hold 8 bytes per vertex and the frontier 1 bit per vertex
+    mov                     r10,                    rcx
+    shl                     r10,                    3
+    add                     r_vprop,                r10
+    add                     r_vaccum,               r10
+    add                     r_outdeglist,           r10
+    add                     rbp,                    r10
+    shr                     rcx,                    3
+    add                     r_frontier,             rcx
+    
+    ; place the number of vertices to process (parameter, rdx) into the address stash
+    vextracti128            xmm0,                   ymm_addrstash,          0
+    vpinsrq                 xmm0,                   xmm0,                   rdx,                    1
+    vinserti128             ymm_addrstash,          ymm_addrstash,          xmm0,                   0
+    
+    ; clear the accumulators for the outdegrees of active vertices (ymm_globaccum) and the change in rank of active sink vertices (ymm10)
+    vxorpd                  ymm_globaccum,          ymm_globaccum,          ymm_globaccum
+    vxorpd                  ymm10,                  ymm10,                  ymm10
+    
+IFDEF ISA_AVX512
+    ; each iteration works on eight vertices in a single register, so broadcast the constants it needs to all eight lanes
+    vbroadcastsd            zmm_globvars,           xmm_globvars
+    vbroadcastsd            zmm_numvertices,        xmm_numvertices
+    vbroadcastsd            zmm_damping,            xmm_damping
+    vbroadcastsd            zmm9,                   xmm9
+    
+    ; all eight lanes hold valid vertices, except possibly in the very last iteration
+    kxnorb                  k4,                     k4,                     k4
+ELSE
+    ; all eight lanes hold valid vertices, except possibly in the very last iteration
+    vpcmpeqq                ymm6,                   ymm6,                   ymm6
+    vpcmpeqq                ymm7,                   ymm7,                   ymm7
+ENDIF
+ENDM
+
+; Updates four consecutive vertices, at a displacement from the effective address in rcx, using the lanes marked valid in the specified register.
+; Places the mask of active vertices into the specified general-purpose register, one bit per vertex.
+vertex_op_update_four                       MACRO disp, ymm_valid, r_active
+    ; read from the accumulators and reset them for the next iteration
+    vmovapd                 ymm0,                   YMMWORD PTR [r_vaccum+rcx+disp]
+    vxorpd                  ymm1,                   ymm1,                   ymm1
+    vmovapd                 YMMWORD PTR [r_vaccum+rcx+disp],                ymm1
+    
+    ; calculate the change in rank and apply it to the ranks
+    vmulpd                  ymm0,                   ymm0,                   ymm_damping
+    vaddpd                  ymm0,                   ymm0,                   ymm_globvars
+    vaddpd                  ymm3,                   ymm0,                   YMMWORD PTR [rbp+rcx+disp]
+    vmovapd                 YMMWORD PTR [rbp+rcx+disp],                     ymm3
+    
+    ; a vertex is active if the magnitude of the change in its rank exceeds the threshold, which is the larger of the change and its negation
+    vsubpd                  ymm1,                   ymm1,                   ymm0
+    vmaxpd                  ymm1,                   ymm1,                   ymm0
+    vcmpltpd                ymm1,                   ymm9,                   ymm1
+    vandpd                  ymm1,                   ymm1,                   ymm_valid
+    vmovmskpd               r_active,               ymm1
+    
+    ; load from the outdegree array and identify sink vertices, whose outdegree is zero
+    vmovapd                 ymm3,                   YMMWORD PTR [r_outdeglist+rcx+disp]
+    vxorpd                  ymm4,                   ymm4,                   ymm4
+    vcmpeqpd                ymm4,                   ymm4,                   ymm3
+    
+IFNDEF EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+    ; if using outdegrees to help with the engine selection threshold, add the outdegrees of active vertices
+    vandpd                  ymm5,                   ymm3,                   ymm1
+    vaddpd                  ymm_globaccum,          ymm_globaccum,          ymm5
+ENDIF
+
+    ; add the change in rank of active sink vertices, which is spread over all vertices in the next iteration
+    vandpd                  ymm5,                   ymm4,                   ymm1
+    vandpd                  ymm5,                   ymm5,                   ymm0
+    vaddpd                  ymm10,                  ymm10,                  ymm5
+    
+    ; if an outdegree happens to be equal to zero, it must be set instead to the number of vertices in the graph
+    ; active vertices send the change in rank divided by the outdegree, and all others send nothing
+    vblendvpd               ymm3,                   ymm3,                   ymm_numvertices,        ymm4
+    vdivpd                  ymm0,                   ymm0,                   ymm3
+    vandpd                  ymm0,                   ymm0,                   ymm1
+    vmovapd                 YMMWORD PTR [r_vprop+rcx+disp],                 ymm0
+ENDM
+
+; Performs an iteration of the Vertex phase at the specified index.
+; Each iteration handles 64 vertices, which share a single element of the frontier, so no other thread touches that element.
+vertex_op_iteration_at_index                MACRO
+    ; calculate the range of vertices to process, which is (index << 6) up to 64 vertices later but no further than the number of vertices
+    mov                     r11,                    rcx
+    shl                     r11,                    6
+    lea                     r10,                    [r11+64]
+    vpextrq                 rax,                    xmm_addrstash,          1
+    cmp                     r10,                    rax
+    cmova                   r10,                    rax
+    
+    ; the HasInfo frontier element for these vertices is built up in r8
+    xor                     r8,                     r8
+    
+  vertex_phase_vertex_loop:
+    cmp                     r11,                    r10
+    jae                     done_vertex_phase_vertex_loop
+    
+    ; eight vertices are handled at a time, so the last time around some of them might be past the end of the assignment
+    ; in that case, only the vertices that are actually assigned can become active, which are those whose lane index is less than the number remaining
+    vpextrq                 rax,                    xmm_addrstash,          1
+    sub                     rax,                    r11
+    cmp                     rax,                    8
+    jae                     vertex_phase_all_lanes_valid
+    vcvtsi2sd               xmm0,                   xmm0,                   rax
+IFDEF ISA_AVX512
+    vbroadcastsd            zmm0,                   xmm0
+    vmovupd                 zmm1,                   ZMMWORD PTR [const_numa_merge_mask_lower]
+    vcmpltpd                k4,                     zmm1,                   zmm0
+ELSE
+    vbroadcastsd            ymm0,                   xmm0
+    vcmpgtpd                ymm6,                   ymm0,                   YMMWORD PTR [const_numa_merge_mask_lower]
+    vcmpgtpd                ymm7,                   ymm0,                   YMMWORD PTR [const_numa_merge_mask_upper]
+ENDIF
+  vertex_phase_all_lanes_valid:
+    
+    ; byte offset of the first of these vertices in the vertex arrays
+    lea                     rcx,                    [8*r11]
+    
+IFDEF ISA_AVX512
+    ; read from the accumulators and reset them for the next iteration
+    vmovapd                 zmm0,                   ZMMWORD PTR [r_vaccum+rcx]
+    vxorpd                  ymm1,                   ymm1,                   ymm1
+    vmovapd                 ZMMWORD PTR [r_vaccum+rcx],                     zmm1
+    
+    ; calculate the change in rank and apply it to the ranks
+    vmulpd                  zmm0,                   zmm0,                   zmm_damping
+    vaddpd                  zmm0,                   zmm0,                   zmm_globvars
+    vaddpd                  zmm3,                   zmm0,                   ZMMWORD PTR [rbp+rcx]
+    vmovapd                 ZMMWORD PTR [rbp+rcx],  zmm3
+    
+    ; a vertex is active if the magnitude of the change in its rank exceeds the threshold, which is the larger of the change and its negation
+    vsubpd                  zmm1,                   zmm1,                   zmm0
+    vmaxpd                  zmm1,                   zmm1,                   zmm0
+    vcmpltpd                k1{k4},                 zmm9,                   zmm1
+    kmovb                   eax,                    k1
+    
+    ; load from the outdegree array and identify sink vertices, whose outdegree is zero
+    vmovapd                 zmm3,                   ZMMWORD PTR [r_outdeglist+rcx]
+    vxorpd                  ymm4,                   ymm4,                   ymm4
+    vcmpeqpd                k3,                     zmm3,                   zmm4
+    kandb                   k2,                     k3,                     k1
+    
+IFNDEF EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+    ; if using outdegrees to help with the engine selection threshold, add the outdegrees of active vertices
+    vaddpd                  zmm_globaccum{k1},      zmm_globaccum,          zmm3
+ENDIF
+
+    ; add the change in rank of active sink vertices, which is spread over all vertices in the next iteration
+    vaddpd                  zmm10{k2},              zmm10,                  zmm0
+    
+    ; if an outdegree happens to be equal to zero, it must be set instead to the number of vertices in the graph
+    ; active vertices send the change in rank divided by the outdegree, and all others send nothing
+    vmovapd                 zmm3{k3},               zmm_numvertices
+    vdivpd                  zmm4{k1},               zmm0,                   zmm3
+    vmovapd                 ZMMWORD PTR [r_vprop+rcx],                      zmm4
+ELSE
+    ; update the lower and upper four vertices, then combine their active masks in eax
+    vertex_op_update_four   0,                      ymm6,                   eax
+    vertex_op_update_four   32,                     ymm7,                   edx
+    shl                     edx,                    4
+    or                      eax,                    edx
+ENDIF
+
+IFNDEF EXPERIMENT_THRESHOLD_WITHOUT_COUNT
+    ; increase the count of active vertices, for convergence detection and next algorithm iteration's engine selection
+    popcnt                  edx,                    eax
+    add                     rbx,                    rdx
+ENDIF
+
+    ; add the active vertices to the HasInfo frontier element
+    mov                     ecx,                    r11d
+    and                     ecx,                    63
+    shl                     rax,                    cl
+    or                      r8,                     rax
+    
+    add                     r11,                    8
+    jmp                     vertex_phase_vertex_loop
+    
+  done_vertex_phase_vertex_loop:
+    ; write the HasInfo frontier element, whose index is that of the last vertex processed divided by 64
+    lea                     rax,                    [r10-1]
+    shr                     rax,                    6
+    mov                     QWORD PTR [r_frontier+8*rax],                   r8
+ENDM
+
+; Performs an iteration of the Vertex phase at the specified index.
+; This is the non-vectorized version, which otherwise operates the same way.
+vertex_op_iteration_at_index_novec          MACRO
+    ; calculate the range of vertices to process, which is (index << 6) up to 64 vertices later but no further than the number of vertices
+    mov                     r11,                    rcx
+    shl                     r11,                    6
+    lea                     r10,                    [r11+64]
+    vpextrq                 rax,                    xmm_addrstash,          1
+    cmp                     r10,                    rax
+    cmova                   r10,                    rax
+    
+    ; the HasInfo frontier element for these vertices is built up in r8
+    xor                     r8,                     r8
+    
+  vertex_phase_vertex_loop:
+    cmp                     r11,                    r10
+    jae                     done_vertex_phase_vertex_loop
+    
+    ; read from the accumulator and reset it, along with the vertex property, which stays that way unless the vertex is active
+    vmovq                   xmm0,                   QWORD PTR [r_vaccum+8*r11]
+    xor                     rax,                    rax
+    mov                     QWORD PTR [r_vaccum+8*r11],                     rax
+    mov                     QWORD PTR [r_vprop+8*r11],                      rax
+    
+    ; calculate the change in rank and apply it to the rank
+    vmulsd                  xmm0,                   xmm0,                   xmm_damping
+    vaddsd                  xmm0,                   xmm0,                   xmm_globvars
+    vaddsd                  xmm1,                   xmm0,                   QWORD PTR [rbp+8*r11]
+    vmovq                   QWORD PTR [rbp+8*r11],  xmm1
+    
+    ; a vertex is active if the magnitude of the change in its rank exceeds the threshold, which is the larger of the change and its negation
+    vxorpd                  xmm1,                   xmm1,                   xmm1
+    vsubsd                  xmm1,                   xmm1,                   xmm0
+    vmaxsd                  xmm1,                   xmm1,                   xmm0
+    vucomisd                xmm1,                   xmm9
+    jbe                     vertex_phase_next_vertex
+    
+    ; add the vertex to HasInfo
+    bts                     r8,                     r11
+IFNDEF EXPERIMENT_THRESHOLD_WITHOUT_COUNT
+    ; increase the count of active vertices, for convergence detection and next algorithm iteration's engine selection
+    inc                     rbx
+ENDIF
+
+    ; load from the outdegree array
+    vmovq                   xmm3,                   QWORD PTR [r_outdeglist+8*r11]
+IFNDEF EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+    ; if using outdegrees to help with the engine selection threshold, add the outdegree
+    vaddsd                  xmm_globaccum,          xmm_globaccum,          xmm3
+ENDIF
+
+    ; if an outdegree happens to be equal to zero, it must be set instead to the number of vertices in the graph
+    ; the change in rank of a sink vertex is also spread over all vertices in the next iteration
+    vxorpd                  xmm4,                   xmm4,                   xmm4
+    vucomisd                xmm3,                   xmm4
+    jne                     vertex_phase_send_change
+    vaddsd                  xmm10,                  xmm10,                  xmm0
+    vmovapd                 xmm3,                   xmm_numvertices
+    
+  vertex_phase_send_change:
+    ; active vertices send the change in rank divided by the outdegree
+    vdivsd                  xmm0,                   xmm0,                   xmm3
+    vmovq                   QWORD PTR [r_vprop+8*r11],                      xmm0
+    
+  vertex_phase_next_vertex:
+    inc                     r11
+    jmp                     vertex_phase_vertex_loop
+    
+  done_vertex_phase_vertex_loop:
+    ; write the HasInfo frontier element, whose index is that of the last vertex processed divided by 64
+    lea                     rax,                    [r10-1]
+    shr                     rax,                    6
+    mov                     QWORD PTR [r_frontier+8*rax],                   r8
+ENDM
+
+
+; --------- PHASE CONTROL FUNCTION --------------------------------------------
+; See "phases.h" for documentation.
+
+IFDEF ISA_AVX512
+perform_vertex_phase_prd_avx512             PROC PUBLIC
+ELSE
+perform_vertex_phase_prd                    PROC PUBLIC
+ENDIF
+    ; save non-volatile registers used throughout this phase
+    push                    rbx
+    push                    rbp
+    push                    rsi
+    push                    rdi
+    push                    r12
+    push                    r13
+    push                    r14
+    push                    r15
+    
+    ; initialize
+    vertex_op_initialize
+    
+    ; calculate the number of total iterations across all threads based on the number of vertices
+    ; by the time this is done, rdx stores the number of iterations
+    ; where V is the number of vertices, number of iterations is equal to (V/64) + (V%64 ? 1 : 0)
+    ; number of vertices is passed in rdx
+    mov                     rcx,                    rdx
+    shr                     rdx,                    6
+    and                     rcx,                    63
+    je                      skip_add_extra_iteration
+    inc                     rdx
+  skip_add_extra_iteration:
+    
+    ; extract thread information useful as loop controls, assigning chunks to each thread round-robin
+    ; formulas:
+    ;    assignment  = #iterations / #total_threads
+    ;    addon       = #iterations % #total_threads < global_thread_id ? 1 : 0
+    ;    prev_addons = min(#iterations % #total_threads, global_thread_id)
+    ;
+    ;    base (rsi)  = (assignment * global_thread_id) + prev_addons
+    ;    inc         = 1
+    ;    max  (rdi)  = base + assignment + addon - 1
+    
+    ; first, perform the unsigned division by setting rdx:rax = #iterations and dividing by #total_threads
+    ; afterwards, rax contains the quotient ("assignment" in the formulas above) and rdx contains the remainder
+    ; the number of active vertices is not yet needed, so rbx temporarily holds "addon"
+    mov                     rax,                    rdx
+    xor                     rdx,                    rdx
+    xor                     rcx,                    rcx
+    threads_helper_get_threads_per_group            ecx
+    div                     rcx
+    
+    ; to calculate other values using total_threads, extract it to rcx
+    ; can be used directly to obtain "addon" (rbx) and "prev_addons" (rsi)
+    threads_helper_get_local_thread_id              ecx
+    xor                     rbx,                    rbx
+    mov                     rsi,                    rdx
+    mov                     rdi,                    0000000000000001h
+    cmp                     rcx,                    rdx
+    cmovl                   rbx,                    rdi
+    cmovl                   rsi,                    rcx
+    
+    ; create some partial values using the calculated quantities
+    ; rsi (base) = prev_addons - this was done above, rdi (max) = assignment + addon - 1
+    ; note that because we are using "jge" below and not "jg", we skip the -1, since "jge" requires that rdi be (last index to process + 1)
+    mov                     rdi,                    rax
+    add                     rdi,                    rbx
+    
+    ; perform multiplication of assignment * total_threads, result in rax
+    ; use the result to add to rsi and figure out "base", then add to rdi to get "max"
+    mul                     rcx
+    add                     rsi,                    rax
+    add                     rdi,                    rsi
+    
+    ; rbx counts active vertices from here on
+    xor                     rbx,                    rbx
+    
+    ; main Vertex phase loop
+  vertex_phase_loop:
+    cmp                     rsi,                    rdi
+    jge                     done_vertex_loop
+    
+    mov                     rcx,                    rsi
+IFDEF EXPERIMENT_WITHOUT_VECTORS
+    vertex_op_iteration_at_index_novec
+ELSE
+    vertex_op_iteration_at_index
+ENDIF
+
+    inc                     rsi
+    jmp                     vertex_phase_loop
+  done_vertex_loop:
+    
+    ; reduce this thread's part of the change in rank of active sink vertices to a single value and write it to this thread's position in the buffer
+IFDEF ISA_AVX512
+    vextractf64x4           ymm0,                   zmm10,                  1
+    vaddpd                  ymm10,                  ymm10,                  ymm0
+ENDIF
+    vextractf128            xmm0,                   ymm10,                  1
+    vaddpd                  xmm0,                   xmm0,                   xmm10
+    vhaddpd                 xmm0,                   xmm0,                   xmm0
+    threads_helper_get_global_thread_id             eax
+    vmovq                   QWORD PTR [r9+8*rax],   xmm0
+    
+IFNDEF EXPERIMENT_THRESHOLD_WITHOUT_OUTDEGREES
+    ; reduce the outdegrees of active vertices to a single value and add it to the number of active vertices
+IFDEF ISA_AVX512
+    vextractf64x4           ymm0,                   zmm_globaccum,          1
+    vaddpd                  ymm_globaccum,          ymm_globaccum,          ymm0
+ENDIF
+    vextractf128            xmm0,                   ymm_globaccum,          1
+    vaddpd                  xmm0,                   xmm0,                   xmm_globaccum
+    vhaddpd                 xmm0,                   xmm0,                   xmm0
+    vcvtsd2si               rax,                    xmm0
+    add                     rbx,                    rax
+ENDIF
+
+    ; the global variable is the number of vertices in the next frontier, possibly along with their outdegrees
+    vmovq                   xmm_globaccum,          rbx
+    
+    ; restore non-volatile registers and return
+    pop                     r15
+    pop                     r14
+    pop                     r13
+    pop                     r12
+    pop                     rdi
+    pop                     rsi
+    pop                     rbp
+    pop                     rbx
+    ret
+IFDEF ISA_AVX512
+perform_vertex_phase_prd_avx512             ENDP
+ELSE
+perform_vertex_phase_prd                    ENDP
+ENDIF
+
+
+_TEXT                                       ENDS
+
+
+END
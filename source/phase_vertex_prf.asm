@@ -0,0 +1,420 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Grazelle
+;      High performance, hardware-optimized graph processing engine.
+;      Targets a single machine with one or more x86-based sockets.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Authored by Samuel Grossman
+; Department of Electrical Engineering, Stanford University
+; (c) 2015-2018
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; phase_vertex_prf.asm
+;      Implementation of the Vertex phase for single-precision PageRank.
+;      Accumulators and vertex properties are read and written as 32-bit
+;      floats, but the arithmetic itself is performed in double precision.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+
+INCLUDE constants.inc
+INCLUDE graphdata.inc
+INCLUDE phasehelpers.inc
+INCLUDE registers.inc
+INCLUDE threadhelpers.inc
+
+
+_TEXT                                       SEGMENT
+
+
+; --------- MACROS ------------------------------------------------------------
+
+; Initializes required state for the Vertex phase.
+vertex_op_initialize                        MACRO
+    ; perform common initialization tasks
+    phase_helper_set_base_addrs
+    phase_helper_set_graph_info_pr
+    
+    ; initialize the array of vertex outdegrees
+    mov                     r_outdeglist,           QWORD PTR [graph_vertex_outdegrees]
+    
+    ; compensate for the first vertex assigned to be processed (assignment passed as a parameter in rcx)
+    ; vertex properties and accumulators are 4 bytes per vertex, but outdegrees are still 8 bytes per vertex
+    shl                     rcx,                    2
+    add                     r_vprop,                rcx
+    add                     r_vaccum,               rcx
+    add                     r_outdeglist,           rcx
+    add                     r_outdeglist,           rcx
+    
+    ; the parameter in r8 points to the address of the reduce buffer, followed by the address of the residual buffer or NULL if the residual is not needed
+    ; keep the address of the residual buffer in r9 and clear the accumulator for this thread's part of the residual
+    mov                     r9,                     QWORD PTR [r8+8]
+    mov                     r8,                     QWORD PTR [r8]
+    vxorpd                  ymm_globaccum,          ymm_globaccum,          ymm_globaccum
+    
+    ; compute the number of loads that need to be performed on the reduce buffer
+    ; there is one entry in that buffer per thread, and loads happen in blocks of 4
+    ; formula for number of loads is 1 + ((total number of threads - 1) / 4), can skip the first increment and take care of it later
+    threads_helper_get_total_threads                eax
+    dec                     rax
+    shr                     rax,                    2
+    
+    ; initialize for the load loop - the ymm accumulator and the iteration counter
+    vxorpd                  ymm1,                   ymm1,                   ymm1
+    xor                     r10,                    r10
+
+    ; load and add the entire content of the reduce buffer, which contains partial PageRank sums from the gather phase
+  sum_reduce_loop:
+    vaddpd                  ymm1,                   ymm1,                   YMMWORD PTR [r8+r10]
+    add                     r10,                    32
+    dec                     rax
+    jge                     sum_reduce_loop
+    
+    ; perform a reduction to compute the total and complete PageRank sum
+    vhaddpd                 ymm1,                   ymm1,                   ymm1
+    vextractf128            xmm0,                   ymm1,                   1
+    vaddpd                  xmm0,                   xmm0,                   xmm1
+    vbroadcastsd            ymm0,                   xmm0
+    
+    ; calculate (1 - [total PageRank sum]) / V which represents the PageRank correction factor to account for sink vertices
+    mov                     rax,                    1
+    vcvtsi2sd               xmm_globvars,           xmm_globvars,           rax
+    vsubpd                  xmm_globvars,           xmm_globvars,           xmm0
+    vdivpd                  xmm_globvars,           xmm_globvars,           xmm_numvertices
+    vbroadcastsd            ymm_globvars,           xmm_globvars
+    
+IFDEF ISA_AVX512
+    ; each iteration works on eight vertices in a single register, so broadcast the constants it needs to all eight lanes
+    vbroadcastsd            zmm_globvars,           xmm_globvars
+    vbroadcastsd            zmm_numvertices,        xmm_numvertices
+    vbroadcastsd            zmm_damping,            xmm_damping
+    vbroadcastsd            zmm_1_minus_d_by_V,     xmm_1_minus_d_by_V
+ENDIF
+ENDM
+
+; Performs an iteration of the Vertex phase at the specified index.
+vertex_op_iteration_at_index                MACRO
+    ; calculate the base index for write, which is just (index << 3)
+    ; to get a byte offset, just multiply by 4 (another << 2), and outdegrees are at twice that offset
+    mov                     r_woffset,              rcx
+    shl                     r_woffset,              5
+    
+IFDEF ISA_AVX512
+    ; load from the outdegree array to properly divide by a vertex's outdegree
+    vmovntdqa               zmm1,                   ZMMWORD PTR [r_outdeglist+2*r_woffset]
+    
+    ; if an outdegree happens to be equal to zero, it must be set instead to the number of vertices in the graph
+    vxorpd                  ymm0,                   ymm0,                   ymm0
+    vcmpeqpd                k1,                     zmm1,                   zmm0
+    vmovapd                 zmm1{k1},               zmm_numvertices
+    
+    ; base address for read is just equal to the vertex index, which is 8 * the iteration index
+    ; to get a byte offset, just multiply by 4 (or << 2)
+    shl                     rcx,                    5
+    add                     rcx,                    r_vaccum
+    
+    ; read from the accumulators and widen to double precision
+    vmovntdqa               ymm_caccum1,            YMMWORD PTR [rcx]
+    vcvtps2pd               zmm_caccum1,            ymm_caccum1
+    
+IFDEF EXPERIMENT_EDGE_FORCE_PUSH
+    ; reset the accumulators if using Edge-Push for PageRank
+    vmovntps                YMMWORD PTR [rcx],      ymm0
+ELSE
+IFDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+    ; reset the accumulators if using Edge-Pull without scheduler awareness for PageRank
+    vmovntps                YMMWORD PTR [rcx],      ymm0
+ENDIF
+ENDIF
+    
+    ; add the sink vertex constant correction factor, multiply by the damping factor, and add to the constant ((1 + d) / V)
+    vaddpd                  zmm_caccum1,            zmm_caccum1,            zmm_globvars
+    vmulpd                  zmm_caccum1,            zmm_caccum1,            zmm_damping
+    vaddpd                  zmm_caccum1,            zmm_caccum1,            zmm_1_minus_d_by_V
+    
+    ; if requested, add the amount by which each rank changed to this thread's part of the residual
+    ; previous ranks are recovered from the vertex properties by widening and multiplying by the outdegree, and the absolute difference is the larger of the two differences
+    test                    r9,                     r9
+    jz                      vertex_skip_residual
+    vcvtps2pd               zmm3,                   YMMWORD PTR [r_vprop+r_woffset]
+    vmulpd                  zmm3,                   zmm3,                   zmm1
+    vsubpd                  zmm4,                   zmm_caccum1,            zmm3
+    vsubpd                  zmm3,                   zmm3,                   zmm_caccum1
+    vmaxpd                  zmm3,                   zmm3,                   zmm4
+    vaddpd                  zmm_globaccum,          zmm_globaccum,          zmm3
+  vertex_skip_residual:
+    
+    ; divide by the outdegree to calculate the final outbound message
+    vdivpd                  zmm_caccum1,            zmm_caccum1,            zmm1
+    
+    ; narrow to single precision and perform the final store to the vertex properties
+    vcvtpd2ps               ymm_caccum1,            zmm_caccum1
+    vmovntps                YMMWORD PTR [r_vprop+r_woffset],                ymm_caccum1
+ELSE
+    ; load from the outdegree array to properly divide by a vertex's outdegree
+    vmovntdqa               ymm1,                   YMMWORD PTR [r_outdeglist+2*r_woffset+0]
+    vmovntdqa               ymm3,                   YMMWORD PTR [r_outdeglist+2*r_woffset+32]
+    
+    ; if an outdegree happens to be equal to zero, it must be set instead to the number of vertices in the graph
+    vxorpd                  ymm0,                   ymm0,                   ymm0
+    vcmpeqpd                ymm6,                   ymm0,                   ymm1
+    vcmpeqpd                ymm7,                   ymm0,                   ymm3
+    vblendvpd               ymm1,                   ymm1,                   ymm_numvertices,        ymm6
+    vblendvpd               ymm3,                   ymm3,                   ymm_numvertices,        ymm7
+    
+    ; base address for read is just equal to the vertex index, which is 8 * the iteration index
+    ; to get a byte offset, just multiply by 4 (or << 2)
+    shl                     rcx,                    5
+    add                     rcx,                    r_vaccum
+    
+    ; read from the accumulators and widen each half to double precision
+    vmovntdqa               ymm_caccum2,            YMMWORD PTR [rcx]
+    vcvtps2pd               ymm_caccum1,            xmm_caccum2
+    vextractf128            xmm_caccum2,            ymm_caccum2,            1
+    vcvtps2pd               ymm_caccum2,            xmm_caccum2
+    
+IFDEF EXPERIMENT_EDGE_FORCE_PUSH
+    ; reset the accumulators if using Edge-Push for PageRank
+    vmovntps                YMMWORD PTR [rcx],      ymm0
+ELSE
+IFDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+    ; reset the accumulators if using Edge-Pull without scheduler awareness for PageRank
+    vmovntps                YMMWORD PTR [rcx],      ymm0
+ENDIF
+ENDIF
+    
+    ; add the sink vertex constant correction factor to both accumulators
+    vaddpd                  ymm_caccum1,            ymm_caccum1,            ymm_globvars
+    vaddpd                  ymm_caccum2,            ymm_caccum2,            ymm_globvars
+    
+    ; multiply by the damping factor and add to the constant ((1 + d) / V)
+    vmulpd                  ymm_caccum1,            ymm_caccum1,            ymm_damping
+    vmulpd                  ymm_caccum2,            ymm_caccum2,            ymm_damping
+    vaddpd                  ymm_caccum1,            ymm_caccum1,            ymm_1_minus_d_by_V
+    vaddpd                  ymm_caccum2,            ymm_caccum2,            ymm_1_minus_d_by_V
+    
+    ; if requested, add the amount by which each rank changed to this thread's part of the residual
+    ; previous ranks are recovered from the vertex properties by widening and multiplying by the outdegree, and the absolute difference is the larger of the two differences
+    test                    r9,                     r9
+    jz                      vertex_skip_residual
+    vcvtps2pd               ymm6,                   XMMWORD PTR [r_vprop+r_woffset+0]
+    vcvtps2pd               ymm7,                   XMMWORD PTR [r_vprop+r_woffset+16]
+    vmulpd                  ymm6,                   ymm6,                   ymm1
+    vmulpd                  ymm7,                   ymm7,                   ymm3
+    vsubpd                  ymm4,                   ymm_caccum1,            ymm6
+    vsubpd                  ymm5,                   ymm_caccum2,            ymm7
+    vsubpd                  ymm6,                   ymm6,                   ymm_caccum1
+    vsubpd                  ymm7,                   ymm7,                   ymm_caccum2
+    vmaxpd                  ymm4,                   ymm4,                   ymm6
+    vmaxpd                  ymm5,                   ymm5,                   ymm7
+    vaddpd                  ymm_globaccum,          ymm_globaccum,          ymm4
+    vaddpd                  ymm_globaccum,          ymm_globaccum,          ymm5
+  vertex_skip_residual:
+    
+    ; divide by the outdegree to calculate the final outbound message
+    vdivpd                  ymm_caccum1,            ymm_caccum1,            ymm1
+    vdivpd                  ymm_caccum2,            ymm_caccum2,            ymm3
+    
+    ; narrow both halves to single precision, combine them, and perform the final store to the vertex properties
+    vcvtpd2ps               xmm_caccum1,            ymm_caccum1
+    vcvtpd2ps               xmm_caccum2,            ymm_caccum2
+    vinsertf128             ymm_caccum1,            ymm_caccum1,            xmm_caccum2,            1
+    vmovntps                YMMWORD PTR [r_vprop+r_woffset],                ymm_caccum1
+ENDIF
+    
+    ; finished this iteration of the Vertex phase
+ENDM
+
+; Performs an iteration of the Vertex phase at the specified index.
+; This is the non-vectorized version.
+vertex_op_iteration_at_index_novec          MACRO
+    ; calculate the base index for write, which is just (index << 0)
+    ; to get a byte offset, just multiply by 4 (another << 2), and outdegrees are at twice that offset
+    mov                     r_woffset,              rcx
+    shl                     r_woffset,              2
+    
+    ; load from the outdegree array to properly divide by a vertex's outdegree
+    vmovq                   xmm1,                   QWORD PTR [r_outdeglist+2*r_woffset]
+    
+    ; if an outdegree happens to be equal to zero, it must be instead set to the number of vertices in the graph
+    vmovq                   rax,                    xmm_numvertices
+    vmovq                   rdx,                    xmm1
+    cmp                     rdx,                    0
+    cmove                   rdx,                    rax
+    vmovq                   xmm1,                   rdx
+    
+    ; base address for read is just equal to the vertex index, which is equal to the iteration index
+    ; to get a byte offset, just multiply by 4 (or << 2)
+    shl                     rcx,                    2
+    add                     rcx,                    r_vaccum
+    
+    ; read from the accumulator and widen to double precision
+    vmovd                   xmm_caccum1,            DWORD PTR [rcx]
+    vcvtss2sd               xmm_caccum1,            xmm_caccum1,            xmm_caccum1
+
+IFDEF EXPERIMENT_EDGE_FORCE_PUSH
+    ; reset the accumulator if using Edge-Push for PageRank
+    xor                     eax,                    eax
+    mov                     DWORD PTR [rcx],        eax
+ELSE
+IFDEF EXPERIMENT_EDGE_PULL_WITHOUT_SCHED_AWARE
+    ; reset the accumulator if using Edge-Pull without scheduler awareness for PageRank
+    xor                     eax,                    eax
+    mov                     DWORD PTR [rcx],        eax
+ENDIF
+ENDIF
+    
+    ; add the sink vertex constant correction factor to the accumulator
+    vaddpd                  xmm_caccum1,            xmm_caccum1,            xmm_globvars
+    
+    ; multiply by the damping factor and add to the constant ((1 + d) / V)
+    vmulpd                  xmm_caccum1,            xmm_caccum1,            xmm_damping
+    vaddpd                  xmm_caccum1,            xmm_caccum1,            xmm_1_minus_d_by_V
+    
+    ; if requested, add the amount by which the rank changed to this thread's part of the residual
+    test                    r9,                     r9
+    jz                      vertex_skip_residual_novec
+    vmovd                   xmm3,                   DWORD PTR [r_vprop+r_woffset]
+    vcvtss2sd               xmm3,                   xmm3,                   xmm3
+    vmulsd                  xmm3,                   xmm3,                   xmm1
+    vsubsd                  xmm4,                   xmm_caccum1,            xmm3
+    vsubsd                  xmm3,                   xmm3,                   xmm_caccum1
+    vmaxsd                  xmm3,                   xmm3,                   xmm4
+    vaddsd                  xmm_globaccum,          xmm_globaccum,          xmm3
+  vertex_skip_residual_novec:
+    
+    ; divide by the outdegree to calculate the final outbound message
+    vdivpd                  xmm_caccum1,            xmm_caccum1,            xmm1
+    
+    ; narrow to single precision and perform the final store to the vertex properties
+    vcvtsd2ss               xmm_caccum1,            xmm_caccum1,            xmm_caccum1
+    vmovd                   eax,                    xmm_caccum1
+    movnti                  DWORD PTR [r_vprop+r_woffset],                  eax
+    
+    ; finished this iteration of the Vertex phase
+ENDM
+
+
+; --------- PHASE CONTROL FUNCTION --------------------------------------------
+; See "phases.h" for documentation.
+
+IFDEF ISA_AVX512
+perform_vertex_phase_prf_avx512             PROC PUBLIC
+ELSE
+perform_vertex_phase_prf                    PROC PUBLIC
+ENDIF
+    ; save non-volatile registers used throughout this phase
+    push                    rbx
+    push                    rsi
+    push                    rdi
+    push                    r12
+    push                    r13
+    push                    r14
+    push                    r15
+    
+    ; initialize
+    vertex_op_initialize
+    
+IFDEF EXPERIMENT_WITHOUT_VECTORS
+    ; total number of iterations across all threads is just the number of vertices assigned to be processed
+    ; number of vertices is passed in rdx
+    ; there is nothing special that needs to be done here
+ELSE
+    ; calculate the number of total iterations across all threads based on the number of vertices
+    ; number of vertices is passed in rdx
+    ; where V is the number of vertices, number of iterations is equal to (V/8) + (V%8 ? 1 : 0)
+    ; by the time this is done, rdx stores the number of iterations
+    mov                     rcx,                    rdx
+    shr                     rdx,                    3
+    and                     rcx,                    7
+    je                      skip_add_extra_iteration
+    inc                     rdx
+  skip_add_extra_iteration:
+ENDIF
+    
+    ; extract thread information useful as loop controls, assigning chunks to each thread round-robin
+    ; formulas:
+    ;    assignment  = #iterations / #total_threads
+    ;    addon       = #iterations % #total_threads < global_thread_id ? 1 : 0
+    ;    prev_addons = min(#iterations % #total_threads, global_thread_id)
+    ;
+    ;    base (rsi)  = (assignment * global_thread_id) + prev_addons
+    ;    inc         = 1
+    ;    max  (rdi)  = base + assignment + addon - 1
+    
+    ; first, perform the unsigned division by setting rdx:rax = #iterations and dividing by #total_threads
+    ; afterwards, rax contains the quotient ("assignment" in the formulas above) and rdx contains the remainder
+    mov                     rax,                    rdx
+    xor                     rdx,                    rdx
+    xor                     rcx,                    rcx
+    threads_helper_get_threads_per_group            ecx
+    div                     rcx
+    
+    ; to calculate other values using total_threads, extract it to rcx
+    ; can be used directly to obtain "addon" (rbx) and "prev_addons" (rsi)
+    threads_helper_get_local_thread_id              ecx
+    xor                     rbx,                    rbx
+    mov                     rsi,                    rdx
+    mov                     rdi,                    0000000000000001h
+    cmp                     rcx,                    rdx
+    cmovl                   rbx,                    rdi
+    cmovl                   rsi,                    rcx
+    
+    ; create some partial values using the calculated quantities
+    ; rsi (base) = prev_addons - this was done above, rdi (max) = assignment + addon - 1
+    ; note that because we are using "jge" below and not "jg", we skip the -1, since "jge" requires that rdi be (last index to process + 1)
+    mov                     rdi,                    rax
+    add                     rdi,                    rbx
+    
+    ; perform multiplication of assignment * total_threads, result in rax
+    ; use the result to add to rsi and figure out "base", then add to rdi to get "max"
+    mul                     rcx
+    add                     rsi,                    rax
+    add                     rdi,                    rsi
+    
+    ; main Vertex phase loop
+  vertex_phase_loop:
+    cmp                     rsi,                    rdi
+    jge                     done_vertex_loop
+    
+    mov                     rcx,                    rsi
+IFDEF EXPERIMENT_WITHOUT_VECTORS
+    vertex_op_iteration_at_index_novec
+ELSE
+    vertex_op_iteration_at_index
+ENDIF
+    
+    inc                     rsi
+    jmp                     vertex_phase_loop
+  done_vertex_loop:
+    
+    ; if requested, reduce this thread's part of the residual to a single value and write it to this thread's position in the residual buffer
+    test                    r9,                     r9
+    jz                      skip_write_residual
+IFDEF ISA_AVX512
+    vextractf64x4           ymm0,                   zmm_globaccum,          1
+    vaddpd                  ymm_globaccum,          ymm_globaccum,          ymm0
+ENDIF
+    vextractf128            xmm0,                   ymm_globaccum,          1
+    vaddpd                  xmm0,                   xmm0,                   xmm_globaccum
+    vhaddpd                 xmm0,                   xmm0,                   xmm0
+    threads_helper_get_global_thread_id             eax
+    vmovq                   QWORD PTR [r9+8*rax],   xmm0
+  skip_write_residual:
+
+    ; restore non-volatile registers and return
+    pop                     r15
+    pop                     r14
+    pop                     r13
+    pop                     r12
+    pop                     rdi
+    pop                     rsi
+    pop                     rbx
+    ret
+IFDEF ISA_AVX512
+perform_vertex_phase_prf_avx512             ENDP
+ELSE
+perform_vertex_phase_prf                    ENDP
+ENDIF
+
+
+_TEXT                                       ENDS
+
+
+END
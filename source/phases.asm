@@ -43,6 +43,35 @@ phase_op_write_global_accum_to_buf          PROC PUBLIC
     ret
 phase_op_write_global_accum_to_buf          ENDP
 
+; ---------
+
+phase_op_perform_edge_phase_into_buf        PROC PUBLIC
+    ; save the non-volatile register used to hold the reduce buffer position and reserve shadow space for the call
+    push                    rbx
+    sub                     rsp,                    32
+    
+    ; extract the current thread ID * 8 to use as an index into the reduce buffer
+    threads_helper_get_global_thread_id             eax
+    lea                     rbx,                    [r9+8*rax]
+    
+    ; resume accumulating from the value already in the reduce buffer
+    vmovq                   xmm_globaccum,          QWORD PTR [rbx]
+    
+    ; perform the Edge phase, which takes the edge list and its count as its only parameters
+    mov                     rax,                    rcx
+    mov                     rcx,                    rdx
+    mov                     rdx,                    r8
+    call                    rax
+    
+    ; write the result back to the reduce buffer
+    vmovq                   QWORD PTR [rbx],        xmm_globaccum
+    
+    ; operation complete
+    add                     rsp,                    32
+    pop                     rbx
+    ret
+phase_op_perform_edge_phase_into_buf        ENDP
+
 
 _TEXT                                       ENDS
 
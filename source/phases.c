@@ -16,14 +16,119 @@
 #include "floathelper.h"
 #include "graphtypes.h"
 #include "graphdata.h"
+#include "phases.h"
 #include "threads.h"
 
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/* -------- TYPE DEFINITIONS ----------------------------------------------- */
+
+// Holds the phase control functions that implement an algorithm using a particular instruction set.
+typedef struct phases_kernels_t
+{
+    void (__WRITTEN_IN_ASSEMBLY__ *edge_pull_phase)(const __m256i* edge_list, const uint64_t edge_list_count);
+    void (__WRITTEN_IN_ASSEMBLY__ *edge_push_phase)(const __m256i* edge_list, const uint64_t edge_list_count);
+    void (__WRITTEN_IN_ASSEMBLY__ *vertex_phase)(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer);
+} phases_kernels_t;
+
+
+/* -------- GLOBALS -------------------------------------------------------- */
+// See "phases.h" for documentation.
+
+void (__WRITTEN_IN_ASSEMBLY__ *perform_edge_pull_phase)(const __m256i* edge_list, const uint64_t edge_list_count) = perform_edge_pull_phase_pr;
+void (__WRITTEN_IN_ASSEMBLY__ *perform_edge_push_phase)(const __m256i* edge_list, const uint64_t edge_list_count) = perform_edge_push_phase_pr;
+void (__WRITTEN_IN_ASSEMBLY__ *perform_vertex_phase)(const uint64_t vertex_start, const uint64_t vertex_count, const uint64_t* reduce_buffer) = perform_vertex_phase_pr;
+
+
+/* -------- LOCALS --------------------------------------------------------- */
+
+// Phase control functions for each algorithm, indexed by the EXECUTION_ALGORITHM_* constants, using AVX2.
+static const phases_kernels_t phases_kernels_avx2[EXECUTION_NUM_ALGORITHMS] = {
+    { perform_edge_pull_phase_pr, perform_edge_push_phase_pr, perform_vertex_phase_pr },
+    { perform_edge_pull_phase_cc, perform_edge_push_phase_cc, perform_vertex_phase_cc },
+    { perform_edge_pull_phase_bfs, perform_edge_push_phase_bfs, perform_vertex_phase_bfs },
+    { perform_edge_pull_phase_prf, perform_edge_push_phase_prf, perform_vertex_phase_prf },
+    { perform_edge_pull_phase_sssp, perform_edge_push_phase_sssp, perform_vertex_phase_cc },
+    { perform_edge_pull_phase_msbfs, perform_edge_push_phase_msbfs, perform_vertex_phase_msbfs },
+    { perform_edge_pull_phase_pr, perform_edge_push_phase_prd, perform_vertex_phase_prd },
+    { perform_edge_pull_phase_prg, perform_edge_push_phase_prg, perform_vertex_phase_prg },
+    { perform_edge_pull_phase_ccg, perform_edge_push_phase_ccg, perform_vertex_phase_ccg }
+};
+
+// Phase control functions for each algorithm, indexed by the EXECUTION_ALGORITHM_* constants, using AVX-512.
+static const phases_kernels_t phases_kernels_avx512[EXECUTION_NUM_ALGORITHMS] = {
+    { perform_edge_pull_phase_pr_avx512, perform_edge_push_phase_pr_avx512, perform_vertex_phase_pr_avx512 },
+    { perform_edge_pull_phase_cc_avx512, perform_edge_push_phase_cc_avx512, perform_vertex_phase_cc_avx512 },
+    { perform_edge_pull_phase_bfs_avx512, perform_edge_push_phase_bfs_avx512, perform_vertex_phase_bfs_avx512 },
+    { perform_edge_pull_phase_prf_avx512, perform_edge_push_phase_prf_avx512, perform_vertex_phase_prf_avx512 },
+    { perform_edge_pull_phase_sssp_avx512, perform_edge_push_phase_sssp_avx512, perform_vertex_phase_cc_avx512 },
+    { perform_edge_pull_phase_msbfs_avx512, perform_edge_push_phase_msbfs_avx512, perform_vertex_phase_msbfs_avx512 },
+    { perform_edge_pull_phase_pr_avx512, perform_edge_push_phase_prd_avx512, perform_vertex_phase_prd_avx512 },
+    { perform_edge_pull_phase_prg, perform_edge_push_phase_prg, perform_vertex_phase_prg },
+    { perform_edge_pull_phase_ccg, perform_edge_push_phase_ccg, perform_vertex_phase_ccg }
+};
+
+// Phase control functions for each algorithm using the selected instruction set.
+static const phases_kernels_t* phases_kernels = phases_kernels_avx2;
 
 
 /* -------- FUNCTIONS ------------------------------------------------------ */
 // See "phases.h" for documentation.
 
+uint32_t phases_select_isa(const uint32_t isa)
+{
+    uint32_t selected_isa = PHASES_ISA_AVX2;
+    
+    // the AVX-512 kernels need the foundation, vector length, doubleword/quadword, and conflict detection subsets
+    // without vectors, the kernels are scalar anyway and AVX-512 has nothing to offer
+#ifndef EXPERIMENT_WITHOUT_VECTORS
+    __builtin_cpu_init();
+    const uint32_t avx512_supported = (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512cd"));
+#else
+    const uint32_t avx512_supported = 0;
+#endif
+    
+    switch (isa)
+    {
+        case PHASES_ISA_AUTO:
+            if (avx512_supported)
+            {
+                selected_isa = PHASES_ISA_AVX512;
+            }
+            break;
+        
+        case PHASES_ISA_AVX512:
+            if (!avx512_supported)
+            {
+                fprintf(stderr, "Error: AVX-512 kernels were requested but are not supported on this system or in this build.\n");
+                exit(255);
+            }
+            selected_isa = PHASES_ISA_AVX512;
+            break;
+        
+        default:
+            break;
+    }
+    
+    phases_kernels = ((PHASES_ISA_AVX512 == selected_isa) ? phases_kernels_avx512 : phases_kernels_avx2);
+    
+    return selected_isa;
+}
+
+// --------
+
+void phases_select_algorithm(const uint32_t algorithm)
+{
+    perform_edge_pull_phase = phases_kernels[algorithm].edge_pull_phase;
+    perform_edge_push_phase = phases_kernels[algorithm].edge_push_phase;
+    perform_vertex_phase = phases_kernels[algorithm].vertex_phase;
+}
+
+// --------
+
 uint64_t phase_op_combine_global_var_from_buf(uint64_t* reduce_buffer)
 {
     uint64_t value = 0ull;
@@ -38,11 +143,85 @@ uint64_t phase_op_combine_global_var_from_buf(uint64_t* reduce_buffer)
 
 // --------
 
+void edge_push_op_build_frontier_queue(const uint64_t* frontier)
+{
+#if !defined(EXPERIMENT_FRONTIERS_NOSTRONG_PUSH) && !defined(EXPERIMENT_FRONTIERS_WITHOUT_QUEUE)
+    const uint64_t num_threads = (uint64_t)threads_get_total_threads();
+    const uint64_t thread_id = (uint64_t)threads_get_global_thread_id();
+    const uint64_t frontier_count = (graph_num_vertices >> 6ull) + ((graph_num_vertices & 63ull) ? 1ull : 0ull);
+    const uint64_t first_element = frontier_count * thread_id / num_threads;
+    const uint64_t last_element = frontier_count * (thread_id + 1ull) / num_threads;
+    
+    // bits past the last vertex in the final frontier element do not correspond to vertices, so they are excluded
+    const uint64_t last_element_mask = ((graph_num_vertices & 63ull) ? ((1ull << (graph_num_vertices & 63ull)) - 1ull) : ~0ull);
+    
+    uint64_t queue_position = 0ull;
+    uint64_t queue_count = 0ull;
+    
+    // first pass: each thread counts the vertices in its part of the frontier
+    for (uint64_t i = first_element; i < last_element; ++i)
+    {
+        const uint64_t element = frontier[i] & ((frontier_count - 1ull == i) ? last_element_mask : ~0ull);
+        queue_position += (uint64_t)__builtin_popcountll(element);
+    }
+    
+    graph_frontier_queue_thread_counts[thread_id] = queue_position;
+    threads_barrier();
+    
+    // every thread combines the same counts, so they all agree on where each part goes and on whether the queue can hold the whole frontier
+    queue_position = 0ull;
+    
+    for (uint64_t i = 0ull; i < num_threads; ++i)
+    {
+        if (i < thread_id)
+        {
+            queue_position += graph_frontier_queue_thread_counts[i];
+        }
+        
+        queue_count += graph_frontier_queue_thread_counts[i];
+    }
+    
+    // second pass: each thread writes the vertices in its part of the frontier to its part of the queue, lowest first
+    if (queue_count <= graph_frontier_queue_capacity)
+    {
+        for (uint64_t i = first_element; i < last_element; ++i)
+        {
+            uint64_t element = frontier[i] & ((frontier_count - 1ull == i) ? last_element_mask : ~0ull);
+            
+            while (0ull != element)
+            {
+                graph_frontier_queue[queue_position] = (i << 6ull) + (uint64_t)__builtin_ctzll(element);
+                queue_position += 1ull;
+                element &= (element - 1ull);
+            }
+        }
+    }
+    
+    if (0 == thread_id)
+    {
+        graph_frontier_queue_count = ((queue_count <= graph_frontier_queue_capacity) ? queue_count : GRAPH_FRONTIER_QUEUE_NONE);
+    }
+#else
+    if (0 == threads_get_global_thread_id())
+    {
+        graph_frontier_queue_count = GRAPH_FRONTIER_QUEUE_NONE;
+    }
+#endif
+    
+    threads_barrier();
+}
+
+// --------
+
 void edge_pull_op_merge_with_merge_buffer(mergeaccum_t* merge_buffer, uint64_t count, double* vertex_accumulators)
 {
     uint64_t i = 0ull, j = 0ull;
     double proposed_value = 0.0;
     
+    // merge buffer records hold partial values in double precision, but the accumulators might be single precision
+    const uint32_t single_precision = execution_algorithm->single_precision;
+    float* const vertex_accumulators_single = (float*)vertex_accumulators;
+    
     while (i < count && !(merge_buffer[i].initial_vertex_id & 0x8000000000000000ull))
     {
         // proposed value is initially the value of the current record we are trying to merge
@@ -53,18 +232,63 @@ void edge_pull_op_merge_with_merge_buffer(mergeaccum_t* merge_buffer, uint64_t c
         // when this loop terminates, proposed_value will have the merged result of those other threads along with the starting thread, and j >= (i + 1)
         for (j = (i + 1ull); j < count && merge_buffer[j].final_vertex_id == merge_buffer[i].final_vertex_id; ++j)
         {
-            proposed_value = SCALAR_REDUCE_OP(proposed_value, merge_buffer[j].final_partial_value);
+            proposed_value = execution_algorithm->scalar_reduce_op(proposed_value, merge_buffer[j].final_partial_value);
         }
         
         // final check: if a thread working on a different final vertex shows up, handle overlap between its first vertex
         // in this case, we'll merge with whatever is already in the accumulators, instead of just writing, otherwise we are ready to write
         if (j < count && merge_buffer[j].initial_vertex_id == merge_buffer[i].final_vertex_id)
         {
-            proposed_value = SCALAR_REDUCE_OP(proposed_value, vertex_accumulators[merge_buffer[j].initial_vertex_id]);
+            proposed_value = execution_algorithm->scalar_reduce_op(proposed_value, (single_precision ? (double)vertex_accumulators_single[merge_buffer[j].initial_vertex_id] : vertex_accumulators[merge_buffer[j].initial_vertex_id]));
         }
         
         // final write to the accumulator and advance to the next merge target
-        vertex_accumulators[merge_buffer[i].final_vertex_id] = proposed_value;
+        if (single_precision)
+        {
+            vertex_accumulators_single[merge_buffer[i].final_vertex_id] = (float)proposed_value;
+        }
+        else
+        {
+            vertex_accumulators[merge_buffer[i].final_vertex_id] = proposed_value;
+        }
         i = j;
     }
 }
+
+// --------
+
+void edge_pull_op_build_frontier_summary(const uint64_t* frontier, uint64_t* summary)
+{
+    const uint64_t num_threads = (uint64_t)threads_get_total_threads();
+    const uint64_t thread_id = (uint64_t)threads_get_global_thread_id();
+    const uint64_t frontier_count = (graph_num_vertices >> 6ull) + ((graph_num_vertices & 63ull) ? 1ull : 0ull);
+    const uint64_t summary_count = (frontier_count >> (GRAPH_FRONTIER_SUMMARY_ELEMENTS_SHIFT + 6ull)) + 1ull;
+    const uint64_t first_summary = summary_count * thread_id / num_threads;
+    const uint64_t last_summary = summary_count * (thread_id + 1ull) / num_threads;
+    
+    // each thread writes whole summary elements, so no synchronization is needed until they are all complete
+    for (uint64_t i = first_summary; i < last_summary; ++i)
+    {
+        uint64_t summary_element = 0ull;
+        
+        for (uint64_t j = 0ull; j < 64ull; ++j)
+        {
+            const uint64_t first_element = ((i << 6ull) + j) << GRAPH_FRONTIER_SUMMARY_ELEMENTS_SHIFT;
+            uint64_t block = 0ull;
+            
+            for (uint64_t k = first_element; k < first_element + (1ull << GRAPH_FRONTIER_SUMMARY_ELEMENTS_SHIFT) && k < frontier_count; ++k)
+            {
+                block |= frontier[k];
+            }
+            
+            if (0ull != block)
+            {
+                summary_element |= (1ull << j);
+            }
+        }
+        
+        summary[i] = summary_element;
+    }
+    
+    threads_barrier();
+}
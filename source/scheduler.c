@@ -7,10 +7,19 @@
 * Department of Electrical Engineering, Stanford University
 * (c) 2015-2018
 *****************************************************************************
-* scheduler.h
-*      Scheduling-related globals. Primarily affects the pull engine.
+* scheduler.c
+*      Implementation of scheduling-related globals and of work stealing
+*      between thread groups.
 *****************************************************************************/
 
+#include "cmdline.h"
+#include "graphdata.h"
+#include "numanodes.h"
+#include "phases.h"
+#include "scheduler.h"
+#include "threads.h"
+
+#include <stddef.h>
 #include <stdint.h>
 
 
@@ -20,3 +29,127 @@
 uint64_t sched_pull_units_per_node = 0ull;
 
 uint64_t sched_pull_units_total = 0ull;
+
+uint64_t sched_units_stolen = 0ull;
+
+
+/* -------- LOCALS --------------------------------------------------------- */
+
+// Number of other groups each group can steal work from.
+static uint32_t sched_steal_num_victims = 0;
+
+// For each group, the other groups in the order in which it steals work from them, nearest NUMA node first.
+static uint32_t sched_steal_victims[CMDLINE_MAX_NUM_NUMA_NODES][CMDLINE_MAX_NUM_NUMA_NODES];
+
+// For each group and each entry in its list of victims, the number of units that must remain unassigned in the victim for the group to steal one of them.
+// Farther nodes need more remaining work, since every vector of a stolen unit is read from remote memory while the victim's own threads are likely to finish the last few units soon anyway.
+static uint64_t sched_steal_min_remaining[CMDLINE_MAX_NUM_NUMA_NODES][CMDLINE_MAX_NUM_NUMA_NODES];
+
+
+/* -------- INTERNAL FUNCTIONS --------------------------------------------- */
+
+#ifndef EXPERIMENT_EDGE_WITHOUT_STEALING
+// Performs a stolen unit of work using the specified Edge phase.
+// The global variable accumulator does not survive this C code, so if there is a reduce buffer the phase continues from, and writes back to, the calling thread's value in it.
+static inline void scheduler_perform_stolen_edge_work(void (__WRITTEN_IN_ASSEMBLY__ *edge_phase)(const __m256i* edge_list, const uint64_t edge_list_count), const __m256i* edge_list, const uint64_t edge_list_count, uint64_t* reduce_buffer)
+{
+    if (NULL == reduce_buffer)
+        edge_phase(edge_list, edge_list_count);
+    else
+        phase_op_perform_edge_phase_into_buf(edge_phase, edge_list, edge_list_count, reduce_buffer);
+}
+
+// ---------
+
+// Steals units of work from other groups, one at a time, and performs each by calling the specified Edge phase on behalf of the victim.
+// Returns once no other group has enough unassigned units left to be worth stealing.
+static void scheduler_steal_edge_work(const uint8_t is_pull, const uint64_t num_units, uint64_t* reduce_buffer)
+{
+    const uint32_t group = threads_get_thread_group_id();
+    const uint32_t local_id = threads_get_local_thread_id();
+    uint64_t num_units_stolen = 0ull;
+    
+    for (uint32_t i = 0; i < sched_steal_num_victims; ++i)
+    {
+        const uint32_t victim = sched_steal_victims[group][i];
+        volatile uint64_t* const victim_counter = graph_scheduler_dynamic_counter_numa[victim];
+        
+        // the counter holds the next unit to assign, so check how many remain before reserving one
+        while ((*victim_counter + sched_steal_min_remaining[group][i]) <= num_units)
+        {
+            const uint64_t unit = __sync_fetch_and_add(victim_counter, 1ull);
+            if (unit >= num_units)
+                break;
+            
+            // the scheduler gives a stealing thread the unit it reserved and nothing more, and the phase uses the victim's edge list and per-node data
+            threads_set_local_thread_id_and_group(SCHED_STEAL_LOCAL_ID_FLAG | (uint32_t)unit, victim);
+            
+            if (is_pull)
+                scheduler_perform_stolen_edge_work(perform_edge_pull_phase, graph_edges_gather_list_block_bufs_numa[victim][0], graph_edges_gather_list_block_counts_numa[victim][0], reduce_buffer);
+            else
+                scheduler_perform_stolen_edge_work(perform_edge_push_phase, graph_edges_scatter_list_block_bufs_numa[victim][0], graph_edges_scatter_list_block_counts_numa[victim][0], reduce_buffer);
+            
+            threads_set_local_thread_id_and_group(local_id, group);
+            num_units_stolen += 1ull;
+        }
+    }
+    
+    if (0ull != num_units_stolen)
+    {
+        __sync_fetch_and_add(&sched_units_stolen, num_units_stolen);
+    }
+}
+#endif
+
+
+/* -------- FUNCTIONS ------------------------------------------------------ */
+// See "scheduler.h" for documentation.
+
+void scheduler_init_stealing(const uint32_t num_numa_nodes, const uint32_t* numa_nodes)
+{
+    sched_steal_num_victims = num_numa_nodes - 1;
+    
+    for (uint32_t group = 0; group < num_numa_nodes; ++group)
+    {
+        const uint32_t local_distance = numanodes_get_distance(numa_nodes[group], numa_nodes[group]);
+        uint32_t num_victims = 0;
+        
+        // insertion sort of the other groups by distance, starting with the next group after this one so that ties do not all favor the same victim
+        for (uint32_t offset = 1; offset < num_numa_nodes; ++offset)
+        {
+            const uint32_t victim = (group + offset) % num_numa_nodes;
+            const uint32_t distance = numanodes_get_distance(numa_nodes[group], numa_nodes[victim]);
+            uint32_t position = num_victims;
+            
+            while (position > 0 && numanodes_get_distance(numa_nodes[group], numa_nodes[sched_steal_victims[group][position - 1]]) > distance)
+            {
+                sched_steal_victims[group][position] = sched_steal_victims[group][position - 1];
+                sched_steal_min_remaining[group][position] = sched_steal_min_remaining[group][position - 1];
+                position -= 1;
+            }
+            
+            // the number of units that must remain is the distance relative to the local node, rounded down, so 2 for a typical remote node
+            sched_steal_victims[group][position] = victim;
+            sched_steal_min_remaining[group][position] = (uint64_t)((distance >= local_distance) ? (distance / local_distance) : 1);
+            num_victims += 1;
+        }
+    }
+}
+
+// ---------
+
+void scheduler_steal_edge_pull_work(uint64_t* reduce_buffer)
+{
+#ifndef EXPERIMENT_EDGE_WITHOUT_STEALING
+    scheduler_steal_edge_work(1, sched_pull_units_per_node, reduce_buffer);
+#endif
+}
+
+// ---------
+
+void scheduler_steal_edge_push_work(uint64_t* reduce_buffer)
+{
+#ifndef EXPERIMENT_EDGE_WITHOUT_STEALING
+    scheduler_steal_edge_work(0, (uint64_t)threads_get_threads_per_group() << SCHED_PUSH_UNITS_PER_THREAD_LOG2, reduce_buffer);
+#endif
+}
@@ -178,6 +178,17 @@ threads_get_per_thread_variable             ENDP
 
 ; ---------
 
+threads_set_local_thread_id_and_group       PROC PUBLIC
+    ; writing to the lower half clears the upper half, so preserve the information there
+    vextractf128            xmm0,                   ymm_threadinfo,         1
+    vpinsrd                 xmm_threadinfo,         xmm_threadinfo,         ecx,                    0           ; local thread ID
+    vpinsrd                 xmm_threadinfo,         xmm_threadinfo,         edx,                    2           ; thread group number
+    vinsertf128             ymm_threadinfo,         ymm_threadinfo,         xmm0,                   1
+    ret
+threads_set_local_thread_id_and_group       ENDP
+
+; ---------
+
 threads_barrier                             PROC PUBLIC
     ; read in the current value of the thread barrier flag
     mov                     edx,                    DWORD PTR [thread_barrier_flag]